@@ -0,0 +1,116 @@
+#!/usr/bin/env bash
+# Measures how long luka takes to compile long arithmetic expressions.
+#
+# Usage: benchmarks/compile.sh [-n repetitions] [-s nested|chain] [depth...]
+#
+# Environment:
+#   LUKA - the luka compiler to use (defaults to `luka` from PATH).
+#
+# For every depth a function returning `1 + (1 + (1 + ...))` (nested, the
+# default) or `1 + 2 * 3 - 4 / 5 ...` (chain) is generated and compiled to an
+# object file at -O0, so the time reported is dominated by the frontend. The
+# time reported is the best of the repetitions.
+
+set -euo pipefail
+
+LUKA="${LUKA:-luka}"
+REPETITIONS=3
+SHAPE=nested
+
+while getopts "n:s:h" option; do
+    case "${option}" in
+        n) REPETITIONS="${OPTARG}" ;;
+        s) SHAPE="${OPTARG}" ;;
+        h | *)
+            sed -n '2,12p' "${BASH_SOURCE[0]}" | sed 's/^# \{0,1\}//'
+            exit 1
+            ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+case "${SHAPE}" in
+    nested | chain) ;;
+    *)
+        echo "unknown shape '${SHAPE}', expected nested or chain" >&2
+        exit 1
+        ;;
+esac
+
+if [ "$#" -gt 0 ]; then
+    DEPTHS=("$@")
+else
+    DEPTHS=(250 500 1000 2000)
+fi
+
+WORK_DIR="$(mktemp -d)"
+trap 'rm -rf "${WORK_DIR}"' EXIT
+
+# Writes a luka source file with a single expression nested to the given depth.
+generate_nested() {
+    local depth="$1" output_file="$2"
+
+    {
+        echo "fn nested(): s32 {"
+        printf "    return "
+        for _ in $(seq "${depth}"); do
+            printf "1 + ("
+        done
+        printf "1"
+        for _ in $(seq "${depth}"); do
+            printf ")"
+        done
+        echo ";"
+        echo "}"
+    } > "${output_file}"
+}
+
+# Writes a luka source file with a single unparenthesized expression of the
+# given number of operators, cycling through operators of different precedence.
+generate_chain() {
+    local depth="$1" output_file="$2"
+    local operators=("+" "*" "-" "/" "<<" "|" "%" "^")
+    local i
+
+    {
+        echo "fn chain(): s32 {"
+        printf "    return 1"
+        for i in $(seq "${depth}"); do
+            printf " %s %d" "${operators[$((i % ${#operators[@]}))]}" \
+                $((i % 7 + 1))
+        done
+        echo ";"
+        echo "}"
+    } > "${output_file}"
+}
+
+status=0
+printf "%-8s %10s\n" "depth" "time (ms)"
+
+for depth in "${DEPTHS[@]}"; do
+    source="${WORK_DIR}/${SHAPE}_${depth}.luka"
+    "generate_${SHAPE}" "${depth}" "${source}"
+
+    best=""
+    for _ in $(seq "${REPETITIONS}"); do
+        start=$(date +%s%N)
+        if ! "${LUKA}" -O0 -c -o "${WORK_DIR}/${SHAPE}_${depth}.o" \
+            "${source}" > "${WORK_DIR}/${SHAPE}_${depth}.log" 2>&1; then
+            echo "depth ${depth}: luka failed to compile, see below" >&2
+            cat "${WORK_DIR}/${SHAPE}_${depth}.log" >&2
+            status=1
+            break
+        fi
+        end=$(date +%s%N)
+        elapsed=$(((end - start) / 1000000))
+        if [ -z "${best}" ] || [ "${elapsed}" -lt "${best}" ]; then
+            best="${elapsed}"
+        fi
+    done
+
+    if [ -n "${best}" ]; then
+        printf "%-8s %10s\n" "${depth}" "${best}"
+    fi
+done
+
+exit "${status}"
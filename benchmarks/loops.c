@@ -0,0 +1,17 @@
+#include <stdint.h>
+#include <stdio.h>
+
+int main(void)
+{
+    uint64_t total = 0;
+    for (uint64_t i = 0; i < 20000; ++i)
+    {
+        for (uint64_t j = 0; j < 20000; ++j)
+        {
+            total = total + ((i * j) ^ (i + j));
+        }
+    }
+
+    printf("%lu\n", total);
+    return 0;
+}
@@ -0,0 +1,101 @@
+#!/usr/bin/env bash
+# Runs every Luka benchmark next to its C equivalent and reports Luka/C ratios.
+#
+# Usage: benchmarks/run.sh [-O level] [-n repetitions] [benchmark...]
+#
+# Environment:
+#   LUKA - the luka compiler to use (defaults to `luka` from PATH).
+#   CC   - the C compiler to compare against (defaults to `clang`).
+#
+# Both sides are built at the same optimization level. Every benchmark prints
+# a checksum, and the run fails if the Luka and C checksums differ. The time
+# reported is the best of the repetitions.
+
+set -euo pipefail
+
+LUKA="${LUKA:-luka}"
+CC="${CC:-clang}"
+OPTIMIZATION="3"
+REPETITIONS=3
+BENCHMARKS_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+
+while getopts "O:n:h" option; do
+    case "${option}" in
+        O) OPTIMIZATION="${OPTARG}" ;;
+        n) REPETITIONS="${OPTARG}" ;;
+        h | *)
+            sed -n '2,12p' "${BASH_SOURCE[0]}" | sed 's/^# \{0,1\}//'
+            exit 1
+            ;;
+    esac
+done
+shift $((OPTIND - 1))
+
+if [ "$#" -gt 0 ]; then
+    BENCHMARKS=("$@")
+else
+    BENCHMARKS=()
+    for source in "${BENCHMARKS_DIR}"/*.luka; do
+        BENCHMARKS+=("$(basename "${source}" .luka)")
+    done
+fi
+
+WORK_DIR="$(mktemp -d)"
+trap 'rm -rf "${WORK_DIR}"' EXIT
+
+# Prints the best wall-clock time of a command in milliseconds, and saves its
+# output to the file given as the first argument.
+best_time_ms() {
+    local output_file="$1"
+    shift
+    local best="" start end elapsed
+
+    for _ in $(seq "${REPETITIONS}"); do
+        start=$(date +%s%N)
+        "$@" > "${output_file}"
+        end=$(date +%s%N)
+        elapsed=$(((end - start) / 1000000))
+        if [ -z "${best}" ] || [ "${elapsed}" -lt "${best}" ]; then
+            best="${elapsed}"
+        fi
+    done
+
+    echo "${best}"
+}
+
+status=0
+printf "%-12s %10s %10s %8s\n" "benchmark" "luka (ms)" "c (ms)" "ratio"
+
+for name in "${BENCHMARKS[@]}"; do
+    luka_exe="${WORK_DIR}/${name}.luka.out"
+    c_exe="${WORK_DIR}/${name}.c.out"
+
+    if ! "${LUKA}" -O"${OPTIMIZATION}" -o "${luka_exe}" \
+        "${BENCHMARKS_DIR}/${name}.luka" > "${WORK_DIR}/${name}.log" 2>&1; then
+        echo "${name}: luka failed to compile, see below" >&2
+        cat "${WORK_DIR}/${name}.log" >&2
+        status=1
+        continue
+    fi
+
+    if ! "${CC}" -O"${OPTIMIZATION}" -o "${c_exe}" \
+        "${BENCHMARKS_DIR}/${name}.c"; then
+        echo "${name}: ${CC} failed to compile" >&2
+        status=1
+        continue
+    fi
+
+    luka_ms=$(best_time_ms "${WORK_DIR}/${name}.luka.txt" "${luka_exe}")
+    c_ms=$(best_time_ms "${WORK_DIR}/${name}.c.txt" "${c_exe}")
+
+    if ! cmp -s "${WORK_DIR}/${name}.luka.txt" "${WORK_DIR}/${name}.c.txt"; then
+        echo "${name}: luka and c outputs differ" >&2
+        status=1
+    fi
+
+    ratio=$(awk -v l="${luka_ms}" -v c="${c_ms}" \
+        'BEGIN { if (c == 0) { c = 1 } printf "%.2f", l / c }')
+    printf "%-12s %10s %10s %8s\n" "${name}" "${luka_ms}" "${c_ms}" "${ratio}"
+done
+
+exit "${status}"
@@ -0,0 +1,48 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static void insertion_sort(int32_t *array, uint64_t length)
+{
+    for (uint64_t i = 1; i < length; ++i)
+    {
+        int32_t key = array[i];
+        uint64_t j = i;
+        while ((j > 0) & (array[j - 1] > key))
+        {
+            array[j] = array[j - 1];
+            j = j - 1;
+        }
+        array[j] = key;
+    }
+}
+
+int main(void)
+{
+    const uint64_t number_of_elements = 60000;
+    int32_t *array = malloc(number_of_elements * sizeof(int32_t));
+    if (NULL == array)
+    {
+        printf("Couldn't allocate memory.\n");
+        exit(1);
+    }
+
+    int64_t seed = 12345;
+    for (uint64_t i = 0; i < number_of_elements; ++i)
+    {
+        seed = ((seed * 1103515245) + 12345) % 2147483647;
+        array[i] = (int32_t) (seed % 100000);
+    }
+
+    insertion_sort(array, number_of_elements);
+
+    uint64_t checksum = 0;
+    for (uint64_t i = 0; i < number_of_elements; ++i)
+    {
+        checksum = (checksum * 31) + (uint64_t) array[i];
+    }
+
+    printf("%d %d %lu\n", array[0], array[number_of_elements - 1], checksum);
+    free(array);
+    return 0;
+}
@@ -0,0 +1,123 @@
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* A straight port of lib/std/String.luka so both sides do the same work. */
+typedef struct
+{
+    uint8_t *buffer;
+    size_t length;
+    size_t capacity;
+    size_t _factor;
+} String;
+
+static void String_init(String *self)
+{
+    self->buffer = NULL;
+    self->length = 0;
+    self->capacity = 0;
+    self->_factor = 16;
+}
+
+static void String_destroy(String *self)
+{
+    if (NULL != self->buffer)
+    {
+        free(self->buffer);
+        self->buffer = NULL;
+    }
+
+    free(self);
+}
+
+static String *String_new(const char *str)
+{
+    String *instance = malloc(sizeof(String));
+    if (NULL == instance)
+    {
+        return NULL;
+    }
+
+    String_init(instance);
+
+    if (NULL != str)
+    {
+        size_t len = strlen(str);
+        instance->buffer = (uint8_t *) strdup(str);
+        instance->length = len;
+        instance->capacity = len;
+    }
+
+    return instance;
+}
+
+static uint8_t *String_cstr(String *self)
+{
+    return self->buffer;
+}
+
+static void String_append(String *self, const char *str)
+{
+    if (NULL == self->buffer)
+    {
+        size_t len = strlen(str);
+        self->buffer = (uint8_t *) strdup(str);
+        self->length = len;
+        self->capacity = len;
+    }
+    else
+    {
+        size_t len = strlen(str);
+        size_t total_len = self->length + len;
+        if (total_len > self->capacity)
+        {
+            size_t new_capacity = self->capacity * self->_factor;
+            uint8_t *new_buffer = realloc(self->buffer, new_capacity);
+            if (new_buffer != NULL)
+            {
+                self->buffer = new_buffer;
+                self->capacity = new_capacity;
+            }
+        }
+        size_t i = self->length;
+        size_t j = 0;
+        uint8_t *buffer = self->buffer;
+        while (j < len)
+        {
+            if (i <= self->capacity)
+            {
+                buffer[i] = (uint8_t) str[j];
+                i = i + 1;
+                j = j + 1;
+            }
+        }
+    }
+}
+
+static uint64_t build(uint64_t pieces)
+{
+    String *s = String_new("luka");
+    for (uint64_t i = 0; i < pieces; ++i)
+    {
+        String_append(s, " benchmark");
+    }
+
+    uint8_t *buffer = String_cstr(s);
+    uint64_t checksum = (uint8_t) (buffer[0] + buffer[4]);
+    String_destroy(s);
+    return checksum;
+}
+
+int main(void)
+{
+    uint64_t total = 0;
+    for (uint64_t round = 0; round < 2000; ++round)
+    {
+        total = total + build(10000);
+    }
+
+    printf("%lu\n", total);
+    return 0;
+}
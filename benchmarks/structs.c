@@ -0,0 +1,62 @@
+#include <stdint.h>
+#include <stdio.h>
+
+typedef struct
+{
+    int64_t x;
+    int64_t y;
+    int64_t vx;
+    int64_t vy;
+} Body;
+
+static void Body_step(Body *self)
+{
+    self->x = self->x + self->vx;
+    self->y = self->y + self->vy;
+    if (self->x > 1000)
+    {
+        self->vx = 0 - self->vx;
+    }
+    if (self->y > 1000)
+    {
+        self->vy = 0 - self->vy;
+    }
+    if (self->x < 0)
+    {
+        self->vx = 0 - self->vx;
+    }
+    if (self->y < 0)
+    {
+        self->vy = 0 - self->vy;
+    }
+}
+
+static int64_t Body_energy(const Body *self)
+{
+    return (self->vx * self->vx) + (self->vy * self->vy);
+}
+
+static int64_t simulate(int64_t seed)
+{
+    Body body = {.x = 0, .y = 0, .vx = 3, .vy = 5};
+    body.x = seed % 1000;
+    body.y = seed % 7;
+    for (int32_t i = 0; i < 1000; ++i)
+    {
+        Body_step(&body);
+    }
+
+    return Body_energy(&body) + body.x;
+}
+
+int main(void)
+{
+    int64_t total = 0;
+    for (int64_t round = 0; round < 200000; ++round)
+    {
+        total = total + simulate(round);
+    }
+
+    printf("%ld\n", total);
+    return 0;
+}
@@ -136,6 +136,23 @@ t_ast_node *AST_new_assignment_expr(t_ast_node *lhs, t_ast_node *rhs);
 t_ast_node *AST_new_if_expr(t_ast_node *cond, t_vector *then_body,
                             t_vector *else_body);
 
+/**
+ * @brief Creates a new AST node of a match expression.
+ *
+ * @note This match is an expression and can return a value from its arms.
+ *
+ * @param[in] value the integer or enum value to match.
+ * @param[in] arms a vector of #t_ast_match_arm_ptr, the first arm with a
+ * pattern equal to the value is executed.
+ * @param[in] else_body a vector of statements that will be executed if no arm
+ * matches, or NULL.
+ *
+ * @return an AST node of a match expression with the passed in value, arms and
+ * else_body.
+ */
+t_ast_node *AST_new_match_expr(t_ast_node *value, t_vector *arms,
+                               t_vector *else_body);
+
 /**
  * @brief Creates a new AST node of a while expression.
  *
@@ -145,10 +162,35 @@ t_ast_node *AST_new_if_expr(t_ast_node *cond, t_vector *then_body,
  * not.
  * @param[in] body a vector of statements that will be executed as long as the
  * condition is true.
+ * @param[in] label the label that break and continue statements can use to
+ * refer to the loop, or NULL.
+ * @param[in] hints the optimization hints of the loop.
  *
  * @return an AST node of a while expression with the passed in cond and body.
  */
-t_ast_node *AST_new_while_expr(t_ast_node *cond, t_vector *body);
+t_ast_node *AST_new_while_expr(t_ast_node *cond, t_vector *body, char *label,
+                               t_loop_hints hints);
+
+/**
+ * @brief Creates a new AST node of a range for expression.
+ *
+ * @details The induction variable goes from @p start up to but not including
+ * @p end, in increments of @p step.
+ *
+ * @param[in] var the induction variable.
+ * @param[in] start the first value of the induction variable.
+ * @param[in] end the value that stops the loop.
+ * @param[in] step the increment of the induction variable, or NULL for 1.
+ * @param[in] body a vector of statements that will be executed for every value.
+ * @param[in] label the label that break and continue statements can use to
+ * refer to the loop, or NULL.
+ * @param[in] hints the optimization hints of the loop.
+ *
+ * @return an AST node of a for expression with the passed in range and body.
+ */
+t_ast_node *AST_new_for_expr(t_ast_node *var, t_ast_node *start,
+                             t_ast_node *end, t_ast_node *step, t_vector *body,
+                             char *label, t_loop_hints hints);
 
 /**
  * @brief Creates a new AST node of a cast expression.
@@ -200,9 +242,24 @@ t_ast_node *AST_new_expression_stmt(t_ast_node *expr);
  *
  * @note Break statements can only be used inside loops.
  *
+ * @param[in] label the label of the loop to break out of, or NULL for the
+ * innermost loop.
+ *
  * @return an AST node of a break statement.
  */
-t_ast_node *AST_new_break_stmt(void);
+t_ast_node *AST_new_break_stmt(char *label);
+
+/**
+ * @brief Creates a new AST node of a continue statement.
+ *
+ * @note Continue statements can only be used inside loops.
+ *
+ * @param[in] label the label of the loop to continue, or NULL for the
+ * innermost loop.
+ *
+ * @return an AST node of a continue statement.
+ */
+t_ast_node *AST_new_continue_stmt(char *label);
 
 /**
  * @brief Creates a new AST node of a struct defintion.
@@ -347,48 +404,22 @@ t_ast_node *AST_new_defer_stmt(t_vector *body);
 t_ast_node *AST_fix_function_last_expression_stmt(t_ast_node *node);
 
 /**
- * @brief Fix structs and enums that were classified as type aliases.
+ * @brief Resolve the types used by a top level node and infer the types of the
+ * variables referenced by it.
  *
- * @param[in] node the AST node that should be fixed.
- * @param[in] module the module that should be used to look up structs and
- * enums.
- * @param[in] logger the logger to be used to log messages.
+ * @details Structs and enums that were classified as type aliases are fixed,
+ * type aliases are resolved, and every variable reference is given the type of
+ * the innermost parameter or let statement declaring it. Every node is visited
+ * once, so the analysis is linear in the size of @p node.
  *
- * @return the same AST node with the type possibly fixed.
- */
-t_ast_node *AST_fix_types(t_ast_node *node, t_module *module, t_logger *logger);
-
-/**
- * @brief Resolve all type aliases inside @p node using @p type_aliases.
- *
- * @param[in] node the node to resolve type aliases in.
- * @param[in] type_aliases a vector that contains all type_aliases in scope.
+ * @param[in,out] node a function, struct definition or global let statement.
+ * @param[in] module the module that should be used to look up structs, enums
+ * and functions.
+ * @param[in] type_aliases a vector that contains all type aliases in scope.
  * @param[in] logger a logger that can be used to log messages.
- *
- * @returns @p node with resolved type aliases.
  */
-t_ast_node *AST_resolve_type_aliases(t_ast_node *node, t_vector *type_aliases,
-                                     t_logger *logger);
-
-/**
- * @brief Populate types of variable reference to parameters of @p function with
- * the correct types.
- *
- * @param[in,out] function the function to fill types in.
- * @param[in] logger a logger that can be used to log messages.
- */
-void AST_fill_parameter_types(t_ast_node *function, t_logger *logger,
-                              const t_module *module);
-
-/**
- * @brief Populate types of variable reference to variables declared in @p
- * function with the correct types.
- *
- * @param[in,out] function the function to fill types in.
- * @param[in] logger a logger that can be used to log messages.
- */
-void AST_fill_variable_types(t_ast_node *function, t_logger *logger,
-                             const t_module *module);
+void AST_analyze(t_ast_node *node, t_module *module, t_vector *type_aliases,
+                 t_logger *logger);
 
 /**
  * @brief Helper function to know if a given node can be used as an
@@ -408,6 +439,24 @@ bool AST_is_expression(t_ast_node *node);
  */
 void AST_free_node(t_ast_node *node, t_logger *logger);
 
+/**
+ * @brief Release the memory of all the AST nodes that were ever created.
+ *
+ * @details AST nodes are allocated from shared blocks, so AST_free_node only
+ * frees the resources a node owns, and the nodes themselves are released here
+ * once no module references them anymore.
+ */
+void AST_free_nodes(void);
+
+/**
+ * @brief Hand the AST nodes created by the current thread over to
+ * AST_free_nodes.
+ *
+ * @details Every thread creates nodes from blocks of its own, a thread that
+ * creates nodes other than the main thread has to call this before it exits.
+ */
+void AST_release_thread_nodes(void);
+
 /**
  * @brief Helper function to print multiple functions.
  *
@@ -2,6 +2,7 @@
 #ifndef LUKA_DEFS_H
 #define LUKA_DEFS_H
 
+#include <llvm-c/Types.h>
 #include <stdbool.h>
 #include <stdint.h>
 
@@ -47,7 +48,7 @@ typedef enum
 } t_return_code;            /**< An enum of possible luka return codes */
 
 #define NUMBER_OF_KEYWORDS                                                     \
-    36 /**< Number of keywords in the luka programming language */
+    42 /**< Number of keywords in the luka programming language */
 extern const char *
     keywords[NUMBER_OF_KEYWORDS]; /**< string representations of the keywords */
 
@@ -69,6 +70,12 @@ typedef enum
     T_IMPORT,       /**< A "import" token */
     T_TYPE,         /**< A "type" token */
     T_DEFER,        /**< A "defer" token */
+    T_EXPORT,       /**< A "export" token */
+    T_FOR,          /**< A "for" token */
+    T_IN,           /**< A "in" token */
+    T_CONTINUE,     /**< A "continue" token */
+    T_RESTRICT,     /**< A "restrict" token */
+    T_MATCH,        /**< A "match" token */
 
     T_NULL,  /**< A "null" token */
     T_TRUE,  /**< A "true" token */
@@ -110,6 +117,9 @@ typedef enum
     T_STAR,                            /**< A "*" token */
     T_SLASH,                           /**< A "/" token */
     T_PERCENT,                         /**< A "%" token */
+    T_PLUS_PERCENT,                    /**< A "+%" token */
+    T_MINUS_PERCENT,                   /**< A "-%" token */
+    T_STAR_PERCENT,                    /**< A "*%" token */
     T_INTLIT,                          /**< An int literal token */
 
     T_EQUALS,    /**< A "=" token */
@@ -120,9 +130,12 @@ typedef enum
     T_NEQ,       /**< A "!=" token */
     T_LEQ,       /**< A "<=" token */
     T_GEQ,       /**< A ">=" token */
+    T_FAT_ARROW, /**< A "=>" token */
 
-    T_AMPERCENT, /**< A "&" token */
-    T_PIPE,      /**< A "|" token */
+    T_AMPERCENT,        /**< A "&" token */
+    T_PIPE,             /**< A "|" token */
+    T_DOUBLE_AMPERCENT, /**< A "&&" token */
+    T_DOUBLE_PIPE,      /**< A "||" token */
     T_CARET,     /**< A "^" token */
     T_TILDE,     /**< A "~" token */
     T_SHL,       /**< A "<<" token */
@@ -131,6 +144,7 @@ typedef enum
     T_COLON,        /**< A ":" token */
     T_DOUBLE_COLON, /**< A "::" token */
     T_DOT,          /**< A "." token */
+    T_DOUBLE_DOT,   /**< A ".." token */
     T_THREE_DOTS,   /**< A "..." token */
 
     T_BUILTIN, /**< A token for an identifier that starts with "@" */
@@ -178,6 +192,9 @@ typedef enum
     AST_TYPE_BUILTIN,           /**< An AST node for builtins */
     AST_TYPE_TYPE_EXPR,         /**< An AST node for type exprs */
     AST_TYPE_DEFER_STMT,        /**< An AST node for defer statements */
+    AST_TYPE_FOR_EXPR,          /**< An AST node for range for expressions */
+    AST_TYPE_CONTINUE_STMT,     /**< An AST node for continue statements */
+    AST_TYPE_MATCH_EXPR,        /**< An AST node for match expressions */
 } t_ast_node_type; /**< An enum for different types of an AST node */
 
 typedef enum
@@ -198,6 +215,11 @@ typedef enum
     BINOP_BAND,     /**< A binary operator for binary and */
     BINOP_BXOR,     /**< A binary operator for binary xor */
     BINOP_BOR,      /**< A binary operator for binary or */
+    BINOP_ADD_WRAP, /**< A binary operator for wrapping addition */
+    BINOP_SUB_WRAP, /**< A binary operator for wrapping subtraction */
+    BINOP_MUL_WRAP, /**< A binary operator for wrapping multiplication */
+    BINOP_LAND,     /**< A binary operator for short-circuit logical and */
+    BINOP_LOR,      /**< A binary operator for short-circuit logical or */
 } t_ast_binop_type; /**< An enum for differnt binary operators */
 
 typedef enum
@@ -230,6 +252,7 @@ typedef enum
     TYPE_STRUCT, /**< Struct type */
     TYPE_ENUM,   /**< Enum type */
     TYPE_ARRAY,  /**< Array type */
+    TYPE_VECTOR, /**< SIMD vector type */
     TYPE_ALIAS,  /**< Alias type */
     TYPE_TYPE,   /**< Type type */
 } t_base_type;   /**< An enum for different value types */
@@ -237,8 +260,17 @@ typedef enum
 typedef enum
 {
     BUILTIN_ID_INVALID, /**< Used for unknown builtin ids */
-    BUILTIN_ID_SIZEOF,  /**< @sizeOf */
-} t_builtin_id;         /**< Identifiers for builtin symbols */
+    BUILTIN_ID_SIZEOF,     /**< @sizeOf */
+    BUILTIN_ID_SHUFFLE,    /**< @shuffle */
+    BUILTIN_ID_SELECT,     /**< @select */
+    BUILTIN_ID_REDUCE_ADD, /**< @reduceAdd */
+    BUILTIN_ID_REDUCE_MUL, /**< @reduceMul */
+    BUILTIN_ID_REDUCE_MIN, /**< @reduceMin */
+    BUILTIN_ID_REDUCE_MAX, /**< @reduceMax */
+    BUILTIN_ID_REDUCE_AND, /**< @reduceAnd */
+    BUILTIN_ID_REDUCE_OR,  /**< @reduceOr */
+    BUILTIN_ID_REDUCE_XOR, /**< @reduceXor */
+} t_builtin_id;            /**< Identifiers for builtin symbols */
 
 typedef struct s_type
 {
@@ -246,6 +278,12 @@ typedef struct s_type
     struct s_type *inner_type; /**< Inner type, used in pointers and arrays */
     void *payload;             /**< Used for the name of structs and enums */
     bool mutable;              /**< Whether the value is mutable or not */
+    struct s_type *canonical;  /**< The type without any mutability, which
+                                    identifies it when comparing types */
+    LLVMTypeRef llvm_type;     /**< The LLVM type of a canonical type, cached
+                                    by code generation */
+    unsigned long llvm_generation; /**< The code generation that cached the
+                                        LLVM type, 0 if it wasn't cached */
 } t_type;                      /**< Struct for describing a type */
 
 typedef struct s_ast_node
@@ -296,6 +334,21 @@ typedef struct
     t_ast_node *rhs;     /**< The expression assigned to the assignee */
 } t_ast_assignment_expr; /**< An AST node for assignment expressions */
 
+typedef struct
+{
+    bool always_inline; /**< Whether the function is always inlined */
+    bool no_inline;     /**< Whether the function is never inlined */
+    bool hot;           /**< Whether the function is called often */
+    bool cold;          /**< Whether the function is rarely called */
+    bool pure;  /**< Whether the function only reads memory, without side
+                   effects */
+    bool constant;  /**< Whether the function doesn't access memory at all */
+    bool no_return; /**< Whether the function never returns */
+    bool no_unwind; /**< Whether the function never unwinds */
+    bool fast_math; /**< Whether the floating point math of the function is
+                       optimized as if it were on real numbers */
+} t_function_attributes; /**< Attributes given to a function */
+
 typedef struct
 {
     char *name;          /**< The name of the function */
@@ -305,12 +358,16 @@ typedef struct
     unsigned int
         arity;   /**< The arity of the function (how many arguments it takes) */
     bool vararg; /**< Whether the function is variadic */
+    bool *restricted; /**< Whether each argument is a `restrict` pointer, NULL
+                         if the function has no arguments */
+    t_function_attributes attributes; /**< The attributes of the function */
 } t_ast_prototype; /**< An AST node for function prototypes */
 
 typedef struct
 {
     t_ast_node *prototype; /**< The prototype of the function */
     t_vector *body;        /**< The body of the function */
+    bool exported;         /**< Whether the function is exported */
 } t_ast_function;          /**< An AST node for functions */
 
 typedef struct
@@ -327,13 +384,55 @@ typedef struct
         *else_body; /**< The statements executed it the condition is false */
 } t_ast_if_expr;    /**< An AST node for if expressions */
 
+typedef struct
+{
+    t_vector *patterns; /**< The constant values the arm matches */
+    t_vector *body;     /**< The statements executed if one of them matches */
+} t_ast_match_arm;      /**< An arm of a match expression */
+
+typedef t_ast_match_arm
+    *t_ast_match_arm_ptr; /**< A type alias for getting this type from a vector */
+
+typedef struct
+{
+    t_ast_node *value; /**< The integer or enum value that is matched */
+    t_vector *arms;    /**< The #t_ast_match_arm_ptr arms, in order */
+    t_vector *else_body; /**< The statements executed if no arm matches, or
+                            NULL */
+} t_ast_match_expr;      /**< An AST node for match expressions */
+
+typedef struct
+{
+    unsigned int unroll_count;     /**< The unroll count, or 0 */
+    unsigned int vectorize_width;  /**< The vectorization width, or 0 */
+    unsigned int interleave_count; /**< The interleave count, or 0 */
+    bool unroll_full;     /**< Whether the loop is fully unrolled */
+    bool vectorize;       /**< Whether vectorization is forced */
+    bool no_vectorize;    /**< Whether vectorization is disabled */
+    bool parallel_access; /**< Whether iterations don't depend on the memory
+                             accesses of each other */
+} t_loop_hints;           /**< Optimization hints given to a loop */
+
 typedef struct
 {
     t_ast_node *cond; /**< The condition of the while expression */
     t_vector
         *body; /**< The statements executed as long as the condition is true */
+    char *label; /**< The label of the loop, or NULL */
+    t_loop_hints hints; /**< The optimization hints of the loop */
 } t_ast_while_expr; /**< An AST node for while expressions */
 
+typedef struct
+{
+    t_ast_node *var;   /**< The induction variable */
+    t_ast_node *start; /**< The first value of the range */
+    t_ast_node *end;   /**< One past the last value of the range */
+    t_ast_node *step;  /**< The constant distance between values, or NULL */
+    t_vector *body;    /**< The statements executed for every value */
+    char *label;       /**< The label of the loop, or NULL */
+    t_loop_hints hints; /**< The optimization hints of the loop */
+} t_ast_for_expr;      /**< An AST node for range for expressions */
+
 typedef struct
 {
     t_ast_node *expr; /**< The expression to cast */
@@ -434,6 +533,12 @@ typedef struct
     t_vector *body;
 } t_ast_defer_stmt;
 
+typedef struct
+{
+    char *label; /**< The label of the loop to jump out of, or NULL for the
+                    innermost loop */
+} t_ast_jump_stmt; /**< An AST node for break and continue statements */
+
 typedef struct s_ast_node
 {
     t_ast_node_type type; /**< The type of the AST node */
@@ -468,9 +573,15 @@ typedef struct s_ast_node
         t_ast_builtin builtin;             /**< Builtin AST node value */
         t_ast_type_expr type_expr;         /**< Type expr AST node value */
         t_ast_defer_stmt defer_stmt; /**< Defer statement AST node value */
+        t_ast_for_expr for_expr;     /**< For expression AST node value */
+        t_ast_jump_stmt break_stmt;  /**< Break statement AST node value */
+        t_ast_jump_stmt continue_stmt; /**< Continue statement AST node value */
+        t_ast_match_expr match_expr;   /**< Match expression AST node value */
     };                               /**< All possible AST node values */
     t_token *token;                  /**< The origin token of the node */
-} t_ast_node;                        /**< A struct for AST nodes */
+    t_type *expr_type; /**< The interned type of the node, memoized by the type
+                          checker once all types are resolved */
+} t_ast_node;          /**< A struct for AST nodes */
 
 typedef t_ast_node
     *t_ast_node_ptr; /**< A type alias for getting this type from a vector */
@@ -9,15 +9,31 @@
 #include "logger.h"
 #include "uthash.h"
 
-typedef struct
+/** Fast-math flags, each allowing an optimization of floating point math */
+#define GEN_FAST_MATH_REASSOC  (1U << 0) /**< Reassociate operations */
+#define GEN_FAST_MATH_CONTRACT (1U << 1) /**< Fuse operations, such as FMA */
+#define GEN_FAST_MATH_NNAN     (1U << 2) /**< Assume there are no NaNs */
+#define GEN_FAST_MATH_NINF     (1U << 3) /**< Assume there are no infinities */
+#define GEN_FAST_MATH_NSZ      (1U << 4) /**< Ignore the sign of zeros */
+#define GEN_FAST_MATH_ARCP     (1U << 5) /**< Multiply by reciprocals */
+#define GEN_FAST_MATH_AFN      (1U << 6) /**< Approximate math functions */
+#define GEN_FAST_MATH_ALL      (0x7FU)   /**< All of the fast-math flags */
+
+typedef struct s_named_value
 {
     char *name;               /**< The name of the named value */
     LLVMValueRef alloca_inst; /**< The alloca instruction of the named value */
-    LLVMTypeRef type;         /**< The LLVM type of the named value */
-    t_type *ttype;            /**< The luka type of the named value */
-    bool mutable;             /**< Whether the named value is mutable */
-    UT_hash_handle hh;        /**< A handle for uthash */
-} t_named_value;              /**< A struct for named values */
+    LLVMValueRef value; /**< The value of an immutable named value that is kept
+                           in a register instead of an alloca, or NULL */
+    LLVMTypeRef type;   /**< The LLVM type of the named value */
+    t_type *ttype;      /**< The luka type of the named value */
+    bool mutable;       /**< Whether the named value is mutable */
+    struct s_named_value *shadowed; /**< The named value hidden by this one */
+    UT_hash_handle hh;              /**< A handle for uthash */
+} t_named_value;                    /**< A struct for named values */
+
+typedef t_named_value
+    *t_named_value_ptr; /**< A type alias for getting this type from a vector */
 
 typedef struct
 {
@@ -39,6 +55,35 @@ typedef struct
     UT_hash_handle hh;       /**< A handle for uthash */
 } t_enum_info;               /**< A struct for keeping info about enums */
 
+typedef struct
+{
+    t_type *ttype;          /**< The interned luka type */
+    LLVMTypeRef llvm_type;  /**< The matching LLVM type */
+    UT_hash_handle hh;      /**< A handle for uthash */
+} t_type_mapping; /**< A struct for caching conversions between types */
+
+typedef struct
+{
+    char *value;          /**< The contents of the string literal */
+    LLVMValueRef global;  /**< The global holding the string literal */
+    UT_hash_handle hh;    /**< A handle for uthash */
+} t_pooled_string; /**< A struct for pooling string literals */
+
+typedef struct
+{
+    char *ir;                 /**< The IR the instruction is parsed from */
+    LLVMModuleRef module;     /**< The module parsed from the IR */
+    LLVMValueRef instruction; /**< The instruction with fast-math flags */
+    UT_hash_handle hh;        /**< A handle for uthash */
+} t_fast_math_template; /**< An instruction with fast-math flags to clone */
+
+typedef struct
+{
+    const char *label;                /**< The label of the loop, or NULL */
+    LLVMBasicBlockRef continue_block; /**< The block `continue` jumps to */
+    LLVMBasicBlockRef break_block;    /**< The block `break` jumps to */
+} t_loop_blocks; /**< The blocks that jump statements in a loop go to */
+
 /**
  * @brief Generate prototypes for all functions in a given luka module.
  * @param[in] module the luka module.
@@ -77,8 +122,25 @@ LLVMValueRef GEN_codegen(t_ast_node *n, LLVMModuleRef module,
 
 /**
  * @brief Initializing the codegen environment.
+ *
+ * @param[in] verify whether to verify every function once it is generated,
+ * which points at the function that is broken, on top of verifying the whole
+ * module.
+ * @param[in] strict whether unsigned arithmetic is assumed not to wrap, like
+ * signed arithmetic is, unless a wrapping operator such as `+%` is used.
+ * @param[in] fast_math the fast-math flags of floating point math in every
+ * function, on top of the flags functions with `@fast_math` get.
+ */
+void GEN_codegen_initialize(bool verify, bool strict, unsigned int fast_math);
+
+/**
+ * @brief Get a fast-math flag by its name in LLVM IR, such as `nnan`.
+ *
+ * @param[in] name the name of the flag.
+ *
+ * @return the flag, or 0 if there is no flag with that name.
  */
-void GEN_codegen_initialize(void);
+unsigned int GEN_fast_math_flag(const char *name);
 
 /**
  * @brief Resetting the codegen environment.
@@ -2,6 +2,7 @@
 #ifndef LUKA_LOGGER_H
 #define LUKA_LOGGER_H
 
+#include <setjmp.h>
 #include <stdarg.h>
 #include <stdio.h>
 
@@ -10,11 +11,22 @@
 
 typedef struct
 {
-    FILE *fp;         /**< A file pointer to the logger file. */
-    char *file_path;  /**< The path of the logger file */
-    size_t verbosity; /**< The verbosity of the logger */
+    FILE *fp;           /**< A file pointer to the logger file. */
+    char *file_path;    /**< The path of the logger file */
+    size_t verbosity;   /**< The verbosity of the logger */
+    jmp_buf *recovery;  /**< Where to jump instead of logging, if set */
+    t_vector *deferred; /**< Where to keep messages to log later, if set */
 } t_logger;
 
+typedef struct
+{
+    const char *level;     /**< The severity level of the message */
+    char *message;         /**< The message, or NULL for a source location */
+    const char *file_path; /**< The file of the source location */
+    long line;             /**< The line of the source location */
+    long offset;           /**< The offset of the source location */
+} t_logger_message; /**< A message kept by a logger to be logged later */
+
 #define L_DEBUG   "DEBUG"   /**< Log string for the DEBUG level */
 #define L_ERROR   "ERROR"   /**< Log string for the ERROR level*/
 #define L_INFO    "INFO"    /**< Log string for the INFO level*/
@@ -33,6 +45,10 @@ t_logger *LOGGER_initialize(char *file_path, size_t verbosity);
 /**
  * @brief Log a new message to the log file.
  *
+ * @note If the logger has a recovery point, nothing is logged and the call
+ * jumps to the recovery point instead. If the logger defers messages, the
+ * message is kept to be logged by LOGGER_replay.
+ *
  * @param[in] logger the logger to log with.
  * @param[in] level the severity level of the log message.
  * @param[in] format the format of the log message.
@@ -61,11 +77,42 @@ void LOGGER_log(t_logger *logger, const char *level, const char *format, ...);
         (void) LOGGER_log(logger, level, format, __VA_ARGS__);                 \
         if (NULL != token)                                                     \
         {                                                                      \
-            (void) IO_print_error(token->file_path, token->line,               \
-                                  token->offset);                              \
+            (void) LOGGER_log_location(logger, token->file_path, token->line,  \
+                                       token->offset);                         \
         }                                                                      \
     } while (0)
 
+/**
+ * @brief Print a line of source code, pointing at a location in it.
+ *
+ * @note If the logger defers messages, the location is kept to be printed by
+ * LOGGER_replay.
+ *
+ * @param[in] logger the logger to log with.
+ * @param[in] file_path the path of the source file.
+ * @param[in] line the line of the location.
+ * @param[in] offset the offset of the location in its line.
+ */
+void LOGGER_log_location(t_logger *logger, const char *file_path, long line,
+                         long offset);
+
+/**
+ * @brief Log the messages that a deferring logger kept, in the order they were
+ * kept, and forget them.
+ *
+ * @param[in] logger the logger to log with.
+ * @param[in,out] messages the #t_logger_message kept by the deferring logger.
+ */
+void LOGGER_replay(t_logger *logger, t_vector *messages);
+
+/**
+ * @brief Forget the messages that a deferring logger kept without logging
+ * them.
+ *
+ * @param[in,out] messages the #t_logger_message kept by the deferring logger.
+ */
+void LOGGER_discard(t_vector *messages);
+
 /**
  * @brief Deallocates all memory allocated by @p logger.
  *
@@ -9,6 +9,7 @@
 
 #include "defs.h"
 #include "logger.h"
+#include "uthash.h"
 #include "vector.h"
 
 typedef struct
@@ -22,7 +23,18 @@ typedef struct
     const char *file_path;  /**< The path of parsed file */
     t_logger *logger;       /**< A logger the parser will log messages to */
     t_module *module;       /**< The module that the parser populates */
-} t_parser;                 /**< A struct for a parser */
+    bool lazy;              /**< Whether function bodies are parsed lazily */
+    bool no_struct_value; /**< Whether `name {` starts a body rather than a
+                             struct value, as in the range of a for loop */
+} t_parser;               /**< A struct for a parser */
+
+typedef struct
+{
+    t_ast_node *function; /**< The function whose body was skipped */
+    t_parser *parser;     /**< The parser of the module of the function */
+    size_t index;         /**< The index of the token before the body */
+    UT_hash_handle hh;    /**< A handle for uthash */
+} t_lazy_body;            /**< A struct for function bodies parsed lazily */
 
 /**
  * @brief Initializes a new parser based on the given parameters.
@@ -49,6 +61,24 @@ void PARSER_initialize(t_parser *parser, t_vector *tokens,
  */
 t_module *PARSER_parse_file(t_parser *parser);
 
+/**
+ * @brief Parse the body of a function that was skipped by a lazy parser.
+ *
+ * @note The parser of the function's module, its tokens and its type aliases
+ * must still be alive.
+ *
+ * @param[in,out] function the function AST node.
+ *
+ * @return the parser of the function's module if its body was parsed now, or
+ * NULL if the body was already parsed or the function has no body.
+ */
+t_parser *PARSER_parse_lazy_body(t_ast_node *function);
+
+/**
+ * @brief Forget the function bodies that were skipped and never parsed.
+ */
+void PARSER_free_lazy_bodies(void);
+
 /**
  * @brief Print all tokens of a parser.
  *
@@ -0,0 +1,23 @@
+/** @file reachability.h */
+#ifndef LUKA_REACHABILITY_H
+#define LUKA_REACHABILITY_H
+
+#include "defs.h"
+#include "logger.h"
+
+/**
+ * @brief Remove every function, struct function and global variable that
+ * can't be reached from `main` or from an exported function, in @p module and
+ * in every module it imports.
+ *
+ * @details Reachable functions whose bodies were skipped by a lazy parser are
+ * parsed, analyzed and type checked on the way. This has to run after type
+ * checking, which may still look up the removed functions, and before code
+ * generation.
+ *
+ * @param[in,out] module the main module of the program.
+ * @param[in] logger a logger that can be used to log messages.
+ */
+void REACHABILITY_prune(t_module *module, t_logger *logger);
+
+#endif // LUKA_REACHABILITY_H
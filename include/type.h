@@ -25,28 +25,56 @@ bool TYPE_is_floating_point(const char *s);
 bool TYPE_is_floating_type(t_type *type);
 
 /**
- * @brief Initialize a Luka type with the base type @p type.
+ * @brief Get the Luka type with the given properties.
+ *
+ * @details Types are interned, so identical types (including mutability) are
+ * the same instance and can be compared by pointer. Types must not be
+ * modified, and live until TYPE_free_interned_types is called. Types can be
+ * made from several threads at once.
  *
  * @param[in] type the base type of the Luka type.
+ * @param[in] inner_type the type pointed to or held by the Luka type, or NULL.
+ * @param[in] payload the name of a struct, enum or alias, which is copied, or
+ * the length of an array or vector.
+ * @param[in] mutable whether the Luka type is mutable.
  *
- * @return a Luka type with the base type @p type.
+ * @return the Luka type.
  */
-t_type *TYPE_initialize_type(t_base_type type);
+t_type *TYPE_make_type(t_base_type type, t_type *inner_type, void *payload,
+                       bool mutable);
 
 /**
- * @brief Checks if two types are equal based on all of their properties.
+ * @brief Get a Luka type that only differs from another in its mutability.
  *
- * @param[in] type1 the first type.
- * @param[in] type2 the second type.
+ * @param[in] type the Luka type.
+ * @param[in] mutable whether the returned type is mutable.
  *
- * @return a boolean that represents if the types are equal.
+ * @return the Luka type.
  */
-bool TYPE_equal(const t_type *type1, const t_type *type2);
+t_type *TYPE_with_mutable(t_type *type, bool mutable);
+
+/**
+ * @brief Checks if a value of the first type is accepted where the second
+ * type is expected, because the types are equal or the first can be cast to
+ * the second.
+ *
+ * @details Pointers, arrays and vectors can also be cast if their inner types
+ * can.
+ *
+ * @param[in] type1 the type of the value.
+ * @param[in] type2 the expected type.
+ *
+ * @return a boolean that represents if the value can be cast.
+ */
+bool TYPE_can_cast(const t_type *type1, const t_type *type2);
 
 /**
  * @brief Checks if two types are equal based on all of their properties but
  * mutabillity.
  *
+ * @details Types are interned, so this compares their canonical types by
+ * pointer.
+ *
  * @param[in] type1 the first type.
  * @param[in] type2 the second type.
  *
@@ -55,21 +83,22 @@ bool TYPE_equal(const t_type *type1, const t_type *type2);
 bool TYPE_equal(const t_type *type1, const t_type *type2);
 
 /**
- * @brief Duplicate a Luka type.
+ * @brief Get the single shared instance of a Luka type.
+ *
+ * @details Used to make types whose properties are filled in one at a time,
+ * see TYPE_make_type.
  *
- * @param[in] type the Luka type to duplicate.
+ * @param[in] type the Luka type to intern, whose inner type must already be
+ * interned. It is not modified or consumed.
  *
- * @return a Luka type that is identical to @p type but resides in new
- * memory.
+ * @return the interned instance of @p type, or NULL if @p type is NULL.
  */
-t_type *TYPE_dup_type(t_type *type);
+t_type *TYPE_intern(const t_type *type);
 
 /**
- * @brief Free a Luka type.
- *
- * @param[in] type the Luka type to free.
+ * @brief Free all the interned types.
  */
-void TYPE_free_type(t_type *type);
+void TYPE_free_interned_types(void);
 
 /**
  * @brief The size of a Luka type.
@@ -89,6 +118,15 @@ ssize_t TYPE_sizeof(t_type *type);
  */
 bool TYPE_is_signed(t_type *type);
 
+/**
+ * @brief Check if a Luka type is an integer type.
+ *
+ * @param[in] type the type to check.
+ *
+ * @return whether the type is a signed or unsigned integer type.
+ */
+bool TYPE_is_integer_type(t_type *type);
+
 /**
  * @brief Dumps a type into a string representation.
  *
@@ -110,10 +148,30 @@ const char *TYPE_to_string(t_type *type, t_logger *logger, char *buffer,
  * @param[in] logger a logger that can be used to log messages.
  * @param[in] module the module to use for resolving typess.
  *
+ * @details If the type of @p node was memoized by TYPE_annotate_type, the
+ * memoized interned type is returned without being recomputed.
+ *
  * @returns TYPE_ANY type if the type is any or not uniquly handled or the type
  * of the handled node.
  */
 t_type *TYPE_get_type(const t_ast_node *node, t_logger *logger,
                       const t_module *module);
 
+/**
+ * @brief Compute the type of @p node once and memoize it on the node.
+ *
+ * @details Should only be used once the types of the variables in the tree
+ * are final, since later changes to them are not reflected in the memoized
+ * type. Annotating children before their parents makes computing the type of
+ * the parent constant time.
+ *
+ * @param[in,out] node the node of which the type should be memoized.
+ * @param[in] logger a logger that can be used to log messages.
+ * @param[in] module the module to use for resolving types.
+ *
+ * @returns the interned type of @p node, which should not be modified.
+ */
+t_type *TYPE_annotate_type(t_ast_node *node, t_logger *logger,
+                           const t_module *module);
+
 #endif // LUKA_TYPE_H
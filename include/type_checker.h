@@ -18,4 +18,20 @@
 bool CHECK_function(const t_module *module, const t_ast_node *function,
                     t_logger *logger);
 
+/**
+ * @brief Type check the given @p functions, on several threads if there are
+ * many of them.
+ *
+ * @details Messages are logged in source order and stop after the first
+ * function that fails, exactly like checking the functions one by one.
+ *
+ * @param[in] module the currently checked module.
+ * @param[in] functions the functions to check.
+ * @param[in] logger the logger to use to log messages.
+ *
+ * @returns true if all functions are valid or false otherwise.
+ */
+bool CHECK_functions(const t_module *module, const t_vector *functions,
+                     t_logger *logger);
+
 #endif // LUKA_TYPE_CHECKER_H
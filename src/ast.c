@@ -1,6 +1,7 @@
 /** @file ast.c */
 #include "ast.h"
 
+#include <pthread.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -8,13 +9,117 @@
 #include "lib.h"
 #include "logger.h"
 #include "type.h"
+#include "uthash.h"
 #include "vector.h"
 
+#define AST_NODES_PER_BLOCK (4096)
+
+typedef struct s_ast_node_block
+{
+    struct s_ast_node_block *next; /**< The previously filled block */
+    size_t used;                   /**< The amount of nodes handed out */
+    t_ast_node nodes[AST_NODES_PER_BLOCK]; /**< The storage of the nodes */
+} t_ast_node_block; /**< A contiguous block of AST nodes */
+
+typedef struct
+{
+    const char *name;  /**< The name of the variable */
+    t_type *type;      /**< The type of the variable */
+    UT_hash_handle hh; /**< A handle for uthash */
+} t_ast_scope_variable; /**< A variable declared in a scope */
+
+typedef struct s_ast_scope
+{
+    t_ast_scope_variable *variables; /**< The variables declared in the scope */
+    struct s_ast_scope *parent;      /**< The enclosing scope */
+} t_ast_scope;                       /**< A lexical scope */
+
+typedef struct
+{
+    t_module *module;       /**< The module used to look up structs and enums */
+    t_vector *type_aliases; /**< The type aliases in scope */
+    t_logger *logger;       /**< A logger that can be used to log messages */
+    t_ast_scope *scope;     /**< The innermost scope */
+} t_ast_analyzer;           /**< The state of the semantic analysis */
+
 static t_builtin_id ast_builtin_id_from_name(const char *name);
 
+/** The blocks that the current thread hands out nodes from */
+static _Thread_local t_ast_node_block *node_blocks = NULL;
+
+/** The blocks of threads that are done creating nodes */
+static t_ast_node_block *released_node_blocks = NULL;
+static pthread_mutex_t released_node_blocks_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief Allocate a zeroed AST node.
+ *
+ * @details Nodes are handed out sequentially from large contiguous blocks
+ * instead of being allocated one by one, so nodes created one after the other
+ * by the parser (a function body, the operands of an expression) end up next to
+ * each other in memory and the passes that walk them stay cache friendly.
+ *
+ * @return a new AST node.
+ */
+static t_ast_node *ast_alloc_node(void)
+{
+    t_ast_node_block *block = NULL;
+
+    if ((NULL == node_blocks) || (AST_NODES_PER_BLOCK == node_blocks->used))
+    {
+        block = calloc(1, sizeof(t_ast_node_block));
+        if (NULL == block)
+        {
+            (void) fprintf(stderr, "Couldn't allocate memory for AST nodes.\n");
+            exit(LUKA_CANT_ALLOC_MEMORY);
+        }
+
+        block->next = node_blocks;
+        block->used = 0;
+        node_blocks = block;
+    }
+
+    return &node_blocks->nodes[node_blocks->used++];
+}
+
+void AST_release_thread_nodes(void)
+{
+    t_ast_node_block *last = node_blocks;
+
+    if (NULL == last)
+    {
+        return;
+    }
+
+    while (NULL != last->next)
+    {
+        last = last->next;
+    }
+
+    (void) pthread_mutex_lock(&released_node_blocks_lock);
+    last->next = released_node_blocks;
+    released_node_blocks = node_blocks;
+    (void) pthread_mutex_unlock(&released_node_blocks_lock);
+
+    node_blocks = NULL;
+}
+
+void AST_free_nodes(void)
+{
+    t_ast_node_block *block = NULL;
+
+    (void) AST_release_thread_nodes();
+    while (NULL != released_node_blocks)
+    {
+        block = released_node_blocks;
+        released_node_blocks = block->next;
+        (void) free(block);
+    }
+}
+
 t_ast_node *AST_new_number(t_type *type, void *value)
 {
-    t_ast_node *node = calloc(1, sizeof(t_ast_node));
+    t_ast_node *node = ast_alloc_node();
     node->type = AST_TYPE_NUMBER;
     node->token = NULL;
     node->number.type = type;
@@ -59,6 +164,7 @@ t_ast_node *AST_new_number(t_type *type, void *value)
         case TYPE_STRING:
         case TYPE_STRUCT:
         case TYPE_TYPE:
+        case TYPE_VECTOR:
         case TYPE_VOID:
             (void) fprintf(stderr, "%d is not a number type.\n", type->type);
             exit(LUKA_GENERAL_ERROR);
@@ -68,7 +174,7 @@ t_ast_node *AST_new_number(t_type *type, void *value)
 
 t_ast_node *AST_new_string(char *value)
 {
-    t_ast_node *node = calloc(1, sizeof(t_ast_node));
+    t_ast_node *node = ast_alloc_node();
     node->type = AST_TYPE_STRING;
     node->token = NULL;
     node->string.value = value;
@@ -79,7 +185,7 @@ t_ast_node *AST_new_string(char *value)
 t_ast_node *AST_new_unary_expr(t_ast_unop_type operator, t_ast_node * rhs,
                                bool mutable)
 {
-    t_ast_node *node = calloc(1, sizeof(t_ast_node));
+    t_ast_node *node = ast_alloc_node();
     node->type = AST_TYPE_UNARY_EXPR;
     node->token = NULL;
     node->unary_expr.operator= operator;
@@ -91,7 +197,7 @@ t_ast_node *AST_new_unary_expr(t_ast_unop_type operator, t_ast_node * rhs,
 t_ast_node *AST_new_binary_expr(t_ast_binop_type operator, t_ast_node * lhs,
                                 t_ast_node *rhs)
 {
-    t_ast_node *node = calloc(1, sizeof(t_ast_node));
+    t_ast_node *node = ast_alloc_node();
     node->type = AST_TYPE_BINARY_EXPR;
     node->token = NULL;
     node->binary_expr.operator= operator;
@@ -104,7 +210,7 @@ t_ast_node *AST_new_prototype(char *name, char **args, t_type **types,
                               unsigned int arity, t_type *return_type,
                               bool vararg)
 {
-    t_ast_node *node = calloc(1, sizeof(t_ast_node));
+    t_ast_node *node = ast_alloc_node();
     node->type = AST_TYPE_PROTOTYPE;
     node->token = NULL;
     node->prototype.name = name;
@@ -113,23 +219,27 @@ t_ast_node *AST_new_prototype(char *name, char **args, t_type **types,
     node->prototype.return_type = return_type;
     node->prototype.arity = arity;
     node->prototype.vararg = vararg;
+    node->prototype.restricted = NULL;
+    (void) memset(&node->prototype.attributes, 0,
+                  sizeof(t_function_attributes));
 
     return node;
 }
 
 t_ast_node *AST_new_function(t_ast_node *prototype, t_vector *body)
 {
-    t_ast_node *node = calloc(1, sizeof(t_ast_node));
+    t_ast_node *node = ast_alloc_node();
     node->type = AST_TYPE_FUNCTION;
     node->token = NULL;
     node->function.prototype = prototype;
     node->function.body = body;
+    node->function.exported = false;
     return node;
 }
 
 t_ast_node *AST_new_return_stmt(t_ast_node *expr)
 {
-    t_ast_node *node = calloc(1, sizeof(t_ast_node));
+    t_ast_node *node = ast_alloc_node();
     node->type = AST_TYPE_RETURN_STMT;
     node->token = NULL;
     node->return_stmt.expr = expr;
@@ -139,7 +249,7 @@ t_ast_node *AST_new_return_stmt(t_ast_node *expr)
 t_ast_node *AST_new_if_expr(t_ast_node *cond, t_vector *then_body,
                             t_vector *else_body)
 {
-    t_ast_node *node = calloc(1, sizeof(t_ast_node));
+    t_ast_node *node = ast_alloc_node();
     node->type = AST_TYPE_IF_EXPR;
     node->token = NULL;
     node->if_expr.cond = cond;
@@ -148,19 +258,51 @@ t_ast_node *AST_new_if_expr(t_ast_node *cond, t_vector *then_body,
     return node;
 }
 
-t_ast_node *AST_new_while_expr(t_ast_node *cond, t_vector *body)
+t_ast_node *AST_new_match_expr(t_ast_node *value, t_vector *arms,
+                               t_vector *else_body)
+{
+    t_ast_node *node = ast_alloc_node();
+    node->type = AST_TYPE_MATCH_EXPR;
+    node->token = NULL;
+    node->match_expr.value = value;
+    node->match_expr.arms = arms;
+    node->match_expr.else_body = else_body;
+    return node;
+}
+
+t_ast_node *AST_new_while_expr(t_ast_node *cond, t_vector *body, char *label,
+                               t_loop_hints hints)
 {
-    t_ast_node *node = calloc(1, sizeof(t_ast_node));
+    t_ast_node *node = ast_alloc_node();
     node->type = AST_TYPE_WHILE_EXPR;
     node->token = NULL;
     node->while_expr.cond = cond;
     node->while_expr.body = body;
+    node->while_expr.label = label;
+    node->while_expr.hints = hints;
+    return node;
+}
+
+t_ast_node *AST_new_for_expr(t_ast_node *var, t_ast_node *start,
+                             t_ast_node *end, t_ast_node *step, t_vector *body,
+                             char *label, t_loop_hints hints)
+{
+    t_ast_node *node = ast_alloc_node();
+    node->type = AST_TYPE_FOR_EXPR;
+    node->token = NULL;
+    node->for_expr.var = var;
+    node->for_expr.start = start;
+    node->for_expr.end = end;
+    node->for_expr.step = step;
+    node->for_expr.body = body;
+    node->for_expr.label = label;
+    node->for_expr.hints = hints;
     return node;
 }
 
 t_ast_node *AST_new_cast_expr(t_ast_node *expr, t_type *type)
 {
-    t_ast_node *node = calloc(1, sizeof(t_ast_node));
+    t_ast_node *node = ast_alloc_node();
     node->type = AST_TYPE_CAST_EXPR;
     node->token = NULL;
     node->cast_expr.expr = expr;
@@ -170,7 +312,7 @@ t_ast_node *AST_new_cast_expr(t_ast_node *expr, t_type *type)
 
 t_ast_node *AST_new_variable(char *name, t_type *type, bool mutable)
 {
-    t_ast_node *node = calloc(1, sizeof(t_ast_node));
+    t_ast_node *node = ast_alloc_node();
     node->type = AST_TYPE_VARIABLE;
     node->token = NULL;
     node->variable.name = name;
@@ -181,7 +323,7 @@ t_ast_node *AST_new_variable(char *name, t_type *type, bool mutable)
 
 t_ast_node *AST_new_let_stmt(t_ast_node *var, t_ast_node *expr, bool is_global)
 {
-    t_ast_node *node = calloc(1, sizeof(t_ast_node));
+    t_ast_node *node = ast_alloc_node();
     node->type = AST_TYPE_LET_STMT;
     node->token = NULL;
     node->let_stmt.var = var;
@@ -192,7 +334,7 @@ t_ast_node *AST_new_let_stmt(t_ast_node *var, t_ast_node *expr, bool is_global)
 
 t_ast_node *AST_new_assignment_expr(t_ast_node *lhs, t_ast_node *rhs)
 {
-    t_ast_node *node = calloc(1, sizeof(t_ast_node));
+    t_ast_node *node = ast_alloc_node();
     node->type = AST_TYPE_ASSIGNMENT_EXPR;
     node->token = NULL;
     node->assignment_expr.lhs = lhs;
@@ -202,7 +344,7 @@ t_ast_node *AST_new_assignment_expr(t_ast_node *lhs, t_ast_node *rhs)
 
 t_ast_node *AST_new_call_expr(t_ast_node *callable, t_vector *args)
 {
-    t_ast_node *node = calloc(1, sizeof(t_ast_node));
+    t_ast_node *node = ast_alloc_node();
     node->type = AST_TYPE_CALL_EXPR;
     node->token = NULL;
     node->call_expr.callable = callable;
@@ -212,25 +354,35 @@ t_ast_node *AST_new_call_expr(t_ast_node *callable, t_vector *args)
 
 t_ast_node *AST_new_expression_stmt(t_ast_node *expr)
 {
-    t_ast_node *node = calloc(1, sizeof(t_ast_node));
+    t_ast_node *node = ast_alloc_node();
     node->type = AST_TYPE_EXPRESSION_STMT;
     node->token = NULL;
     node->expression_stmt.expr = expr;
     return node;
 }
 
-t_ast_node *AST_new_break_stmt()
+t_ast_node *AST_new_break_stmt(char *label)
 {
-    t_ast_node *node = calloc(1, sizeof(t_ast_node));
+    t_ast_node *node = ast_alloc_node();
     node->type = AST_TYPE_BREAK_STMT;
     node->token = NULL;
+    node->break_stmt.label = label;
+    return node;
+}
+
+t_ast_node *AST_new_continue_stmt(char *label)
+{
+    t_ast_node *node = ast_alloc_node();
+    node->type = AST_TYPE_CONTINUE_STMT;
+    node->token = NULL;
+    node->continue_stmt.label = label;
     return node;
 }
 
 t_ast_node *AST_new_struct_definition(char *name, t_vector *struct_fields,
                                       t_vector *functions)
 {
-    t_ast_node *node = calloc(1, sizeof(t_ast_node));
+    t_ast_node *node = ast_alloc_node();
     node->type = AST_TYPE_STRUCT_DEFINITION;
     node->token = NULL;
     node->struct_definition.name = name;
@@ -241,7 +393,7 @@ t_ast_node *AST_new_struct_definition(char *name, t_vector *struct_fields,
 
 t_ast_node *AST_new_struct_value(char *name, t_vector *struct_values)
 {
-    t_ast_node *node = calloc(1, sizeof(t_ast_node));
+    t_ast_node *node = ast_alloc_node();
     node->type = AST_TYPE_STRUCT_VALUE;
     node->token = NULL;
     node->struct_value.name = name;
@@ -251,7 +403,7 @@ t_ast_node *AST_new_struct_value(char *name, t_vector *struct_values)
 
 t_ast_node *AST_new_enum_definition(char *name, t_vector *enum_fields)
 {
-    t_ast_node *node = calloc(1, sizeof(t_ast_node));
+    t_ast_node *node = ast_alloc_node();
     node->type = AST_TYPE_ENUM_DEFINITION;
     node->token = NULL;
     node->enum_definition.name = name;
@@ -261,7 +413,7 @@ t_ast_node *AST_new_enum_definition(char *name, t_vector *enum_fields)
 
 t_ast_node *AST_new_get_expr(t_ast_node *variable, char *key, bool is_enum)
 {
-    t_ast_node *node = calloc(1, sizeof(t_ast_node));
+    t_ast_node *node = ast_alloc_node();
     node->type = AST_TYPE_GET_EXPR;
     node->token = NULL;
     node->get_expr.variable = variable;
@@ -272,7 +424,7 @@ t_ast_node *AST_new_get_expr(t_ast_node *variable, char *key, bool is_enum)
 
 t_ast_node *AST_new_array_deref(t_ast_node *variable, t_ast_node *index)
 {
-    t_ast_node *node = calloc(1, sizeof(t_ast_node));
+    t_ast_node *node = ast_alloc_node();
     node->type = AST_TYPE_ARRAY_DEREF;
     node->token = NULL;
     node->array_deref.variable = variable;
@@ -282,7 +434,7 @@ t_ast_node *AST_new_array_deref(t_ast_node *variable, t_ast_node *index)
 
 t_ast_node *AST_new_literal(t_ast_literal_type type)
 {
-    t_ast_node *node = calloc(1, sizeof(t_ast_node));
+    t_ast_node *node = ast_alloc_node();
     node->type = AST_TYPE_LITERAL;
     node->token = NULL;
     node->literal.type = type;
@@ -291,7 +443,7 @@ t_ast_node *AST_new_literal(t_ast_literal_type type)
 
 t_ast_node *AST_new_array_literal(t_vector *exprs, t_type *type)
 {
-    t_ast_node *node = calloc(1, sizeof(t_ast_node));
+    t_ast_node *node = ast_alloc_node();
     node->type = AST_TYPE_ARRAY_LITERAL;
     node->token = NULL;
     node->array_literal.exprs = exprs;
@@ -301,7 +453,7 @@ t_ast_node *AST_new_array_literal(t_vector *exprs, t_type *type)
 
 t_ast_node *AST_new_builtin(char *name)
 {
-    t_ast_node *node = calloc(1, sizeof(t_ast_node));
+    t_ast_node *node = ast_alloc_node();
     node->type = AST_TYPE_BUILTIN;
     node->token = NULL;
     node->builtin.name = name;
@@ -311,7 +463,7 @@ t_ast_node *AST_new_builtin(char *name)
 
 t_ast_node *AST_new_type_expr(t_type *type)
 {
-    t_ast_node *node = calloc(1, sizeof(t_ast_node));
+    t_ast_node *node = ast_alloc_node();
     node->type = AST_TYPE_TYPE_EXPR;
     node->token = NULL;
     node->type_expr.type = type;
@@ -320,16 +472,46 @@ t_ast_node *AST_new_type_expr(t_type *type)
 
 t_ast_node *AST_new_defer_stmt(t_vector *body)
 {
-    t_ast_node *node = calloc(1, sizeof(t_ast_node));
+    t_ast_node *node = ast_alloc_node();
     node->type = AST_TYPE_DEFER_STMT;
     node->token = NULL;
     node->defer_stmt.body = body;
     return node;
 }
 
+/**
+ * @brief Unwrap the last statement of a body of statements if it is a compound
+ * expression, so that its value becomes the value of the body.
+ *
+ * @param[in,out] body the statements of the body, may be NULL.
+ */
+static void ast_fix_body_last_expression_stmt(t_vector *body)
+{
+    t_ast_node *last_stmt = NULL;
+
+    if ((NULL == body) || (0 == body->size))
+    {
+        return;
+    }
+
+    last_stmt = VECTOR_GET_AS(t_ast_node_ptr, body, body->size - 1);
+    if ((AST_TYPE_EXPRESSION_STMT == last_stmt->type)
+        && ((AST_TYPE_IF_EXPR == last_stmt->expression_stmt.expr->type)
+            || (AST_TYPE_MATCH_EXPR == last_stmt->expression_stmt.expr->type)
+            || (AST_TYPE_WHILE_EXPR
+                == last_stmt->expression_stmt.expr->type)))
+    {
+        last_stmt->expression_stmt.expr
+            = AST_fix_function_last_expression_stmt(
+                last_stmt->expression_stmt.expr);
+        vector_assign(body, body->size - 1, &last_stmt->expression_stmt.expr);
+    }
+}
+
 t_ast_node *AST_fix_function_last_expression_stmt(t_ast_node *node)
 {
     t_ast_node *last_stmt = NULL;
+    t_ast_match_arm *arm = NULL;
     if (AST_TYPE_FUNCTION == node->type)
     {
         if (NULL != node->function.body)
@@ -343,6 +525,8 @@ t_ast_node *AST_fix_function_last_expression_stmt(t_ast_node *node)
             if (AST_TYPE_EXPRESSION_STMT == last_stmt->type)
             {
                 if ((AST_TYPE_IF_EXPR == last_stmt->expression_stmt.expr->type)
+                    || (AST_TYPE_MATCH_EXPR
+                        == last_stmt->expression_stmt.expr->type)
                     || (AST_TYPE_WHILE_EXPR
                         == last_stmt->expression_stmt.expr->type))
                 {
@@ -369,6 +553,8 @@ t_ast_node *AST_fix_function_last_expression_stmt(t_ast_node *node)
             if (AST_TYPE_EXPRESSION_STMT == last_stmt->type)
             {
                 if ((AST_TYPE_IF_EXPR == last_stmt->expression_stmt.expr->type)
+                    || (AST_TYPE_MATCH_EXPR
+                        == last_stmt->expression_stmt.expr->type)
                     || (AST_TYPE_WHILE_EXPR
                         == last_stmt->expression_stmt.expr->type))
                 {
@@ -393,6 +579,8 @@ t_ast_node *AST_fix_function_last_expression_stmt(t_ast_node *node)
             if (AST_TYPE_EXPRESSION_STMT == last_stmt->type)
             {
                 if ((AST_TYPE_IF_EXPR == last_stmt->expression_stmt.expr->type)
+                    || (AST_TYPE_MATCH_EXPR
+                        == last_stmt->expression_stmt.expr->type)
                     || (AST_TYPE_WHILE_EXPR
                         == last_stmt->expression_stmt.expr->type))
                 {
@@ -406,6 +594,15 @@ t_ast_node *AST_fix_function_last_expression_stmt(t_ast_node *node)
             }
         }
     }
+    else if (AST_TYPE_MATCH_EXPR == node->type)
+    {
+        VECTOR_FOR_EACH(node->match_expr.arms, arms)
+        {
+            arm = ITERATOR_GET_AS(t_ast_match_arm_ptr, &arms);
+            (void) ast_fix_body_last_expression_stmt(arm->body);
+        }
+        (void) ast_fix_body_last_expression_stmt(node->match_expr.else_body);
+    }
     else if (AST_TYPE_WHILE_EXPR == node->type)
     {
         if (NULL != node->while_expr.body)
@@ -441,15 +638,19 @@ static t_type *ast_resolve_type(t_type *aliased_type, t_vector *type_aliases,
                                 t_logger *logger)
 {
     t_type_alias *type_alias = NULL;
-    if (NULL != aliased_type->inner_type)
-    {
-        aliased_type->inner_type
-            = ast_resolve_type(aliased_type->inner_type, type_aliases, logger);
-    }
+    t_type resolved_type = {0};
 
     if (TYPE_ALIAS != aliased_type->type)
     {
-        return aliased_type;
+        if (NULL == aliased_type->inner_type)
+        {
+            return aliased_type;
+        }
+
+        resolved_type = *aliased_type;
+        resolved_type.inner_type
+            = ast_resolve_type(aliased_type->inner_type, type_aliases, logger);
+        return TYPE_intern(&resolved_type);
     }
 
     VECTOR_FOR_EACH(type_aliases, it_type_aliases)
@@ -457,8 +658,7 @@ static t_type *ast_resolve_type(t_type *aliased_type, t_vector *type_aliases,
         type_alias = *(t_type_alias **) iterator_get(&it_type_aliases);
         if (0 == strcmp((char *) aliased_type->payload, type_alias->name))
         {
-            return TYPE_dup_type(
-                ast_resolve_type(type_alias->type, type_aliases, logger));
+            return ast_resolve_type(type_alias->type, type_aliases, logger);
         }
     }
 
@@ -469,762 +669,530 @@ static t_type *ast_resolve_type(t_type *aliased_type, t_vector *type_aliases,
 
 static t_type *ast_fix_type(t_type *type, t_module *module)
 {
+    t_type fixed_type = {0};
+
     if (NULL == type)
     {
         return type;
     }
 
-    type->inner_type = ast_fix_type(type->inner_type, module);
+    fixed_type = *type;
+    fixed_type.inner_type = ast_fix_type(type->inner_type, module);
 
-    if (NULL == type->payload)
+    if ((NULL != type->payload) && (TYPE_ALIAS == type->type))
     {
-        return type;
+        if (LIB_is_struct_name(module, type->payload, NULL))
+        {
+            fixed_type.type = TYPE_STRUCT;
+        }
+        else if (LIB_is_enum_name(module, type->payload, NULL))
+        {
+            fixed_type.type = TYPE_ENUM;
+        }
+    }
+
+    return TYPE_intern(&fixed_type);
+}
+
+static void ast_fill_let_stmt_var_if_needed(t_ast_node *node, t_logger *logger,
+                                            const t_module *module)
+{
+    t_type *old_type = NULL;
+
+    if (NULL == node->let_stmt.var->variable.type)
+    {
+        node->let_stmt.var->variable.type
+            = TYPE_get_type(node->let_stmt.expr, logger, module);
+    }
+
+    if (TYPE_ANY == node->let_stmt.var->variable.type->type)
+    {
+        old_type = node->let_stmt.var->variable.type;
+        node->let_stmt.var->variable.type
+            = TYPE_get_type(node->let_stmt.expr, logger, module);
+        if (old_type->mutable)
+        {
+            node->let_stmt.var->variable.type = TYPE_with_mutable(
+                node->let_stmt.var->variable.type, true);
+        }
+    }
+}
+
+/**
+ * @brief Infer the type of the induction variable of a for expression when it
+ * isn't written in the source.
+ *
+ * @details The variable takes the type of the start of the range, unless the
+ * start is a number literal, in which case the end of the range decides, so
+ * `0..length` counts in the type of `length`.
+ *
+ * @param[in,out] node the for expression AST node.
+ * @param[in] logger a logger that can be used to log messages.
+ * @param[in] module the module of the for expression.
+ */
+static void ast_fill_for_expr_var_if_needed(t_ast_node *node, t_logger *logger,
+                                            const t_module *module)
+{
+    t_ast_node *bound = node->for_expr.start;
+
+    if (TYPE_ANY != node->for_expr.var->variable.type->type)
+    {
+        return;
     }
 
-    if (TYPE_ALIAS != type->type)
+    if (AST_TYPE_NUMBER == bound->type)
+    {
+        bound = node->for_expr.end;
+    }
+
+    /* The induction variable is never mutable, even if the bound is */
+    node->for_expr.var->variable.type
+        = TYPE_with_mutable(TYPE_get_type(bound, logger, module), false);
+}
+
+/**
+ * @brief Fix and resolve a type written in the source.
+ *
+ * @param[in] type the type to analyze, may be NULL.
+ * @param[in] analyzer the state of the analysis.
+ *
+ * @return the fixed type, without any type aliases.
+ */
+static t_type *ast_analyze_type(t_type *type, const t_ast_analyzer *analyzer)
+{
+    if (NULL == type)
     {
         return type;
     }
 
-    if (LIB_is_struct_name(module, type->payload, NULL))
+    type = ast_fix_type(type, analyzer->module);
+    return ast_resolve_type(type, analyzer->type_aliases, analyzer->logger);
+}
+
+/**
+ * @brief Open a new innermost scope.
+ *
+ * @param[in,out] analyzer the state of the analysis.
+ */
+static void ast_scope_push(t_ast_analyzer *analyzer)
+{
+    t_ast_scope *scope = NULL;
+
+    scope = calloc(1, sizeof(t_ast_scope));
+    if (NULL == scope)
     {
-        type->type = TYPE_STRUCT;
+        (void) LOGGER_log(analyzer->logger, L_ERROR,
+                          "Couldn't allocate memory for scope.\n");
+        exit(LUKA_CANT_ALLOC_MEMORY);
     }
-    else if (LIB_is_enum_name(module, type->payload, NULL))
+
+    scope->parent = analyzer->scope;
+    analyzer->scope = scope;
+}
+
+/**
+ * @brief Close the innermost scope and forget the variables declared in it.
+ *
+ * @param[in,out] analyzer the state of the analysis.
+ */
+static void ast_scope_pop(t_ast_analyzer *analyzer)
+{
+    t_ast_scope *scope = analyzer->scope;
+    t_ast_scope_variable *variable = NULL, *tmp = NULL;
+
+    HASH_ITER(hh, scope->variables, variable, tmp)
     {
-        type->type = TYPE_ENUM;
+        HASH_DEL(scope->variables, variable);
+        (void) free(variable);
     }
 
-    return type;
+    analyzer->scope = scope->parent;
+    (void) free(scope);
 }
 
-t_ast_node *AST_fix_types(t_ast_node *node, t_module *module, t_logger *logger)
+/**
+ * @brief Declare a variable in the innermost scope, shadowing any variable
+ * with the same name.
+ *
+ * @param[in,out] analyzer the state of the analysis.
+ * @param[in] name the name of the variable.
+ * @param[in] type the type of the variable, owned by its declaration.
+ */
+static void ast_scope_declare(t_ast_analyzer *analyzer, const char *name,
+                              t_type *type)
 {
-    size_t i = 0;
+    t_ast_scope_variable *variable = NULL;
 
-    switch (node->type)
+    HASH_FIND_STR(analyzer->scope->variables, name, variable);
+    if (NULL == variable)
     {
-        case AST_TYPE_LET_STMT:
-            {
-                if (NULL != node->let_stmt.var)
-                {
-                    node->let_stmt.var
-                        = AST_fix_types(node->let_stmt.var, module, logger);
-                }
-                break;
-            }
-        case AST_TYPE_EXPRESSION_STMT:
-            {
-                if (NULL != node->expression_stmt.expr)
-                {
-                    node->expression_stmt.expr = AST_fix_types(
-                        node->expression_stmt.expr, module, logger);
-                }
-                break;
-            }
-        case AST_TYPE_ASSIGNMENT_EXPR:
-            {
-                if (NULL != node->assignment_expr.lhs)
-                {
-                    node->assignment_expr.lhs = AST_fix_types(
-                        node->assignment_expr.lhs, module, logger);
-                }
+        variable = calloc(1, sizeof(t_ast_scope_variable));
+        if (NULL == variable)
+        {
+            (void) LOGGER_log(analyzer->logger, L_ERROR,
+                              "Couldn't allocate memory for variable.\n");
+            exit(LUKA_CANT_ALLOC_MEMORY);
+        }
 
-                if (NULL != node->assignment_expr.rhs)
-                {
-                    node->assignment_expr.rhs = AST_fix_types(
-                        node->assignment_expr.rhs, module, logger);
-                }
-                break;
-            }
-        case AST_TYPE_GET_EXPR:
-            {
-                if (NULL != node->get_expr.variable)
-                {
-                    node->get_expr.variable = AST_fix_types(
-                        node->get_expr.variable, module, logger);
-                }
-                break;
-            }
-        case AST_TYPE_CALL_EXPR:
-            {
-                if (NULL != node->call_expr.callable)
-                {
-                    node->call_expr.callable = AST_fix_types(
-                        node->call_expr.callable, module, logger);
-                }
+        variable->name = name;
+        HASH_ADD_KEYPTR(hh, analyzer->scope->variables, variable->name,
+                        strlen(variable->name), variable);
+    }
 
-                if (NULL != node->call_expr.args)
-                {
-                    t_vector *args = NULL;
-                    t_ast_node *arg = NULL;
+    variable->type = type;
+}
 
-                    args = node->call_expr.args;
-                    for (i = 0; i < args->size; ++i)
-                    {
-                        arg = *(t_ast_node **) vector_get(args, i);
-                        arg = AST_fix_types(arg, module, logger);
-                        if (vector_assign(args, i, &arg))
-                        {
-                            (void) LOGGER_log(logger, L_ERROR,
-                                              "Failed while assigning arg "
-                                              "to the vector");
-                            exit(LUKA_VECTOR_FAILURE);
-                        }
-                    }
-                }
-                break;
-            }
-        case AST_TYPE_CAST_EXPR:
-            {
-                node->cast_expr.type
-                    = ast_fix_type(node->cast_expr.type, module);
-                break;
-            }
-        case AST_TYPE_VARIABLE:
-            {
-                node->variable.type = ast_fix_type(node->variable.type, module);
-                break;
-            }
-        case AST_TYPE_PROTOTYPE:
-            {
-                for (i = 0; i < node->prototype.arity; ++i)
-                {
-                    node->prototype.types[i]
-                        = ast_fix_type(node->prototype.types[i], module);
-                }
+/**
+ * @brief Look up the type of the innermost variable named @p name.
+ *
+ * @param[in] analyzer the state of the analysis.
+ * @param[in] name the name of the variable.
+ *
+ * @return the type of the variable or NULL if it is not declared in any scope.
+ */
+static t_type *ast_scope_lookup(const t_ast_analyzer *analyzer,
+                                const char *name)
+{
+    t_ast_scope *scope = NULL;
+    t_ast_scope_variable *variable = NULL;
 
-                node->prototype.return_type
-                    = ast_fix_type(node->prototype.return_type, module);
-                break;
-            }
-        case AST_TYPE_FUNCTION:
-            {
-                node->function.prototype
-                    = AST_fix_types(node->function.prototype, module, logger);
-                if (NULL != node->function.body)
-                {
-                    t_vector *ast_nodes = NULL;
-                    t_ast_node *ast_node = NULL;
+    for (scope = analyzer->scope; NULL != scope; scope = scope->parent)
+    {
+        HASH_FIND_STR(scope->variables, name, variable);
+        if (NULL != variable)
+        {
+            return variable->type;
+        }
+    }
 
-                    ast_nodes = node->function.body;
-                    for (i = 0; i < ast_nodes->size; ++i)
-                    {
-                        ast_node = *(t_ast_node **) vector_get(ast_nodes, i);
-                        ast_node = AST_fix_types(ast_node, module, logger);
-                        if (vector_assign(ast_nodes, i, &ast_node))
-                        {
-                            (void) LOGGER_log(logger, L_ERROR,
-                                              "Failed while assigning ast node "
-                                              "to the vector");
-                            exit(LUKA_VECTOR_FAILURE);
-                        }
-                    }
-                    break;
-                }
-                break;
-            }
-        case AST_TYPE_STRUCT_DEFINITION:
-            {
-                t_vector *struct_fields = NULL;
-                t_struct_field *struct_field = NULL;
+    return NULL;
+}
 
-                struct_fields = node->struct_definition.struct_fields;
-                for (i = 0; i < struct_fields->size; ++i)
-                {
-                    struct_field
-                        = *(t_struct_field **) vector_get(struct_fields, i);
-                    struct_field->type
-                        = ast_fix_type(struct_field->type, module);
-                    if (vector_assign(struct_fields, i, &struct_field))
-                    {
-                        (void) LOGGER_log(logger, L_ERROR,
-                                          "Failed while assigning struct field "
-                                          "to the vector");
-                        exit(LUKA_VECTOR_FAILURE);
-                    }
-                }
-                break;
-            }
-        case AST_TYPE_BREAK_STMT:
-        case AST_TYPE_WHILE_EXPR:
-        case AST_TYPE_IF_EXPR:
-        case AST_TYPE_BINARY_EXPR:
-        case AST_TYPE_DEFER_STMT:
-        case AST_TYPE_NUMBER:
-        case AST_TYPE_STRING:
-        case AST_TYPE_STRUCT_VALUE:
-        case AST_TYPE_UNARY_EXPR:
-        case AST_TYPE_ARRAY_DEREF:
-        case AST_TYPE_ARRAY_LITERAL:
-        case AST_TYPE_BUILTIN:
-        case AST_TYPE_ENUM_DEFINITION:
-        case AST_TYPE_LITERAL:
-        case AST_TYPE_RETURN_STMT:
-        case AST_TYPE_TYPE_EXPR:
-            {
-                (void) LOGGER_log(
-                    logger, L_WARNING,
-                    "Fixing types is currently not implement for AST type %d\n",
-                    node->type);
-            }
-            break;
+static void ast_analyze_node(t_ast_node *node, t_ast_analyzer *analyzer);
+
+/**
+ * @brief Analyze a block of statements inside a new scope.
+ *
+ * @param[in,out] body the statements of the block, may be NULL.
+ * @param[in,out] analyzer the state of the analysis.
+ */
+static void ast_analyze_body(t_vector *body, t_ast_analyzer *analyzer)
+{
+    t_ast_node *stmt = NULL;
+
+    if (NULL == body)
+    {
+        return;
     }
-    return node;
+
+    (void) ast_scope_push(analyzer);
+    VECTOR_FOR_EACH(body, stmts)
+    {
+        stmt = ITERATOR_GET_AS(t_ast_node_ptr, &stmts);
+        (void) ast_analyze_node(stmt, analyzer);
+    }
+    (void) ast_scope_pop(analyzer);
 }
 
-t_ast_node *AST_resolve_type_aliases(t_ast_node *node, t_vector *type_aliases,
-                                     t_logger *logger)
+/**
+ * @brief Fix the types written inside @p node and infer the types of the
+ * variables it references, visiting every node once.
+ *
+ * @param[in,out] node the node to analyze, may be NULL.
+ * @param[in,out] analyzer the state of the analysis.
+ */
+static void ast_analyze_node(t_ast_node *node, t_ast_analyzer *analyzer)
 {
+    t_ast_node *child = NULL;
+    t_ast_match_arm *arm = NULL;
+    t_struct_value_field *struct_value = NULL;
+    t_struct_field *struct_field = NULL;
+    t_type *type = NULL;
     size_t i = 0;
+
+    if (NULL == node)
+    {
+        return;
+    }
+
     switch (node->type)
     {
-        case AST_TYPE_PROTOTYPE:
-            {
-                for (i = 0; i < node->prototype.arity; ++i)
-                {
-                    node->prototype.types[i] = ast_resolve_type(
-                        node->prototype.types[i], type_aliases, logger);
-                }
-                node->prototype.return_type = ast_resolve_type(
-                    node->prototype.return_type, type_aliases, logger);
-                break;
-            }
-        case AST_TYPE_CAST_EXPR:
-            {
-                node->cast_expr.type = ast_resolve_type(node->cast_expr.type,
-                                                        type_aliases, logger);
-                break;
-            }
+        case AST_TYPE_BREAK_STMT:
+        case AST_TYPE_BUILTIN:
+        case AST_TYPE_CONTINUE_STMT:
+        case AST_TYPE_ENUM_DEFINITION:
+        case AST_TYPE_LITERAL:
+        case AST_TYPE_NUMBER:
+        case AST_TYPE_STRING:
+        case AST_TYPE_TYPE_EXPR:
+            break;
         case AST_TYPE_VARIABLE:
             {
-                if (NULL != node->variable.type)
+                type = (NULL == node->variable.name)
+                         ? NULL
+                         : ast_scope_lookup(analyzer, node->variable.name);
+                if (NULL == type)
                 {
-                    node->variable.type = ast_resolve_type(
-                        node->variable.type, type_aliases, logger);
-                }
-                break;
-            }
-        case AST_TYPE_FUNCTION:
-            {
-                node->function.prototype = AST_resolve_type_aliases(
-                    node->function.prototype, type_aliases, logger);
-                if (NULL != node->function.body)
-                {
-                    t_vector *ast_nodes = NULL;
-                    t_ast_node *ast_node = NULL;
-
-                    ast_nodes = node->function.body;
-                    for (i = 0; i < ast_nodes->size; ++i)
-                    {
-                        ast_node = *(t_ast_node **) vector_get(ast_nodes, i);
-                        ast_node = AST_resolve_type_aliases(
-                            ast_node, type_aliases, logger);
-                        if (vector_assign(ast_nodes, i, &ast_node))
-                        {
-                            (void) LOGGER_log(logger, L_ERROR,
-                                              "Failed while assigning ast node "
-                                              "to the vector");
-                            exit(LUKA_VECTOR_FAILURE);
-                        }
-                    }
+                    node->variable.type
+                        = ast_analyze_type(node->variable.type, analyzer);
                     break;
                 }
+
+                node->variable.type = type;
                 break;
             }
         case AST_TYPE_LET_STMT:
             {
-                if (NULL != node->let_stmt.var)
+                (void) ast_analyze_node(node->let_stmt.expr, analyzer);
+                if (NULL != node->let_stmt.expr)
                 {
-                    node->let_stmt.var = AST_resolve_type_aliases(
-                        node->let_stmt.var, type_aliases, logger);
+                    (void) ast_fill_let_stmt_var_if_needed(
+                        node, analyzer->logger, analyzer->module);
                 }
+
+                node->let_stmt.var->variable.type = ast_analyze_type(
+                    node->let_stmt.var->variable.type, analyzer);
+                (void) ast_scope_declare(analyzer,
+                                         node->let_stmt.var->variable.name,
+                                         node->let_stmt.var->variable.type);
                 break;
             }
         case AST_TYPE_EXPRESSION_STMT:
             {
-                if (NULL != node->expression_stmt.expr)
-                {
-                    node->expression_stmt.expr = AST_resolve_type_aliases(
-                        node->expression_stmt.expr, type_aliases, logger);
-                }
+                (void) ast_analyze_node(node->expression_stmt.expr, analyzer);
                 break;
             }
-        case AST_TYPE_ASSIGNMENT_EXPR:
+        case AST_TYPE_RETURN_STMT:
             {
-                if (NULL != node->assignment_expr.lhs)
-                {
-                    node->assignment_expr.lhs = AST_resolve_type_aliases(
-                        node->assignment_expr.lhs, type_aliases, logger);
-                }
-
-                if (NULL != node->assignment_expr.rhs)
-                {
-                    node->assignment_expr.rhs = AST_resolve_type_aliases(
-                        node->assignment_expr.rhs, type_aliases, logger);
-                }
+                (void) ast_analyze_node(node->return_stmt.expr, analyzer);
                 break;
             }
-        case AST_TYPE_GET_EXPR:
+        case AST_TYPE_DEFER_STMT:
             {
-                if (NULL != node->get_expr.variable)
-                {
-                    node->get_expr.variable = AST_resolve_type_aliases(
-                        node->get_expr.variable, type_aliases, logger);
-                }
+                (void) ast_analyze_body(node->defer_stmt.body, analyzer);
                 break;
             }
-        case AST_TYPE_CALL_EXPR:
+        case AST_TYPE_ASSIGNMENT_EXPR:
             {
-                if (NULL != node->call_expr.callable)
-                {
-                    node->call_expr.callable = AST_resolve_type_aliases(
-                        node->call_expr.callable, type_aliases, logger);
-                }
-
-                if (NULL != node->call_expr.args)
-                {
-                    t_vector *args = NULL;
-                    t_ast_node *arg = NULL;
-
-                    args = node->call_expr.args;
-                    for (i = 0; i < args->size; ++i)
-                    {
-                        arg = *(t_ast_node **) vector_get(args, i);
-                        arg = AST_resolve_type_aliases(arg, type_aliases,
-                                                       logger);
-                        if (vector_assign(args, i, &arg))
-                        {
-                            (void) LOGGER_log(logger, L_ERROR,
-                                              "Failed while assigning arg "
-                                              "to the vector");
-                            exit(LUKA_VECTOR_FAILURE);
-                        }
-                    }
-                }
+                (void) ast_analyze_node(node->assignment_expr.lhs, analyzer);
+                (void) ast_analyze_node(node->assignment_expr.rhs, analyzer);
                 break;
             }
-        case AST_TYPE_STRUCT_DEFINITION:
+        case AST_TYPE_UNARY_EXPR:
             {
-                t_vector *struct_fields = NULL;
-                t_struct_field *struct_field = NULL;
-
-                struct_fields = node->struct_definition.struct_fields;
-                for (i = 0; i < struct_fields->size; ++i)
-                {
-                    struct_field
-                        = *(t_struct_field **) vector_get(struct_fields, i);
-                    struct_field->type = ast_resolve_type(struct_field->type,
-                                                          type_aliases, logger);
-                    if (vector_assign(struct_fields, i, &struct_field))
-                    {
-                        (void) LOGGER_log(logger, L_ERROR,
-                                          "Failed while assigning struct field "
-                                          "to the vector");
-                        exit(LUKA_VECTOR_FAILURE);
-                    }
-                }
+                (void) ast_analyze_node(node->unary_expr.rhs, analyzer);
                 break;
             }
-        case AST_TYPE_ARRAY_DEREF:
-        case AST_TYPE_ARRAY_LITERAL:
         case AST_TYPE_BINARY_EXPR:
-        case AST_TYPE_BREAK_STMT:
-        case AST_TYPE_BUILTIN:
-        case AST_TYPE_DEFER_STMT:
-        case AST_TYPE_ENUM_DEFINITION:
-        case AST_TYPE_IF_EXPR:
-        case AST_TYPE_LITERAL:
-        case AST_TYPE_NUMBER:
-        case AST_TYPE_RETURN_STMT:
-        case AST_TYPE_STRING:
-        case AST_TYPE_STRUCT_VALUE:
-        case AST_TYPE_TYPE_EXPR:
-        case AST_TYPE_UNARY_EXPR:
-        case AST_TYPE_WHILE_EXPR:
             {
-                (void) LOGGER_log(logger, L_WARNING,
-                                  "Resolving type aliases is not currently "
-                                  "implented for AST type %d",
-                                  node->type);
+                (void) ast_analyze_node(node->binary_expr.lhs, analyzer);
+                (void) ast_analyze_node(node->binary_expr.rhs, analyzer);
                 break;
             }
-    }
-    return node;
-}
-
-static void ast_fill_let_stmt_var_if_needed(t_ast_node *node, t_logger *logger,
-                                            const t_module *module)
-{
-    t_type *old_type = NULL;
-
-    if (NULL == node->let_stmt.var->variable.type)
-    {
-        node->let_stmt.var->variable.type
-            = TYPE_get_type(node->let_stmt.expr, logger, module);
-    }
-
-    if (TYPE_ANY == node->let_stmt.var->variable.type->type)
-    {
-        old_type = node->let_stmt.var->variable.type;
-        node->let_stmt.var->variable.type
-            = TYPE_get_type(node->let_stmt.expr, logger, module);
-        if (old_type->mutable)
-        {
-            node->let_stmt.var->variable.type->mutable = old_type->mutable;
-        }
-    }
-}
-
-static void ast_fill_type(t_ast_node *node, const char *var_name,
-                          t_type *new_type, t_logger *logger,
-                          const t_module *module)
-{
-    t_ast_node *stmt = NULL;
-    t_struct_value_field *struct_value = NULL;
-
-    if (NULL == node)
-    {
-        return;
-    }
-
-    switch (node->type)
-    {
-        case AST_TYPE_ARRAY_LITERAL:
-        case AST_TYPE_BREAK_STMT:
-        case AST_TYPE_ENUM_DEFINITION:
-        case AST_TYPE_LITERAL:
-        case AST_TYPE_NUMBER:
-        case AST_TYPE_PROTOTYPE:
-        case AST_TYPE_STRING:
-        case AST_TYPE_STRUCT_DEFINITION:
-            break;
         case AST_TYPE_CAST_EXPR:
             {
-                (void) ast_fill_type(node->cast_expr.expr, var_name, new_type,
-                                     logger, module);
+                (void) ast_analyze_node(node->cast_expr.expr, analyzer);
+                node->cast_expr.type
+                    = ast_analyze_type(node->cast_expr.type, analyzer);
+                break;
             }
-            break;
-        case AST_TYPE_STRUCT_VALUE:
+        case AST_TYPE_GET_EXPR:
             {
-                if (NULL == node->struct_value.struct_values)
-                {
-                    break;
-                }
-
-                VECTOR_FOR_EACH(node->struct_value.struct_values, struct_values)
-                {
-                    struct_value = ITERATOR_GET_AS(t_struct_value_field_ptr,
-                                                   &struct_values);
-                    (void) ast_fill_type(struct_value->expr, var_name, new_type,
-                                         logger, module);
-                }
+                (void) ast_analyze_node(node->get_expr.variable, analyzer);
                 break;
             }
-        case AST_TYPE_FUNCTION:
+        case AST_TYPE_ARRAY_DEREF:
             {
-                if (NULL == node->function.body)
-                {
-                    return;
-                }
-                VECTOR_FOR_EACH(node->function.body, stmts)
-                {
-                    stmt = ITERATOR_GET_AS(t_ast_node_ptr, &stmts);
-                    (void) ast_fill_type(stmt, var_name, new_type, logger,
-                                         module);
-                }
+                (void) ast_analyze_node(node->array_deref.variable, analyzer);
+                (void) ast_analyze_node(node->array_deref.index, analyzer);
                 break;
             }
-        case AST_TYPE_VARIABLE:
+        case AST_TYPE_ARRAY_LITERAL:
             {
-                if (NULL == node->variable.name)
-                {
-                    break;
-                }
-
-                if (0 != strcmp(node->variable.name, var_name))
+                VECTOR_FOR_EACH(node->array_literal.exprs, exprs)
                 {
-                    break;
-                }
-
-                if (NULL != node->variable.type)
-                {
-                    (void) TYPE_free_type(node->variable.type);
-                    node->variable.type = NULL;
+                    child = ITERATOR_GET_AS(t_ast_node_ptr, &exprs);
+                    (void) ast_analyze_node(child, analyzer);
                 }
 
-                node->variable.type = TYPE_dup_type(new_type);
-                break;
-            }
-        case AST_TYPE_WHILE_EXPR:
-            {
-                (void) ast_fill_type(node->while_expr.cond, var_name, new_type,
-                                     logger, module);
-                if (NULL != node->while_expr.body)
+                /* The parser types literals by their first element, which is
+                 * unknown when it is a variable */
+                if ((TYPE_ANY == node->array_literal.type->type)
+                    && (0 < node->array_literal.exprs->size))
                 {
-                    VECTOR_FOR_EACH(node->while_expr.body, stmts)
-                    {
-                        stmt = ITERATOR_GET_AS(t_ast_node_ptr, &stmts);
-                        (void) ast_fill_type(stmt, var_name, new_type, logger,
-                                             module);
-                    }
+                    node->array_literal.type = TYPE_get_type(
+                        VECTOR_GET_AS(t_ast_node_ptr, node->array_literal.exprs,
+                                      0),
+                        analyzer->logger, analyzer->module);
                 }
 
+                node->array_literal.type
+                    = ast_analyze_type(node->array_literal.type, analyzer);
                 break;
             }
-        case AST_TYPE_IF_EXPR:
+        case AST_TYPE_STRUCT_VALUE:
             {
-                (void) ast_fill_type(node->if_expr.cond, var_name, new_type,
-                                     logger, module);
-                if (NULL != node->if_expr.then_body)
+                if (NULL == node->struct_value.struct_values)
                 {
-                    VECTOR_FOR_EACH(node->if_expr.then_body, stmts)
-                    {
-                        stmt = ITERATOR_GET_AS(t_ast_node_ptr, &stmts);
-                        (void) ast_fill_type(stmt, var_name, new_type, logger,
-                                             module);
-                    }
+                    break;
                 }
 
-                if (NULL != node->if_expr.else_body)
+                VECTOR_FOR_EACH(node->struct_value.struct_values, struct_values)
                 {
-                    VECTOR_FOR_EACH(node->if_expr.else_body, stmts)
-                    {
-                        stmt = ITERATOR_GET_AS(t_ast_node_ptr, &stmts);
-                        (void) ast_fill_type(stmt, var_name, new_type, logger,
-                                             module);
-                    }
+                    struct_value = ITERATOR_GET_AS(t_struct_value_field_ptr,
+                                                   &struct_values);
+                    (void) ast_analyze_node(struct_value->expr, analyzer);
                 }
-
                 break;
             }
         case AST_TYPE_CALL_EXPR:
             {
-                if (NULL != node->call_expr.callable)
+                (void) ast_analyze_node(node->call_expr.callable, analyzer);
+                if (NULL == node->call_expr.args)
                 {
-                    (void) ast_fill_type(node->call_expr.callable, var_name,
-                                         new_type, logger, module);
+                    break;
                 }
-                if (NULL != node->call_expr.args)
+
+                VECTOR_FOR_EACH(node->call_expr.args, args)
                 {
-                    VECTOR_FOR_EACH(node->call_expr.args, args)
-                    {
-                        stmt = ITERATOR_GET_AS(t_ast_node_ptr, &args);
-                        (void) ast_fill_type(stmt, var_name, new_type, logger,
-                                             module);
-                    }
+                    child = ITERATOR_GET_AS(t_ast_node_ptr, &args);
+                    (void) ast_analyze_node(child, analyzer);
                 }
-
-                break;
-            }
-        case AST_TYPE_ARRAY_DEREF:
-            {
-                (void) ast_fill_type(node->array_deref.variable, var_name,
-                                     new_type, logger, module);
-                (void) ast_fill_type(node->array_deref.index, var_name,
-                                     new_type, logger, module);
-                break;
-            }
-        case AST_TYPE_GET_EXPR:
-            {
-                (void) ast_fill_type(node->get_expr.variable, var_name,
-                                     new_type, logger, module);
-                break;
-            }
-        case AST_TYPE_EXPRESSION_STMT:
-            {
-                (void) ast_fill_type(node->expression_stmt.expr, var_name,
-                                     new_type, logger, module);
                 break;
             }
-        case AST_TYPE_LET_STMT:
+        case AST_TYPE_IF_EXPR:
             {
-                (void) ast_fill_type(node->let_stmt.expr, var_name, new_type,
-                                     logger, module);
-                (void) ast_fill_let_stmt_var_if_needed(node, logger, module);
+                (void) ast_analyze_node(node->if_expr.cond, analyzer);
+                (void) ast_analyze_body(node->if_expr.then_body, analyzer);
+                (void) ast_analyze_body(node->if_expr.else_body, analyzer);
                 break;
             }
-        case AST_TYPE_ASSIGNMENT_EXPR:
+        case AST_TYPE_MATCH_EXPR:
             {
-                (void) ast_fill_type(node->assignment_expr.lhs, var_name,
-                                     new_type, logger, module);
-                (void) ast_fill_type(node->assignment_expr.rhs, var_name,
-                                     new_type, logger, module);
+                (void) ast_analyze_node(node->match_expr.value, analyzer);
+                VECTOR_FOR_EACH(node->match_expr.arms, arms)
+                {
+                    arm = ITERATOR_GET_AS(t_ast_match_arm_ptr, &arms);
+                    VECTOR_FOR_EACH(arm->patterns, patterns)
+                    {
+                        child = ITERATOR_GET_AS(t_ast_node_ptr, &patterns);
+                        (void) ast_analyze_node(child, analyzer);
+                    }
+                    (void) ast_analyze_body(arm->body, analyzer);
+                }
+                (void) ast_analyze_body(node->match_expr.else_body, analyzer);
                 break;
             }
-        case AST_TYPE_UNARY_EXPR:
+        case AST_TYPE_WHILE_EXPR:
             {
-                (void) ast_fill_type(node->unary_expr.rhs, var_name, new_type,
-                                     logger, module);
+                (void) ast_analyze_node(node->while_expr.cond, analyzer);
+                (void) ast_analyze_body(node->while_expr.body, analyzer);
                 break;
             }
-        case AST_TYPE_BINARY_EXPR:
+        case AST_TYPE_FOR_EXPR:
             {
-                (void) ast_fill_type(node->binary_expr.lhs, var_name, new_type,
-                                     logger, module);
-                (void) ast_fill_type(node->binary_expr.rhs, var_name, new_type,
-                                     logger, module);
+                (void) ast_analyze_node(node->for_expr.start, analyzer);
+                (void) ast_analyze_node(node->for_expr.end, analyzer);
+                (void) ast_analyze_node(node->for_expr.step, analyzer);
+                (void) ast_fill_for_expr_var_if_needed(node, analyzer->logger,
+                                                       analyzer->module);
+
+                node->for_expr.var->variable.type = ast_analyze_type(
+                    node->for_expr.var->variable.type, analyzer);
+
+                /* The induction variable lives in its own scope so the body
+                 * can shadow it */
+                (void) ast_scope_push(analyzer);
+                (void) ast_scope_declare(analyzer,
+                                         node->for_expr.var->variable.name,
+                                         node->for_expr.var->variable.type);
+                (void) ast_analyze_body(node->for_expr.body, analyzer);
+                (void) ast_scope_pop(analyzer);
                 break;
             }
-        case AST_TYPE_RETURN_STMT:
+        case AST_TYPE_PROTOTYPE:
             {
-                (void) ast_fill_type(node->return_stmt.expr, var_name, new_type,
-                                     logger, module);
+                for (i = 0; i < node->prototype.arity; ++i)
+                {
+                    node->prototype.types[i]
+                        = ast_analyze_type(node->prototype.types[i], analyzer);
+                }
+
+                node->prototype.return_type
+                    = ast_analyze_type(node->prototype.return_type, analyzer);
                 break;
             }
-        case AST_TYPE_DEFER_STMT:
+        case AST_TYPE_FUNCTION:
             {
-                if (NULL == node->defer_stmt.body)
+                (void) ast_analyze_node(node->function.prototype, analyzer);
+                if (NULL == node->function.body)
                 {
-                    return;
+                    break;
                 }
-                VECTOR_FOR_EACH(node->defer_stmt.body, stmts)
+
+                /* Parameters live in their own scope so the body can shadow
+                 * them */
+                (void) ast_scope_push(analyzer);
+                for (i = 0; i < node->function.prototype->prototype.arity; ++i)
                 {
-                    stmt = ITERATOR_GET_AS(t_ast_node_ptr, &stmts);
-                    (void) ast_fill_type(stmt, var_name, new_type, logger,
-                                         module);
+                    (void) ast_scope_declare(
+                        analyzer, node->function.prototype->prototype.args[i],
+                        node->function.prototype->prototype.types[i]);
                 }
+                (void) ast_analyze_body(node->function.body, analyzer);
+                (void) ast_scope_pop(analyzer);
                 break;
             }
-        case AST_TYPE_BUILTIN:
-        case AST_TYPE_TYPE_EXPR:
-            {
-                (void) LOGGER_log(logger, L_INFO,
-                                  "ast_fill_type: default case %d\n",
-                                  node->type);
-                break;
-            }
-    }
-}
-
-void AST_fill_parameter_types(t_ast_node *function, t_logger *logger,
-                              const t_module *module)
-{
-    t_ast_node *proto = NULL;
-    t_vector *body = NULL;
-    size_t i = 0;
-
-    if (NULL == function)
-    {
-        return;
-    }
-
-    proto = function->function.prototype;
-    body = function->function.body;
-
-    if ((NULL == proto) || (NULL == body))
-    {
-        return;
-    }
-
-    for (i = 0; i < proto->prototype.arity; ++i)
-    {
-        (void) ast_fill_type(function, proto->prototype.args[i],
-                             proto->prototype.types[i], logger, module);
-    }
-}
-
-void AST_fill_variable_types(t_ast_node *node, t_logger *logger,
-                             const t_module *module)
-{
-    t_ast_node *stmt = NULL, *var = NULL;
-    t_vector *body = NULL;
-
-    if (NULL == node)
-    {
-        return;
-    }
-
-    switch (node->type)
-    {
-        case AST_TYPE_FUNCTION:
-            body = node->function.body;
-            break;
-        case AST_TYPE_WHILE_EXPR:
-            body = node->while_expr.body;
-            break;
-        case AST_TYPE_IF_EXPR:
-            body = node->if_expr.then_body;
-
-            if ((NULL == body))
-            {
-                return;
-            }
-
-            VECTOR_FOR_EACH(body, stmts)
+        case AST_TYPE_STRUCT_DEFINITION:
             {
-                stmt = ITERATOR_GET_AS(t_ast_node_ptr, &stmts);
-                if (AST_TYPE_LET_STMT == stmt->type)
+                VECTOR_FOR_EACH(node->struct_definition.struct_fields, fields)
                 {
-                    (void) ast_fill_let_stmt_var_if_needed(stmt, logger,
-                                                           module);
-
-                    var = stmt->let_stmt.var;
-                    (void) ast_fill_type(node, var->variable.name,
-                                         var->variable.type, logger, module);
+                    struct_field
+                        = ITERATOR_GET_AS(t_struct_field_ptr, &fields);
+                    struct_field->type
+                        = ast_analyze_type(struct_field->type, analyzer);
                 }
-                else
+
+                if (NULL == node->struct_definition.struct_functions)
                 {
-                    (void) AST_fill_variable_types(stmt, logger, module);
+                    break;
                 }
-            }
 
-            body = node->if_expr.else_body;
-            break;
-        case AST_TYPE_DEFER_STMT:
-            body = node->defer_stmt.body;
-            break;
-        case AST_TYPE_ARRAY_DEREF:
-        case AST_TYPE_ARRAY_LITERAL:
-        case AST_TYPE_ASSIGNMENT_EXPR:
-        case AST_TYPE_BINARY_EXPR:
-        case AST_TYPE_BREAK_STMT:
-        case AST_TYPE_BUILTIN:
-        case AST_TYPE_CALL_EXPR:
-        case AST_TYPE_CAST_EXPR:
-        case AST_TYPE_ENUM_DEFINITION:
-        case AST_TYPE_EXPRESSION_STMT:
-        case AST_TYPE_GET_EXPR:
-        case AST_TYPE_LET_STMT:
-        case AST_TYPE_LITERAL:
-        case AST_TYPE_NUMBER:
-        case AST_TYPE_PROTOTYPE:
-        case AST_TYPE_RETURN_STMT:
-        case AST_TYPE_STRING:
-        case AST_TYPE_STRUCT_DEFINITION:
-        case AST_TYPE_STRUCT_VALUE:
-        case AST_TYPE_TYPE_EXPR:
-        case AST_TYPE_UNARY_EXPR:
-        case AST_TYPE_VARIABLE:
-            {
-                (void) LOGGER_log(logger, L_INFO,
-                                  "AST_fill_variable_types default case %d\n",
-                                  node->type);
-                return;
+                VECTOR_FOR_EACH(node->struct_definition.struct_functions,
+                                functions)
+                {
+                    child = ITERATOR_GET_AS(t_ast_node_ptr, &functions);
+                    (void) AST_fix_function_last_expression_stmt(child);
+                    (void) ast_analyze_node(child, analyzer);
+                }
+                break;
             }
     }
+}
+
+void AST_analyze(t_ast_node *node, t_module *module, t_vector *type_aliases,
+                 t_logger *logger)
+{
+    t_ast_analyzer analyzer = {.module = module,
+                               .type_aliases = type_aliases,
+                               .logger = logger,
+                               .scope = NULL};
 
-    if ((NULL == body))
+    if (AST_TYPE_LET_STMT == node->type)
     {
+        /* The initializers of globals are constants that are typed by the
+         * backend, only the declared type needs fixing. */
+        node->let_stmt.var->variable.type
+            = ast_analyze_type(node->let_stmt.var->variable.type, &analyzer);
         return;
     }
 
-    VECTOR_FOR_EACH(body, stmts)
+    if (AST_TYPE_FUNCTION == node->type)
     {
-        stmt = ITERATOR_GET_AS(t_ast_node_ptr, &stmts);
-        if (AST_TYPE_LET_STMT == stmt->type)
-        {
-            (void) ast_fill_let_stmt_var_if_needed(stmt, logger, module);
-
-            var = stmt->let_stmt.var;
-            (void) ast_fill_type(node, var->variable.name, var->variable.type,
-                                 logger, module);
-        }
-        else
-        {
-            (void) AST_fill_variable_types(stmt, logger, module);
-        }
+        (void) AST_fix_function_last_expression_stmt(node);
     }
+
+    (void) ast_analyze_node(node, &analyzer);
 }
 
 bool AST_is_expression(t_ast_node *node)
@@ -1233,6 +1201,7 @@ bool AST_is_expression(t_ast_node *node)
             || (AST_TYPE_UNARY_EXPR == node->type)
             || (AST_TYPE_BINARY_EXPR == node->type)
             || (AST_TYPE_IF_EXPR == node->type)
+            || (AST_TYPE_MATCH_EXPR == node->type)
             || (AST_TYPE_WHILE_EXPR == node->type)
             || (AST_TYPE_CAST_EXPR == node->type)
             || (AST_TYPE_ASSIGNMENT_EXPR == node->type)
@@ -1249,24 +1218,27 @@ void AST_free_node(t_ast_node *node, t_logger *logger)
 
     switch (node->type)
     {
-        case AST_TYPE_BREAK_STMT:
         case AST_TYPE_LITERAL:
+        case AST_TYPE_NUMBER:
+        case AST_TYPE_TYPE_EXPR:
             break;
-        case AST_TYPE_STRING:
+        case AST_TYPE_BREAK_STMT:
+        case AST_TYPE_CONTINUE_STMT:
             {
-                if (NULL != node->string.value)
+                /* Both statements share the layout of a jump statement */
+                if (NULL != node->break_stmt.label)
                 {
-                    (void) free(node->string.value);
-                    node->string.value = NULL;
+                    (void) free(node->break_stmt.label);
+                    node->break_stmt.label = NULL;
                 }
                 break;
             }
-        case AST_TYPE_NUMBER:
+        case AST_TYPE_STRING:
             {
-                if (NULL != node->number.type)
+                if (NULL != node->string.value)
                 {
-                    (void) TYPE_free_type(node->number.type);
-                    node->number.type = NULL;
+                    (void) free(node->string.value);
+                    node->string.value = NULL;
                 }
                 break;
             }
@@ -1277,12 +1249,6 @@ void AST_free_node(t_ast_node *node, t_logger *logger)
                     (void) free(node->variable.name);
                     node->variable.name = NULL;
                 }
-
-                if (NULL != node->variable.type)
-                {
-                    (void) TYPE_free_type(node->variable.type);
-                    node->variable.type = NULL;
-                }
                 break;
             }
         case AST_TYPE_UNARY_EXPR:
@@ -1323,22 +1289,14 @@ void AST_free_node(t_ast_node *node, t_logger *logger)
 
                 if (NULL != node->prototype.types)
                 {
-                    for (size_t i = 0; i < node->prototype.arity; ++i)
-                    {
-                        if (NULL != node->prototype.types[i])
-                        {
-                            (void) TYPE_free_type(node->prototype.types[i]);
-                            node->prototype.types[i] = NULL;
-                        }
-                    }
                     (void) free(node->prototype.types);
                     node->prototype.types = NULL;
                 }
 
-                if (NULL != node->prototype.return_type)
+                if (NULL != node->prototype.restricted)
                 {
-                    (void) TYPE_free_type(node->prototype.return_type);
-                    node->prototype.return_type = NULL;
+                    (void) free(node->prototype.restricted);
+                    node->prototype.restricted = NULL;
                 }
 
                 break;
@@ -1410,6 +1368,54 @@ void AST_free_node(t_ast_node *node, t_logger *logger)
                 }
                 break;
             }
+        case AST_TYPE_MATCH_EXPR:
+            {
+                t_ast_node *stmt = NULL;
+                t_ast_match_arm *arm = NULL;
+
+                (void) AST_free_node(node->match_expr.value, logger);
+                VECTOR_FOR_EACH(node->match_expr.arms, arms)
+                {
+                    arm = ITERATOR_GET_AS(t_ast_match_arm_ptr, &arms);
+                    VECTOR_FOR_EACH(arm->patterns, patterns)
+                    {
+                        stmt = ITERATOR_GET_AS(t_ast_node_ptr, &patterns);
+                        (void) AST_free_node(stmt, logger);
+                    }
+                    (void) vector_clear(arm->patterns);
+                    (void) vector_destroy(arm->patterns);
+                    (void) free(arm->patterns);
+
+                    VECTOR_FOR_EACH(arm->body, stmts)
+                    {
+                        stmt = ITERATOR_GET_AS(t_ast_node_ptr, &stmts);
+                        (void) AST_free_node(stmt, logger);
+                    }
+                    (void) vector_clear(arm->body);
+                    (void) vector_destroy(arm->body);
+                    (void) free(arm->body);
+                    (void) free(arm);
+                }
+                (void) vector_clear(node->match_expr.arms);
+                (void) vector_destroy(node->match_expr.arms);
+                (void) free(node->match_expr.arms);
+                node->match_expr.arms = NULL;
+
+                if (NULL != node->match_expr.else_body)
+                {
+                    VECTOR_FOR_EACH(node->match_expr.else_body, stmts)
+                    {
+                        stmt = ITERATOR_GET_AS(t_ast_node_ptr, &stmts);
+                        (void) AST_free_node(stmt, logger);
+                    }
+
+                    (void) vector_clear(node->match_expr.else_body);
+                    (void) vector_destroy(node->match_expr.else_body);
+                    (void) free(node->match_expr.else_body);
+                    node->match_expr.else_body = NULL;
+                }
+                break;
+            }
         case AST_TYPE_WHILE_EXPR:
             {
                 if (NULL != node->while_expr.cond)
@@ -1431,19 +1437,48 @@ void AST_free_node(t_ast_node *node, t_logger *logger)
                     (void) free(node->while_expr.body);
                     node->while_expr.body = NULL;
                 }
+
+                if (NULL != node->while_expr.label)
+                {
+                    (void) free(node->while_expr.label);
+                    node->while_expr.label = NULL;
+                }
                 break;
             }
-        case AST_TYPE_CAST_EXPR:
+        case AST_TYPE_FOR_EXPR:
             {
-                if (NULL != node->cast_expr.expr)
+                (void) AST_free_node(node->for_expr.var, logger);
+                (void) AST_free_node(node->for_expr.start, logger);
+                (void) AST_free_node(node->for_expr.end, logger);
+                (void) AST_free_node(node->for_expr.step, logger);
+
+                if (NULL != node->for_expr.body)
                 {
-                    (void) AST_free_node(node->cast_expr.expr, logger);
+                    t_ast_node *stmt = NULL;
+                    VECTOR_FOR_EACH(node->for_expr.body, stmts)
+                    {
+                        stmt = ITERATOR_GET_AS(t_ast_node_ptr, &stmts);
+                        (void) AST_free_node(stmt, logger);
+                    }
+
+                    (void) vector_clear(node->for_expr.body);
+                    (void) vector_destroy(node->for_expr.body);
+                    (void) free(node->for_expr.body);
+                    node->for_expr.body = NULL;
                 }
 
-                if (NULL != node->cast_expr.type)
+                if (NULL != node->for_expr.label)
+                {
+                    (void) free(node->for_expr.label);
+                    node->for_expr.label = NULL;
+                }
+                break;
+            }
+        case AST_TYPE_CAST_EXPR:
+            {
+                if (NULL != node->cast_expr.expr)
                 {
-                    (void) TYPE_free_type(node->cast_expr.type);
-                    node->cast_expr.type = NULL;
+                    (void) AST_free_node(node->cast_expr.expr, logger);
                 }
                 break;
             }
@@ -1529,12 +1564,6 @@ void AST_free_node(t_ast_node *node, t_logger *logger)
                                 struct_field->name = NULL;
                             }
 
-                            if (NULL != struct_field->type)
-                            {
-                                (void) TYPE_free_type(struct_field->type);
-                                struct_field->type = NULL;
-                            }
-
                             (void) free(struct_field);
                             struct_field = NULL;
                         }
@@ -1690,11 +1719,6 @@ void AST_free_node(t_ast_node *node, t_logger *logger)
 
         case AST_TYPE_ARRAY_LITERAL:
             {
-                if (NULL != node->array_literal.type)
-                {
-                    (void) TYPE_free_type(node->array_literal.type);
-                    node->array_literal.type = NULL;
-                }
                 if (NULL != node->array_literal.exprs)
                 {
                     VECTOR_FOR_EACH(node->array_literal.exprs, exprs)
@@ -1720,15 +1744,6 @@ void AST_free_node(t_ast_node *node, t_logger *logger)
                 }
                 break;
             }
-        case AST_TYPE_TYPE_EXPR:
-            {
-                if (NULL != node->type_expr.type)
-                {
-                    (void) TYPE_free_type(node->type_expr.type);
-                    node->type_expr.type = NULL;
-                }
-                break;
-            }
         case AST_TYPE_DEFER_STMT:
             {
                 if (NULL != node->defer_stmt.body)
@@ -1748,7 +1763,8 @@ void AST_free_node(t_ast_node *node, t_logger *logger)
             }
     }
 
-    (void) free(node);
+    /* The storage of the node itself belongs to its block and is released by
+     * AST_free_nodes. */
     node = NULL;
 }
 
@@ -1851,6 +1867,16 @@ static char *ast_binop_to_str(t_ast_binop_type op)
             return "^";
         case BINOP_BOR:
             return "|";
+        case BINOP_ADD_WRAP:
+            return "+%";
+        case BINOP_SUB_WRAP:
+            return "-%";
+        case BINOP_MUL_WRAP:
+            return "*%";
+        case BINOP_LAND:
+            return "&&";
+        case BINOP_LOR:
+            return "||";
     }
 }
 
@@ -2046,6 +2072,39 @@ void AST_print_ast(t_ast_node *node, int offset, t_logger *logger)
                 }
                 break;
             }
+        case AST_TYPE_MATCH_EXPR:
+            {
+                t_ast_match_arm *arm = NULL;
+
+                (void) LOGGER_log(logger, L_DEBUG, "%*c\b Match Expression\n",
+                                  offset, ' ');
+                (void) LOGGER_log(logger, L_DEBUG, "%*c\b Value\n",
+                                  offset + 2, ' ');
+                (void) AST_print_ast(node->match_expr.value, offset + 4,
+                                     logger);
+                VECTOR_FOR_EACH(node->match_expr.arms, arms)
+                {
+                    arm = ITERATOR_GET_AS(t_ast_match_arm_ptr, &arms);
+                    (void) LOGGER_log(logger, L_DEBUG, "%*c\b Arm\n",
+                                      offset + 2, ' ');
+                    VECTOR_FOR_EACH(arm->patterns, patterns)
+                    {
+                        (void) AST_print_ast(
+                            ITERATOR_GET_AS(t_ast_node_ptr, &patterns),
+                            offset + 4, logger);
+                    }
+                    (void) ast_print_statements_block(arm->body, offset + 4,
+                                                      logger);
+                }
+                if (NULL != node->match_expr.else_body)
+                {
+                    (void) LOGGER_log(logger, L_DEBUG, "%*c\b Else Body\n",
+                                      offset + 2, ' ');
+                    (void) ast_print_statements_block(
+                        node->match_expr.else_body, offset + 4, logger);
+                }
+                break;
+            }
         case AST_TYPE_WHILE_EXPR:
             {
                 (void) LOGGER_log(logger, L_DEBUG, "%*c\b While Expression\n",
@@ -2066,6 +2125,35 @@ void AST_print_ast(t_ast_node *node, int offset, t_logger *logger)
                 }
                 break;
             }
+        case AST_TYPE_FOR_EXPR:
+            {
+                (void) LOGGER_log(logger, L_DEBUG, "%*c\b For Expression\n",
+                                  offset, ' ');
+                (void) LOGGER_log(logger, L_DEBUG, "%*c\b Variable\n",
+                                  offset + 2, ' ');
+                (void) AST_print_ast(node->for_expr.var, offset + 4, logger);
+                (void) LOGGER_log(logger, L_DEBUG, "%*c\b Start\n",
+                                  offset + 2, ' ');
+                (void) AST_print_ast(node->for_expr.start, offset + 4, logger);
+                (void) LOGGER_log(logger, L_DEBUG, "%*c\b End\n", offset + 2,
+                                  ' ');
+                (void) AST_print_ast(node->for_expr.end, offset + 4, logger);
+                if (NULL != node->for_expr.step)
+                {
+                    (void) LOGGER_log(logger, L_DEBUG, "%*c\b Step\n",
+                                      offset + 2, ' ');
+                    (void) AST_print_ast(node->for_expr.step, offset + 4,
+                                         logger);
+                }
+                if (NULL != node->for_expr.body)
+                {
+                    (void) LOGGER_log(logger, L_DEBUG, "%*c\b Body\n",
+                                      offset + 2, ' ');
+                    (void) ast_print_statements_block(node->for_expr.body,
+                                                      offset + 4, logger);
+                }
+                break;
+            }
         case AST_TYPE_CAST_EXPR:
             {
                 (void) LOGGER_log(logger, L_DEBUG, "%*c\b Cast Expression\n",
@@ -2213,6 +2301,12 @@ void AST_print_ast(t_ast_node *node, int offset, t_logger *logger)
                                   offset, ' ');
                 break;
             }
+        case AST_TYPE_CONTINUE_STMT:
+            {
+                (void) LOGGER_log(logger, L_DEBUG,
+                                  "%*c\b Continue statement\n", offset, ' ');
+                break;
+            }
         case AST_TYPE_STRUCT_DEFINITION:
             {
                 (void) LOGGER_log(logger, L_DEBUG, "%*c\b Struct Definition\n",
@@ -2496,6 +2590,8 @@ bool AST_is_cond_binop(t_ast_binop_type op)
         case BINOP_NEQ:
         case BINOP_LEQ:
         case BINOP_GEQ:
+        case BINOP_LAND:
+        case BINOP_LOR:
             return true;
         case BINOP_ADD:
         case BINOP_DIVIDE:
@@ -2507,15 +2603,39 @@ bool AST_is_cond_binop(t_ast_binop_type op)
         case BINOP_BAND:
         case BINOP_BXOR:
         case BINOP_BOR:
+        case BINOP_ADD_WRAP:
+        case BINOP_SUB_WRAP:
+        case BINOP_MUL_WRAP:
             return false;
     }
 }
 
 static t_builtin_id ast_builtin_id_from_name(const char *name)
 {
-    if (0 == strcmp("@sizeOf", name))
+    static const struct
+    {
+        const char *name;
+        t_builtin_id id;
+    } builtins[] = {
+        {"@sizeOf", BUILTIN_ID_SIZEOF},
+        {"@shuffle", BUILTIN_ID_SHUFFLE},
+        {"@select", BUILTIN_ID_SELECT},
+        {"@reduceAdd", BUILTIN_ID_REDUCE_ADD},
+        {"@reduceMul", BUILTIN_ID_REDUCE_MUL},
+        {"@reduceMin", BUILTIN_ID_REDUCE_MIN},
+        {"@reduceMax", BUILTIN_ID_REDUCE_MAX},
+        {"@reduceAnd", BUILTIN_ID_REDUCE_AND},
+        {"@reduceOr", BUILTIN_ID_REDUCE_OR},
+        {"@reduceXor", BUILTIN_ID_REDUCE_XOR},
+    };
+    size_t i = 0;
+
+    for (i = 0; i < sizeof(builtins) / sizeof(builtins[0]); ++i)
     {
-        return BUILTIN_ID_SIZEOF;
+        if (0 == strcmp(builtins[i].name, name))
+        {
+            return builtins[i].id;
+        }
     }
 
     return BUILTIN_ID_INVALID;
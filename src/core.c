@@ -2,7 +2,7 @@
 #include "ast.h"
 #include "type.h"
 
-#define NUMBER_OF_BUILTINS 1
+#define NUMBER_OF_BUILTINS 10
 
 #define ALLOC_GENERIC(amount, var_name, type)                                  \
     do                                                                         \
@@ -19,6 +19,41 @@
 
 static t_ast_node *g_builtins[NUMBER_OF_BUILTINS] = {0};
 
+/**
+ * @brief Create the prototype of a SIMD vector builtin, whose arguments and
+ * return type are checked against the vector types of the call site instead of
+ * the prototype.
+ *
+ * @param[in] name the name of the builtin.
+ * @param[in] arity the number of arguments of the builtin.
+ *
+ * @return the prototype, or NULL on allocation failure.
+ */
+static t_ast_node *core_new_vector_builtin(char *name, size_t arity)
+{
+    static char *arg_names[] = {"a", "b", "c"};
+    size_t i = 0;
+    t_type **types = NULL;
+    char **args = NULL;
+
+    ALLOC_ARGS(arity);
+    ALLOC_TYPES(arity);
+    for (i = 0; i < arity; ++i)
+    {
+        args[i] = arg_names[i];
+        types[i] = TYPE_make_type(TYPE_ANY, NULL, NULL, false);
+    }
+
+    return AST_new_prototype(name, args, types, (unsigned int) arity,
+                             TYPE_make_type(TYPE_ANY, NULL, NULL, false),
+                             false);
+
+l_cleanup:
+    (void) free(args);
+    (void) free(types);
+    return NULL;
+}
+
 bool CORE_initialize_builtins(t_logger *logger)
 {
     int i = 0;
@@ -26,16 +61,33 @@ bool CORE_initialize_builtins(t_logger *logger)
     t_type **types = NULL, *return_type = NULL;
     char **args = NULL;
 
-    return_type = TYPE_initialize_type(TYPE_UINT64);
+    return_type = TYPE_make_type(TYPE_UINT64, NULL, NULL, false);
     ALLOC_ARGS(1);
     args[0] = "expr_type";
 
     ALLOC_TYPES(1);
-    types[0] = TYPE_initialize_type(TYPE_TYPE);
+    types[0] = TYPE_make_type(TYPE_TYPE, NULL, NULL, false);
     prototype
         = AST_new_prototype("@sizeOf", args, types, 1, return_type, false);
     g_builtins[i++] = prototype;
 
+    g_builtins[i++] = core_new_vector_builtin("@shuffle", 3);
+    g_builtins[i++] = core_new_vector_builtin("@select", 3);
+    g_builtins[i++] = core_new_vector_builtin("@reduceAdd", 1);
+    g_builtins[i++] = core_new_vector_builtin("@reduceMul", 1);
+    g_builtins[i++] = core_new_vector_builtin("@reduceMin", 1);
+    g_builtins[i++] = core_new_vector_builtin("@reduceMax", 1);
+    g_builtins[i++] = core_new_vector_builtin("@reduceAnd", 1);
+    g_builtins[i++] = core_new_vector_builtin("@reduceOr", 1);
+    g_builtins[i++] = core_new_vector_builtin("@reduceXor", 1);
+    for (i = 0; i < NUMBER_OF_BUILTINS; ++i)
+    {
+        if (NULL == g_builtins[i])
+        {
+            goto l_cleanup;
+        }
+    }
+
     return true;
 
 l_cleanup:
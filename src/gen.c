@@ -3,6 +3,9 @@
 
 #include <llvm-c/Analysis.h>
 #include <llvm-c/Core.h>
+#include <llvm-c/DebugInfo.h>
+#include <llvm-c/IRReader.h>
+#include <llvm-c/Target.h>
 #include <llvm-c/Types.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -16,11 +19,45 @@
 #include "utils.h"
 #include "vector.h"
 
+/** Zero aggregate literals of at least this many bytes are built with memset */
+#define GEN_MEMSET_THRESHOLD (64)
+
 static t_named_value *named_values = NULL;
 static t_struct_info *struct_infos = NULL;
 static t_enum_info *enum_infos = NULL;
 static t_vector *loop_blocks = NULL;
 static t_vector *defer_blocks = NULL;
+static t_vector *scoped_values = NULL;
+static t_vector *memory_variables = NULL;
+static t_vector *captured_variables = NULL;
+static t_vector *written_through_variables = NULL;
+static t_type_mapping *llvm_type_to_ttype = NULL;
+/** The code generation that the LLVM types cached on types are valid for */
+static unsigned long llvm_type_generation = 1;
+static t_pooled_string *string_pool = NULL;
+static bool verify_functions = true;
+static bool strict_overflow = false;
+static unsigned int default_fast_math_flags = 0;
+static unsigned int fast_math_flags = 0;
+static t_fast_math_template *fast_math_templates = NULL;
+
+/** The fast-math flags by their name in LLVM IR */
+static const struct
+{
+    const char *name;
+    unsigned int flag;
+} GEN_FAST_MATH_FLAGS[] = {
+    {"reassoc", GEN_FAST_MATH_REASSOC}, {"contract", GEN_FAST_MATH_CONTRACT},
+    {"nnan", GEN_FAST_MATH_NNAN},       {"ninf", GEN_FAST_MATH_NINF},
+    {"nsz", GEN_FAST_MATH_NSZ},         {"arcp", GEN_FAST_MATH_ARCP},
+    {"afn", GEN_FAST_MATH_AFN},
+};
+
+/** The real predicates by their value in LLVMRealPredicate */
+static const char *const GEN_REAL_PREDICATE_NAMES[] = {
+    "false", "oeq", "ogt", "oge", "olt", "ole", "one", "ord",
+    "uno",   "ueq", "ugt", "uge", "ult", "ule", "une", "true",
+};
 
 static LLVMValueRef gen_codegen_sizeof(t_ast_node *node, t_type *type,
                                        t_logger *logger);
@@ -30,6 +67,10 @@ static LLVMValueRef gen_codegen_stmts(t_vector *statements,
                                       LLVMBuilderRef builder,
                                       bool *has_return_stmt, t_logger *logger);
 
+static size_t gen_scope_open(void);
+
+static void gen_scope_close(size_t scope);
+
 /**
  * @brief Generate LLVM IR for all currently defined defer blocks.
  *
@@ -40,7 +81,7 @@ static LLVMValueRef gen_codegen_stmts(t_vector *statements,
 static void gen_codegen_defer_blocks(LLVMModuleRef module,
                                      LLVMBuilderRef builder, t_logger *logger)
 {
-    size_t i = 0;
+    size_t i = 0, scope = 0;
     t_ast_node *node = NULL;
 
     if (NULL != defer_blocks)
@@ -48,8 +89,10 @@ static void gen_codegen_defer_blocks(LLVMModuleRef module,
         for (i = 0; i < defer_blocks->size; ++i)
         {
             node = *(t_ast_node **) vector_get(defer_blocks, i);
+            scope = gen_scope_open();
             (void) gen_codegen_stmts(node->defer_stmt.body, module, builder,
                                      NULL, logger);
+            (void) gen_scope_close(scope);
         }
     }
 }
@@ -60,14 +103,18 @@ static void gen_codegen_defer_blocks(LLVMModuleRef module,
  * @param[in] type the LLVM type.
  * @param[in] logger a logger that can be used to log messages.
  *
- * @return the Luka type.
+ * @return the interned Luka type, which should not be freed.
  */
 static t_type *gen_llvm_type_to_ttype(LLVMTypeRef type, t_logger *logger)
 {
-    t_type *ttype = calloc(1, sizeof(t_type));
-    if (NULL == type)
+    t_type converted = {0};
+    t_type *ttype = &converted;
+    t_type_mapping *mapping = NULL;
+
+    HASH_FIND_PTR(llvm_type_to_ttype, &type, mapping);
+    if (NULL != mapping)
     {
-        exit(LUKA_CANT_ALLOC_MEMORY);
+        return mapping->ttype;
     }
 
     ttype->payload = NULL;
@@ -145,6 +192,13 @@ static t_type *gen_llvm_type_to_ttype(LLVMTypeRef type, t_logger *logger)
             = gen_llvm_type_to_ttype(LLVMGetElementType(type), logger);
         ttype->payload = (void *) ((size_t) LLVMGetArrayLength(type));
     }
+    else if (LLVMVectorTypeKind == LLVMGetTypeKind(type))
+    {
+        ttype->type = TYPE_VECTOR;
+        ttype->inner_type
+            = gen_llvm_type_to_ttype(LLVMGetElementType(type), logger);
+        ttype->payload = (void *) ((size_t) LLVMGetVectorSize(type));
+    }
     else
     {
         (void) LLVMDumpType(type);
@@ -154,7 +208,16 @@ static t_type *gen_llvm_type_to_ttype(LLVMTypeRef type, t_logger *logger)
         exit(LUKA_CODEGEN_ERROR);
     }
 
-    return ttype;
+    mapping = calloc(1, sizeof(t_type_mapping));
+    if (NULL == mapping)
+    {
+        exit(LUKA_CANT_ALLOC_MEMORY);
+    }
+
+    mapping->llvm_type = type;
+    mapping->ttype = TYPE_intern(ttype);
+    HASH_ADD_PTR(llvm_type_to_ttype, llvm_type, mapping);
+    return mapping->ttype;
 }
 
 /**
@@ -242,7 +305,12 @@ static LLVMValueRef gen_get_struct_field_pointer(t_named_value *variable,
     }
 
     var = variable->alloca_inst;
-    if (should_deref)
+    if (NULL != variable->value)
+    {
+        /* Only pointers to structs are kept in registers */
+        var = variable->value;
+    }
+    else if (should_deref)
     {
         var = LLVMBuildLoad(builder, var, "loadtmp");
     }
@@ -297,21 +365,32 @@ static bool gen_llvm_cast_sizes_if_needed(LLVMValueRef *lhs, LLVMValueRef *rhs,
                                      TYPE_is_signed(lhs_t), "intcasttmp");
         }
 
-        (void) TYPE_free_type(lhs_t);
-        lhs_t = NULL;
-        (void) TYPE_free_type(rhs_t);
-        rhs_t = NULL;
-
         return true;
     }
 
-    (void) TYPE_free_type(lhs_t);
-    lhs_t = NULL;
-    (void) TYPE_free_type(rhs_t);
-    rhs_t = NULL;
     return false;
 }
 
+/**
+ * @brief Free a named value.
+ *
+ * @param[in] named_value the named value.
+ */
+static void gen_named_value_free(t_named_value *named_value)
+{
+    if (NULL != named_value)
+    {
+        if (NULL != named_value->name)
+        {
+            (void) free(named_value->name);
+            named_value->name = NULL;
+        }
+
+        (void) free(named_value);
+        named_value = NULL;
+    }
+}
+
 /**
  * @brief Clearing currently defined named values.
  */
@@ -322,35 +401,125 @@ static void gen_named_values_clear(void)
     HASH_ITER(hh, named_values, named_value, named_value_iter)
     {
         HASH_DEL(named_values, named_value);
-        if (NULL != named_value)
-        {
-            if (NULL != named_value->name)
-            {
-                (void) free(named_value->name);
-                named_value->name = NULL;
-            }
+        (void) gen_named_value_free(named_value);
+    }
+}
 
-            if (NULL != named_value->ttype)
-            {
-                (void) TYPE_free_type(named_value->ttype);
-                named_value->ttype = NULL;
-            }
+/**
+ * @brief Declare a local named value in the innermost scope, hiding any named
+ * value with the same name until the scope is closed.
+ *
+ * @param[in] named_value the named value.
+ */
+static void gen_named_value_declare(t_named_value *named_value)
+{
+    HASH_FIND_STR(named_values, named_value->name, named_value->shadowed);
+    if (NULL != named_value->shadowed)
+    {
+        HASH_DEL(named_values, named_value->shadowed);
+    }
+
+    HASH_ADD_KEYPTR(hh, named_values, named_value->name,
+                    strlen(named_value->name), named_value);
+    (void) vector_push_back(scoped_values, &named_value);
+}
+
+/**
+ * @brief Open a new scope for local named values.
+ *
+ * @return a marker that should be passed to gen_scope_close.
+ */
+static size_t gen_scope_open(void)
+{
+    return scoped_values->size;
+}
+
+/**
+ * @brief Close the scopes opened since @p scope, forgetting the named values
+ * declared in them.
+ *
+ * @param[in] scope the marker returned by gen_scope_open.
+ */
+static void gen_scope_close(size_t scope)
+{
+    t_named_value *named_value = NULL;
 
-            (void) free(named_value);
-            named_value = NULL;
+    while (scope < scoped_values->size)
+    {
+        named_value
+            = VECTOR_GET_AS(t_named_value_ptr, scoped_values,
+                            scoped_values->size - 1);
+        (void) vector_pop_back(scoped_values);
+
+        HASH_DEL(named_values, named_value);
+        if (NULL != named_value->shadowed)
+        {
+            HASH_ADD_KEYPTR(hh, named_values, named_value->shadowed->name,
+                            strlen(named_value->shadowed->name),
+                            named_value->shadowed);
         }
+        (void) gen_named_value_free(named_value);
     }
 }
 
 /**
- * @brief Convert Luka type to LLVM type.
+ * @brief Clearing a cache of type conversions.
+ *
+ * @param[in,out] mappings the cache to clear.
+ */
+static void gen_type_mappings_clear(t_type_mapping **mappings)
+{
+    t_type_mapping *mapping = NULL, *mapping_iter = NULL;
+
+    HASH_ITER(hh, *mappings, mapping, mapping_iter)
+    {
+        HASH_DEL(*mappings, mapping);
+        (void) free(mapping);
+    }
+}
+
+/**
+ * @brief Clearing the pool of string literals.
+ */
+static void gen_string_pool_clear(void)
+{
+    t_pooled_string *pooled_string = NULL, *pooled_string_iter = NULL;
+
+    HASH_ITER(hh, string_pool, pooled_string, pooled_string_iter)
+    {
+        HASH_DEL(string_pool, pooled_string);
+        (void) free(pooled_string->value);
+        (void) free(pooled_string);
+    }
+}
+
+/**
+ * @brief Clearing the instructions with fast-math flags that are cloned.
+ */
+static void gen_fast_math_templates_clear(void)
+{
+    t_fast_math_template *template = NULL, *template_iter = NULL;
+
+    HASH_ITER(hh, fast_math_templates, template, template_iter)
+    {
+        HASH_DEL(fast_math_templates, template);
+        (void) LLVMDisposeModule(template->module);
+        (void) free(template->ir);
+        (void) free(template);
+    }
+}
+
+static LLVMTypeRef gen_type_to_llvm_type(t_type *type, t_logger *logger);
+
+/**
+ * @brief Convert Luka type to LLVM type without looking at the cache.
  *
  * @param[in] type the Luka type to convert.
  * @param[in] logger a logger that can be used to log messages.
  *
  * @return the LLVM type.
  */
-static LLVMTypeRef gen_type_to_llvm_type(t_type *type, t_logger *logger)
+static LLVMTypeRef gen_build_llvm_type(t_type *type, t_logger *logger)
 {
     t_struct_info *struct_info = NULL;
 
@@ -398,6 +567,10 @@ static LLVMTypeRef gen_type_to_llvm_type(t_type *type, t_logger *logger)
             }
             return LLVMPointerType(
                 gen_type_to_llvm_type(type->inner_type, logger), 0);
+        case TYPE_VECTOR:
+            return LLVMVectorType(
+                gen_type_to_llvm_type(type->inner_type, logger),
+                (unsigned int) (size_t) type->payload);
         case TYPE_STRUCT:
             HASH_FIND_STR(struct_infos, (char *) type->payload, struct_info);
             if ((NULL != struct_info) && (NULL != struct_info->struct_type))
@@ -421,6 +594,30 @@ static LLVMTypeRef gen_type_to_llvm_type(t_type *type, t_logger *logger)
     }
 }
 
+/**
+ * @brief Convert Luka type to LLVM type.
+ *
+ * @details The conversion is cached on the canonical type, as types are
+ * interned and mutability doesn't change the LLVM type.
+ *
+ * @param[in] type the Luka type to convert.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return the LLVM type.
+ */
+static LLVMTypeRef gen_type_to_llvm_type(t_type *type, t_logger *logger)
+{
+    t_type *canonical = type->canonical;
+
+    if (llvm_type_generation != canonical->llvm_generation)
+    {
+        canonical->llvm_type = gen_build_llvm_type(canonical, logger);
+        canonical->llvm_generation = llvm_type_generation;
+    }
+
+    return canonical->llvm_type;
+}
+
 /**
  * @brief Create an alloca in the entry block of a function for a new
  * named_value.
@@ -521,1280 +718,3571 @@ static LLVMOpcode gen_llvm_get_cast_op(LLVMTypeRef type, LLVMTypeRef dest_type,
         }
     }
 
-    if (NULL != ttype)
-    {
-        (void) TYPE_free_type(ttype);
-        ttype = NULL;
-    }
+    return opcode;
+}
 
-    if (NULL != dest_ttype)
+/**
+ * @brief Check whether a LLVM type is a floating point type or a vector of
+ * floating point types.
+ *
+ * @param[in] type the LLVM type.
+ *
+ * @return whether @p type holds floating point values.
+ */
+static bool gen_llvm_is_floating_type(LLVMTypeRef type)
+{
+    if (LLVMVectorTypeKind == LLVMGetTypeKind(type))
     {
-        (void) free(dest_ttype);
-        dest_ttype = NULL;
+        type = LLVMGetElementType(type);
     }
 
-    return opcode;
+    return (LLVMFloatTypeKind == LLVMGetTypeKind(type))
+        || (LLVMDoubleTypeKind == LLVMGetTypeKind(type));
 }
 
 /**
- * @brief Cast a LLVM value to a new type.
+ * @brief Get the type of an expression, or of its lanes if it is a vector.
  *
- * @param[in] builder the LLVM IR builder.
- * @param[in] original_value the value that should be casted.
- * @param[in] dest_type the type the value should be casted to.
- * @param[in] logger a logger that can be used to log messages.
+ * @details LLVM integers carry no sign, so this looks at the luka type the
+ * type checker annotated the expression with.
  *
- * @return the value casted to the `dest_type`.
+ * @param[in] node the AST node of the expression.
+ *
+ * @return the type of the expression or of its lanes, or NULL if it isn't
+ * known.
  */
-static LLVMValueRef gen_codegen_cast(LLVMBuilderRef builder,
-                                     LLVMValueRef original_value,
-                                     LLVMTypeRef dest_type, t_logger *logger)
+static t_type *gen_expr_lane_type(const t_ast_node *node)
 {
-    LLVMTypeRef type = LLVMTypeOf(original_value);
+    t_type *type = node->expr_type;
 
-    if ((LLVMArrayTypeKind == LLVMGetTypeKind(type))
-        && (LLVMPointerTypeKind == LLVMGetTypeKind(dest_type)))
+    if ((NULL == type) && (AST_TYPE_VARIABLE == node->type))
     {
-        return original_value;
+        type = node->variable.type;
     }
 
-    if ((LLVMPointerTypeKind == LLVMGetTypeKind(type))
-        && (LLVMPointerTypeKind == LLVMGetTypeKind(dest_type)))
+    if ((NULL != type) && (TYPE_VECTOR == type->type))
     {
-        return LLVMBuildPointerCast(builder, original_value, dest_type,
-                                    "ptrcasttmp");
+        type = type->inner_type;
     }
 
-    return LLVMBuildCast(builder, gen_llvm_get_cast_op(type, dest_type, logger),
-                         original_value, dest_type, "casttmp");
+    return type;
 }
 
 /**
- * @brief Cast both hand sides to floating point if one of them is a floating
- * point type.
+ * @brief Check whether an expression holds unsigned integers, lane by lane for
+ * vectors.
  *
- * @param[in,out] lhs the left hand side.
- * @param[in,out] rhs the right hand side.
- * @param[in] builder the LLVM IR builder.
- * @param[in] logger a logger that can be used to log messages.
+ * @details Expressions without a known type are treated as signed.
  *
- * @return whether a cast has happend.
+ * @param[in] node the AST node of the expression.
+ *
+ * @return whether the expression holds unsigned integers.
  */
-static bool gen_llvm_cast_to_fp_if_needed(LLVMValueRef *lhs, LLVMValueRef *rhs,
-                                          LLVMBuilderRef builder,
-                                          t_logger *logger)
+static bool gen_is_unsigned_expr(const t_ast_node *node)
 {
-    t_type *lhs_t = gen_llvm_type_to_ttype(LLVMTypeOf(*lhs), logger);
-    t_type *rhs_t = gen_llvm_type_to_ttype(LLVMTypeOf(*rhs), logger);
+    t_type *type = gen_expr_lane_type(node);
 
-    if (TYPE_is_floating_type(lhs_t) || TYPE_is_floating_type(rhs_t))
+    if (NULL == type)
     {
-        if (TYPE_is_floating_type(lhs_t) && !TYPE_is_floating_type(rhs_t))
-        {
-            if (TYPE_is_signed(rhs_t))
-            {
-                *rhs = LLVMBuildSIToFP(builder, *rhs, LLVMTypeOf(*lhs),
-                                       "sitofpcasttmp");
-            }
-            else
-            {
-                *rhs = LLVMBuildUIToFP(builder, *rhs, LLVMTypeOf(*lhs),
-                                       "uitofpcasttmp");
-            }
-        }
-        else if (!TYPE_is_floating_type(lhs_t) && TYPE_is_floating_type(rhs_t))
-        {
-            if (TYPE_is_signed(lhs_t))
-            {
-                *lhs = LLVMBuildSIToFP(builder, *lhs, LLVMTypeOf(*rhs),
-                                       "sitofpcasttmp");
-            }
-            else
-            {
-                *lhs = LLVMBuildUIToFP(builder, *lhs, LLVMTypeOf(*rhs),
-                                       "uitofpcasttmp");
-            }
-        }
-
-        (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
-
-        (void) TYPE_free_type(lhs_t);
-        lhs_t = NULL;
-        (void) TYPE_free_type(rhs_t);
-        rhs_t = NULL;
-
-        return true;
+        return false;
     }
 
-    (void) TYPE_free_type(lhs_t);
-    lhs_t = NULL;
-    (void) TYPE_free_type(rhs_t);
-    rhs_t = NULL;
-    return false;
+    return (TYPE_BOOL == type->type) || (TYPE_UINT8 == type->type)
+        || (TYPE_UINT16 == type->type) || (TYPE_UINT32 == type->type)
+        || (TYPE_UINT64 == type->type);
 }
 
 /**
- * @brief Cast both hand sides to signed if one of them is a signed type.
+ * @brief Check whether an expression is known to hold integers of the given
+ * signedness, lane by lane for vectors.
  *
- * @param[in,out] lhs the left hand side.
- * @param[in,out] rhs the right hand side.
- * @param[in] builder the LLVM IR builder.
- * @param[in] logger a logger that can be used to log messages.
+ * @details Number literals have either signedness, since they take the type
+ * of the expression they are used in.
  *
- * @return whether a cast has happend.
+ * @param[in] node the AST node of the expression.
+ * @param[in] is_signed whether to check for signed or for unsigned integers.
+ *
+ * @return whether the expression holds integers of the given signedness,
+ * false if its type isn't known.
  */
-static bool gen_llvm_cast_to_signed_if_needed(LLVMValueRef *lhs,
-                                              LLVMValueRef *rhs,
-                                              LLVMBuilderRef builder,
-                                              t_logger *logger)
+static bool gen_is_integer_expr(const t_ast_node *node, bool is_signed)
 {
-    t_type *lhs_t = gen_llvm_type_to_ttype(LLVMTypeOf(*lhs), logger);
-    t_type *rhs_t = gen_llvm_type_to_ttype(LLVMTypeOf(*rhs), logger);
+    t_type *type = NULL;
 
-    if (TYPE_is_signed(lhs_t) || TYPE_is_signed(rhs_t))
+    if (AST_TYPE_NUMBER == node->type)
     {
-        if (TYPE_is_signed(lhs_t) && !TYPE_is_signed(rhs_t))
-        {
-            *rhs = LLVMBuildIntCast2(builder, *rhs, LLVMTypeOf(*lhs), true,
-                                     "signedcasttmp");
-        }
-        else if (!TYPE_is_signed(lhs_t) && TYPE_is_signed(rhs_t))
-        {
-            *lhs = LLVMBuildIntCast2(builder, *lhs, LLVMTypeOf(*rhs), true,
-                                     "signedcasttmp");
-        }
-
-        (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
+        return !TYPE_is_floating_type(node->number.type);
+    }
 
-        (void) TYPE_free_type(lhs_t);
-        lhs_t = NULL;
-        (void) TYPE_free_type(rhs_t);
-        rhs_t = NULL;
+    type = gen_expr_lane_type(node);
+    if (NULL == type)
+    {
+        return false;
+    }
 
-        return true;
+    if (is_signed)
+    {
+        return TYPE_is_signed(type);
     }
 
-    (void) TYPE_free_type(lhs_t);
-    lhs_t = NULL;
-    (void) TYPE_free_type(rhs_t);
-    rhs_t = NULL;
-    return false;
+    return (TYPE_UINT8 == type->type) || (TYPE_UINT16 == type->type)
+        || (TYPE_UINT32 == type->type) || (TYPE_UINT64 == type->type);
 }
 
 /**
- * @brief Cast a null to be a null of the other type if one of the hand sides is
- * null.
+ * @brief Build a binary operation, marking integer addition, subtraction and
+ * multiplication as not overflowing when the operands allow it.
  *
- * @param[in,out] lhs the left hand side.
- * @param[in,out] rhs the right hand side.
+ * @details Signed arithmetic gets `nsw`, and unsigned arithmetic gets `nuw` if
+ * overflow is strict. Nothing is marked if the signedness of the operands is
+ * unknown or differs, or if the operator wraps, such as `+%`.
+ *
+ * @param[in] n the binary expression AST node.
+ * @param[in] opcode the LLVM opcode of the operation.
+ * @param[in] lhs the left operand.
+ * @param[in] rhs the right operand.
+ * @param[in] builder the LLVM IR builder.
+ * @param[in] name the name of the built value.
  * @param[in] logger a logger that can be used to log messages.
  *
- * @return whether a cast has happend.
+ * @return the built binary operation.
  */
-static bool gen_llvm_cast_null_if_needed(LLVMValueRef *lhs, LLVMValueRef *rhs,
-                                         t_logger *logger)
+static LLVMValueRef gen_build_binop(const t_ast_node *n, LLVMOpcode opcode,
+                                    LLVMValueRef lhs, LLVMValueRef rhs,
+                                    LLVMBuilderRef builder, const char *name,
+                                    t_logger *logger)
 {
-    t_type *lhs_t = gen_llvm_type_to_ttype(LLVMTypeOf(*lhs), logger);
-    t_type *rhs_t = gen_llvm_type_to_ttype(LLVMTypeOf(*rhs), logger);
-    bool lhs_null = LLVMIsAConstantPointerNull(*lhs);
-    bool rhs_null = LLVMIsAConstantPointerNull(*rhs);
+    t_ast_binop_type op = n->binary_expr.operator;
+    bool wraps = (BINOP_ADD_WRAP == op) || (BINOP_SUB_WRAP == op)
+              || (BINOP_MUL_WRAP == op);
+    bool no_signed_wrap = false, no_unsigned_wrap = false;
 
-    if (lhs_null || rhs_null)
+    if (wraps && gen_llvm_is_floating_type(LLVMTypeOf(lhs)))
     {
-        if (lhs_null && !rhs_null)
+        LOGGER_LOG_LOC(logger, L_ERROR, n->token,
+                       "Wrapping operators are only defined on integers.\n",
+                       NULL);
+        exit(LUKA_CODEGEN_ERROR);
+    }
+
+    no_signed_wrap = !wraps && gen_is_integer_expr(n->binary_expr.lhs, true)
+                  && gen_is_integer_expr(n->binary_expr.rhs, true);
+    no_unsigned_wrap = !wraps && strict_overflow
+                    && gen_is_integer_expr(n->binary_expr.lhs, false)
+                    && gen_is_integer_expr(n->binary_expr.rhs, false);
+
+    if (LLVMAdd == opcode)
+    {
+        if (no_signed_wrap)
         {
-            *lhs = LLVMConstPointerNull(LLVMTypeOf(*rhs));
+            return LLVMBuildNSWAdd(builder, lhs, rhs, name);
         }
-        else if (!lhs_null && rhs_null)
+
+        if (no_unsigned_wrap)
         {
-            *rhs = LLVMConstPointerNull(LLVMTypeOf(*lhs));
+            return LLVMBuildNUWAdd(builder, lhs, rhs, name);
         }
-        else
+    }
+    else if (LLVMSub == opcode)
+    {
+        if (no_signed_wrap)
         {
-            *lhs = LLVMConstPointerNull(LLVMTypeOf(*rhs));
+            return LLVMBuildNSWSub(builder, lhs, rhs, name);
         }
 
-        (void) TYPE_free_type(lhs_t);
-        lhs_t = NULL;
-        (void) TYPE_free_type(rhs_t);
-        rhs_t = NULL;
+        if (no_unsigned_wrap)
+        {
+            return LLVMBuildNUWSub(builder, lhs, rhs, name);
+        }
+    }
+    else if (LLVMMul == opcode)
+    {
+        if (no_signed_wrap)
+        {
+            return LLVMBuildNSWMul(builder, lhs, rhs, name);
+        }
 
-        return true;
+        if (no_unsigned_wrap)
+        {
+            return LLVMBuildNUWMul(builder, lhs, rhs, name);
+        }
     }
 
-    (void) TYPE_free_type(lhs_t);
-    lhs_t = NULL;
-    (void) TYPE_free_type(rhs_t);
-    rhs_t = NULL;
-    return false;
+    return LLVMBuildBinOp(builder, opcode, lhs, rhs, name);
 }
 
 /**
- * @brief Get LLVM opcode for the binary operator `op` and cast `lhs` and `rhs`
- * if needed.
+ * @brief Get the name in LLVM IR of a floating point instruction that can have
+ * fast-math flags.
  *
- * @param[in] op the binary operator.
- * @param[in,out] lhs a pointer to the left operand of the binary expression.
- * @param[in,out] rhs a pointer to the right operand of the binary expression.
- * @param[in] builder the LLVM IR builder.
- * @param[in] logger a logger that can be used to log messages.
+ * @param[in] opcode the opcode of the instruction.
+ *
+ * @return the name of the instruction, or NULL if it can't have fast-math
+ * flags.
  */
-static LLVMOpcode gen_get_llvm_opcode(t_ast_binop_type op, LLVMValueRef *lhs,
-                                      LLVMValueRef *rhs, LLVMBuilderRef builder,
-                                      t_logger *logger)
+static const char *gen_fast_math_instruction_name(LLVMOpcode opcode)
 {
-    switch (op)
+    if (LLVMFAdd == opcode)
     {
-        case BINOP_ADD:
-            if (gen_llvm_cast_to_fp_if_needed(lhs, rhs, builder, logger))
-            {
-                return LLVMFAdd;
-            }
+        return "fadd";
+    }
+    else if (LLVMFSub == opcode)
+    {
+        return "fsub";
+    }
+    else if (LLVMFMul == opcode)
+    {
+        return "fmul";
+    }
+    else if (LLVMFDiv == opcode)
+    {
+        return "fdiv";
+    }
+    else if (LLVMFRem == opcode)
+    {
+        return "frem";
+    }
+    else if (LLVMFNeg == opcode)
+    {
+        return "fneg";
+    }
+    else if (LLVMFCmp == opcode)
+    {
+        return "fcmp";
+    }
 
-            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
-            return LLVMAdd;
-        case BINOP_SUBTRACT:
-            if (gen_llvm_cast_to_fp_if_needed(lhs, rhs, builder, logger))
-            {
-                return LLVMFSub;
-            }
+    return NULL;
+}
 
-            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
-            return LLVMSub;
-        case BINOP_MULTIPLY:
-            if (gen_llvm_cast_to_fp_if_needed(lhs, rhs, builder, logger))
-            {
-                return LLVMFMul;
-            }
+/**
+ * @brief Get an instruction with the fast-math flags of the current function
+ * to clone, parsing it the first time it is needed.
+ *
+ * @param[in] value the floating point instruction to get a template for.
+ * @param[in] name the name of the instruction in LLVM IR, such as `fadd`.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return an instruction with the opcode, predicate and operand types of
+ * @p value and with fast-math flags.
+ */
+static LLVMValueRef gen_fast_math_template(LLVMValueRef value, const char *name,
+                                           t_logger *logger)
+{
+    char ir[512] = {0}, flags[64] = {0}, *type = NULL, *error = NULL;
+    const char *predicate = "";
+    t_fast_math_template *template = NULL;
+    LLVMMemoryBufferRef buffer = NULL;
+    size_t i = 0;
 
-            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
-            return LLVMMul;
-        case BINOP_DIVIDE:
-            if (gen_llvm_cast_to_fp_if_needed(lhs, rhs, builder, logger))
-            {
-                return LLVMFDiv;
-            }
+    for (i = 0;
+         i < sizeof(GEN_FAST_MATH_FLAGS) / sizeof(GEN_FAST_MATH_FLAGS[0]); ++i)
+    {
+        if (0 != (fast_math_flags & GEN_FAST_MATH_FLAGS[i].flag))
+        {
+            (void) strcat(flags, GEN_FAST_MATH_FLAGS[i].name);
+            (void) strcat(flags, " ");
+        }
+    }
 
-            if (gen_llvm_cast_to_signed_if_needed(lhs, rhs, builder, logger))
-            {
-                return LLVMSDiv;
-            }
+    if (LLVMFCmp == LLVMGetInstructionOpcode(value))
+    {
+        predicate = GEN_REAL_PREDICATE_NAMES[LLVMGetFCmpPredicate(value)];
+    }
 
-            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
-            return LLVMUDiv;
-        case BINOP_MODULOS:
-            if (gen_llvm_cast_to_fp_if_needed(lhs, rhs, builder, logger))
-            {
-                return LLVMFRem;
-            }
+    type = LLVMPrintTypeToString(LLVMTypeOf(LLVMGetOperand(value, 0)));
+    (void) snprintf(ir, sizeof(ir),
+                    "define void @template(%s %%lhs, %s %%rhs) {\n"
+                    "  %%value = %s %s%s %s %%lhs%s\n"
+                    "  ret void\n"
+                    "}\n",
+                    type, type, name, flags, predicate, type,
+                    (1 == LLVMGetNumOperands(value)) ? "" : ", %rhs");
+    (void) LLVMDisposeMessage(type);
 
-            if (gen_llvm_cast_to_signed_if_needed(lhs, rhs, builder, logger))
-            {
-                return LLVMSRem;
-            }
+    HASH_FIND_STR(fast_math_templates, ir, template);
+    if (NULL != template)
+    {
+        return template->instruction;
+    }
 
-            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
-            return LLVMURem;
-        case BINOP_BAND:
-            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
-            return LLVMAnd;
-        case BINOP_BOR:
-            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
-            return LLVMOr;
-        case BINOP_BXOR:
-            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
-            return LLVMXor;
-        case BINOP_SHL:
-            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
-            return LLVMShl;
-        case BINOP_SHR:
-            if (gen_llvm_cast_to_signed_if_needed(lhs, rhs, builder, logger))
-            {
-                return LLVMAShr;
-            }
+    template = calloc(1, sizeof(t_fast_math_template));
+    if (NULL == template)
+    {
+        (void) LOGGER_log(logger, L_ERROR,
+                          "Couldn't allocate memory for fast-math template.\n");
+        exit(LUKA_CANT_ALLOC_MEMORY);
+    }
 
-            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
-            return LLVMLShr;
-        case BINOP_EQUALS:
-        case BINOP_GEQ:
-        case BINOP_GREATER:
-        case BINOP_LEQ:
-        case BINOP_LESSER:
-        case BINOP_NEQ:
-            {
-                (void) LOGGER_log(logger, L_ERROR,
-                                  "No handler found for op: %d\n", op);
-                exit(LUKA_CODEGEN_ERROR);
-            }
+    /* Parsing takes ownership of the buffer */
+    buffer
+        = LLVMCreateMemoryBufferWithMemoryRangeCopy(ir, strlen(ir), "template");
+    if (0
+        != LLVMParseIRInContext(LLVMGetGlobalContext(), buffer,
+                                &template->module, &error))
+    {
+        (void) LOGGER_log(logger, L_ERROR,
+                          "Couldn't build a fast-math instruction:\n%s\n",
+                          error);
+        exit(LUKA_CODEGEN_ERROR);
     }
+
+    template->ir = strdup(ir);
+    template->instruction = LLVMGetFirstInstruction(LLVMGetEntryBasicBlock(
+        LLVMGetNamedFunction(template->module, "template")));
+    HASH_ADD_KEYPTR(hh, fast_math_templates, template->ir,
+                    strlen(template->ir), template);
+    return template->instruction;
 }
 
 /**
- * @brief Checks if the comparison between `lhs` and `rhs` will be an integer
- * comparison.
+ * @brief Give a floating point instruction the fast-math flags of the current
+ * function.
  *
- * @param[in] lhs the left operand of the comparison.
- * @param[in] rhs the right operand of the comparison.
+ * @details The LLVM C API can't set fast-math flags, so @p value is replaced
+ * with a clone of an instruction that was parsed from IR with the flags.
+ *
+ * @param[in] builder the LLVM IR builder that has just built @p value.
+ * @param[in] value the built value.
  * @param[in] logger a logger that can be used to log messages.
  *
- * @return whether the comparison will be an integer comparison.
+ * @return the instruction with fast-math flags, or @p value if it isn't a
+ * floating point instruction or if there are no flags to give.
  */
-static bool gen_is_icmp(LLVMValueRef lhs, LLVMValueRef rhs, t_logger *logger)
+static LLVMValueRef gen_set_fast_math_flags(LLVMBuilderRef builder,
+                                            LLVMValueRef value,
+                                            t_logger *logger)
 {
-    t_type *lhs_t = gen_llvm_type_to_ttype(LLVMTypeOf(lhs), logger);
-    t_type *rhs_t = gen_llvm_type_to_ttype(LLVMTypeOf(rhs), logger);
-    bool is_icmp
-        = !TYPE_is_floating_type(lhs_t) && !TYPE_is_floating_type(rhs_t);
+    LLVMValueRef instruction = NULL;
+    const char *name = NULL;
+    char *value_name = NULL;
+    size_t length = 0;
+    int i = 0;
 
-    (void) TYPE_free_type(lhs_t);
-    lhs_t = NULL;
-    (void) TYPE_free_type(rhs_t);
-    rhs_t = NULL;
+    if ((0 == fast_math_flags) || (NULL == LLVMIsAInstruction(value)))
+    {
+        return value;
+    }
 
-    return is_icmp;
+    name = gen_fast_math_instruction_name(LLVMGetInstructionOpcode(value));
+    if (NULL == name)
+    {
+        return value;
+    }
+
+    instruction
+        = LLVMInstructionClone(gen_fast_math_template(value, name, logger));
+    for (i = 0; i < LLVMGetNumOperands(value); ++i)
+    {
+        (void) LLVMSetOperand(instruction, (unsigned int) i,
+                              LLVMGetOperand(value, (unsigned int) i));
+    }
+
+    value_name = strdup(LLVMGetValueName2(value, &length));
+    (void) LLVMInstructionEraseFromParent(value);
+    (void) LLVMInsertIntoBuilderWithName(builder, instruction, value_name);
+    (void) free(value_name);
+    return instruction;
 }
 
 /**
- * @brief Get a LLVM integer comparison opcode for `op`.
+ * @brief Tell the backend which floating point optimizations the fast-math
+ * flags of the current function allow.
+ *
+ * @param[in] func the LLVM function.
+ */
+static void gen_add_fast_math_attributes(LLVMValueRef func)
+{
+    static const struct
+    {
+        const char *name;
+        unsigned int flags;
+    } attributes[] = {
+        {"no-nans-fp-math", GEN_FAST_MATH_NNAN},
+        {"no-infs-fp-math", GEN_FAST_MATH_NINF},
+        {"no-signed-zeros-fp-math", GEN_FAST_MATH_NSZ},
+        {"approx-func-fp-math", GEN_FAST_MATH_AFN},
+        {"unsafe-fp-math", GEN_FAST_MATH_ALL},
+    };
+    size_t i = 0;
+
+    for (i = 0; i < sizeof(attributes) / sizeof(attributes[0]); ++i)
+    {
+        if (attributes[i].flags == (fast_math_flags & attributes[i].flags))
+        {
+            (void) LLVMAddAttributeAtIndex(
+                func, LLVMAttributeFunctionIndex,
+                LLVMCreateStringAttribute(
+                    LLVMGetGlobalContext(), attributes[i].name,
+                    (unsigned int) strlen(attributes[i].name), "true",
+                    (unsigned int) strlen("true")));
+        }
+    }
+}
+
+/**
+ * @brief Convert a scalar or a vector to another scalar or vector type with as
+ * many lanes, converting every lane by value.
  *
- * @param[in] op the binary operator.
- * @param[in,out] lhs the left operand of the comparison.
- * @param[in,out] rhs the right operand of the comparison.
  * @param[in] builder the LLVM IR builder.
- * @param[in] logger a logger that can be used to log messages.
+ * @param[in] value the value to convert.
+ * @param[in] dest_type the type to convert to.
+ * @param[in] is_signed whether integer lanes of @p value, or of the result if
+ * @p value is floating point, are signed.
  *
- * @return an integer predicate for the comparison.
+ * @return the converted value.
  */
-static LLVMIntPredicate gen_llvm_get_int_predicate(t_ast_binop_type op,
-                                                   LLVMValueRef *lhs,
-                                                   LLVMValueRef *rhs,
-                                                   LLVMBuilderRef builder,
-                                                   t_logger *logger)
+static LLVMValueRef gen_codegen_lane_cast(LLVMBuilderRef builder,
+                                          LLVMValueRef value,
+                                          LLVMTypeRef dest_type, bool is_signed)
 {
-    switch (op)
-    {
-        case BINOP_LESSER:
-            if (gen_llvm_cast_to_signed_if_needed(lhs, rhs, builder, logger))
-            {
-                (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
-                return LLVMIntSLT;
-            }
+    bool is_float = gen_llvm_is_floating_type(LLVMTypeOf(value));
+    bool dest_is_float = gen_llvm_is_floating_type(dest_type);
 
-            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
-            return LLVMIntULT;
-        case BINOP_GREATER:
-            if (gen_llvm_cast_to_signed_if_needed(lhs, rhs, builder, logger))
-            {
-                (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
-                return LLVMIntSGT;
-            }
+    if (LLVMTypeOf(value) == dest_type)
+    {
+        return value;
+    }
 
-            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
-            return LLVMIntUGT;
-        case BINOP_EQUALS:
-            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
-            return LLVMIntEQ;
-        case BINOP_NEQ:
-            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
-            return LLVMIntNE;
-        case BINOP_LEQ:
-            if (gen_llvm_cast_to_signed_if_needed(lhs, rhs, builder, logger))
-            {
-                (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
-                return LLVMIntSLE;
-            }
+    if (is_float && dest_is_float)
+    {
+        return LLVMBuildFPCast(builder, value, dest_type, "fpcasttmp");
+    }
 
-            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
-            return LLVMIntULE;
-        case BINOP_GEQ:
-            if (gen_llvm_cast_to_signed_if_needed(lhs, rhs, builder, logger))
-            {
-                (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
-                return LLVMIntSGE;
-            }
+    if (is_float)
+    {
+        return is_signed
+                 ? LLVMBuildFPToSI(builder, value, dest_type, "fptositmp")
+                 : LLVMBuildFPToUI(builder, value, dest_type, "fptouitmp");
+    }
 
-            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
-            return LLVMIntUGE;
-        case BINOP_ADD:
-        case BINOP_DIVIDE:
-        case BINOP_MODULOS:
-        case BINOP_MULTIPLY:
-        case BINOP_SUBTRACT:
-        case BINOP_BAND:
-        case BINOP_BOR:
-        case BINOP_BXOR:
-        case BINOP_SHL:
-        case BINOP_SHR:
-            {
-                (void) LOGGER_log(logger, L_ERROR,
-                                  "Op %d is not a int comparison operator.\n",
-                                  op);
-                exit(LUKA_CODEGEN_ERROR);
-            }
+    if (dest_is_float)
+    {
+        return is_signed
+                 ? LLVMBuildSIToFP(builder, value, dest_type, "sitofptmp")
+                 : LLVMBuildUIToFP(builder, value, dest_type, "uitofptmp");
     }
+
+    return LLVMBuildIntCast2(builder, value, dest_type, is_signed,
+                             "intcasttmp");
 }
 
 /**
- * @brief Get a LLVM real comparison opcode for `op`.
+ * @brief Align a load or a store of a vector to its lanes, since vectors are
+ * often loaded from and stored to arrays that are only aligned to their
+ * elements.
  *
- * @param[in] op the binary operator.
- * @param[in,out] lhs the left operand of the comparison.
- * @param[in,out] rhs the right operand of the comparison.
  * @param[in] builder the LLVM IR builder.
- * @param[in] logger a logger that can be used to log messages.
+ * @param[in] instruction the load or store instruction.
+ * @param[in] vector_type the LLVM vector type that is loaded or stored.
+ */
+static void gen_set_lane_alignment(LLVMBuilderRef builder,
+                                   LLVMValueRef instruction,
+                                   LLVMTypeRef vector_type)
+{
+    LLVMModuleRef module = LLVMGetGlobalParent(
+        LLVMGetBasicBlockParent(LLVMGetInsertBlock(builder)));
+
+    (void) LLVMSetAlignment(
+        instruction,
+        LLVMABIAlignmentOfType(LLVMGetModuleDataLayout(module),
+                               LLVMGetElementType(vector_type)));
+}
+
+/**
+ * @brief Broadcast a scalar to every lane of a vector.
  *
- * @return a real predicate for the comparison.
+ * @param[in] builder the LLVM IR builder.
+ * @param[in] scalar the scalar, converted to the element type if needed.
+ * @param[in] vector_type the LLVM vector type.
+ * @param[in] is_signed whether @p scalar is a signed integer.
+ *
+ * @return a vector with @p scalar in every lane.
  */
-static LLVMRealPredicate gen_llvm_get_real_predicate(t_ast_binop_type op,
-                                                     LLVMValueRef *lhs,
-                                                     LLVMValueRef *rhs,
-                                                     LLVMBuilderRef builder,
-                                                     t_logger *logger)
+static LLVMValueRef gen_codegen_splat(LLVMBuilderRef builder,
+                                      LLVMValueRef scalar,
+                                      LLVMTypeRef vector_type, bool is_signed)
 {
-    (void) gen_llvm_cast_to_fp_if_needed(lhs, rhs, builder, logger);
-    switch (op)
-    {
-        case BINOP_LESSER:
-            return LLVMRealOLE;
-        case BINOP_GREATER:
-            return LLVMRealOGT;
-        case BINOP_EQUALS:
-            return LLVMRealOEQ;
-        case BINOP_NEQ:
-            return LLVMRealONE;
-        case BINOP_LEQ:
-            return LLVMRealOLE;
-        case BINOP_GEQ:
-            return LLVMRealOGE;
+    LLVMValueRef vector = NULL;
+
+    scalar = gen_codegen_lane_cast(
+        builder, scalar, LLVMGetElementType(vector_type), is_signed);
+    vector = LLVMBuildInsertElement(builder, LLVMGetUndef(vector_type), scalar,
+                                    LLVMConstInt(LLVMInt32Type(), 0, false),
+                                    "splatinserttmp");
+    return LLVMBuildShuffleVector(
+        builder, vector, LLVMGetUndef(vector_type),
+        LLVMConstNull(
+            LLVMVectorType(LLVMInt32Type(), LLVMGetVectorSize(vector_type))),
+        "splattmp");
+}
+
+/**
+ * @brief Convert a value to a vector type.
+ *
+ * @details Scalars are broadcast to every lane, vectors are converted lane by
+ * lane and pointers to arrays, which is what array literals evaluate to, are
+ * loaded as vectors.
+ *
+ * @param[in] builder the LLVM IR builder.
+ * @param[in] value the value to convert.
+ * @param[in] dest_type the LLVM vector type.
+ * @param[in] is_signed whether integer lanes of @p value are signed.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return the value converted to @p dest_type.
+ */
+static LLVMValueRef gen_codegen_vector_cast(LLVMBuilderRef builder,
+                                            LLVMValueRef value,
+                                            LLVMTypeRef dest_type,
+                                            bool is_signed, t_logger *logger)
+{
+    LLVMTypeRef type = LLVMTypeOf(value);
+    LLVMTypeKind type_kind = LLVMGetTypeKind(type);
+    LLVMTypeRef array_type = NULL;
+    LLVMValueRef load = NULL;
+
+    if ((LLVMVectorTypeKind == type_kind)
+        && (LLVMGetVectorSize(type) == LLVMGetVectorSize(dest_type)))
+    {
+        return gen_codegen_lane_cast(builder, value, dest_type, is_signed);
+    }
+
+    if ((LLVMIntegerTypeKind == type_kind) || (LLVMFloatTypeKind == type_kind)
+        || (LLVMDoubleTypeKind == type_kind))
+    {
+        return gen_codegen_splat(builder, value, dest_type, is_signed);
+    }
+
+    if (LLVMPointerTypeKind == type_kind)
+    {
+        array_type = LLVMGetElementType(type);
+        if ((LLVMArrayTypeKind == LLVMGetTypeKind(array_type))
+            && (LLVMGetArrayLength(array_type) == LLVMGetVectorSize(dest_type)))
+        {
+            type = LLVMVectorType(LLVMGetElementType(array_type),
+                                  LLVMGetVectorSize(dest_type));
+            value = LLVMBuildBitCast(builder, value, LLVMPointerType(type, 0),
+                                     "vecptrtmp");
+            load = LLVMBuildLoad2(builder, type, value, "vecloadtmp");
+            (void) gen_set_lane_alignment(builder, load, type);
+            return gen_codegen_lane_cast(builder, load, dest_type, is_signed);
+        }
+    }
+
+    (void) LLVMDumpType(LLVMTypeOf(value));
+    (void) LOGGER_log(logger, L_ERROR,
+                      "\nCan't convert this type to a vector of %u lanes.\n",
+                      LLVMGetVectorSize(dest_type));
+    exit(LUKA_CODEGEN_ERROR);
+}
+
+/**
+ * @brief Cast a LLVM value to a new type.
+ *
+ * @param[in] builder the LLVM IR builder.
+ * @param[in] original_value the value that should be casted.
+ * @param[in] dest_type the type the value should be casted to.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return the value casted to the `dest_type`.
+ */
+static LLVMValueRef gen_codegen_cast(LLVMBuilderRef builder,
+                                     LLVMValueRef original_value,
+                                     LLVMTypeRef dest_type, t_logger *logger)
+{
+    LLVMTypeRef type = LLVMTypeOf(original_value);
+
+    if ((LLVMArrayTypeKind == LLVMGetTypeKind(type))
+        && (LLVMPointerTypeKind == LLVMGetTypeKind(dest_type)))
+    {
+        return original_value;
+    }
+
+    if (LLVMVectorTypeKind == LLVMGetTypeKind(dest_type))
+    {
+        return gen_codegen_vector_cast(builder, original_value, dest_type,
+                                       true, logger);
+    }
+
+    if ((LLVMPointerTypeKind == LLVMGetTypeKind(type))
+        && (LLVMPointerTypeKind == LLVMGetTypeKind(dest_type)))
+    {
+        return LLVMBuildPointerCast(builder, original_value, dest_type,
+                                    "ptrcasttmp");
+    }
+
+    return LLVMBuildCast(builder, gen_llvm_get_cast_op(type, dest_type, logger),
+                         original_value, dest_type, "casttmp");
+}
+
+/**
+ * @brief Cast both hand sides to floating point if one of them is a floating
+ * point type.
+ *
+ * @param[in,out] lhs the left hand side.
+ * @param[in,out] rhs the right hand side.
+ * @param[in] builder the LLVM IR builder.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return whether a cast has happend.
+ */
+static bool gen_llvm_cast_to_fp_if_needed(LLVMValueRef *lhs, LLVMValueRef *rhs,
+                                          LLVMBuilderRef builder,
+                                          t_logger *logger)
+{
+    t_type *lhs_t = gen_llvm_type_to_ttype(LLVMTypeOf(*lhs), logger);
+    t_type *rhs_t = gen_llvm_type_to_ttype(LLVMTypeOf(*rhs), logger);
+
+    if (TYPE_is_floating_type(lhs_t) || TYPE_is_floating_type(rhs_t))
+    {
+        if (TYPE_is_floating_type(lhs_t) && !TYPE_is_floating_type(rhs_t))
+        {
+            if (TYPE_is_signed(rhs_t))
+            {
+                *rhs = LLVMBuildSIToFP(builder, *rhs, LLVMTypeOf(*lhs),
+                                       "sitofpcasttmp");
+            }
+            else
+            {
+                *rhs = LLVMBuildUIToFP(builder, *rhs, LLVMTypeOf(*lhs),
+                                       "uitofpcasttmp");
+            }
+        }
+        else if (!TYPE_is_floating_type(lhs_t) && TYPE_is_floating_type(rhs_t))
+        {
+            if (TYPE_is_signed(lhs_t))
+            {
+                *lhs = LLVMBuildSIToFP(builder, *lhs, LLVMTypeOf(*rhs),
+                                       "sitofpcasttmp");
+            }
+            else
+            {
+                *lhs = LLVMBuildUIToFP(builder, *lhs, LLVMTypeOf(*rhs),
+                                       "uitofpcasttmp");
+            }
+        }
+
+        (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
+
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Cast both hand sides to signed if one of them is a signed type.
+ *
+ * @param[in,out] lhs the left hand side.
+ * @param[in,out] rhs the right hand side.
+ * @param[in] builder the LLVM IR builder.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return whether a cast has happend.
+ */
+static bool gen_llvm_cast_to_signed_if_needed(LLVMValueRef *lhs,
+                                              LLVMValueRef *rhs,
+                                              LLVMBuilderRef builder,
+                                              t_logger *logger)
+{
+    t_type *lhs_t = gen_llvm_type_to_ttype(LLVMTypeOf(*lhs), logger);
+    t_type *rhs_t = gen_llvm_type_to_ttype(LLVMTypeOf(*rhs), logger);
+
+    if (TYPE_is_signed(lhs_t) || TYPE_is_signed(rhs_t))
+    {
+        if (TYPE_is_signed(lhs_t) && !TYPE_is_signed(rhs_t))
+        {
+            *rhs = LLVMBuildIntCast2(builder, *rhs, LLVMTypeOf(*lhs), true,
+                                     "signedcasttmp");
+        }
+        else if (!TYPE_is_signed(lhs_t) && TYPE_is_signed(rhs_t))
+        {
+            *lhs = LLVMBuildIntCast2(builder, *lhs, LLVMTypeOf(*rhs), true,
+                                     "signedcasttmp");
+        }
+
+        (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
+
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Cast a null to be a null of the other type if one of the hand sides is
+ * null.
+ *
+ * @param[in,out] lhs the left hand side.
+ * @param[in,out] rhs the right hand side.
+ *
+ * @return whether a cast has happend.
+ */
+static bool gen_llvm_cast_null_if_needed(LLVMValueRef *lhs, LLVMValueRef *rhs)
+{
+    bool lhs_null = LLVMIsAConstantPointerNull(*lhs);
+    bool rhs_null = LLVMIsAConstantPointerNull(*rhs);
+
+    if (lhs_null || rhs_null)
+    {
+        if (lhs_null && !rhs_null)
+        {
+            *lhs = LLVMConstPointerNull(LLVMTypeOf(*rhs));
+        }
+        else if (!lhs_null && rhs_null)
+        {
+            *rhs = LLVMConstPointerNull(LLVMTypeOf(*lhs));
+        }
+        else
+        {
+            *lhs = LLVMConstPointerNull(LLVMTypeOf(*rhs));
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Get LLVM opcode for the binary operator `op` and cast `lhs` and `rhs`
+ * if needed.
+ *
+ * @param[in] op the binary operator.
+ * @param[in,out] lhs a pointer to the left operand of the binary expression.
+ * @param[in,out] rhs a pointer to the right operand of the binary expression.
+ * @param[in] builder the LLVM IR builder.
+ * @param[in] logger a logger that can be used to log messages.
+ */
+static LLVMOpcode gen_get_llvm_opcode(t_ast_binop_type op, LLVMValueRef *lhs,
+                                      LLVMValueRef *rhs, LLVMBuilderRef builder,
+                                      t_logger *logger)
+{
+    switch (op)
+    {
         case BINOP_ADD:
+        case BINOP_ADD_WRAP:
+            if (gen_llvm_cast_to_fp_if_needed(lhs, rhs, builder, logger))
+            {
+                return LLVMFAdd;
+            }
+
+            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
+            return LLVMAdd;
+        case BINOP_SUBTRACT:
+        case BINOP_SUB_WRAP:
+            if (gen_llvm_cast_to_fp_if_needed(lhs, rhs, builder, logger))
+            {
+                return LLVMFSub;
+            }
+
+            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
+            return LLVMSub;
+        case BINOP_MULTIPLY:
+        case BINOP_MUL_WRAP:
+            if (gen_llvm_cast_to_fp_if_needed(lhs, rhs, builder, logger))
+            {
+                return LLVMFMul;
+            }
+
+            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
+            return LLVMMul;
         case BINOP_DIVIDE:
+            if (gen_llvm_cast_to_fp_if_needed(lhs, rhs, builder, logger))
+            {
+                return LLVMFDiv;
+            }
+
+            if (gen_llvm_cast_to_signed_if_needed(lhs, rhs, builder, logger))
+            {
+                return LLVMSDiv;
+            }
+
+            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
+            return LLVMUDiv;
         case BINOP_MODULOS:
-        case BINOP_MULTIPLY:
-        case BINOP_SUBTRACT:
-        case BINOP_BAND:
-        case BINOP_BOR:
+            if (gen_llvm_cast_to_fp_if_needed(lhs, rhs, builder, logger))
+            {
+                return LLVMFRem;
+            }
+
+            if (gen_llvm_cast_to_signed_if_needed(lhs, rhs, builder, logger))
+            {
+                return LLVMSRem;
+            }
+
+            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
+            return LLVMURem;
+        case BINOP_BAND:
+            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
+            return LLVMAnd;
+        case BINOP_BOR:
+            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
+            return LLVMOr;
+        case BINOP_BXOR:
+            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
+            return LLVMXor;
+        case BINOP_SHL:
+            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
+            return LLVMShl;
+        case BINOP_SHR:
+            if (gen_llvm_cast_to_signed_if_needed(lhs, rhs, builder, logger))
+            {
+                return LLVMAShr;
+            }
+
+            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
+            return LLVMLShr;
+        case BINOP_EQUALS:
+        case BINOP_GEQ:
+        case BINOP_GREATER:
+        case BINOP_LEQ:
+        case BINOP_LESSER:
+        case BINOP_NEQ:
+        case BINOP_LAND:
+        case BINOP_LOR:
+            {
+                (void) LOGGER_log(logger, L_ERROR,
+                                  "No handler found for op: %d\n", op);
+                exit(LUKA_CODEGEN_ERROR);
+            }
+    }
+}
+
+/**
+ * @brief Checks if the comparison between `lhs` and `rhs` will be an integer
+ * comparison.
+ *
+ * @param[in] lhs the left operand of the comparison.
+ * @param[in] rhs the right operand of the comparison.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return whether the comparison will be an integer comparison.
+ */
+static bool gen_is_icmp(LLVMValueRef lhs, LLVMValueRef rhs, t_logger *logger)
+{
+    t_type *lhs_t = gen_llvm_type_to_ttype(LLVMTypeOf(lhs), logger);
+    t_type *rhs_t = gen_llvm_type_to_ttype(LLVMTypeOf(rhs), logger);
+    bool is_icmp
+        = !TYPE_is_floating_type(lhs_t) && !TYPE_is_floating_type(rhs_t);
+
+    return is_icmp;
+}
+
+/**
+ * @brief Get a LLVM integer comparison opcode for `op`.
+ *
+ * @param[in] op the binary operator.
+ * @param[in,out] lhs the left operand of the comparison.
+ * @param[in,out] rhs the right operand of the comparison.
+ * @param[in] builder the LLVM IR builder.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return an integer predicate for the comparison.
+ */
+static LLVMIntPredicate gen_llvm_get_int_predicate(t_ast_binop_type op,
+                                                   LLVMValueRef *lhs,
+                                                   LLVMValueRef *rhs,
+                                                   LLVMBuilderRef builder,
+                                                   t_logger *logger)
+{
+    switch (op)
+    {
+        case BINOP_LESSER:
+            if (gen_llvm_cast_to_signed_if_needed(lhs, rhs, builder, logger))
+            {
+                (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
+                return LLVMIntSLT;
+            }
+
+            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
+            return LLVMIntULT;
+        case BINOP_GREATER:
+            if (gen_llvm_cast_to_signed_if_needed(lhs, rhs, builder, logger))
+            {
+                (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
+                return LLVMIntSGT;
+            }
+
+            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
+            return LLVMIntUGT;
+        case BINOP_EQUALS:
+            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
+            return LLVMIntEQ;
+        case BINOP_NEQ:
+            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
+            return LLVMIntNE;
+        case BINOP_LEQ:
+            if (gen_llvm_cast_to_signed_if_needed(lhs, rhs, builder, logger))
+            {
+                (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
+                return LLVMIntSLE;
+            }
+
+            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
+            return LLVMIntULE;
+        case BINOP_GEQ:
+            if (gen_llvm_cast_to_signed_if_needed(lhs, rhs, builder, logger))
+            {
+                (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
+                return LLVMIntSGE;
+            }
+
+            (void) gen_llvm_cast_sizes_if_needed(lhs, rhs, builder, logger);
+            return LLVMIntUGE;
+        case BINOP_ADD:
+        case BINOP_DIVIDE:
+        case BINOP_MODULOS:
+        case BINOP_MULTIPLY:
+        case BINOP_SUBTRACT:
+        case BINOP_BAND:
+        case BINOP_BOR:
+        case BINOP_BXOR:
+        case BINOP_SHL:
+        case BINOP_SHR:
+        case BINOP_ADD_WRAP:
+        case BINOP_SUB_WRAP:
+        case BINOP_MUL_WRAP:
+        case BINOP_LAND:
+        case BINOP_LOR:
+            {
+                (void) LOGGER_log(logger, L_ERROR,
+                                  "Op %d is not a int comparison operator.\n",
+                                  op);
+                exit(LUKA_CODEGEN_ERROR);
+            }
+    }
+}
+
+/**
+ * @brief Get a LLVM real comparison opcode for `op`.
+ *
+ * @param[in] op the binary operator.
+ * @param[in,out] lhs the left operand of the comparison.
+ * @param[in,out] rhs the right operand of the comparison.
+ * @param[in] builder the LLVM IR builder.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return a real predicate for the comparison.
+ */
+static LLVMRealPredicate gen_llvm_get_real_predicate(t_ast_binop_type op,
+                                                     LLVMValueRef *lhs,
+                                                     LLVMValueRef *rhs,
+                                                     LLVMBuilderRef builder,
+                                                     t_logger *logger)
+{
+    (void) gen_llvm_cast_to_fp_if_needed(lhs, rhs, builder, logger);
+    switch (op)
+    {
+        case BINOP_LESSER:
+            return LLVMRealOLT;
+        case BINOP_GREATER:
+            return LLVMRealOGT;
+        case BINOP_EQUALS:
+            return LLVMRealOEQ;
+        case BINOP_NEQ:
+            return LLVMRealONE;
+        case BINOP_LEQ:
+            return LLVMRealOLE;
+        case BINOP_GEQ:
+            return LLVMRealOGE;
+        case BINOP_ADD:
+        case BINOP_DIVIDE:
+        case BINOP_MODULOS:
+        case BINOP_MULTIPLY:
+        case BINOP_SUBTRACT:
+        case BINOP_BAND:
+        case BINOP_BOR:
         case BINOP_BXOR:
         case BINOP_SHL:
         case BINOP_SHR:
+        case BINOP_ADD_WRAP:
+        case BINOP_SUB_WRAP:
+        case BINOP_MUL_WRAP:
+        case BINOP_LAND:
+        case BINOP_LOR:
+            {
+                (void) LOGGER_log(logger, L_ERROR,
+                                  "Op %d is not a real comparison operator.\n",
+                                  op);
+                exit(LUKA_CODEGEN_ERROR);
+            }
+    }
+}
+
+/**
+ * @brief Get the address of the expression of `node`.
+ *
+ * @param[in] node the AST node.
+ */
+static LLVMValueRef gen_get_address(t_ast_node *node, LLVMModuleRef module,
+                                    LLVMBuilderRef builder, t_logger *logger)
+{
+    switch (node->type)
+    {
+        case AST_TYPE_VARIABLE:
+            {
+                t_named_value *val = NULL;
+
+                HASH_FIND_STR(named_values, node->variable.name, val);
+
+                if ((NULL != val) && (NULL != val->value))
+                {
+                    LOGGER_LOG_LOC(logger, L_ERROR, node->token,
+                                   "Can't get address of variable %s kept "
+                                   "in a register.\n",
+                                   node->variable.name);
+                    exit(LUKA_CODEGEN_ERROR);
+                }
+
+                if (NULL != val)
+                {
+                    return val->alloca_inst;
+                }
+
+                LOGGER_LOG_LOC(logger, L_ERROR, node->token,
+                               "Variable %s is undefined.\n",
+                               node->variable.name);
+                exit(LUKA_CODEGEN_ERROR);
+            }
+        case AST_TYPE_GET_EXPR:
+            {
+                t_named_value *variable = NULL;
+
+                if (NULL == node->get_expr.variable)
+                {
+                    LOGGER_LOG_LOC(logger, L_ERROR, node->token,
+                                   "Get expr variable name is null.\n", NULL);
+                    exit(LUKA_CODEGEN_ERROR);
+                }
+
+                HASH_FIND_STR(named_values,
+                              node->get_expr.variable->variable.name, variable);
+                if (NULL == variable)
+                {
+                    LOGGER_LOG_LOC(logger, L_ERROR, node->token,
+                                   "Couldn't find a variable named `%s`.\n",
+                                   node->get_expr.variable->variable.name);
+                    exit(LUKA_CODEGEN_ERROR);
+                }
+
+                return gen_get_struct_field_pointer(
+                    variable, node->get_expr.key, builder, logger);
+            }
+        case AST_TYPE_ARRAY_DEREF:
+            {
+                t_named_value *val = NULL;
+                LLVMTypeKind val_type_kind = LLVMIntegerTypeKind;
+                LLVMValueRef index = NULL;
+                LLVMValueRef ptr = NULL;
+
+                HASH_FIND_STR(named_values,
+                              node->array_deref.variable->variable.name, val);
+
+                if (NULL == val)
+                {
+                    LOGGER_LOG_LOC(logger, L_ERROR, node->token,
+                                   "Variable %s is undefined.\n",
+                                   node->array_deref.variable->variable.name);
+                    exit(LUKA_CODEGEN_ERROR);
+                }
+
+                val_type_kind = LLVMGetTypeKind(val->type);
+
+                if ((LLVMArrayTypeKind != val_type_kind)
+                    && (LLVMPointerTypeKind != val_type_kind))
+                {
+                    LOGGER_LOG_LOC(
+                        logger, L_ERROR, node->token,
+                        "Variable %s is not an array or a pointer.\n",
+                        node->array_deref.variable->variable.name);
+                    exit(LUKA_CODEGEN_ERROR);
+                }
+
+                index = GEN_codegen(node->array_deref.index, module, builder,
+                                    logger);
+                if (NULL == index)
+                {
+                    LOGGER_LOG_LOC(
+                        logger, L_ERROR, node->array_deref.index->token,
+                        "Couldn't generate index in array dereference.\n",
+                        NULL);
+                    exit(LUKA_CODEGEN_ERROR);
+                }
+
+                if (LLVMIntegerTypeKind != LLVMGetTypeKind(LLVMTypeOf(index)))
+                {
+                    LOGGER_LOG_LOC(logger, L_ERROR,
+                                   node->array_deref.index->token,
+                                   "Index in array dereference should "
+                                   "resolve to an integer.\n",
+                                   NULL);
+                    exit(LUKA_CODEGEN_ERROR);
+                }
+
+                ptr = val->alloca_inst;
+                if (NULL != val->value)
+                {
+                    /* Only pointers are kept in registers */
+                    ptr = val->value;
+                }
+                else if (LLVMArrayTypeKind != LLVMGetTypeKind(val->type))
+                {
+                    ptr = LLVMBuildLoad(builder, ptr, "loadtmp");
+                }
+
+                return LLVMBuildGEP2(builder, LLVMGetElementType(val->type),
+                                     ptr, &index, 1, "arrdereftmp");
+            }
+        case AST_TYPE_UNARY_EXPR:
+            {
+                if (node->unary_expr.operator!= UNOP_DEREF)
+                {
+                    LOGGER_LOG_LOC(
+                        logger, L_ERROR, node->token,
+                        "Can't assign to unary expr not of type deref %d.\n",
+                        node->unary_expr.operator);
+                    exit(LUKA_CODEGEN_ERROR);
+                }
+
+                return GEN_codegen(node->unary_expr.rhs, module, builder,
+                                   logger);
+            }
+        case AST_TYPE_ARRAY_LITERAL:
+        case AST_TYPE_ASSIGNMENT_EXPR:
+        case AST_TYPE_BINARY_EXPR:
+        case AST_TYPE_BREAK_STMT:
+        case AST_TYPE_BUILTIN:
+        case AST_TYPE_CALL_EXPR:
+        case AST_TYPE_CAST_EXPR:
+        case AST_TYPE_CONTINUE_STMT:
+        case AST_TYPE_DEFER_STMT:
+        case AST_TYPE_ENUM_DEFINITION:
+        case AST_TYPE_EXPRESSION_STMT:
+        case AST_TYPE_FOR_EXPR:
+        case AST_TYPE_FUNCTION:
+        case AST_TYPE_IF_EXPR:
+        case AST_TYPE_LET_STMT:
+        case AST_TYPE_LITERAL:
+        case AST_TYPE_MATCH_EXPR:
+        case AST_TYPE_NUMBER:
+        case AST_TYPE_PROTOTYPE:
+        case AST_TYPE_RETURN_STMT:
+        case AST_TYPE_STRING:
+        case AST_TYPE_STRUCT_DEFINITION:
+        case AST_TYPE_STRUCT_VALUE:
+        case AST_TYPE_TYPE_EXPR:
+        case AST_TYPE_WHILE_EXPR:
+            {
+                LOGGER_LOG_LOC(logger, L_ERROR, node->token,
+                               "Can't get address of %d.\n", node->type);
+                exit(LUKA_CODEGEN_ERROR);
+            }
+    }
+}
+
+/**
+ * @brief Generate LLVM IR for an unary expression.
+ *
+ * @param[in] n the AST node.
+ * @param[in] module the LLVM module.
+ * @param[in] builder the LLVM builder.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return the built LLVM IR for the unary expression.
+ */
+static LLVMValueRef gen_codegen_unexpr(t_ast_node *n, LLVMModuleRef module,
+                                       LLVMBuilderRef builder, t_logger *logger)
+{
+    LLVMValueRef rhs = NULL, load = NULL;
+    if (NULL != n->unary_expr.rhs)
+    {
+        rhs = GEN_codegen(n->unary_expr.rhs, module, builder, logger);
+    }
+
+    if (NULL == rhs)
+    {
+        LOGGER_LOG_LOC(logger, L_ERROR, n->unary_expr.rhs->token,
+                       "Couldn't codegen rhs for unary expression.\n", NULL);
+        exit(LUKA_CODEGEN_ERROR);
+    }
+
+    switch (n->unary_expr.operator)
+    {
+        case UNOP_NOT:
+            {
+                return LLVMBuildNot(builder, rhs, "nottmp");
+            }
+        case UNOP_MINUS:
+            {
+                if (gen_llvm_is_floating_type(LLVMTypeOf(rhs)))
+                {
+                    return gen_set_fast_math_flags(
+                        builder, LLVMBuildFNeg(builder, rhs, "negtmp"), logger);
+                }
+
+                if (gen_is_integer_expr(n, true))
+                {
+                    return LLVMBuildNSWNeg(builder, rhs, "negtmp");
+                }
+
+                return LLVMBuildNeg(builder, rhs, "negtmp");
+            }
+        case UNOP_REF:
+            {
+                return gen_get_address(n->unary_expr.rhs, module, builder,
+                                       logger);
+            }
+        case UNOP_DEREF:
+            {
+                load = LLVMBuildLoad(builder, rhs, "loadtmp");
+                if (LLVMVectorTypeKind == LLVMGetTypeKind(LLVMTypeOf(load)))
+                {
+                    (void) gen_set_lane_alignment(builder, load,
+                                                  LLVMTypeOf(load));
+                }
+                return load;
+            }
+        case UNOP_PLUS:
+            {
+                LOGGER_LOG_LOC(logger, L_ERROR, n->token,
+                               "Currently not supporting %d operator in "
+                               "unary expression.\n",
+                               n->unary_expr.operator);
+                exit(LUKA_CODEGEN_ERROR);
+            }
+        case UNOP_BNOT:
+            {
+                return LLVMBuildXor(builder, LLVMConstAllOnes(LLVMTypeOf(rhs)),
+                                    rhs, "bnottmp");
+            }
+    }
+}
+
+/**
+ * @brief Generate LLVM IR for a binary expression on vectors, lane by lane.
+ *
+ * @details A scalar operand is broadcast to every lane of the vector operand.
+ * Comparisons give a vector of bools with the result of every lane.
+ *
+ * @param[in] n the AST node.
+ * @param[in] lhs the left operand.
+ * @param[in] rhs the right operand.
+ * @param[in] builder the LLVM builder.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return the built LLVM IR for the binary expression.
+ */
+static LLVMValueRef gen_codegen_vector_binexpr(t_ast_node *n, LLVMValueRef lhs,
+                                               LLVMValueRef rhs,
+                                               LLVMBuilderRef builder,
+                                               t_logger *logger)
+{
+    bool is_float = false, is_unsigned = false;
+    LLVMOpcode opcode = LLVMAdd;
+
+    if (LLVMVectorTypeKind != LLVMGetTypeKind(LLVMTypeOf(lhs)))
+    {
+        is_unsigned = gen_is_unsigned_expr(n->binary_expr.rhs);
+        lhs = gen_codegen_splat(builder, lhs, LLVMTypeOf(rhs),
+                                !gen_is_unsigned_expr(n->binary_expr.lhs));
+    }
+    else
+    {
+        is_unsigned = gen_is_unsigned_expr(n->binary_expr.lhs);
+        if (LLVMVectorTypeKind != LLVMGetTypeKind(LLVMTypeOf(rhs)))
+        {
+            rhs = gen_codegen_splat(builder, rhs, LLVMTypeOf(lhs),
+                                    !gen_is_unsigned_expr(n->binary_expr.rhs));
+        }
+    }
+
+    if (LLVMTypeOf(lhs) != LLVMTypeOf(rhs))
+    {
+        LOGGER_LOG_LOC(logger, L_ERROR, n->token,
+                       "Both vectors in a binary expression must have the "
+                       "same element type and number of lanes.\n",
+                       NULL);
+        exit(LUKA_CODEGEN_ERROR);
+    }
+
+    is_float = gen_llvm_is_floating_type(LLVMTypeOf(lhs));
+    switch (n->binary_expr.operator)
+    {
+        case BINOP_ADD:
+        case BINOP_ADD_WRAP:
+            opcode = is_float ? LLVMFAdd : LLVMAdd;
+            break;
+        case BINOP_SUBTRACT:
+        case BINOP_SUB_WRAP:
+            opcode = is_float ? LLVMFSub : LLVMSub;
+            break;
+        case BINOP_MULTIPLY:
+        case BINOP_MUL_WRAP:
+            opcode = is_float ? LLVMFMul : LLVMMul;
+            break;
+        case BINOP_DIVIDE:
+            opcode = is_float ? LLVMFDiv : (is_unsigned ? LLVMUDiv : LLVMSDiv);
+            break;
+        case BINOP_MODULOS:
+            opcode = is_float ? LLVMFRem : (is_unsigned ? LLVMURem : LLVMSRem);
+            break;
+        case BINOP_BAND:
+            opcode = LLVMAnd;
+            break;
+        case BINOP_BOR:
+            opcode = LLVMOr;
+            break;
+        case BINOP_BXOR:
+            opcode = LLVMXor;
+            break;
+        case BINOP_SHL:
+            opcode = LLVMShl;
+            break;
+        case BINOP_SHR:
+            opcode = is_unsigned ? LLVMLShr : LLVMAShr;
+            break;
+        case BINOP_LESSER:
+            return is_float
+                     ? LLVMBuildFCmp(builder, LLVMRealOLT, lhs, rhs, "fcmptmp")
+                     : LLVMBuildICmp(builder,
+                                     is_unsigned ? LLVMIntULT : LLVMIntSLT,
+                                     lhs, rhs, "icmptmp");
+        case BINOP_GREATER:
+            return is_float
+                     ? LLVMBuildFCmp(builder, LLVMRealOGT, lhs, rhs, "fcmptmp")
+                     : LLVMBuildICmp(builder,
+                                     is_unsigned ? LLVMIntUGT : LLVMIntSGT,
+                                     lhs, rhs, "icmptmp");
+        case BINOP_LEQ:
+            return is_float
+                     ? LLVMBuildFCmp(builder, LLVMRealOLE, lhs, rhs, "fcmptmp")
+                     : LLVMBuildICmp(builder,
+                                     is_unsigned ? LLVMIntULE : LLVMIntSLE,
+                                     lhs, rhs, "icmptmp");
+        case BINOP_GEQ:
+            return is_float
+                     ? LLVMBuildFCmp(builder, LLVMRealOGE, lhs, rhs, "fcmptmp")
+                     : LLVMBuildICmp(builder,
+                                     is_unsigned ? LLVMIntUGE : LLVMIntSGE,
+                                     lhs, rhs, "icmptmp");
+        case BINOP_EQUALS:
+            return is_float
+                     ? LLVMBuildFCmp(builder, LLVMRealOEQ, lhs, rhs, "fcmptmp")
+                     : LLVMBuildICmp(builder, LLVMIntEQ, lhs, rhs, "icmptmp");
+        case BINOP_NEQ:
+            return is_float
+                     ? LLVMBuildFCmp(builder, LLVMRealONE, lhs, rhs, "fcmptmp")
+                     : LLVMBuildICmp(builder, LLVMIntNE, lhs, rhs, "icmptmp");
+        case BINOP_LAND:
+        case BINOP_LOR:
+            {
+                LOGGER_LOG_LOC(logger, L_ERROR, n->token,
+                               "Logical operators are not defined on "
+                               "vectors.\n",
+                               NULL);
+                exit(LUKA_CODEGEN_ERROR);
+            }
+    }
+
+    if (is_float
+        && ((LLVMAnd == opcode) || (LLVMOr == opcode) || (LLVMXor == opcode)
+            || (LLVMShl == opcode) || (LLVMLShr == opcode)
+            || (LLVMAShr == opcode)))
+    {
+        LOGGER_LOG_LOC(logger, L_ERROR, n->token,
+                       "Bitwise operators are not defined on floating point "
+                       "vectors.\n",
+                       NULL);
+        exit(LUKA_CODEGEN_ERROR);
+    }
+
+    return gen_build_binop(n, opcode, lhs, rhs, builder, "vbinoptmp",
+                           logger);
+}
+
+/**
+ * @brief Generate LLVM IR that branches on a condition, so that `&&` and `||`
+ * in the condition jump straight to @p true_block or @p false_block once
+ * their result is known instead of building a bool first.
+ *
+ * @param[in] cond the AST node of the condition.
+ * @param[in] true_block the block to branch to when the condition holds.
+ * @param[in] false_block the block to branch to when it doesn't.
+ * @param[in] module the LLVM module.
+ * @param[in] builder the LLVM builder.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return the last branch that was built, or NULL if generating the condition
+ * failed.
+ */
+static LLVMValueRef gen_codegen_cond_br(t_ast_node *cond,
+                                        LLVMBasicBlockRef true_block,
+                                        LLVMBasicBlockRef false_block,
+                                        LLVMModuleRef module,
+                                        LLVMBuilderRef builder,
+                                        t_logger *logger)
+{
+    LLVMValueRef value = NULL, func = NULL;
+    LLVMBasicBlockRef rhs_block = NULL;
+    bool is_and = false;
+
+    if ((AST_TYPE_BINARY_EXPR != cond->type)
+        || ((BINOP_LAND != cond->binary_expr.operator)
+            && (BINOP_LOR != cond->binary_expr.operator)))
+    {
+        value = GEN_codegen(cond, module, builder, logger);
+        if (NULL == value)
+        {
+            return NULL;
+        }
+
+        return LLVMBuildCondBr(builder, value, true_block, false_block);
+    }
+
+    is_and = (BINOP_LAND == cond->binary_expr.operator);
+    func = LLVMGetBasicBlockParent(LLVMGetInsertBlock(builder));
+    rhs_block = LLVMAppendBasicBlock(func, is_and ? "land_rhs" : "lor_rhs");
+    if (NULL
+        == gen_codegen_cond_br(cond->binary_expr.lhs,
+                               is_and ? rhs_block : true_block,
+                               is_and ? false_block : rhs_block, module,
+                               builder, logger))
+    {
+        return NULL;
+    }
+
+    (void) LLVMPositionBuilderAtEnd(builder, rhs_block);
+    return gen_codegen_cond_br(cond->binary_expr.rhs, true_block, false_block,
+                               module, builder, logger);
+}
+
+/**
+ * @brief Generate LLVM IR for a `&&` or `||` expression, which only evaluates
+ * its right operand when the left one doesn't decide the result.
+ *
+ * @param[in] n the AST node.
+ * @param[in] module the LLVM module.
+ * @param[in] builder the LLVM builder.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return a bool PHI node with the result of the expression.
+ */
+static LLVMValueRef gen_codegen_logical_binexpr(t_ast_node *n,
+                                                LLVMModuleRef module,
+                                                LLVMBuilderRef builder,
+                                                t_logger *logger)
+{
+    LLVMValueRef func = NULL, lhs = NULL, rhs = NULL, phi = NULL,
+                 incoming_values[2] = {NULL, NULL};
+    LLVMBasicBlockRef incoming_blocks[2] = {NULL, NULL}, rhs_block = NULL,
+                      merge_block = NULL;
+    bool is_and = (BINOP_LAND == n->binary_expr.operator);
+
+    func = LLVMGetBasicBlockParent(LLVMGetInsertBlock(builder));
+    merge_block = LLVMCreateBasicBlockInContext(
+        LLVMGetGlobalContext(), is_and ? "land_merge" : "lor_merge");
+
+    lhs = GEN_codegen(n->binary_expr.lhs, module, builder, logger);
+    if (NULL == lhs)
+    {
+        LOGGER_LOG_LOC(logger, L_ERROR, n->token,
+                       "Binexpr lhs or rhs is null.\n", NULL);
+        exit(LUKA_CODEGEN_ERROR);
+    }
+
+    /* The left operand decides the result when it is false for `&&` and
+     * when it is true for `||` */
+    incoming_values[0] = LLVMConstInt(LLVMInt1Type(), is_and ? 0 : 1, false);
+    incoming_blocks[0] = LLVMGetInsertBlock(builder);
+    rhs_block = LLVMAppendBasicBlock(func, is_and ? "land_rhs" : "lor_rhs");
+    (void) LLVMBuildCondBr(builder, lhs, is_and ? rhs_block : merge_block,
+                           is_and ? merge_block : rhs_block);
+
+    (void) LLVMPositionBuilderAtEnd(builder, rhs_block);
+    rhs = GEN_codegen(n->binary_expr.rhs, module, builder, logger);
+    if (NULL == rhs)
+    {
+        LOGGER_LOG_LOC(logger, L_ERROR, n->token,
+                       "Binexpr lhs or rhs is null.\n", NULL);
+        exit(LUKA_CODEGEN_ERROR);
+    }
+    incoming_values[1] = rhs;
+    incoming_blocks[1] = LLVMGetInsertBlock(builder);
+    (void) LLVMBuildBr(builder, merge_block);
+
+    (void) LLVMAppendExistingBasicBlock(func, merge_block);
+    (void) LLVMPositionBuilderAtEnd(builder, merge_block);
+    phi = LLVMBuildPhi(builder, LLVMInt1Type(), is_and ? "landtmp" : "lortmp");
+    (void) LLVMAddIncoming(phi, incoming_values, incoming_blocks, 2);
+
+    return phi;
+}
+
+/**
+ * @brief Generate LLVM IR for a binary expression.
+ *
+ * @param[in] n the AST node.
+ * @param[in] module the LLVM module.
+ * @param[in] builder the LLVM builder.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return the built LLVM IR for the binary expression.
+ */
+static LLVMValueRef gen_codegen_binexpr(t_ast_node *n, LLVMModuleRef module,
+                                        LLVMBuilderRef builder,
+                                        t_logger *logger)
+{
+    LLVMValueRef lhs = NULL, rhs = NULL;
+    LLVMOpcode opcode = LLVMAdd;
+    LLVMIntPredicate int_predicate = LLVMIntEQ;
+    LLVMRealPredicate real_predicate = LLVMRealOEQ;
+
+    if ((BINOP_LAND == n->binary_expr.operator)
+        || (BINOP_LOR == n->binary_expr.operator))
+    {
+        return gen_codegen_logical_binexpr(n, module, builder, logger);
+    }
+
+    if (NULL != n->binary_expr.lhs)
+    {
+        lhs = GEN_codegen(n->binary_expr.lhs, module, builder, logger);
+    }
+
+    if (NULL != n->binary_expr.rhs)
+    {
+        rhs = GEN_codegen(n->binary_expr.rhs, module, builder, logger);
+    }
+
+    if ((NULL == lhs) || (NULL == rhs))
+    {
+        LOGGER_LOG_LOC(logger, L_ERROR, n->token,
+                       "Binexpr lhs or rhs is null.\n", NULL);
+        exit(LUKA_CODEGEN_ERROR);
+    }
+
+    if ((LLVMVectorTypeKind == LLVMGetTypeKind(LLVMTypeOf(lhs)))
+        || (LLVMVectorTypeKind == LLVMGetTypeKind(LLVMTypeOf(rhs))))
+    {
+        return gen_set_fast_math_flags(
+            builder, gen_codegen_vector_binexpr(n, lhs, rhs, builder, logger),
+            logger);
+    }
+
+    if (AST_is_cond_binop(n->binary_expr.operator))
+    {
+        (void) gen_llvm_cast_null_if_needed(&lhs, &rhs);
+        if (gen_is_icmp(lhs, rhs, logger))
+        {
+            int_predicate = gen_llvm_get_int_predicate(
+                n->binary_expr.operator, & lhs, &rhs, builder, logger);
+            return LLVMBuildICmp(builder, int_predicate, lhs, rhs, "icmptmp");
+        }
+        real_predicate = gen_llvm_get_real_predicate(
+            n->binary_expr.operator, & lhs, &rhs, builder, logger);
+        return gen_set_fast_math_flags(
+            builder,
+            LLVMBuildFCmp(builder, real_predicate, lhs, rhs, "fcmptmp"),
+            logger);
+    }
+
+    opcode = gen_get_llvm_opcode(n->binary_expr.operator, & lhs, &rhs, builder,
+                                 logger);
+    return gen_set_fast_math_flags(
+        builder,
+        gen_build_binop(n, opcode, lhs, rhs, builder, "binoptmp", logger),
+        logger);
+}
+
+static LLVMTypeRef gen_function_type(t_ast_node *prototype, t_logger *logger)
+{
+    size_t i = 0, arity = prototype->prototype.arity;
+    bool vararg = prototype->prototype.vararg;
+    LLVMTypeRef *params = NULL;
+
+    if (vararg)
+    {
+        --arity;
+    }
+    params = calloc(arity, sizeof(LLVMTypeRef));
+    if (NULL == params)
+    {
+        (void) LOGGER_log(
+            logger, L_ERROR,
+            "Failed to assign memory for params in prototype generaion.\n");
+        exit(LUKA_CANT_ALLOC_MEMORY);
+    }
+
+    for (i = 0; i < arity; ++i)
+    {
+        params[i]
+            = gen_type_to_llvm_type(prototype->prototype.types[i], logger);
+    }
+
+    return LLVMFunctionType(
+        gen_type_to_llvm_type(prototype->prototype.return_type, logger), params,
+        (unsigned int) arity, vararg);
+}
+
+/**
+ * @brief Give a function defined in the program internal linkage and the fast
+ * calling convention, updating the calls that were already built against it.
+ *
+ * @param[in] func the LLVM function.
+ */
+static void gen_internalize_function(LLVMValueRef func)
+{
+    LLVMUseRef use = NULL;
+    LLVMValueRef user = NULL;
+
+    (void) LLVMSetLinkage(func, LLVMInternalLinkage);
+    (void) LLVMSetFunctionCallConv(func, LLVMFastCallConv);
+
+    for (use = LLVMGetFirstUse(func); NULL != use; use = LLVMGetNextUse(use))
+    {
+        user = LLVMGetUser(use);
+        if ((NULL != LLVMIsACallInst(user))
+            && (func == LLVMGetCalledValue(user)))
+        {
+            (void) LLVMSetInstructionCallConv(user, LLVMFastCallConv);
+        }
+    }
+}
+
+/**
+ * @brief Add an attribute without a value to a function or to one of its
+ * arguments.
+ *
+ * @param[in] func the LLVM function.
+ * @param[in] index LLVMAttributeFunctionIndex, or the index of the argument
+ * plus one.
+ * @param[in] name the name of the attribute, such as `noinline`.
+ */
+static void gen_add_attribute(LLVMValueRef func, LLVMAttributeIndex index,
+                              const char *name)
+{
+    LLVMAttributeRef attribute = NULL;
+
+    attribute = LLVMCreateEnumAttribute(
+        LLVMGetGlobalContext(),
+        LLVMGetEnumAttributeKindForName(name, strlen(name)), 0);
+    (void) LLVMAddAttributeAtIndex(func, index, attribute);
+}
+
+/**
+ * @brief Add the LLVM attributes matching the attributes of a function, such
+ * as `@inline` or `@noreturn`.
+ *
+ * @param[in] func the LLVM function.
+ * @param[in] attributes the attributes of the function.
+ */
+static void gen_add_function_attributes(LLVMValueRef func,
+                                        const t_function_attributes *attributes)
+{
+    if (attributes->always_inline)
+    {
+        (void) gen_add_attribute(func, LLVMAttributeFunctionIndex,
+                                 "alwaysinline");
+    }
+
+    if (attributes->no_inline)
+    {
+        (void) gen_add_attribute(func, LLVMAttributeFunctionIndex,
+                                 "noinline");
+    }
+
+    if (attributes->hot)
+    {
+        (void) gen_add_attribute(func, LLVMAttributeFunctionIndex,
+                                 "hot");
+    }
+
+    if (attributes->cold)
+    {
+        (void) gen_add_attribute(func, LLVMAttributeFunctionIndex,
+                                 "cold");
+    }
+
+    if (attributes->pure)
+    {
+        (void) gen_add_attribute(func, LLVMAttributeFunctionIndex,
+                                 "readonly");
+    }
+
+    if (attributes->constant)
+    {
+        (void) gen_add_attribute(func, LLVMAttributeFunctionIndex,
+                                 "readnone");
+    }
+
+    if (attributes->no_return)
+    {
+        (void) gen_add_attribute(func, LLVMAttributeFunctionIndex,
+                                 "noreturn");
+    }
+
+    if (attributes->no_unwind)
+    {
+        (void) gen_add_attribute(func, LLVMAttributeFunctionIndex,
+                                 "nounwind");
+    }
+}
+
+/**
+ * @brief Generate LLVM IR for a function prototype.
+ *
+ * @param[in] n the AST node.
+ * @param[in] module the LLVM module.
+ * @param[in] builder the LLVM builder.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return the built LLVM IR for the function prototype.
+ */
+static LLVMValueRef gen_codegen_prototype(t_ast_node *n, LLVMModuleRef module,
+                                          LLVMBuilderRef UNUSED(builder),
+                                          t_logger *logger)
+{
+    LLVMValueRef func = NULL, module_func = NULL, param = NULL;
+    LLVMTypeRef func_type = NULL;
+    unsigned int i = 0;
+    size_t arity = n->prototype.arity;
+    bool vararg = n->prototype.vararg;
+    LLVMTypeRef *params = NULL;
+    char *func_type_str = NULL, *module_func_str = NULL;
+    if (vararg)
+    {
+        --arity;
+    }
+
+    func_type = gen_function_type(n, logger);
+
+    module_func = LLVMGetNamedFunction(module, n->prototype.name);
+    if (NULL != module_func)
+    {
+        func_type_str = LLVMPrintTypeToString(func_type);
+        module_func_str = LLVMPrintTypeToString(LLVMTypeOf(module_func));
+        if (((LLVMExternalLinkage == LLVMGetLinkage(module_func))
+             || (LLVMInternalLinkage == LLVMGetLinkage(module_func)))
+            && (0 == strcmp(func_type_str, module_func_str)))
+        {
+            func = module_func;
+            goto l_cleanup;
+        }
+    }
+    func = LLVMAddFunction(module, n->prototype.name, func_type);
+    (void) LLVMSetLinkage(func, LLVMExternalLinkage);
+
+    for (i = 0; i < arity; ++i)
+    {
+        param = LLVMGetParam(func, i);
+        (void) LLVMSetValueName(param, n->prototype.args[i]);
+        if ((NULL == n->prototype.restricted) || !n->prototype.restricted[i])
+        {
+            continue;
+        }
+
+        if (LLVMPointerTypeKind != LLVMGetTypeKind(LLVMTypeOf(param)))
+        {
+            LOGGER_LOG_LOC(logger, L_ERROR, n->token,
+                           "Only pointer arguments can be `restrict`, but "
+                           "`%s` isn't a pointer.\n",
+                           n->prototype.args[i]);
+            exit(LUKA_CODEGEN_ERROR);
+        }
+        (void) gen_add_attribute(func, i + 1, "noalias");
+    }
+
+l_cleanup:
+    if (NULL != params)
+    {
+        (void) free(params);
+    }
+
+    if (NULL != func_type_str)
+    {
+        (void) LLVMDisposeMessage(func_type_str);
+    }
+
+    if (NULL != module_func_str)
+    {
+        (void) LLVMDisposeMessage(module_func_str);
+    }
+
+    (void) gen_add_function_attributes(func, &n->prototype.attributes);
+    return func;
+}
+
+/**
+ * @brief Generate LLVM IR for a vector of statements.
+ *
+ * @param[in] statements a vector of AST nodes for the statements.
+ * @param[in] module the LLVM module.
+ * @param[in] builder the LLVM builder.
+ * @param[out] has_return_stmt whether there's a return statement in one of
+ * these statements.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return the built LLVM IR for the statements.
+ */
+static LLVMValueRef gen_codegen_stmts(t_vector *statements,
+                                      LLVMModuleRef module,
+                                      LLVMBuilderRef builder,
+                                      bool *has_return_stmt, t_logger *logger)
+{
+    t_ast_node *stmt = NULL;
+    LLVMValueRef ret_val = NULL;
+
+    VECTOR_FOR_EACH(statements, stmts)
+    {
+        stmt = ITERATOR_GET_AS(t_ast_node_ptr, &stmts);
+        if (AST_TYPE_RETURN_STMT == stmt->type)
+        {
+            ret_val = GEN_codegen(stmt, module, builder, logger);
+
+            if (NULL != has_return_stmt)
+            {
+                *has_return_stmt = true;
+            }
+            break;
+        }
+        ret_val = GEN_codegen(stmt, module, builder, logger);
+    }
+
+    return ret_val;
+}
+
+static void gen_collect_memory_variables(t_ast_node *node);
+
+/**
+ * @brief Get the variable that an access such as `a[i].field` or `*a` goes
+ * through the memory of.
+ *
+ * @param[in] node the AST node of the access.
+ *
+ * @return the name of the variable, or NULL if the access doesn't start at a
+ * variable.
+ */
+static char *gen_access_root(t_ast_node *node)
+{
+    while (NULL != node)
+    {
+        if (AST_TYPE_VARIABLE == node->type)
+        {
+            return node->variable.name;
+        }
+
+        if (AST_TYPE_ARRAY_DEREF == node->type)
+        {
+            node = node->array_deref.variable;
+        }
+        else if (AST_TYPE_GET_EXPR == node->type)
+        {
+            node = node->get_expr.variable;
+        }
+        else if ((AST_TYPE_UNARY_EXPR == node->type)
+                 && (UNOP_DEREF == node->unary_expr.operator))
+        {
+            node = node->unary_expr.rhs;
+        }
+        else
+        {
+            return NULL;
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Collect the variables used in @p node, where a variable that is
+ * @p node itself is only dereferenced or compared, which doesn't capture it.
+ *
+ * @param[in] node the AST node, may be NULL.
+ */
+static void gen_collect_memory_variables_uncaptured(t_ast_node *node)
+{
+    if ((NULL != node) && (AST_TYPE_VARIABLE != node->type))
+    {
+        (void) gen_collect_memory_variables(node);
+    }
+}
+
+/**
+ * @brief Collect the variables that are assigned or whose address is taken in
+ * any of @p nodes.
+ *
+ * @param[in] nodes the AST nodes, may be NULL.
+ */
+static void gen_collect_memory_variables_in(t_vector *nodes)
+{
+    if (NULL == nodes)
+    {
+        return;
+    }
+
+    VECTOR_FOR_EACH(nodes, nodes_iter)
+    {
+        (void) gen_collect_memory_variables(
+            ITERATOR_GET_AS(t_ast_node_ptr, &nodes_iter));
+    }
+}
+
+/**
+ * @brief Collect the names of the variables that are assigned or whose
+ * address is taken in @p node into memory_variables.
+ *
+ * @details Variables are matched by name, so a variable is kept in memory if
+ * any variable with the same name in the function is assigned or has its
+ * address taken. Along the way, the variables whose value may outlive the
+ * function are collected into captured_variables, and the variables that are
+ * written through into written_through_variables, both just as
+ * conservatively.
+ *
+ * @param[in] node the AST node, may be NULL.
+ */
+static void gen_collect_memory_variables(t_ast_node *node)
+{
+    t_struct_value_field *field = NULL;
+    const t_ast_match_arm *arm = NULL;
+    t_ast_node *variable = NULL;
+    char *root = NULL;
+
+    if (NULL == node)
+    {
+        return;
+    }
+
+    switch (node->type)
+    {
+        case AST_TYPE_BREAK_STMT:
+        case AST_TYPE_BUILTIN:
+        case AST_TYPE_CONTINUE_STMT:
+        case AST_TYPE_ENUM_DEFINITION:
+        case AST_TYPE_LITERAL:
+        case AST_TYPE_NUMBER:
+        case AST_TYPE_PROTOTYPE:
+        case AST_TYPE_STRING:
+        case AST_TYPE_STRUCT_DEFINITION:
+        case AST_TYPE_TYPE_EXPR:
+            break;
+        case AST_TYPE_VARIABLE:
+            {
+                (void) vector_push_back(captured_variables,
+                                        &node->variable.name);
+                break;
+            }
+        case AST_TYPE_UNARY_EXPR:
+            {
+                if ((UNOP_REF == node->unary_expr.operator)
+                    && (AST_TYPE_VARIABLE == node->unary_expr.rhs->type))
+                {
+                    (void) vector_push_back(
+                        memory_variables,
+                        &node->unary_expr.rhs->variable.name);
+                }
+
+                if (UNOP_REF == node->unary_expr.operator)
+                {
+                    /* A pointer into what a variable points to escapes */
+                    root = gen_access_root(node->unary_expr.rhs);
+                    if (NULL != root)
+                    {
+                        (void) vector_push_back(captured_variables, &root);
+                    }
+                }
+
+                if (UNOP_DEREF == node->unary_expr.operator)
+                {
+                    (void) gen_collect_memory_variables_uncaptured(
+                        node->unary_expr.rhs);
+                }
+                else
+                {
+                    (void) gen_collect_memory_variables(node->unary_expr.rhs);
+                }
+                break;
+            }
+        case AST_TYPE_ARRAY_LITERAL:
+            {
+                (void) gen_collect_memory_variables_in(
+                    node->array_literal.exprs);
+                break;
+            }
+        case AST_TYPE_ASSIGNMENT_EXPR:
+            {
+                if (AST_TYPE_VARIABLE == node->assignment_expr.lhs->type)
+                {
+                    (void) vector_push_back(
+                        memory_variables,
+                        &node->assignment_expr.lhs->variable.name);
+                }
+                else if (AST_TYPE_ARRAY_DEREF
+                         == node->assignment_expr.lhs->type)
+                {
+                    /* Assigning to a lane of a vector assigns the vector */
+                    variable = node->assignment_expr.lhs->array_deref.variable;
+                    if ((NULL != variable->variable.type)
+                        && (TYPE_VECTOR == variable->variable.type->type))
+                    {
+                        (void) vector_push_back(memory_variables,
+                                                &variable->variable.name);
+                    }
+                }
+
+                root = gen_access_root(node->assignment_expr.lhs);
+                if ((AST_TYPE_VARIABLE != node->assignment_expr.lhs->type)
+                    && (NULL != root))
+                {
+                    (void) vector_push_back(written_through_variables, &root);
+                }
+                (void) gen_collect_memory_variables_uncaptured(
+                    node->assignment_expr.lhs);
+                (void) gen_collect_memory_variables(
+                    node->assignment_expr.rhs);
+                break;
+            }
+        case AST_TYPE_BINARY_EXPR:
+            {
+                if (AST_is_cond_binop(node->binary_expr.operator))
+                {
+                    (void) gen_collect_memory_variables_uncaptured(
+                        node->binary_expr.lhs);
+                    (void) gen_collect_memory_variables_uncaptured(
+                        node->binary_expr.rhs);
+                }
+                else
+                {
+                    (void) gen_collect_memory_variables(node->binary_expr.lhs);
+                    (void) gen_collect_memory_variables(node->binary_expr.rhs);
+                }
+                break;
+            }
+        case AST_TYPE_CALL_EXPR:
+            {
+                /* A method call passes the object it is called on */
+                if (AST_TYPE_GET_EXPR == node->call_expr.callable->type)
+                {
+                    (void) gen_collect_memory_variables(
+                        node->call_expr.callable->get_expr.variable);
+                }
+                (void) gen_collect_memory_variables(
+                    node->call_expr.callable);
+                (void) gen_collect_memory_variables_in(
+                    node->call_expr.args);
+                break;
+            }
+        case AST_TYPE_CAST_EXPR:
             {
-                (void) LOGGER_log(logger, L_ERROR,
-                                  "Op %d is not a real comparison operator.\n",
-                                  op);
-                exit(LUKA_CODEGEN_ERROR);
+                (void) gen_collect_memory_variables(node->cast_expr.expr);
+                break;
+            }
+        case AST_TYPE_DEFER_STMT:
+            {
+                (void) gen_collect_memory_variables_in(
+                    node->defer_stmt.body);
+                break;
+            }
+        case AST_TYPE_EXPRESSION_STMT:
+            {
+                (void) gen_collect_memory_variables(
+                    node->expression_stmt.expr);
+                break;
+            }
+        case AST_TYPE_FUNCTION:
+            {
+                (void) gen_collect_memory_variables_in(node->function.body);
+                break;
+            }
+        case AST_TYPE_GET_EXPR:
+            {
+                (void) gen_collect_memory_variables_uncaptured(
+                    node->get_expr.variable);
+                break;
+            }
+        case AST_TYPE_ARRAY_DEREF:
+            {
+                (void) gen_collect_memory_variables_uncaptured(
+                    node->array_deref.variable);
+                (void) gen_collect_memory_variables(
+                    node->array_deref.index);
+                break;
+            }
+        case AST_TYPE_IF_EXPR:
+            {
+                (void) gen_collect_memory_variables(node->if_expr.cond);
+                (void) gen_collect_memory_variables_in(
+                    node->if_expr.then_body);
+                (void) gen_collect_memory_variables_in(
+                    node->if_expr.else_body);
+                break;
+            }
+        case AST_TYPE_MATCH_EXPR:
+            {
+                (void) gen_collect_memory_variables(node->match_expr.value);
+                VECTOR_FOR_EACH(node->match_expr.arms, arms)
+                {
+                    arm = ITERATOR_GET_AS(t_ast_match_arm_ptr, &arms);
+                    (void) gen_collect_memory_variables_in(arm->patterns);
+                    (void) gen_collect_memory_variables_in(arm->body);
+                }
+                (void) gen_collect_memory_variables_in(
+                    node->match_expr.else_body);
+                break;
+            }
+        case AST_TYPE_LET_STMT:
+            {
+                (void) gen_collect_memory_variables(node->let_stmt.expr);
+                break;
+            }
+        case AST_TYPE_RETURN_STMT:
+            {
+                (void) gen_collect_memory_variables(
+                    node->return_stmt.expr);
+                break;
+            }
+        case AST_TYPE_STRUCT_VALUE:
+            {
+                if (NULL == node->struct_value.struct_values)
+                {
+                    break;
+                }
+
+                VECTOR_FOR_EACH(node->struct_value.struct_values, fields)
+                {
+                    field = ITERATOR_GET_AS(t_struct_value_field_ptr, &fields);
+                    (void) gen_collect_memory_variables(field->expr);
+                }
+                break;
+            }
+        case AST_TYPE_WHILE_EXPR:
+            {
+                (void) gen_collect_memory_variables(node->while_expr.cond);
+                (void) gen_collect_memory_variables_in(
+                    node->while_expr.body);
+                break;
+            }
+        case AST_TYPE_FOR_EXPR:
+            {
+                (void) gen_collect_memory_variables(node->for_expr.start);
+                (void) gen_collect_memory_variables(node->for_expr.end);
+                (void) gen_collect_memory_variables(node->for_expr.step);
+                (void) gen_collect_memory_variables_in(node->for_expr.body);
+                break;
             }
     }
 }
 
 /**
- * @brief Get the address of the expression of `node`.
+ * @brief Check whether a named value can be kept in a register instead of an
+ * alloca.
  *
- * @param[in] node the AST node.
+ * @details That is the case for scalars and pointers that are never assigned
+ * and whose address is never taken in the current function, which is what
+ * every immutable binding looks like.
+ *
+ * @param[in] name the name of the named value.
+ * @param[in] ttype the luka type of the named value.
+ *
+ * @return whether the named value can be kept in a register.
  */
-static LLVMValueRef gen_get_address(t_ast_node *node, LLVMModuleRef module,
-                                    LLVMBuilderRef builder, t_logger *logger)
+static bool gen_is_register_value(const char *name, const t_type *ttype)
 {
-    switch (node->type)
+    if ((TYPE_STRUCT == ttype->type) || (TYPE_ARRAY == ttype->type))
     {
-        case AST_TYPE_VARIABLE:
-            {
-                t_named_value *val = NULL;
+        return false;
+    }
 
-                HASH_FIND_STR(named_values, node->variable.name, val);
+    VECTOR_FOR_EACH(memory_variables, names)
+    {
+        if (0 == strcmp(name, ITERATOR_GET_AS(t_char_ptr, &names)))
+        {
+            return false;
+        }
+    }
 
-                if (NULL != val)
-                {
-                    return val->alloca_inst;
-                }
+    return true;
+}
 
-                LOGGER_LOG_LOC(logger, L_ERROR, node->token,
-                               "Variable %s is undefined.\n",
-                               node->variable.name);
-                exit(LUKA_CODEGEN_ERROR);
-            }
-        case AST_TYPE_GET_EXPR:
-            {
-                t_named_value *variable = NULL;
+/**
+ * @brief Check whether a name is one of the names in a vector.
+ *
+ * @param[in] names the vector of names.
+ * @param[in] name the name to look for.
+ *
+ * @return whether @p name is in @p names.
+ */
+static bool gen_is_collected(t_vector *names, const char *name)
+{
+    VECTOR_FOR_EACH(names, names_iter)
+    {
+        if (0 == strcmp(name, ITERATOR_GET_AS(t_char_ptr, &names_iter)))
+        {
+            return true;
+        }
+    }
 
-                if (NULL == node->get_expr.variable)
-                {
-                    LOGGER_LOG_LOC(logger, L_ERROR, node->token,
-                                   "Get expr variable name is null.\n", NULL);
-                    exit(LUKA_CODEGEN_ERROR);
-                }
+    return false;
+}
 
-                HASH_FIND_STR(named_values,
-                              node->get_expr.variable->variable.name, variable);
-                if (NULL == variable)
-                {
-                    LOGGER_LOG_LOC(logger, L_ERROR, node->token,
-                                   "Couldn't find a variable named `%s`.\n",
-                                   node->get_expr.variable->variable.name);
-                    exit(LUKA_CODEGEN_ERROR);
-                }
+/**
+ * @brief Add the attributes that the body of a function proves about its
+ * pointer arguments, after the variables of the body were collected.
+ *
+ * @details A pointer that is only dereferenced or compared doesn't outlive the
+ * call and is `nocapture`. If it also points to immutable memory that is never
+ * written through, it is `readonly`.
+ *
+ * @param[in] func the LLVM function.
+ * @param[in] proto the prototype of the function.
+ */
+static void gen_add_param_attributes(LLVMValueRef func, t_ast_node *proto)
+{
+    unsigned int i = 0, arity = proto->prototype.arity;
+    const t_type *type = NULL;
+    bool immutable = false;
 
-                return gen_get_struct_field_pointer(
-                    variable, node->get_expr.key, builder, logger);
-            }
-        case AST_TYPE_ARRAY_DEREF:
-            {
-                t_named_value *val = NULL;
-                LLVMTypeKind val_type_kind = LLVMIntegerTypeKind;
-                LLVMValueRef index = NULL;
-                LLVMValueRef ptr = NULL;
+    if (proto->prototype.vararg)
+    {
+        --arity;
+    }
 
-                HASH_FIND_STR(named_values,
-                              node->array_deref.variable->variable.name, val);
+    for (i = 0; i < arity; ++i)
+    {
+        if ((LLVMPointerTypeKind
+             != LLVMGetTypeKind(LLVMTypeOf(LLVMGetParam(func, i))))
+            || gen_is_collected(captured_variables, proto->prototype.args[i]))
+        {
+            continue;
+        }
+        (void) gen_add_attribute(func, i + 1, "nocapture");
+
+        type = proto->prototype.types[i];
+        immutable = (TYPE_STRING == type->type)
+                 || (((TYPE_PTR == type->type) || (TYPE_ARRAY == type->type))
+                     && !type->inner_type->mutable);
+        if (immutable
+            && !gen_is_collected(written_through_variables,
+                                 proto->prototype.args[i]))
+        {
+            (void) gen_add_attribute(func, i + 1, "readonly");
+        }
+    }
+}
 
-                if (NULL == val)
-                {
-                    LOGGER_LOG_LOC(logger, L_ERROR, node->token,
-                                   "Variable %s is undefined.\n",
-                                   node->array_deref.variable->variable.name);
-                    exit(LUKA_CODEGEN_ERROR);
-                }
+/**
+ * @brief Generate LLVM IR for a function.
+ *
+ * @param[in] n the AST node.
+ * @param[in] module the LLVM module.
+ * @param[in] builder the LLVM builder.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return the built LLVM IR for the function.
+ */
+static LLVMValueRef gen_codegen_function(t_ast_node *n, LLVMModuleRef module,
+                                         LLVMBuilderRef builder,
+                                         t_logger *logger)
+{
+    LLVMValueRef func = NULL, ret_val = NULL;
+    LLVMBasicBlockRef block = NULL;
+    t_ast_node *proto = NULL;
+    bool has_return_stmt = false;
+    t_type *return_ttype;
+    LLVMTypeRef return_type = NULL, expected_func_type = NULL, func_type = NULL;
+    unsigned int i = 0;
+    size_t arity = 0, scope = 0;
+    t_named_value *val = NULL;
+    char **args = NULL;
 
-                val_type_kind = LLVMGetTypeKind(val->type);
+    expected_func_type = gen_function_type(n->function.prototype, logger);
+    func = LLVMGetNamedFunction(module, n->function.prototype->prototype.name);
+    if (NULL == func)
+    {
+        func = GEN_codegen(n->function.prototype, module, builder, logger);
+    }
+    else if (0 != LLVMCountBasicBlocks(func))
+    {
+        LOGGER_LOG_LOC(logger, L_ERROR, n->token,
+                       "Cannot redefine function %s\n",
+                       n->function.prototype->prototype.name);
+        exit(LUKA_CODEGEN_ERROR);
+    }
+    else if ((func_type = LLVMGetElementType(LLVMTypeOf(func)))
+             != expected_func_type)
+    {
+        LOGGER_LOG_LOC(logger, L_ERROR, n->token,
+                       "Previous declaration of function %s does not match "
+                       "current declaration, previous: %s, current: %s\n",
+                       n->function.prototype->prototype.name,
+                       LLVMPrintTypeToString(func_type),
+                       LLVMPrintTypeToString(expected_func_type));
+        exit(LUKA_CODEGEN_ERROR);
+    }
 
-                if ((LLVMArrayTypeKind != val_type_kind)
-                    && (LLVMPointerTypeKind != val_type_kind))
-                {
-                    LOGGER_LOG_LOC(
-                        logger, L_ERROR, node->token,
-                        "Variable %s is not an array or a pointer.\n",
-                        node->array_deref.variable->variable.name);
-                    exit(LUKA_CODEGEN_ERROR);
-                }
+    if (NULL == func)
+    {
+        LOGGER_LOG_LOC(logger, L_ERROR, n->token,
+                       "Prototype generation failed in function generation\n",
+                       NULL);
+        exit(LUKA_CODEGEN_ERROR);
+    }
 
-                index = GEN_codegen(node->array_deref.index, module, builder,
-                                    logger);
-                if (NULL == index)
-                {
-                    LOGGER_LOG_LOC(
-                        logger, L_ERROR, node->array_deref.index->token,
-                        "Couldn't generate index in array dereference.\n",
-                        NULL);
-                    exit(LUKA_CODEGEN_ERROR);
-                }
+    if (NULL == n->function.body)
+    {
+        /* Extern definition */
+        return func;
+    }
 
-                if (LLVMIntegerTypeKind != LLVMGetTypeKind(LLVMTypeOf(index)))
-                {
-                    LOGGER_LOG_LOC(logger, L_ERROR,
-                                   node->array_deref.index->token,
-                                   "Index in array dereference should "
-                                   "resolve to an integer.\n",
-                                   NULL);
-                    exit(LUKA_CODEGEN_ERROR);
-                }
+    proto = n->function.prototype;
+    arity = proto->prototype.arity;
+    args = proto->prototype.args;
+
+    /* Only exported functions and main can be called from outside the
+     * program, everything else is free to use a faster calling convention. */
+    if (!n->function.exported && !proto->prototype.vararg
+        && (0 != strcmp(proto->prototype.name, "main")))
+    {
+        (void) gen_internalize_function(func);
+    }
+
+    (void) vector_clear(defer_blocks);
+    (void) vector_clear(memory_variables);
+    (void) vector_clear(captured_variables);
+    (void) vector_clear(written_through_variables);
+    (void) gen_collect_memory_variables(n);
+    (void) gen_add_param_attributes(func, proto);
+    fast_math_flags = default_fast_math_flags;
+    if (proto->prototype.attributes.fast_math)
+    {
+        fast_math_flags = GEN_FAST_MATH_ALL;
+    }
+    (void) gen_add_fast_math_attributes(func);
+    scope = gen_scope_open();
+
+    block = LLVMAppendBasicBlock(func, "entry");
+    (void) LLVMPositionBuilderAtEnd(builder, block);
+
+    for (i = 0; i < arity; ++i)
+    {
+        val = malloc(sizeof(t_named_value));
+        if (NULL == val)
+        {
+            LOGGER_LOG_LOC(logger, L_ERROR, n->token,
+                           "Couldn't allocate memory for named value in "
+                           "gen_codegen_function.",
+                           NULL);
+            exit(LUKA_CODEGEN_ERROR);
+        }
+
+        val->name = strdup(args[i]);
+        val->type = LLVMTypeOf(LLVMGetParam(func, i));
+        val->ttype = proto->prototype.types[i];
+        val->mutable = val->ttype->mutable;
+        val->alloca_inst = NULL;
+        val->value = NULL;
+        if (gen_is_register_value(val->name, val->ttype))
+        {
+            val->value = LLVMGetParam(func, i);
+        }
+        else
+        {
+            val->alloca_inst
+                = gen_create_entry_block_allca(func, val->type, val->name);
+            (void) LLVMBuildStore(builder, LLVMGetParam(func, i),
+                                  val->alloca_inst);
+        }
 
-                ptr = val->alloca_inst;
-                if (LLVMArrayTypeKind != LLVMGetTypeKind(val->type))
-                {
-                    ptr = LLVMBuildLoad(builder, ptr, "loadtmp");
-                }
+        (void) gen_named_value_declare(val);
 
-                return LLVMBuildGEP2(builder, LLVMGetElementType(val->type),
-                                     ptr, &index, 1, "arrdereftmp");
-            }
-        case AST_TYPE_UNARY_EXPR:
-            {
-                if (node->unary_expr.operator!= UNOP_DEREF)
-                {
-                    LOGGER_LOG_LOC(
-                        logger, L_ERROR, node->token,
-                        "Can't assign to unary expr not of type deref %d.\n",
-                        node->unary_expr.operator);
-                    exit(LUKA_CODEGEN_ERROR);
-                }
+        val = NULL;
+    }
 
-                return LLVMBuildLoad(builder,
-                                     gen_get_address(node->unary_expr.rhs,
-                                                     module, builder, logger),
-                                     "loadtmp");
-            }
-        case AST_TYPE_ARRAY_LITERAL:
-        case AST_TYPE_ASSIGNMENT_EXPR:
-        case AST_TYPE_BINARY_EXPR:
-        case AST_TYPE_BREAK_STMT:
-        case AST_TYPE_BUILTIN:
-        case AST_TYPE_CALL_EXPR:
-        case AST_TYPE_CAST_EXPR:
-        case AST_TYPE_DEFER_STMT:
-        case AST_TYPE_ENUM_DEFINITION:
-        case AST_TYPE_EXPRESSION_STMT:
-        case AST_TYPE_FUNCTION:
-        case AST_TYPE_IF_EXPR:
-        case AST_TYPE_LET_STMT:
-        case AST_TYPE_LITERAL:
-        case AST_TYPE_NUMBER:
-        case AST_TYPE_PROTOTYPE:
-        case AST_TYPE_RETURN_STMT:
-        case AST_TYPE_STRING:
-        case AST_TYPE_STRUCT_DEFINITION:
-        case AST_TYPE_STRUCT_VALUE:
-        case AST_TYPE_TYPE_EXPR:
-        case AST_TYPE_WHILE_EXPR:
+    ret_val = gen_codegen_stmts(n->function.body, module, builder,
+                                &has_return_stmt, logger);
+    return_ttype = n->function.prototype->prototype.return_type;
+    return_type = gen_type_to_llvm_type(return_ttype, logger);
+
+    if ((NULL == ret_val)
+        || !AST_is_expression(VECTOR_GET_AS(t_ast_node_ptr, n->function.body,
+                                            n->function.body->size - 1)))
+    {
+        if ((false == has_return_stmt))
+        {
+            switch (return_ttype->type)
             {
-                LOGGER_LOG_LOC(logger, L_ERROR, node->token,
-                               "Can't get address of %d.\n", node->type);
-                exit(LUKA_CODEGEN_ERROR);
+                case TYPE_VOID:
+                    ret_val = NULL;
+                    break;
+                case TYPE_F32:
+                case TYPE_F64:
+                    ret_val = LLVMConstReal(return_type, 0.0);
+                    break;
+                case TYPE_ANY:
+                case TYPE_STRING:
+                    ret_val = LLVMConstPointerNull(return_type);
+                    break;
+                case TYPE_SINT8:
+                case TYPE_SINT16:
+                case TYPE_SINT32:
+                case TYPE_SINT64:
+                    ret_val = LLVMConstInt(return_type, 0, true);
+                    break;
+                case TYPE_UINT8:
+                case TYPE_UINT16:
+                case TYPE_UINT32:
+                case TYPE_UINT64:
+                    ret_val = LLVMConstInt(return_type, 0, false);
+                    break;
+                case TYPE_ALIAS:
+                case TYPE_ARRAY:
+                case TYPE_BOOL:
+                case TYPE_ENUM:
+                case TYPE_PTR:
+                case TYPE_STRUCT:
+                case TYPE_TYPE:
+                    ret_val = LLVMConstInt(return_type, 0, false);
+                    break;
+                case TYPE_VECTOR:
+                    ret_val = LLVMConstNull(return_type);
+                    break;
             }
+        }
+    }
+    else if ((NULL != ret_val) && (LLVMTypeOf(ret_val) != return_type))
+    {
+        ret_val = gen_codegen_cast(builder, ret_val, return_type, logger);
+    }
+
+    (void) gen_codegen_defer_blocks(module, builder, logger);
+
+    if (!has_return_stmt)
+    {
+        (void) LLVMBuildRet(builder, ret_val);
+    }
+
+    (void) gen_scope_close(scope);
+
+    if (verify_functions
+        && (1 == LLVMVerifyFunction(func, LLVMReturnStatusAction)))
+    {
+        (void) LLVMDumpModule(module);
+        LOGGER_LOG_LOC(logger, L_ERROR, n->token, "Invalid function %s\n",
+                       n->function.prototype->prototype.name);
+        (void) LLVMVerifyFunction(func, LLVMPrintMessageAction);
+        (void) LLVMDeleteFunction(func);
+        exit(LUKA_CODEGEN_ERROR);
     }
+
+    return func;
 }
 
 /**
- * @brief Generate LLVM IR for an unary expression.
+ * @brief Generate LLVM IR for a return statement.
  *
  * @param[in] n the AST node.
  * @param[in] module the LLVM module.
  * @param[in] builder the LLVM builder.
  * @param[in] logger a logger that can be used to log messages.
  *
- * @return the built LLVM IR for the unary expression.
+ * @return the built LLVM IR for the return statement.
  */
-static LLVMValueRef gen_codegen_unexpr(t_ast_node *n, LLVMModuleRef module,
-                                       LLVMBuilderRef builder, t_logger *logger)
+static LLVMValueRef gen_codegen_return_stmt(t_ast_node *n, LLVMModuleRef module,
+                                            LLVMBuilderRef builder,
+                                            t_logger *logger)
 {
-    LLVMValueRef rhs = NULL;
-    t_type *type = NULL;
-    if (NULL != n->unary_expr.rhs)
-    {
-        rhs = GEN_codegen(n->unary_expr.rhs, module, builder, logger);
-    }
+    LLVMValueRef expr = NULL;
 
-    if (NULL == rhs)
+    if (NULL == n->return_stmt.expr)
     {
-        LOGGER_LOG_LOC(logger, L_ERROR, n->unary_expr.rhs->token,
-                       "Couldn't codegen rhs for unary expression.\n", NULL);
+        LOGGER_LOG_LOC(logger, L_ERROR, n->token,
+                       "Return statement has no expr.\n", NULL);
         exit(LUKA_CODEGEN_ERROR);
     }
 
-    switch (n->unary_expr.operator)
-    {
-        case UNOP_NOT:
-            {
-                return LLVMBuildNot(builder, rhs, "nottmp");
-            }
-        case UNOP_MINUS:
-            {
-                type = gen_llvm_type_to_ttype(LLVMTypeOf(rhs), logger);
-                if (TYPE_is_floating_type(type))
-                {
-                    (void) TYPE_free_type(type);
-                    type = NULL;
-                    return LLVMBuildFNeg(builder, rhs, "negtmp");
-                }
+    (void) gen_codegen_defer_blocks(module, builder, logger);
 
-                (void) TYPE_free_type(type);
-                type = NULL;
-                return LLVMBuildNeg(builder, rhs, "negtmp");
-            }
-        case UNOP_REF:
-            {
-                return gen_get_address(n->unary_expr.rhs, module, builder,
-                                       logger);
-            }
-        case UNOP_DEREF:
-            {
-                return LLVMBuildLoad(builder, rhs, "loadtmp");
-            }
-        case UNOP_PLUS:
-            {
-                LOGGER_LOG_LOC(logger, L_ERROR, n->token,
-                               "Currently not supporting %d operator in "
-                               "unary expression.\n",
-                               n->unary_expr.operator);
-                exit(LUKA_CODEGEN_ERROR);
-            }
-        case UNOP_BNOT:
-            {
-                return LLVMBuildXor(
-                    builder,
-                    LLVMConstInt(LLVMTypeOf(rhs), (unsigned long) -1, true),
-                    rhs, "bnottmp");
-            }
+    expr = GEN_codegen(n->return_stmt.expr, module, builder, logger);
+    if (NULL == expr)
+    {
+        LOGGER_LOG_LOC(logger, L_ERROR, n->token,
+                       "Expression generation failed in return stmt\n", NULL);
+        exit(LUKA_CODEGEN_ERROR);
     }
+    (void) LLVMBuildRet(builder, expr);
+    return NULL;
 }
 
 /**
- * @brief Generate LLVM IR for a binary expression.
+ * @brief Generate LLVM IR for an if expression.
  *
  * @param[in] n the AST node.
  * @param[in] module the LLVM module.
  * @param[in] builder the LLVM builder.
  * @param[in] logger a logger that can be used to log messages.
  *
- * @return the built LLVM IR for the binary expression.
+ * @return the built LLVM IR for the if expression.
  */
-static LLVMValueRef gen_codegen_binexpr(t_ast_node *n, LLVMModuleRef module,
+static LLVMValueRef gen_codegen_if_expr(t_ast_node *n, LLVMModuleRef module,
                                         LLVMBuilderRef builder,
                                         t_logger *logger)
 {
-    LLVMValueRef lhs = NULL, rhs = NULL;
-    LLVMOpcode opcode = LLVMAdd;
-    LLVMIntPredicate int_predicate = LLVMIntEQ;
-    LLVMRealPredicate real_predicate = LLVMRealOEQ;
+    LLVMValueRef then_value = NULL, else_value = NULL, phi = NULL, func = NULL,
+                 incoming_values[2] = {NULL, NULL};
+    LLVMBasicBlockRef cond_block = NULL, then_block = NULL, else_block = NULL,
+                      merge_block = NULL;
+    bool has_return_stmt = false;
+    size_t scope = 0;
 
-    if (NULL != n->binary_expr.lhs)
+    func = LLVMGetBasicBlockParent(LLVMGetInsertBlock(builder));
+
+    cond_block = LLVMAppendBasicBlock(func, "if_cond");
+    then_block = LLVMCreateBasicBlockInContext(LLVMGetGlobalContext(), "then");
+    if (NULL != n->if_expr.else_body)
     {
-        lhs = GEN_codegen(n->binary_expr.lhs, module, builder, logger);
+        else_block
+            = LLVMCreateBasicBlockInContext(LLVMGetGlobalContext(), "else");
     }
+    merge_block
+        = LLVMCreateBasicBlockInContext(LLVMGetGlobalContext(), "if_merge");
 
-    if (NULL != n->binary_expr.rhs)
+    (void) LLVMBuildBr(builder, cond_block);
+    (void) LLVMPositionBuilderAtEnd(builder, cond_block);
+
+    if (NULL
+        == gen_codegen_cond_br(n->if_expr.cond, then_block,
+                               (NULL != n->if_expr.else_body) ? else_block
+                                                              : merge_block,
+                               module, builder, logger))
     {
-        rhs = GEN_codegen(n->binary_expr.rhs, module, builder, logger);
+        LOGGER_LOG_LOC(logger, L_ERROR, n->token,
+                       "Condition generation failed in if expr\n", NULL);
+        exit(LUKA_CODEGEN_ERROR);
+    }
+
+    (void) LLVMAppendExistingBasicBlock(func, then_block);
+    (void) LLVMPositionBuilderAtEnd(builder, then_block);
+
+    scope = gen_scope_open();
+    then_value = gen_codegen_stmts(n->if_expr.then_body, module, builder,
+                                   &has_return_stmt, logger);
+    (void) gen_scope_close(scope);
+
+    if (!has_return_stmt)
+    {
+        (void) LLVMBuildBr(builder, merge_block);
+    }
+
+    then_block = LLVMGetInsertBlock(builder);
+
+    if (NULL != n->if_expr.else_body)
+    {
+        (void) LLVMAppendExistingBasicBlock(func, else_block);
+        (void) LLVMPositionBuilderAtEnd(builder, else_block);
+        has_return_stmt = false;
+        scope = gen_scope_open();
+        else_value = gen_codegen_stmts(n->if_expr.else_body, module, builder,
+                                       &has_return_stmt, logger);
+        (void) gen_scope_close(scope);
+
+        if (!has_return_stmt)
+        {
+            (void) LLVMBuildBr(builder, merge_block);
+        }
+    }
+
+    else_block = LLVMGetInsertBlock(builder);
+
+    (void) LLVMAppendExistingBasicBlock(func, merge_block);
+    (void) LLVMPositionBuilderAtEnd(builder, merge_block);
+
+    if ((NULL == then_value)
+        && !((NULL != n->if_expr.else_body) && (NULL != else_value)))
+    {
+        return NULL;
+    }
+
+    if (((NULL == then_value) && (NULL != else_value))
+        || ((NULL != then_value) && (NULL == else_value)))
+    {
+        LOGGER_LOG_LOC(
+            logger, L_ERROR, n->token,
+            "If one branch returns a values, both must return a value.\n",
+            NULL);
+        exit(LUKA_CODEGEN_ERROR);
     }
 
-    if ((NULL == lhs) || (NULL == rhs))
+    if ((NULL != n->if_expr.else_body)
+        && (LLVMTypeOf(then_value) != LLVMTypeOf(else_value)))
     {
         LOGGER_LOG_LOC(logger, L_ERROR, n->token,
-                       "Binexpr lhs or rhs is null.\n", NULL);
+                       "Values of then and else branches must be of the "
+                       "same type in if expr.\n",
+                       NULL);
         exit(LUKA_CODEGEN_ERROR);
     }
 
-    if (AST_is_cond_binop(n->binary_expr.operator))
-    {
-        (void) gen_llvm_cast_null_if_needed(&lhs, &rhs, logger);
-        if (gen_is_icmp(lhs, rhs, logger))
-        {
-            int_predicate = gen_llvm_get_int_predicate(
-                n->binary_expr.operator, & lhs, &rhs, builder, logger);
-            return LLVMBuildICmp(builder, int_predicate, lhs, rhs, "icmptmp");
-        }
-        real_predicate = gen_llvm_get_real_predicate(
-            n->binary_expr.operator, & lhs, &rhs, builder, logger);
-        return LLVMBuildFCmp(builder, real_predicate, lhs, rhs, "fcmptmp");
-    }
-
-    opcode = gen_get_llvm_opcode(n->binary_expr.operator, & lhs, &rhs, builder,
-                                 logger);
-    return LLVMBuildBinOp(builder, opcode, lhs, rhs, "binoptmp");
-}
+    phi = LLVMBuildPhi(builder, LLVMTypeOf(then_value), "phi");
 
-static LLVMTypeRef gen_function_type(t_ast_node *prototype, t_logger *logger)
-{
-    size_t i = 0, arity = prototype->prototype.arity;
-    bool vararg = prototype->prototype.vararg;
-    LLVMTypeRef *params = NULL;
+    (void) LLVMAddIncoming(phi, &then_value, &then_block, 1);
 
-    if (vararg)
-    {
-        --arity;
-    }
-    params = calloc(arity, sizeof(LLVMTypeRef));
-    if (NULL == params)
+    if (NULL != n->if_expr.else_body)
     {
-        (void) LOGGER_log(
-            logger, L_ERROR,
-            "Failed to assign memory for params in prototype generaion.\n");
-        exit(LUKA_CANT_ALLOC_MEMORY);
+        (void) LLVMAddIncoming(phi, &else_value, &else_block, 1);
     }
-
-    for (i = 0; i < arity; ++i)
+    else
     {
-        params[i]
-            = gen_type_to_llvm_type(prototype->prototype.types[i], logger);
+        incoming_values[0] = LLVMConstInt(LLVMInt32Type(), 0, 0);
+        (void) LLVMAddIncoming(phi, incoming_values, &cond_block, 1);
     }
 
-    return LLVMFunctionType(
-        gen_type_to_llvm_type(prototype->prototype.return_type, logger), params,
-        (unsigned int) arity, vararg);
+    return phi;
 }
 
 /**
- * @brief Generate LLVM IR for a function prototype.
+ * @brief Find the enum that a match expression matches, from the type of its
+ * value or from the enum values used as its patterns.
  *
- * @param[in] n the AST node.
- * @param[in] module the LLVM module.
- * @param[in] builder the LLVM builder.
+ * @param[in] n the AST node of the match expression.
  * @param[in] logger a logger that can be used to log messages.
  *
- * @return the built LLVM IR for the function prototype.
+ * @return the info of the enum, or NULL if the match is over integers.
  */
-static LLVMValueRef gen_codegen_prototype(t_ast_node *n, LLVMModuleRef module,
-                                          LLVMBuilderRef UNUSED(builder),
-                                          t_logger *logger)
+static t_enum_info *gen_match_enum_info(t_ast_node *n, t_logger *logger)
 {
-    LLVMValueRef func = NULL, module_func = NULL, param = NULL;
-    LLVMTypeRef func_type = NULL;
-    unsigned int i = 0;
-    size_t arity = n->prototype.arity;
-    bool vararg = n->prototype.vararg;
-    LLVMTypeRef *params = NULL;
-    char *func_type_str = NULL, *module_func_str = NULL;
-    if (vararg)
-    {
-        --arity;
-    }
-
-    func_type = gen_function_type(n, logger);
+    const t_ast_match_arm *arm = NULL;
+    t_ast_node *pattern = NULL;
+    t_type *type = gen_expr_lane_type(n->match_expr.value);
+    t_enum_info *enum_info = NULL;
+    char *enum_name = NULL, *pattern_enum_name = NULL;
 
-    module_func = LLVMGetNamedFunction(module, n->prototype.name);
-    if (NULL != module_func)
+    if ((NULL != type) && (TYPE_ENUM == type->type))
     {
-        func_type_str = LLVMPrintTypeToString(func_type);
-        module_func_str = LLVMPrintTypeToString(LLVMTypeOf(module_func));
-        if ((LLVMExternalLinkage == LLVMGetLinkage(module_func))
-            && (0 == strcmp(func_type_str, module_func_str)))
-        {
-            func = module_func;
-            goto l_cleanup;
-        }
+        enum_name = type->payload;
     }
-    func = LLVMAddFunction(module, n->prototype.name, func_type);
-    (void) LLVMSetLinkage(func, LLVMExternalLinkage);
 
-    for (i = 0; i < arity; ++i)
+    VECTOR_FOR_EACH(n->match_expr.arms, arms)
     {
-        param = LLVMGetParam(func, i);
-        (void) LLVMSetValueName(param, n->prototype.args[i]);
-    }
+        arm = ITERATOR_GET_AS(t_ast_match_arm_ptr, &arms);
+        VECTOR_FOR_EACH(arm->patterns, patterns)
+        {
+            pattern = ITERATOR_GET_AS(t_ast_node_ptr, &patterns);
+            if ((AST_TYPE_GET_EXPR != pattern->type)
+                || !pattern->get_expr.is_enum)
+            {
+                continue;
+            }
 
-l_cleanup:
-    if (NULL != params)
-    {
-        (void) free(params);
+            pattern_enum_name = pattern->get_expr.variable->variable.name;
+            if (NULL == enum_name)
+            {
+                enum_name = pattern_enum_name;
+            }
+            else if (0 != strcmp(enum_name, pattern_enum_name))
+            {
+                LOGGER_LOG_LOC(logger, L_ERROR, pattern->token,
+                               "Pattern of enum %s in a match expression over "
+                               "enum %s.\n",
+                               pattern_enum_name, enum_name);
+                exit(LUKA_CODEGEN_ERROR);
+            }
+        }
     }
 
-    if (NULL != func_type_str)
+    if (NULL == enum_name)
     {
-        (void) LLVMDisposeMessage(func_type_str);
+        return NULL;
     }
 
-    if (NULL != module_func_str)
+    HASH_FIND_STR(enum_infos, enum_name, enum_info);
+    if (NULL == enum_info)
     {
-        (void) LLVMDisposeMessage(module_func_str);
+        LOGGER_LOG_LOC(logger, L_ERROR, n->token,
+                       "Couldn't find enum info for enum %s.\n", enum_name);
+        exit(LUKA_CODEGEN_ERROR);
     }
 
-    return func;
+    return enum_info;
 }
 
 /**
- * @brief Generate LLVM IR for a vector of statements.
+ * @brief Generate the constant values of the patterns of a match expression,
+ * in the order of its arms.
  *
- * @param[in] statements a vector of AST nodes for the statements.
+ * @param[in] n the AST node of the match expression.
+ * @param[in] type the LLVM type of the matched value.
+ * @param[out] cases the values of the patterns.
  * @param[in] module the LLVM module.
  * @param[in] builder the LLVM builder.
- * @param[out] has_return_stmt whether there's a return statement in one of
- * these statements.
  * @param[in] logger a logger that can be used to log messages.
- *
- * @return the built LLVM IR for the statements.
  */
-static LLVMValueRef gen_codegen_stmts(t_vector *statements,
-                                      LLVMModuleRef module,
-                                      LLVMBuilderRef builder,
-                                      bool *has_return_stmt, t_logger *logger)
+static void gen_codegen_match_patterns(t_ast_node *n, LLVMTypeRef type,
+                                       LLVMValueRef *cases,
+                                       LLVMModuleRef module,
+                                       LLVMBuilderRef builder,
+                                       t_logger *logger)
 {
-    t_ast_node *stmt = NULL;
-    LLVMValueRef ret_val = NULL;
+    const t_ast_match_arm *arm = NULL;
+    t_ast_node *pattern = NULL;
+    LLVMValueRef value = NULL;
+    size_t number_of_cases = 0, i = 0;
 
-    VECTOR_FOR_EACH(statements, stmts)
+    VECTOR_FOR_EACH(n->match_expr.arms, arms)
     {
-        stmt = ITERATOR_GET_AS(t_ast_node_ptr, &stmts);
-        if (AST_TYPE_RETURN_STMT == stmt->type)
+        arm = ITERATOR_GET_AS(t_ast_match_arm_ptr, &arms);
+        VECTOR_FOR_EACH(arm->patterns, patterns)
         {
-            ret_val = GEN_codegen(stmt, module, builder, logger);
+            pattern = ITERATOR_GET_AS(t_ast_node_ptr, &patterns);
+            value = GEN_codegen(pattern, module, builder, logger);
+            if ((NULL == value) || (NULL == LLVMIsAConstantInt(value)))
+            {
+                LOGGER_LOG_LOC(logger, L_ERROR, pattern->token,
+                               "Match patterns must be constant integers or "
+                               "enum values.\n",
+                               NULL);
+                exit(LUKA_CODEGEN_ERROR);
+            }
 
-            if (NULL != has_return_stmt)
+            value = LLVMConstIntCast(value, type,
+                                     !gen_is_unsigned_expr(pattern));
+            /* Constants are uniqued, so equal patterns are the same value */
+            for (i = 0; i < number_of_cases; ++i)
             {
-                *has_return_stmt = true;
+                if (cases[i] == value)
+                {
+                    LOGGER_LOG_LOC(logger, L_ERROR, pattern->token,
+                                   "Pattern is already matched by an earlier "
+                                   "arm of the match expression.\n",
+                                   NULL);
+                    exit(LUKA_CODEGEN_ERROR);
+                }
             }
-            break;
+
+            cases[number_of_cases] = value;
+            ++number_of_cases;
         }
-        ret_val = GEN_codegen(stmt, module, builder, logger);
     }
+}
 
-    return ret_val;
+/**
+ * @brief Check whether the patterns of a match expression cover every field
+ * of an enum, reporting the first field that isn't covered.
+ *
+ * @param[in] n the AST node of the match expression.
+ * @param[in] enum_info the enum the match expression matches.
+ * @param[in] cases the values of the patterns.
+ * @param[in] number_of_cases the number of patterns.
+ * @param[in] logger a logger that can be used to log messages.
+ */
+static void gen_check_match_exhaustive(t_ast_node *n,
+                                       const t_enum_info *enum_info,
+                                       LLVMValueRef *cases,
+                                       size_t number_of_cases,
+                                       t_logger *logger)
+{
+    size_t i = 0, j = 0;
+
+    for (i = 0; i < enum_info->number_of_fields; ++i)
+    {
+        for (j = 0; j < number_of_cases; ++j)
+        {
+            if (enum_info->enum_field_values[i]
+                == LLVMConstIntGetSExtValue(cases[j]))
+            {
+                break;
+            }
+        }
+
+        if (j == number_of_cases)
+        {
+            LOGGER_LOG_LOC(logger, L_ERROR, n->token,
+                           "Match expression doesn't cover %s::%s, add an arm "
+                           "for it or an `else` arm.\n",
+                           enum_info->enum_name,
+                           enum_info->enum_field_names[i]);
+            exit(LUKA_CODEGEN_ERROR);
+        }
+    }
 }
 
 /**
- * @brief Generate LLVM IR for a function.
+ * @brief Generate LLVM IR for a match expression.
+ *
+ * @details The match is lowered to a single switch instruction, which LLVM
+ * turns into a jump table, a lookup table or a binary search. A match over an
+ * enum without an `else` arm must cover every field of the enum. Enum values
+ * are plain integers that can hold any value, so such a match traps on a
+ * value that isn't one of the fields instead of assuming it can't happen.
  *
  * @param[in] n the AST node.
  * @param[in] module the LLVM module.
  * @param[in] builder the LLVM builder.
  * @param[in] logger a logger that can be used to log messages.
  *
- * @return the built LLVM IR for the function.
+ * @return a PHI node with the value of the arm that was executed, or NULL if
+ * the arms don't have values.
  */
-static LLVMValueRef gen_codegen_function(t_ast_node *n, LLVMModuleRef module,
-                                         LLVMBuilderRef builder,
-                                         t_logger *logger)
+static LLVMValueRef gen_codegen_match_expr(t_ast_node *n, LLVMModuleRef module,
+                                           LLVMBuilderRef builder,
+                                           t_logger *logger)
 {
-    LLVMValueRef func = NULL, ret_val = NULL;
-    LLVMBasicBlockRef block = NULL;
-    t_ast_node *proto = NULL;
+    LLVMValueRef func = NULL, value = NULL, switch_inst = NULL, phi = NULL,
+                 trap = NULL, *cases = NULL, *incoming_values = NULL;
+    LLVMBasicBlockRef default_block = NULL, merge_block = NULL,
+                      arm_block = NULL, *incoming_blocks = NULL;
+    const t_ast_match_arm *arm = NULL;
+    const t_enum_info *enum_info = NULL;
+    t_vector *body = NULL;
+    size_t number_of_cases = 0, number_of_incoming = 0, number_of_values = 0,
+           next_case = 0, scope = 0, i = 0, j = 0;
     bool has_return_stmt = false;
-    t_type *return_ttype;
-    LLVMTypeRef return_type = NULL, expected_func_type = NULL, func_type = NULL;
-    unsigned int i = 0;
-    size_t arity = 0;
-    t_named_value *val = NULL;
-    char **args = NULL;
 
-    expected_func_type = gen_function_type(n->function.prototype, logger);
-    func = LLVMGetNamedFunction(module, n->function.prototype->prototype.name);
-    if (NULL == func)
-    {
-        func = GEN_codegen(n->function.prototype, module, builder, logger);
-    }
-    else if (0 != LLVMCountBasicBlocks(func))
+    func = LLVMGetBasicBlockParent(LLVMGetInsertBlock(builder));
+
+    value = GEN_codegen(n->match_expr.value, module, builder, logger);
+    if ((NULL == value)
+        || (LLVMIntegerTypeKind != LLVMGetTypeKind(LLVMTypeOf(value))))
     {
         LOGGER_LOG_LOC(logger, L_ERROR, n->token,
-                       "Cannot redefine function %s\n",
-                       n->function.prototype->prototype.name);
+                       "Match expressions can only match integers and "
+                       "enums.\n",
+                       NULL);
         exit(LUKA_CODEGEN_ERROR);
     }
-    else if ((func_type = LLVMGetElementType(LLVMTypeOf(func)))
-             != expected_func_type)
+
+    VECTOR_FOR_EACH(n->match_expr.arms, arms)
     {
-        LOGGER_LOG_LOC(logger, L_ERROR, n->token,
-                       "Previous declaration of function %s does not match "
-                       "current declaration, previous: %s, current: %s\n",
-                       n->function.prototype->prototype.name,
-                       LLVMPrintTypeToString(func_type),
-                       LLVMPrintTypeToString(expected_func_type));
-        exit(LUKA_CODEGEN_ERROR);
+        arm = ITERATOR_GET_AS(t_ast_match_arm_ptr, &arms);
+        number_of_cases += arm->patterns->size;
     }
 
-    if (NULL == func)
+    cases = calloc(number_of_cases + 1, sizeof(LLVMValueRef));
+    incoming_values
+        = calloc(n->match_expr.arms->size + 1, sizeof(LLVMValueRef));
+    incoming_blocks
+        = calloc(n->match_expr.arms->size + 1, sizeof(LLVMBasicBlockRef));
+    if ((NULL == cases) || (NULL == incoming_values)
+        || (NULL == incoming_blocks))
     {
-        LOGGER_LOG_LOC(logger, L_ERROR, n->token,
-                       "Prototype generation failed in function generation\n",
-                       NULL);
-        exit(LUKA_CODEGEN_ERROR);
+        (void) LOGGER_log(logger, L_ERROR,
+                          "Couldn't allocate memory for a match expr.\n");
+        exit(LUKA_CANT_ALLOC_MEMORY);
     }
 
-    if (NULL == n->function.body)
+    (void) gen_codegen_match_patterns(n, LLVMTypeOf(value), cases, module,
+                                      builder, logger);
+
+    merge_block
+        = LLVMCreateBasicBlockInContext(LLVMGetGlobalContext(), "match_merge");
+    enum_info = gen_match_enum_info(n, logger);
+    if (NULL != n->match_expr.else_body)
     {
-        /* Extern definition */
-        return func;
+        default_block = LLVMCreateBasicBlockInContext(LLVMGetGlobalContext(),
+                                                      "match_else");
+    }
+    else if (NULL != enum_info)
+    {
+        (void) gen_check_match_exhaustive(n, enum_info, cases,
+                                          number_of_cases, logger);
+        default_block = LLVMCreateBasicBlockInContext(LLVMGetGlobalContext(),
+                                                      "match_trap");
+    }
+    else
+    {
+        default_block = merge_block;
     }
 
-    proto = n->function.prototype;
-    arity = proto->prototype.arity;
-    args = proto->prototype.args;
+    switch_inst = LLVMBuildSwitch(builder, value, default_block,
+                                  (unsigned int) number_of_cases);
 
-    (void) vector_clear(defer_blocks);
+    for (i = 0; i <= n->match_expr.arms->size; ++i)
+    {
+        if (i < n->match_expr.arms->size)
+        {
+            arm = VECTOR_GET_AS(t_ast_match_arm_ptr, n->match_expr.arms, i);
+            arm_block = LLVMAppendBasicBlock(func, "match_arm");
+            for (j = 0; j < arm->patterns->size; ++j)
+            {
+                (void) LLVMAddCase(switch_inst, cases[next_case], arm_block);
+                ++next_case;
+            }
+            body = arm->body;
+        }
+        else if (NULL != n->match_expr.else_body)
+        {
+            arm_block = default_block;
+            (void) LLVMAppendExistingBasicBlock(func, arm_block);
+            body = n->match_expr.else_body;
+        }
+        else
+        {
+            break;
+        }
 
-    block = LLVMAppendBasicBlock(func, "entry");
-    (void) LLVMPositionBuilderAtEnd(builder, block);
+        (void) LLVMPositionBuilderAtEnd(builder, arm_block);
+        has_return_stmt = false;
+        scope = gen_scope_open();
+        incoming_values[number_of_incoming] = gen_codegen_stmts(
+            body, module, builder, &has_return_stmt, logger);
+        (void) gen_scope_close(scope);
+
+        if (has_return_stmt)
+        {
+            continue;
+        }
+
+        (void) LLVMBuildBr(builder, merge_block);
+        incoming_blocks[number_of_incoming] = LLVMGetInsertBlock(builder);
+        if (NULL != incoming_values[number_of_incoming])
+        {
+            ++number_of_values;
+        }
+        ++number_of_incoming;
+    }
+
+    if ((NULL == n->match_expr.else_body) && (default_block != merge_block))
+    {
+        (void) LLVMAppendExistingBasicBlock(func, default_block);
+        (void) LLVMPositionBuilderAtEnd(builder, default_block);
+        trap = LLVMGetIntrinsicDeclaration(
+            module, LLVMLookupIntrinsicID("llvm.trap", strlen("llvm.trap")),
+            NULL, 0);
+        (void) LLVMBuildCall2(builder, LLVMGlobalGetValueType(trap), trap,
+                              NULL, 0, "");
+        (void) LLVMBuildUnreachable(builder);
+    }
+
+    (void) LLVMAppendExistingBasicBlock(func, merge_block);
+    (void) LLVMPositionBuilderAtEnd(builder, merge_block);
+    (void) free(cases);
+
+    if (0 == number_of_values)
+    {
+        (void) free(incoming_values);
+        (void) free(incoming_blocks);
+        return NULL;
+    }
+
+    if ((number_of_values != number_of_incoming)
+        || (default_block == merge_block))
+    {
+        LOGGER_LOG_LOC(logger, L_ERROR, n->token,
+                       "If one arm of a match expression returns a value, "
+                       "every arm must return a value, and it needs an "
+                       "`else` arm unless it covers every field of an "
+                       "enum.\n",
+                       NULL);
+        exit(LUKA_CODEGEN_ERROR);
+    }
 
-    for (i = 0; i < arity; ++i)
+    for (i = 1; i < number_of_incoming; ++i)
     {
-        val = malloc(sizeof(t_named_value));
-        if (NULL == val)
+        if (LLVMTypeOf(incoming_values[i]) != LLVMTypeOf(incoming_values[0]))
         {
             LOGGER_LOG_LOC(logger, L_ERROR, n->token,
-                           "Couldn't allocate memory for named value in "
-                           "gen_codegen_function.",
+                           "Values of the arms of a match expression must be "
+                           "of the same type.\n",
                            NULL);
             exit(LUKA_CODEGEN_ERROR);
         }
+    }
 
-        val->name = strdup(args[i]);
-        val->type = LLVMTypeOf(LLVMGetParam(func, i));
-        val->ttype = TYPE_dup_type(proto->prototype.types[i]);
-        val->mutable = val->ttype->mutable;
-        val->alloca_inst
-            = gen_create_entry_block_allca(func, val->type, val->name);
+    phi = LLVMBuildPhi(builder, LLVMTypeOf(incoming_values[0]), "matchtmp");
+    (void) LLVMAddIncoming(phi, incoming_values, incoming_blocks,
+                           (unsigned int) number_of_incoming);
+    (void) free(incoming_values);
+    (void) free(incoming_blocks);
 
-        (void) LLVMBuildStore(builder, LLVMGetParam(func, i), val->alloca_inst);
+    return phi;
+}
 
-        HASH_ADD_KEYPTR(hh, named_values, val->name, strlen(val->name), val);
+/**
+ * @brief Build a property of a loop ID, such as
+ * `!{!"llvm.loop.unroll.count", i32 4}`.
+ *
+ * @param[in] name the name of the property.
+ * @param[in] value the value of the property, or NULL if it has none.
+ *
+ * @return the metadata node of the property.
+ */
+static LLVMMetadataRef gen_loop_property(const char *name, LLVMValueRef value)
+{
+    LLVMContextRef context = LLVMGetGlobalContext();
+    LLVMMetadataRef operands[2];
 
-        val = NULL;
+    operands[0] = LLVMMDStringInContext2(context, name, strlen(name));
+    if (NULL == value)
+    {
+        return LLVMMDNodeInContext2(context, operands, 1);
     }
 
-    ret_val = gen_codegen_stmts(n->function.body, module, builder,
-                                &has_return_stmt, logger);
-    return_ttype = n->function.prototype->prototype.return_type;
-    return_type = gen_type_to_llvm_type(return_ttype, logger);
+    operands[1] = LLVMValueAsMetadata(value);
+    return LLVMMDNodeInContext2(context, operands, 2);
+}
 
-    if ((NULL == ret_val)
-        || !AST_is_expression(VECTOR_GET_AS(t_ast_node_ptr, n->function.body,
-                                            n->function.body->size - 1)))
+/**
+ * @brief Create an access group for the memory accesses of a loop with the
+ * `@parallel_access` hint.
+ *
+ * @details An access group must be a distinct node, which the C API can't
+ * create, so it is taken from a snippet of IR that is parsed into the global
+ * context. The node outlives the module it was parsed into, as metadata nodes
+ * belong to the context.
+ *
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return the metadata node of the new access group.
+ */
+static LLVMMetadataRef gen_access_group(t_logger *logger)
+{
+    const char *ir = "define void @group() {\n"
+                     "  ret void, !luka.group !0\n"
+                     "}\n"
+                     "!0 = distinct !{}\n";
+    LLVMModuleRef module = NULL;
+    LLVMMemoryBufferRef buffer = NULL;
+    LLVMValueRef inst = NULL;
+    LLVMMetadataRef group = NULL;
+    char *error = NULL;
+
+    /* Parsing takes ownership of the buffer */
+    buffer = LLVMCreateMemoryBufferWithMemoryRangeCopy(ir, strlen(ir), "group");
+    if (0 != LLVMParseIRInContext(LLVMGetGlobalContext(), buffer, &module,
+                                  &error))
     {
-        if ((false == has_return_stmt))
+        (void) LOGGER_log(logger, L_ERROR,
+                          "Couldn't build an access group:\n%s\n", error);
+        exit(LUKA_CODEGEN_ERROR);
+    }
+
+    inst = LLVMGetFirstInstruction(
+        LLVMGetEntryBasicBlock(LLVMGetNamedFunction(module, "group")));
+    group = LLVMValueAsMetadata(
+        LLVMGetMetadata(inst, LLVMGetMDKindID("luka.group", 10)));
+    (void) LLVMDisposeModule(module);
+    return group;
+}
+
+/**
+ * @brief Put the memory accesses in the blocks of a loop in its access group.
+ *
+ * @details An access that is already in the group of an inner loop is put in
+ * a list of both groups, so it stays parallel in the inner loop.
+ *
+ * @param[in] first_block the first block of the loop.
+ * @param[in] end_block the block after the last block of the loop.
+ * @param[in] group the access group of the loop.
+ */
+static void gen_set_access_group(LLVMBasicBlockRef first_block,
+                                 LLVMBasicBlockRef end_block,
+                                 LLVMMetadataRef group)
+{
+    LLVMContextRef context = LLVMGetGlobalContext();
+    LLVMBasicBlockRef block = NULL;
+    LLVMValueRef inst = NULL, groups = NULL, *operands = NULL;
+    LLVMMetadataRef *list = NULL;
+    unsigned int kind = LLVMGetMDKindID("llvm.access.group", 17);
+    unsigned int length = 0, i = 0;
+
+    for (block = first_block; (NULL != block) && (end_block != block);
+         block = LLVMGetNextBasicBlock(block))
+    {
+        for (inst = LLVMGetFirstInstruction(block); NULL != inst;
+             inst = LLVMGetNextInstruction(inst))
         {
-            switch (return_ttype->type)
+            if ((NULL == LLVMIsALoadInst(inst))
+                && (NULL == LLVMIsAStoreInst(inst))
+                && (NULL == LLVMIsACallInst(inst)))
             {
-                case TYPE_VOID:
-                    ret_val = NULL;
-                    break;
-                case TYPE_F32:
-                case TYPE_F64:
-                    ret_val = LLVMConstReal(return_type, 0.0);
-                    break;
-                case TYPE_ANY:
-                case TYPE_STRING:
-                    ret_val = LLVMConstPointerNull(return_type);
-                    break;
-                case TYPE_SINT8:
-                case TYPE_SINT16:
-                case TYPE_SINT32:
-                case TYPE_SINT64:
-                    ret_val = LLVMConstInt(return_type, 0, true);
-                    break;
-                case TYPE_UINT8:
-                case TYPE_UINT16:
-                case TYPE_UINT32:
-                case TYPE_UINT64:
-                    ret_val = LLVMConstInt(return_type, 0, false);
-                    break;
-                case TYPE_ALIAS:
-                case TYPE_ARRAY:
-                case TYPE_BOOL:
-                case TYPE_ENUM:
-                case TYPE_PTR:
-                case TYPE_STRUCT:
-                case TYPE_TYPE:
-                    ret_val = LLVMConstInt(return_type, 0, false);
-                    break;
+                continue;
             }
-        }
-    }
-    else if ((NULL != ret_val) && (LLVMTypeOf(ret_val) != return_type))
-    {
-        ret_val = gen_codegen_cast(builder, ret_val, return_type, logger);
-    }
 
-    (void) gen_codegen_defer_blocks(module, builder, logger);
+            groups = LLVMGetMetadata(inst, kind);
+            if (NULL == groups)
+            {
+                (void) LLVMSetMetadata(inst, kind,
+                                       LLVMMetadataAsValue(context, group));
+                continue;
+            }
 
-    if (!has_return_stmt)
-    {
-        (void) LLVMBuildRet(builder, ret_val);
-    }
+            /* A group has no operands, while a list has the groups in it */
+            length = LLVMGetMDNodeNumOperands(groups);
+            operands = calloc(length + 1, sizeof(LLVMValueRef));
+            list = calloc(length + 2, sizeof(LLVMMetadataRef));
+            if ((NULL == operands) || (NULL == list))
+            {
+                exit(LUKA_CANT_ALLOC_MEMORY);
+            }
 
-    if (1 == LLVMVerifyFunction(func, LLVMReturnStatusAction))
-    {
-        (void) LLVMDumpModule(module);
-        LOGGER_LOG_LOC(logger, L_ERROR, n->token, "Invalid function %s\n",
-                       n->function.prototype->prototype.name);
-        (void) LLVMVerifyFunction(func, LLVMPrintMessageAction);
-        (void) LLVMDeleteFunction(func);
-        exit(LUKA_CODEGEN_ERROR);
+            (void) LLVMGetMDNodeOperands(groups, operands);
+            for (i = 0; i < length; ++i)
+            {
+                list[i] = LLVMValueAsMetadata(operands[i]);
+            }
+            if (0 == length)
+            {
+                list[length++] = LLVMValueAsMetadata(groups);
+            }
+            list[length++] = group;
+
+            (void) LLVMSetMetadata(
+                inst, kind,
+                LLVMMetadataAsValue(context,
+                                    LLVMMDNodeInContext2(context, list,
+                                                         length)));
+            (void) free(operands);
+            (void) free(list);
+        }
     }
-
-    return func;
 }
 
 /**
- * @brief Generate LLVM IR for a return statement.
+ * @brief Attach loop metadata to the branch of the latch of a loop.
  *
- * @param[in] n the AST node.
- * @param[in] module the LLVM module.
- * @param[in] builder the LLVM builder.
- * @param[in] logger a logger that can be used to log messages.
+ * @details The loop ID is a node that refers to itself, followed by the
+ * properties of the loop, and is what passes such as the loop vectorizer look
+ * for to recognize the loop. Nothing is attached if the loop has no
+ * properties.
  *
- * @return the built LLVM IR for the return statement.
+ * @param[in] branch the branch at the end of the latch of the loop.
+ * @param[in] hints the optimization hints of the loop.
+ * @param[in] must_progress whether the loop is known to terminate.
+ * @param[in] access_group the access group of the loop, or NULL if its
+ * accesses aren't parallel.
  */
-static LLVMValueRef gen_codegen_return_stmt(t_ast_node *n, LLVMModuleRef module,
-                                            LLVMBuilderRef builder,
-                                            t_logger *logger)
+static void gen_set_loop_metadata(LLVMValueRef branch,
+                                  const t_loop_hints *hints, bool must_progress,
+                                  LLVMMetadataRef access_group)
 {
-    LLVMValueRef expr = NULL;
+    LLVMContextRef context = LLVMGetGlobalContext();
+    LLVMMetadataRef self = NULL, loop_id = NULL;
+    LLVMMetadataRef operands[8];
+    LLVMTypeRef i32 = LLVMInt32TypeInContext(context);
+    LLVMTypeRef i1 = LLVMInt1TypeInContext(context);
+    unsigned int count = 1;
 
-    if (NULL == n->return_stmt.expr)
+    if (must_progress)
     {
-        LOGGER_LOG_LOC(logger, L_ERROR, n->token,
-                       "Return statement has no expr.\n", NULL);
-        exit(LUKA_CODEGEN_ERROR);
+        operands[count++] = gen_loop_property("llvm.loop.mustprogress", NULL);
     }
 
-    (void) gen_codegen_defer_blocks(module, builder, logger);
+    if (hints->unroll_full)
+    {
+        operands[count++] = gen_loop_property("llvm.loop.unroll.full", NULL);
+    }
+    else if (1 == hints->unroll_count)
+    {
+        operands[count++]
+            = gen_loop_property("llvm.loop.unroll.disable", NULL);
+    }
+    else if (0 != hints->unroll_count)
+    {
+        operands[count++] = gen_loop_property(
+            "llvm.loop.unroll.count",
+            LLVMConstInt(i32, hints->unroll_count, false));
+    }
 
-    expr = GEN_codegen(n->return_stmt.expr, module, builder, logger);
-    if (NULL == expr)
+    if (hints->vectorize || hints->no_vectorize)
     {
-        LOGGER_LOG_LOC(logger, L_ERROR, n->token,
-                       "Expression generation failed in return stmt\n", NULL);
-        exit(LUKA_CODEGEN_ERROR);
+        operands[count++]
+            = gen_loop_property("llvm.loop.vectorize.enable",
+                                LLVMConstInt(i1, hints->vectorize, false));
     }
-    (void) LLVMBuildRet(builder, expr);
-    return NULL;
+
+    if (0 != hints->vectorize_width)
+    {
+        operands[count++] = gen_loop_property(
+            "llvm.loop.vectorize.width",
+            LLVMConstInt(i32, hints->vectorize_width, false));
+    }
+
+    if (0 != hints->interleave_count)
+    {
+        operands[count++] = gen_loop_property(
+            "llvm.loop.interleave.count",
+            LLVMConstInt(i32, hints->interleave_count, false));
+    }
+
+    if (NULL != access_group)
+    {
+        operands[count++] = gen_loop_property(
+            "llvm.loop.parallel_accesses",
+            LLVMMetadataAsValue(context, access_group));
+    }
+
+    if (1 == count)
+    {
+        return;
+    }
+
+    self = LLVMTemporaryMDNode(context, NULL, 0);
+    operands[0] = self;
+    loop_id = LLVMMDNodeInContext2(context, operands, count);
+    (void) LLVMMetadataReplaceAllUsesWith(self, loop_id);
+
+    (void) LLVMSetMetadata(branch, LLVMGetMDKindID("llvm.loop", 9),
+                           LLVMMetadataAsValue(context, loop_id));
 }
 
 /**
- * @brief Generate LLVM IR for an if expression.
+ * @brief Generate LLVM IR for a while expression.
  *
  * @param[in] n the AST node.
  * @param[in] module the LLVM module.
  * @param[in] builder the LLVM builder.
  * @param[in] logger a logger that can be used to log messages.
  *
- * @return the built LLVM IR for the if expression.
+ * @return the built LLVM IR for the while expression.
  */
-static LLVMValueRef gen_codegen_if_expr(t_ast_node *n, LLVMModuleRef module,
-                                        LLVMBuilderRef builder,
-                                        t_logger *logger)
+static LLVMValueRef gen_codegen_while_expr(t_ast_node *n, LLVMModuleRef module,
+                                           LLVMBuilderRef builder,
+                                           t_logger *logger)
 {
-    LLVMValueRef cond = NULL, then_value = NULL, else_value = NULL, phi = NULL,
-                 func = NULL, incoming_values[2] = {NULL, NULL};
-    LLVMBasicBlockRef cond_block = NULL, then_block = NULL, else_block = NULL,
-                      merge_block = NULL;
-    bool has_return_stmt = false;
+    LLVMValueRef func = NULL, cond = NULL, body_value = NULL, branch = NULL;
+    LLVMBasicBlockRef cond_block = NULL, body_block = NULL, end_block = NULL;
+    LLVMMetadataRef group = NULL;
+    t_loop_blocks blocks;
+    size_t scope = 0;
 
     func = LLVMGetBasicBlockParent(LLVMGetInsertBlock(builder));
 
-    cond_block = LLVMAppendBasicBlock(func, "if_cond");
-    then_block = LLVMCreateBasicBlockInContext(LLVMGetGlobalContext(), "then");
-    if (NULL != n->if_expr.else_body)
+    cond_block = LLVMAppendBasicBlock(func, "while_cond");
+    body_block = LLVMAppendBasicBlock(func, "while_body");
+    end_block
+        = LLVMCreateBasicBlockInContext(LLVMGetGlobalContext(), "while_end");
+
+    if (NULL != loop_blocks)
     {
-        else_block
-            = LLVMCreateBasicBlockInContext(LLVMGetGlobalContext(), "else");
+        blocks.label = n->while_expr.label;
+        blocks.continue_block = cond_block;
+        blocks.break_block = end_block;
+        (void) vector_push_front(loop_blocks, &blocks);
     }
-    merge_block
-        = LLVMCreateBasicBlockInContext(LLVMGetGlobalContext(), "if_merge");
 
     (void) LLVMBuildBr(builder, cond_block);
     (void) LLVMPositionBuilderAtEnd(builder, cond_block);
 
-    cond = GEN_codegen(n->if_expr.cond, module, builder, logger);
-    if (NULL == cond)
+    if (NULL
+        == gen_codegen_cond_br(n->while_expr.cond, body_block, end_block,
+                               module, builder, logger))
     {
         LOGGER_LOG_LOC(logger, L_ERROR, n->token,
-                       "Condition generation failed in if expr\n", NULL);
+                       "Condition generation failed in while expr\n", NULL);
         exit(LUKA_CODEGEN_ERROR);
     }
 
-    if (NULL != n->if_expr.else_body)
-    {
-        (void) LLVMBuildCondBr(builder, cond, then_block, else_block);
-    }
-    else
+    (void) LLVMPositionBuilderAtEnd(builder, body_block);
+
+    scope = gen_scope_open();
+    body_value
+        = gen_codegen_stmts(n->while_expr.body, module, builder, NULL, logger);
+    (void) gen_scope_close(scope);
+    /* The latch is a single branch, since it carries the loop metadata */
+    cond = GEN_codegen(n->while_expr.cond, module, builder, logger);
+    if (NULL == cond)
     {
-        (void) LLVMBuildCondBr(builder, cond, then_block, merge_block);
+        LOGGER_LOG_LOC(logger, L_ERROR, n->token,
+                       "Condition generation failed in while expr\n", NULL);
+        exit(LUKA_CODEGEN_ERROR);
     }
-
-    (void) LLVMAppendExistingBasicBlock(func, then_block);
-    (void) LLVMPositionBuilderAtEnd(builder, then_block);
-
-    then_value = gen_codegen_stmts(n->if_expr.then_body, module, builder,
-                                   &has_return_stmt, logger);
-
-    if (!has_return_stmt)
+    branch = LLVMBuildCondBr(builder, cond, body_block, end_block);
+    group = n->while_expr.hints.parallel_access ? gen_access_group(logger)
+                                                : NULL;
+    (void) gen_set_loop_metadata(branch, &n->while_expr.hints, false, group);
+    if (NULL != group)
     {
-        (void) LLVMBuildBr(builder, merge_block);
+        (void) gen_set_access_group(cond_block, end_block, group);
     }
 
-    then_block = LLVMGetInsertBlock(builder);
-
-    if (NULL != n->if_expr.else_body)
+    if (NULL != loop_blocks)
     {
-        (void) LLVMAppendExistingBasicBlock(func, else_block);
-        (void) LLVMPositionBuilderAtEnd(builder, else_block);
-        has_return_stmt = false;
-        else_value = gen_codegen_stmts(n->if_expr.else_body, module, builder,
-                                       &has_return_stmt, logger);
-
-        if (!has_return_stmt)
-        {
-            (void) LLVMBuildBr(builder, merge_block);
-        }
+        (void) vector_pop_front(loop_blocks);
     }
 
-    else_block = LLVMGetInsertBlock(builder);
-
-    (void) LLVMAppendExistingBasicBlock(func, merge_block);
-    (void) LLVMPositionBuilderAtEnd(builder, merge_block);
+    (void) LLVMAppendExistingBasicBlock(func, end_block);
+    (void) LLVMPositionBuilderAtEnd(builder, end_block);
 
-    if ((NULL == then_value)
-        && !((NULL != n->if_expr.else_body) && (NULL != else_value)))
-    {
-        return NULL;
-    }
+    return body_value;
+}
 
-    if (((NULL == then_value) && (NULL != else_value))
-        || ((NULL != then_value) && (NULL == else_value)))
-    {
-        LOGGER_LOG_LOC(
-            logger, L_ERROR, n->token,
-            "If one branch returns a values, both must return a value.\n",
-            NULL);
+/**
+ * @brief Generate LLVM IR for a bound of the range of a for expression.
+ *
+ * @param[in] node the AST node of the bound.
+ * @param[in] type the LLVM type of the induction variable.
+ * @param[in] module the LLVM module.
+ * @param[in] builder the LLVM builder.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return the bound converted to the type of the induction variable.
+ */
+static LLVMValueRef gen_codegen_for_bound(t_ast_node *node, LLVMTypeRef type,
+                                          LLVMModuleRef module,
+                                          LLVMBuilderRef builder,
+                                          t_logger *logger)
+{
+    LLVMValueRef value = NULL;
+
+    value = GEN_codegen(node, module, builder, logger);
+    if (NULL == value)
+    {
+        LOGGER_LOG_LOC(logger, L_ERROR, node->token,
+                       "Range generation failed in for expr\n", NULL);
         exit(LUKA_CODEGEN_ERROR);
     }
 
-    if ((NULL != n->if_expr.else_body)
-        && (LLVMTypeOf(then_value) != LLVMTypeOf(else_value)))
+    if (LLVMTypeOf(value) == type)
     {
-        LOGGER_LOG_LOC(logger, L_ERROR, n->token,
-                       "Values of then and else branches must be of the "
-                       "same type in if expr.\n",
-                       NULL);
-        exit(LUKA_CODEGEN_ERROR);
+        return value;
     }
 
-    phi = LLVMBuildPhi(builder, LLVMTypeOf(then_value), "phi");
+    return LLVMBuildIntCast2(builder, value, type, !gen_is_unsigned_expr(node),
+                             "casttmp");
+}
 
-    (void) LLVMAddIncoming(phi, &then_value, &then_block, 1);
+/**
+ * @brief Generate the direction of a range for expression from its step, and
+ * trap if the step is zero.
+ *
+ * @param[in] n the AST node of the for expression.
+ * @param[in] step the step of the range.
+ * @param[in] is_signed whether the induction variable is signed.
+ * @param[in] module the LLVM module.
+ * @param[in] builder the LLVM builder.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return an i1 that is true if the range is ascending, a constant if the step
+ * is a constant.
+ */
+static LLVMValueRef gen_codegen_for_direction(t_ast_node *n, LLVMValueRef step,
+                                              bool is_signed,
+                                              LLVMModuleRef module,
+                                              LLVMBuilderRef builder,
+                                              t_logger *logger)
+{
+    LLVMValueRef func = NULL, trap = NULL, zero = NULL;
+    LLVMBasicBlockRef trap_block = NULL, loop_block = NULL;
+    LLVMTypeRef bool_type = LLVMInt1Type();
 
-    if (NULL != n->if_expr.else_body)
+    if (LLVMIsAConstantInt(step))
     {
-        (void) LLVMAddIncoming(phi, &else_value, &else_block, 1);
+        if (0 == LLVMConstIntGetZExtValue(step))
+        {
+            LOGGER_LOG_LOC(logger, L_ERROR, n->token,
+                           "The step of a for loop can't be zero.\n", NULL);
+            exit(LUKA_CODEGEN_ERROR);
+        }
+
+        return LLVMConstInt(
+            bool_type, !is_signed || (0 < LLVMConstIntGetSExtValue(step)),
+            false);
     }
-    else
+
+    func = LLVMGetBasicBlockParent(LLVMGetInsertBlock(builder));
+    trap_block = LLVMAppendBasicBlock(func, "for_zero_step");
+    loop_block = LLVMAppendBasicBlock(func, "for_preheader");
+    zero = LLVMConstNull(LLVMTypeOf(step));
+    (void) LLVMBuildCondBr(
+        builder, LLVMBuildICmp(builder, LLVMIntEQ, step, zero, "forzero"),
+        trap_block, loop_block);
+
+    (void) LLVMPositionBuilderAtEnd(builder, trap_block);
+    trap = LLVMGetIntrinsicDeclaration(
+        module, LLVMLookupIntrinsicID("llvm.trap", strlen("llvm.trap")), NULL,
+        0);
+    (void) LLVMBuildCall2(builder, LLVMGlobalGetValueType(trap), trap, NULL, 0,
+                          "");
+    (void) LLVMBuildUnreachable(builder);
+
+    (void) LLVMPositionBuilderAtEnd(builder, loop_block);
+    if (!is_signed)
     {
-        incoming_values[0] = LLVMConstInt(LLVMInt32Type(), 0, 0);
-        (void) LLVMAddIncoming(phi, incoming_values, &cond_block, 1);
+        return LLVMConstInt(bool_type, true, false);
     }
 
-    return phi;
+    return LLVMBuildICmp(builder, LLVMIntSGT, step, zero, "forascending");
 }
 
 /**
- * @brief Generate LLVM IR for a while expression.
+ * @brief Generate LLVM IR for a range for expression.
+ *
+ * @details The loop is emitted in the canonical form that the loop passes of
+ * LLVM expect: a preheader that checks the range isn't empty, a header that
+ * holds the induction variable in a single PHI node, and a latch that branches
+ * back while the distance left to the end of the range is larger than the
+ * step. Stepping therefore never goes past the end of the range, so it can't
+ * wrap even next to the limits of the type, and the trip count is known when
+ * entering the loop, which lets the loop be vectorized or unrolled. The
+ * direction of a step that isn't a constant is picked at run time, and such a
+ * loop also counts its iterations. A step of zero traps instead of looping
+ * forever.
  *
  * @param[in] n the AST node.
  * @param[in] module the LLVM module.
  * @param[in] builder the LLVM builder.
  * @param[in] logger a logger that can be used to log messages.
  *
- * @return the built LLVM IR for the while expression.
+ * @return NULL, as for expressions have no value.
  */
-static LLVMValueRef gen_codegen_while_expr(t_ast_node *n, LLVMModuleRef module,
-                                           LLVMBuilderRef builder,
-                                           t_logger *logger)
+static LLVMValueRef gen_codegen_for_expr(t_ast_node *n, LLVMModuleRef module,
+                                         LLVMBuilderRef builder,
+                                         t_logger *logger)
 {
-    LLVMValueRef func = NULL, cond = NULL, body_value = NULL;
-    LLVMBasicBlockRef cond_block = NULL, body_block = NULL, end_block = NULL;
+    LLVMValueRef func = NULL, start = NULL, end = NULL, step = NULL,
+                 cond = NULL, phi = NULL, next = NULL, branch = NULL,
+                 ascending = NULL, distance = NULL, magnitude = NULL,
+                 trips = NULL, count = NULL, count_next = NULL, zero = NULL;
+    LLVMBasicBlockRef preheader_block = NULL, body_block = NULL,
+                      latch_block = NULL, end_block = NULL;
+    LLVMTypeRef type = NULL;
+    LLVMMetadataRef group = NULL;
+    t_type *ttype = NULL;
+    t_named_value *val = NULL;
+    t_loop_blocks blocks;
+    bool is_signed = false, has_return_stmt = false;
+    size_t scope = 0;
 
-    func = LLVMGetBasicBlockParent(LLVMGetInsertBlock(builder));
+    ttype = n->for_expr.var->variable.type;
+    type = gen_type_to_llvm_type(ttype, logger);
+    is_signed = TYPE_is_signed(ttype);
 
-    cond_block = LLVMAppendBasicBlock(func, "while_cond");
-    body_block = LLVMAppendBasicBlock(func, "while_body");
+    start = gen_codegen_for_bound(n->for_expr.start, type, module, builder,
+                                  logger);
+    end = gen_codegen_for_bound(n->for_expr.end, type, module, builder,
+                                logger);
+    step = (NULL == n->for_expr.step)
+             ? LLVMConstInt(type, 1, false)
+             : gen_codegen_for_bound(n->for_expr.step, type, module, builder,
+                                     logger);
+
+    func = LLVMGetBasicBlockParent(LLVMGetInsertBlock(builder));
+    ascending = gen_codegen_for_direction(n, step, is_signed, module, builder,
+                                          logger);
+    body_block = LLVMAppendBasicBlock(func, "for_body");
+    latch_block
+        = LLVMCreateBasicBlockInContext(LLVMGetGlobalContext(), "for_latch");
     end_block
-        = LLVMCreateBasicBlockInContext(LLVMGetGlobalContext(), "while_end");
+        = LLVMCreateBasicBlockInContext(LLVMGetGlobalContext(), "for_end");
+
+    preheader_block = LLVMGetInsertBlock(builder);
+    if (NULL == LLVMIsAConstantInt(ascending))
+    {
+        cond = LLVMBuildSelect(
+            builder, ascending,
+            LLVMBuildICmp(builder, LLVMIntSLT, start, end, "forascending"),
+            LLVMBuildICmp(builder, LLVMIntSGT, start, end, "fordescending"),
+            "forguard");
+        /* Count the iterations after the first one, as the loop passes can't
+         * compute the trip count of a loop that steps in either direction */
+        distance = LLVMBuildSelect(
+            builder, ascending, LLVMBuildSub(builder, end, start, "forleft"),
+            LLVMBuildSub(builder, start, end, "forleft"), "fordistance");
+        magnitude = LLVMBuildSelect(builder, ascending, step,
+                                    LLVMBuildNeg(builder, step, "forneg"),
+                                    "formagnitude");
+        trips = LLVMBuildUDiv(
+            builder,
+            LLVMBuildSub(builder, distance, LLVMConstInt(type, 1, false),
+                         "forspan"),
+            magnitude, "fortrips");
+    }
+    else
+    {
+        cond = LLVMBuildICmp(builder,
+                             LLVMConstIntGetZExtValue(ascending)
+                                 ? (is_signed ? LLVMIntSLT : LLVMIntULT)
+                                 : LLVMIntSGT,
+                             start, end, "forguard");
+    }
+    (void) LLVMBuildCondBr(builder, cond, body_block, end_block);
+    (void) LLVMPositionBuilderAtEnd(builder, body_block);
+
+    phi = LLVMBuildPhi(builder, type, n->for_expr.var->variable.name);
+    (void) LLVMAddIncoming(phi, &start, &preheader_block, 1);
+    if (NULL != trips)
+    {
+        zero = LLVMConstNull(type);
+        count = LLVMBuildPhi(builder, type, "forcount");
+        (void) LLVMAddIncoming(count, &zero, &preheader_block, 1);
+    }
 
     if (NULL != loop_blocks)
     {
-        (void) vector_push_front(loop_blocks, &end_block);
+        blocks.label = n->for_expr.label;
+        blocks.continue_block = latch_block;
+        blocks.break_block = end_block;
+        (void) vector_push_front(loop_blocks, &blocks);
     }
 
-    (void) LLVMBuildBr(builder, cond_block);
-    (void) LLVMPositionBuilderAtEnd(builder, cond_block);
+    scope = gen_scope_open();
 
-    cond = GEN_codegen(n->while_expr.cond, module, builder, logger);
-    if (NULL == cond)
+    val = malloc(sizeof(t_named_value));
+    if (NULL == val)
     {
-        LOGGER_LOG_LOC(logger, L_ERROR, n->token,
-                       "Condition generation failed in while expr\n", NULL);
-        exit(LUKA_CODEGEN_ERROR);
+        exit(LUKA_CANT_ALLOC_MEMORY);
+    }
+    val->name = strdup(n->for_expr.var->variable.name);
+    val->alloca_inst = NULL;
+    val->value = NULL;
+    val->type = type;
+    val->ttype = ttype;
+    val->mutable = false;
+    val->shadowed = NULL;
+    if (gen_is_register_value(val->name, val->ttype))
+    {
+        val->value = phi;
     }
+    else
+    {
+        /* The address of the induction variable is taken, so every iteration
+         * gets a copy of it in memory */
+        val->alloca_inst = gen_create_entry_block_allca(func, type, val->name);
+        (void) LLVMBuildStore(builder, phi, val->alloca_inst);
+    }
+    (void) gen_named_value_declare(val);
 
-    (void) LLVMBuildCondBr(builder, cond, body_block, end_block);
-    (void) LLVMPositionBuilderAtEnd(builder, body_block);
+    (void) gen_codegen_stmts(n->for_expr.body, module, builder,
+                             &has_return_stmt, logger);
+    (void) gen_scope_close(scope);
 
-    body_value
-        = gen_codegen_stmts(n->while_expr.body, module, builder, NULL, logger);
-    cond = GEN_codegen(n->while_expr.cond, module, builder, logger);
-    if (NULL == cond)
+    if (!has_return_stmt)
     {
-        LOGGER_LOG_LOC(logger, L_ERROR, n->token,
-                       "Condition generation failed in while expr\n", NULL);
-        exit(LUKA_CODEGEN_ERROR);
+        (void) LLVMBuildBr(builder, latch_block);
+    }
+
+    (void) LLVMAppendExistingBasicBlock(func, latch_block);
+    (void) LLVMPositionBuilderAtEnd(builder, latch_block);
+
+    /* Branch back while the distance left to the end is larger than the step,
+     * a distance that is positive and so can't wrap as an unsigned number */
+    if (NULL != trips)
+    {
+        cond = LLVMBuildICmp(builder, LLVMIntULT, count, trips, "forcond");
+        count_next = LLVMBuildNUWAdd(
+            builder, count, LLVMConstInt(type, 1, false), "forcountnext");
+        (void) LLVMAddIncoming(count, &count_next, &latch_block, 1);
+    }
+    else if (LLVMConstIntGetZExtValue(ascending))
+    {
+        distance = LLVMBuildSub(builder, end, phi, "fordistance");
+        cond = LLVMBuildICmp(builder, LLVMIntUGT, distance, step, "forcond");
+    }
+    else
+    {
+        distance = LLVMBuildSub(builder, phi, end, "fordistance");
+        cond = LLVMBuildICmp(builder, LLVMIntUGT, distance,
+                             LLVMConstNeg(step), "forcond");
+    }
+    next = is_signed ? LLVMBuildNSWAdd(builder, phi, step, "fornext")
+                     : LLVMBuildNUWAdd(builder, phi, step, "fornext");
+    branch = LLVMBuildCondBr(builder, cond, body_block, end_block);
+    group = n->for_expr.hints.parallel_access ? gen_access_group(logger)
+                                              : NULL;
+    (void) gen_set_loop_metadata(branch, &n->for_expr.hints, true, group);
+    (void) LLVMAddIncoming(phi, &next, &latch_block, 1);
+    if (NULL != group)
+    {
+        (void) gen_set_access_group(body_block, end_block, group);
     }
-    (void) LLVMBuildCondBr(builder, cond, body_block, end_block);
 
     if (NULL != loop_blocks)
     {
@@ -1804,7 +4292,7 @@ static LLVMValueRef gen_codegen_while_expr(t_ast_node *n, LLVMModuleRef module,
     (void) LLVMAppendExistingBasicBlock(func, end_block);
     (void) LLVMPositionBuilderAtEnd(builder, end_block);
 
-    return body_value;
+    return NULL;
 }
 
 /**
@@ -1827,6 +4315,12 @@ static LLVMValueRef gen_codegen_cast_expr(t_ast_node *node,
 
     expr = GEN_codegen(node->cast_expr.expr, module, builder, logger);
     dest_type = gen_type_to_llvm_type(node->cast_expr.type, logger);
+    if (LLVMVectorTypeKind == LLVMGetTypeKind(dest_type))
+    {
+        return gen_codegen_vector_cast(
+            builder, expr, dest_type,
+            !gen_is_unsigned_expr(node->cast_expr.expr), logger);
+    }
     return gen_codegen_cast(builder, expr, dest_type, logger);
 }
 
@@ -1849,6 +4343,11 @@ static LLVMValueRef gen_codegen_variable(t_ast_node *node,
 
     HASH_FIND_STR(named_values, node->variable.name, val);
 
+    if ((NULL != val) && (NULL != val->value))
+    {
+        return val->value;
+    }
+
     if (NULL != val)
     {
         return LLVMBuildLoad2(builder, val->type, val->alloca_inst, val->name);
@@ -1873,7 +4372,7 @@ static LLVMValueRef gen_codegen_let_stmt(t_ast_node *node, LLVMModuleRef module,
                                          LLVMBuilderRef builder,
                                          t_logger *logger)
 {
-    LLVMValueRef expr = NULL;
+    LLVMValueRef expr = NULL, literal = NULL;
     t_ast_variable variable;
     t_named_value *val = NULL;
     bool is_global = node->let_stmt.is_global;
@@ -1905,23 +4404,31 @@ static LLVMValueRef gen_codegen_let_stmt(t_ast_node *node, LLVMModuleRef module,
 
     val = malloc(sizeof(t_named_value));
     val->name = strdup(variable.name);
+    val->alloca_inst = NULL;
+    val->value = NULL;
+    val->shadowed = NULL;
     if ((NULL == variable.type) && !extern_var)
     {
         val->type = LLVMTypeOf(expr);
         val->ttype = gen_llvm_type_to_ttype(val->type, logger);
         if (TYPE_STRUCT == val->ttype->type)
         {
-            val->ttype->payload
-                = strdup(node->let_stmt.expr->struct_value.name);
+            val->ttype
+                = TYPE_make_type(TYPE_STRUCT, NULL,
+                                 node->let_stmt.expr->struct_value.name,
+                                 val->ttype->mutable);
         }
     }
     else
     {
-        val->ttype = TYPE_dup_type(variable.type);
+        val->ttype = variable.type;
         val->type = gen_type_to_llvm_type(val->ttype, logger);
     }
 
-    if (!extern_var && (LLVMTypeOf(expr) != val->type))
+    /* Aggregate literals evaluate to a pointer to their storage, which is
+     * copied below */
+    if (!extern_var && (LLVMTypeOf(expr) != val->type)
+        && (LLVMTypeOf(expr) != LLVMPointerType(val->type, 0)))
     {
         expr = gen_codegen_cast(builder, expr, val->type, logger);
     }
@@ -1931,9 +4438,21 @@ static LLVMValueRef gen_codegen_let_stmt(t_ast_node *node, LLVMModuleRef module,
         val->alloca_inst = LLVMAddGlobal(module, val->type, val->name);
         if (!extern_var)
         {
+            if (LLVMTypeOf(expr) == LLVMPointerType(val->type, 0))
+            {
+                /* Constant aggregate literals are globals themselves */
+                literal = expr;
+                expr = LLVMGetInitializer(literal);
+                (void) LLVMDeleteGlobal(literal);
+            }
             (void) LLVMSetInitializer(val->alloca_inst, expr);
         }
     }
+    else if ((LLVMTypeOf(expr) == val->type)
+             && gen_is_register_value(val->name, val->ttype))
+    {
+        val->value = expr;
+    }
     else
     {
         val->alloca_inst = gen_create_entry_block_allca(
@@ -1962,11 +4481,60 @@ static LLVMValueRef gen_codegen_let_stmt(t_ast_node *node, LLVMModuleRef module,
     }
 
     val->mutable = variable.mutable || variable.type->mutable;
-    HASH_ADD_KEYPTR(hh, named_values, val->name, strlen(val->name), val);
+    if (is_global)
+    {
+        HASH_ADD_KEYPTR(hh, named_values, val->name, strlen(val->name), val);
+    }
+    else
+    {
+        (void) gen_named_value_declare(val);
+    }
 
     return NULL;
 }
 
+/**
+ * @brief Generate LLVM IR for an assignment to a single lane of a vector.
+ *
+ * @param[in] node the AST node of the assignment expression.
+ * @param[in] val the named value of the vector, which is kept in memory.
+ * @param[in] module the LLVM module.
+ * @param[in] builder the LLVM builder.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return the value assigned to the lane.
+ */
+static LLVMValueRef gen_codegen_lane_assignment(t_ast_node *node,
+                                                t_named_value *val,
+                                                LLVMModuleRef module,
+                                                LLVMBuilderRef builder,
+                                                t_logger *logger)
+{
+    LLVMValueRef vector = NULL, index = NULL, lane = NULL;
+
+    if (NULL == val->alloca_inst)
+    {
+        LOGGER_LOG_LOC(logger, L_ERROR, node->token,
+                       "Can't assign to a lane of vector %s kept in a "
+                       "register.\n",
+                       val->name);
+        exit(LUKA_CODEGEN_ERROR);
+    }
+
+    index = GEN_codegen(node->assignment_expr.lhs->array_deref.index, module,
+                        builder, logger);
+    lane = GEN_codegen(node->assignment_expr.rhs, module, builder, logger);
+    lane = gen_codegen_lane_cast(
+        builder, lane, LLVMGetElementType(val->type),
+        !gen_is_unsigned_expr(node->assignment_expr.rhs));
+
+    vector = LLVMBuildLoad2(builder, val->type, val->alloca_inst, val->name);
+    vector
+        = LLVMBuildInsertElement(builder, vector, lane, index, "laneinserttmp");
+    (void) LLVMBuildStore(builder, vector, val->alloca_inst);
+    return lane;
+}
+
 /**
  * @brief Generate LLVM IR for an assignment expression.
  *
@@ -2037,6 +4605,12 @@ static LLVMValueRef gen_codegen_assignment_expr(t_ast_node *node,
                 exit(LUKA_CODEGEN_ERROR);
             }
 
+            if (LLVMVectorTypeKind == LLVMGetTypeKind(val->type))
+            {
+                return gen_codegen_lane_assignment(node, val, module, builder,
+                                                   logger);
+            }
+
             lhs = gen_get_address(node->assignment_expr.lhs, module, builder,
                                   logger);
         }
@@ -2047,37 +4621,305 @@ static LLVMValueRef gen_codegen_assignment_expr(t_ast_node *node,
         }
     }
 
-    if (NULL != node->assignment_expr.rhs)
+    if (NULL != node->assignment_expr.rhs)
+    {
+        rhs = GEN_codegen(node->assignment_expr.rhs, module, builder, logger);
+    }
+
+    if ((NULL == lhs) || (NULL == rhs))
+    {
+        LOGGER_LOG_LOC(logger, L_ERROR, node->token,
+                       "Expression generation in assignment expr failed.\n",
+                       NULL);
+        exit(LUKA_CODEGEN_ERROR);
+    }
+
+    dest_type = LLVMGetElementType(LLVMTypeOf(lhs));
+    if (LLVMVectorTypeKind == LLVMGetTypeKind(dest_type))
+    {
+        rhs = gen_codegen_vector_cast(
+            builder, rhs, dest_type,
+            !gen_is_unsigned_expr(node->assignment_expr.rhs), logger);
+        store = LLVMBuildStore(builder, rhs, lhs);
+        (void) gen_set_lane_alignment(builder, store, dest_type);
+        return rhs;
+    }
+
+    rhs = LLVMBuildCast(
+        builder, gen_llvm_get_cast_op(LLVMTypeOf(rhs), dest_type, logger), rhs,
+        dest_type, "casttmp");
+    store = LLVMBuildStore(builder, rhs, lhs);
+    alignment = TYPE_sizeof(gen_llvm_type_to_ttype(LLVMTypeOf(lhs), logger));
+    if (0 != alignment)
+    {
+        (void) LLVMSetAlignment(store, (unsigned int) alignment);
+    }
+    return rhs;
+}
+
+/**
+ * @brief Generate an argument of a SIMD vector builtin, which must be a vector.
+ *
+ * @param[in] node the AST node of the builtin call.
+ * @param[in] i the index of the argument.
+ * @param[in] module the LLVM module.
+ * @param[in] builder the LLVM builder.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return the vector argument.
+ */
+static LLVMValueRef gen_codegen_vector_arg(t_ast_node *node, size_t i,
+                                          LLVMModuleRef module,
+                                          LLVMBuilderRef builder,
+                                          t_logger *logger)
+{
+    t_ast_node *arg = VECTOR_GET_AS(t_ast_node_ptr, node->call_expr.args, i);
+    LLVMValueRef value = GEN_codegen(arg, module, builder, logger);
+
+    if (LLVMVectorTypeKind != LLVMGetTypeKind(LLVMTypeOf(value)))
+    {
+        LOGGER_LOG_LOC(logger, L_ERROR, arg->token,
+                       "Argument %zu of %s should be a vector.\n", i + 1,
+                       node->call_expr.callable->builtin.name);
+        exit(LUKA_CODEGEN_ERROR);
+    }
+
+    return value;
+}
+
+/**
+ * @brief Generate LLVM IR for @shuffle(a, b, [lanes...]), which picks lanes
+ * out of the concatenation of two vectors by constant indices.
+ *
+ * @param[in] node the AST node of the builtin call.
+ * @param[in] module the LLVM module.
+ * @param[in] builder the LLVM builder.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return the shuffled vector.
+ */
+static LLVMValueRef gen_codegen_shuffle(t_ast_node *node, LLVMModuleRef module,
+                                        LLVMBuilderRef builder,
+                                        t_logger *logger)
+{
+    LLVMValueRef lhs = NULL, rhs = NULL, lane = NULL, *mask = NULL,
+                 shuffle = NULL;
+    t_ast_node *mask_node = NULL;
+    size_t i = 0, lanes = 0;
+
+    lhs = gen_codegen_vector_arg(node, 0, module, builder, logger);
+    rhs = gen_codegen_vector_arg(node, 1, module, builder, logger);
+    if (LLVMTypeOf(lhs) != LLVMTypeOf(rhs))
+    {
+        LOGGER_LOG_LOC(logger, L_ERROR, node->token,
+                       "Both vectors passed to @shuffle must have the same "
+                       "type.\n",
+                       NULL);
+        exit(LUKA_CODEGEN_ERROR);
+    }
+
+    mask_node = VECTOR_GET_AS(t_ast_node_ptr, node->call_expr.args, 2);
+    if (AST_TYPE_ARRAY_LITERAL != mask_node->type)
+    {
+        LOGGER_LOG_LOC(logger, L_ERROR, mask_node->token,
+                       "The lanes of @shuffle should be an array literal.\n",
+                       NULL);
+        exit(LUKA_CODEGEN_ERROR);
+    }
+
+    lanes = mask_node->array_literal.exprs->size;
+    mask = calloc(lanes, sizeof(LLVMValueRef));
+    if (NULL == mask)
+    {
+        exit(LUKA_CANT_ALLOC_MEMORY);
+    }
+
+    for (i = 0; i < lanes; ++i)
+    {
+        lane = GEN_codegen(
+            VECTOR_GET_AS(t_ast_node_ptr, mask_node->array_literal.exprs, i),
+            module, builder, logger);
+        if ((NULL == LLVMIsAConstantInt(lane))
+            || (LLVMConstIntGetZExtValue(lane)
+                >= 2 * (unsigned long long) LLVMGetVectorSize(LLVMTypeOf(lhs))))
+        {
+            LOGGER_LOG_LOC(logger, L_ERROR, mask_node->token,
+                           "Lane %zu of @shuffle should be a constant lane "
+                           "index of either vector.\n",
+                           i);
+            exit(LUKA_CODEGEN_ERROR);
+        }
+
+        mask[i] = LLVMConstInt(LLVMInt32Type(), LLVMConstIntGetZExtValue(lane),
+                               false);
+    }
+
+    shuffle = LLVMBuildShuffleVector(builder, lhs, rhs,
+                                     LLVMConstVector(mask, (unsigned int) lanes),
+                                     "shuffletmp");
+    (void) free(mask);
+    return shuffle;
+}
+
+/**
+ * @brief Reduce a vector with a binary operator by repeatedly combining its
+ * lower and upper halves, which takes log2 of the lanes steps.
+ *
+ * @details Used for floating point sums and products, since the reduction
+ * intrinsics are strictly ordered without the reassoc flag, which LLVM's C API
+ * can't set.
+ *
+ * @param[in] node the AST node of the builtin call.
+ * @param[in] vector the vector to reduce.
+ * @param[in] opcode the binary operator.
+ * @param[in] builder the LLVM builder.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return the reduced scalar.
+ */
+static LLVMValueRef gen_codegen_reduce_tree(t_ast_node *node,
+                                            LLVMValueRef vector,
+                                            LLVMOpcode opcode,
+                                            LLVMBuilderRef builder,
+                                            t_logger *logger)
+{
+    LLVMValueRef low_mask[32] = {0}, high_mask[32] = {0}, low = NULL,
+                 high = NULL;
+    unsigned int lanes = LLVMGetVectorSize(LLVMTypeOf(vector)), i = 0;
+
+    if ((lanes > 64) || (0 != (lanes & (lanes - 1))))
+    {
+        LOGGER_LOG_LOC(logger, L_ERROR, node->token,
+                       "Reducing a floating point vector requires a power of "
+                       "two lanes, up to 64.\n",
+                       NULL);
+        exit(LUKA_CODEGEN_ERROR);
+    }
+
+    for (lanes /= 2; lanes > 0; lanes /= 2)
+    {
+        for (i = 0; i < lanes; ++i)
+        {
+            low_mask[i] = LLVMConstInt(LLVMInt32Type(), i, false);
+            high_mask[i] = LLVMConstInt(LLVMInt32Type(), lanes + i, false);
+        }
+
+        low = LLVMBuildShuffleVector(builder, vector,
+                                     LLVMGetUndef(LLVMTypeOf(vector)),
+                                     LLVMConstVector(low_mask, lanes),
+                                     "reducelowtmp");
+        high = LLVMBuildShuffleVector(builder, vector,
+                                      LLVMGetUndef(LLVMTypeOf(vector)),
+                                      LLVMConstVector(high_mask, lanes),
+                                      "reducehightmp");
+        vector = LLVMBuildBinOp(builder, opcode, low, high, "reducetmp");
+    }
+
+    return LLVMBuildExtractElement(builder, vector,
+                                   LLVMConstInt(LLVMInt32Type(), 0, false),
+                                   "reducetmp");
+}
+
+/**
+ * @brief Generate LLVM IR for the horizontal reduction builtins, such as
+ * @reduceAdd, which combine every lane of a vector into a scalar.
+ *
+ * @param[in] node the AST node of the builtin call.
+ * @param[in] module the LLVM module.
+ * @param[in] builder the LLVM builder.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return the reduced scalar.
+ */
+static LLVMValueRef gen_codegen_reduce(t_ast_node *node, LLVMModuleRef module,
+                                       LLVMBuilderRef builder,
+                                       t_logger *logger)
+{
+    const char *name = NULL;
+    LLVMValueRef vector = NULL, intrinsic = NULL;
+    LLVMTypeRef vector_type = NULL;
+    unsigned int id = 0;
+    bool is_float = false, is_unsigned = false;
+
+    vector = gen_codegen_vector_arg(node, 0, module, builder, logger);
+    vector_type = LLVMTypeOf(vector);
+    is_float = gen_llvm_is_floating_type(vector_type);
+    is_unsigned = gen_is_unsigned_expr(
+        VECTOR_GET_AS(t_ast_node_ptr, node->call_expr.args, 0));
+
+    switch (node->call_expr.callable->builtin.id)
     {
-        rhs = GEN_codegen(node->assignment_expr.rhs, module, builder, logger);
+        case BUILTIN_ID_REDUCE_ADD:
+            if (is_float)
+            {
+                return gen_codegen_reduce_tree(node, vector, LLVMFAdd, builder,
+                                               logger);
+            }
+            name = "llvm.vector.reduce.add";
+            break;
+        case BUILTIN_ID_REDUCE_MUL:
+            if (is_float)
+            {
+                return gen_codegen_reduce_tree(node, vector, LLVMFMul, builder,
+                                               logger);
+            }
+            name = "llvm.vector.reduce.mul";
+            break;
+        case BUILTIN_ID_REDUCE_MIN:
+            name = is_float      ? "llvm.vector.reduce.fmin"
+                 : is_unsigned ? "llvm.vector.reduce.umin"
+                               : "llvm.vector.reduce.smin";
+            break;
+        case BUILTIN_ID_REDUCE_MAX:
+            name = is_float      ? "llvm.vector.reduce.fmax"
+                 : is_unsigned ? "llvm.vector.reduce.umax"
+                               : "llvm.vector.reduce.smax";
+            break;
+        case BUILTIN_ID_REDUCE_AND:
+            name = "llvm.vector.reduce.and";
+            break;
+        case BUILTIN_ID_REDUCE_OR:
+            name = "llvm.vector.reduce.or";
+            break;
+        case BUILTIN_ID_REDUCE_XOR:
+            name = "llvm.vector.reduce.xor";
+            break;
+        case BUILTIN_ID_INVALID:
+        case BUILTIN_ID_SIZEOF:
+        case BUILTIN_ID_SHUFFLE:
+        case BUILTIN_ID_SELECT:
+            (void) LOGGER_log(logger, L_ERROR, "%s is not a reduction.\n",
+                              node->call_expr.callable->builtin.name);
+            exit(LUKA_CODEGEN_ERROR);
     }
 
-    if ((NULL == lhs) || (NULL == rhs))
+    if (is_float
+        && ((BUILTIN_ID_REDUCE_AND == node->call_expr.callable->builtin.id)
+            || (BUILTIN_ID_REDUCE_OR == node->call_expr.callable->builtin.id)
+            || (BUILTIN_ID_REDUCE_XOR
+                == node->call_expr.callable->builtin.id)))
     {
         LOGGER_LOG_LOC(logger, L_ERROR, node->token,
-                       "Expression generation in assignment expr failed.\n",
-                       NULL);
+                       "%s is not defined on floating point vectors.\n",
+                       node->call_expr.callable->builtin.name);
         exit(LUKA_CODEGEN_ERROR);
     }
 
-    dest_type = LLVMGetElementType(LLVMTypeOf(lhs));
-    rhs = LLVMBuildCast(
-        builder, gen_llvm_get_cast_op(LLVMTypeOf(rhs), dest_type, logger), rhs,
-        dest_type, "casttmp");
-    store = LLVMBuildStore(builder, rhs, lhs);
-    alignment = TYPE_sizeof(gen_llvm_type_to_ttype(LLVMTypeOf(lhs), logger));
-    if (0 != alignment)
-    {
-        (void) LLVMSetAlignment(store, (unsigned int) alignment);
-    }
-    return rhs;
+    id = LLVMLookupIntrinsicID(name, strlen(name));
+    intrinsic = LLVMGetIntrinsicDeclaration(module, id, &vector_type, 1);
+    return LLVMBuildCall2(
+        builder,
+        LLVMIntrinsicGetType(LLVMGetModuleContext(module), id, &vector_type, 1),
+        intrinsic, &vector, 1, "reducetmp");
 }
 
 static LLVMValueRef gen_codegen_builtin_call(t_ast_node *node,
-                                             LLVMModuleRef UNUSED(module),
-                                             LLVMBuilderRef UNUSED(builder),
+                                             LLVMModuleRef module,
+                                             LLVMBuilderRef builder,
                                              t_logger *logger)
 {
+    LLVMValueRef mask = NULL, lhs = NULL, rhs = NULL;
+
     switch (node->call_expr.callable->builtin.id)
     {
         case BUILTIN_ID_SIZEOF:
@@ -2087,6 +4929,33 @@ static LLVMValueRef gen_codegen_builtin_call(t_ast_node *node,
                 t_type *type = arg0_node->type_expr.type;
                 return gen_codegen_sizeof(node, type, logger);
             }
+        case BUILTIN_ID_SHUFFLE:
+            return gen_codegen_shuffle(node, module, builder, logger);
+        case BUILTIN_ID_SELECT:
+            {
+                mask = gen_codegen_vector_arg(node, 0, module, builder, logger);
+                lhs = gen_codegen_vector_arg(node, 1, module, builder, logger);
+                rhs = gen_codegen_vector_arg(node, 2, module, builder, logger);
+                if ((LLVMTypeOf(lhs) != LLVMTypeOf(rhs))
+                    || (LLVMGetVectorSize(LLVMTypeOf(mask))
+                        != LLVMGetVectorSize(LLVMTypeOf(lhs))))
+                {
+                    LOGGER_LOG_LOC(logger, L_ERROR, node->token,
+                                   "@select takes a mask and two vectors of "
+                                   "the same type and number of lanes.\n",
+                                   NULL);
+                    exit(LUKA_CODEGEN_ERROR);
+                }
+                return LLVMBuildSelect(builder, mask, lhs, rhs, "selecttmp");
+            }
+        case BUILTIN_ID_REDUCE_ADD:
+        case BUILTIN_ID_REDUCE_MUL:
+        case BUILTIN_ID_REDUCE_MIN:
+        case BUILTIN_ID_REDUCE_MAX:
+        case BUILTIN_ID_REDUCE_AND:
+        case BUILTIN_ID_REDUCE_OR:
+        case BUILTIN_ID_REDUCE_XOR:
+            return gen_codegen_reduce(node, module, builder, logger);
         case BUILTIN_ID_INVALID:
             return NULL;
     }
@@ -2235,6 +5104,7 @@ static LLVMValueRef gen_codegen_call(t_ast_node *node, LLVMModuleRef module,
             builder, func_type, func, args,
             (unsigned int) node->call_expr.args->size,
             LLVMGetReturnType(func_type) != LLVMVoidType() ? "calltmp" : "");
+        (void) LLVMSetInstructionCallConv(call, LLVMGetFunctionCallConv(func));
     }
 
 l_cleanup:
@@ -2281,6 +5151,60 @@ static LLVMValueRef gen_codegen_expression_stmt(t_ast_node *n,
     return NULL;
 }
 
+/**
+ * @brief Find the loop that a break or continue statement jumps out of.
+ *
+ * @param[in] n the AST node of the statement.
+ * @param[in] label the label of the loop, or NULL for the innermost loop.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return the blocks of the loop, or NULL when not inside a loop.
+ */
+static const t_loop_blocks *gen_find_loop_blocks(t_ast_node *n,
+                                                 const char *label,
+                                                 t_logger *logger)
+{
+    const t_loop_blocks *blocks = NULL;
+    size_t i = 0;
+
+    if ((NULL == loop_blocks) || (0 == loop_blocks->size))
+    {
+        return NULL;
+    }
+
+    /* The innermost loop is at the front */
+    for (i = 0; i < loop_blocks->size; ++i)
+    {
+        blocks = vector_get(loop_blocks, i);
+        if ((NULL == label)
+            || ((NULL != blocks->label) && (0 == strcmp(label, blocks->label))))
+        {
+            return blocks;
+        }
+    }
+
+    LOGGER_LOG_LOC(logger, L_ERROR, n->token,
+                   "No enclosing loop is labelled `%s`.\n", label);
+    exit(LUKA_CODEGEN_ERROR);
+}
+
+/**
+ * @brief Jump out of the current block of a loop to @p dest_block.
+ *
+ * @param[in] builder the LLVM builder.
+ * @param[in] dest_block the block to jump to.
+ */
+static void gen_codegen_jump(LLVMBuilderRef builder,
+                             LLVMBasicBlockRef dest_block)
+{
+    (void) LLVMBuildBr(builder, dest_block);
+    // TODO: Find if there's a better way to supress "Terminator found in the
+    // middle of a basic block"
+    dest_block = LLVMAppendBasicBlock(
+        LLVMGetBasicBlockParent(LLVMGetInsertBlock(builder)), "unused_block");
+    (void) LLVMPositionBuilderAtEnd(builder, dest_block);
+}
+
 /**
  * @brief Generate LLVM IR for a break statement.
  *
@@ -2296,23 +5220,46 @@ static LLVMValueRef gen_codegen_break_stmt(t_ast_node *n,
                                            LLVMBuilderRef builder,
                                            t_logger *logger)
 {
-    LLVMBasicBlockRef dest_block = NULL;
+    const t_loop_blocks *blocks = NULL;
 
-    if ((NULL == loop_blocks) || (0 == loop_blocks->size))
+    blocks = gen_find_loop_blocks(n, n->break_stmt.label, logger);
+    if (NULL == blocks)
     {
         LOGGER_LOG_LOC(logger, L_WARNING, n->token,
                        "Cannot break when not inside a loop.\n", NULL);
         return NULL;
     }
 
-    dest_block = VECTOR_GET_AS(LLVMBasicBlockRef, loop_blocks, 0);
+    (void) gen_codegen_jump(builder, blocks->break_block);
+    return NULL;
+}
 
-    (void) LLVMBuildBr(builder, dest_block);
-    // TODO: Find if there's a better way to supress "Terminator found in the
-    // middle of a basic block"
-    dest_block = LLVMAppendBasicBlock(
-        LLVMGetBasicBlockParent(LLVMGetInsertBlock(builder)), "unused_block");
-    (void) LLVMPositionBuilderAtEnd(builder, dest_block);
+/**
+ * @brief Generate LLVM IR for a continue statement.
+ *
+ * @param[in] n the AST node.
+ * @param[in] module the LLVM module.
+ * @param[in] builder the LLVM builder.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return the built LLVM IR for the continue statement.
+ */
+static LLVMValueRef gen_codegen_continue_stmt(t_ast_node *n,
+                                              LLVMModuleRef UNUSED(module),
+                                              LLVMBuilderRef builder,
+                                              t_logger *logger)
+{
+    const t_loop_blocks *blocks = NULL;
+
+    blocks = gen_find_loop_blocks(n, n->continue_stmt.label, logger);
+    if (NULL == blocks)
+    {
+        LOGGER_LOG_LOC(logger, L_WARNING, n->token,
+                       "Cannot continue when not inside a loop.\n", NULL);
+        return NULL;
+    }
+
+    (void) gen_codegen_jump(builder, blocks->continue_block);
     return NULL;
 }
 
@@ -2365,6 +5312,7 @@ static LLVMValueRef gen_codegen_number(t_ast_node *node, t_logger *logger)
         case TYPE_STRING:
         case TYPE_STRUCT:
         case TYPE_TYPE:
+        case TYPE_VECTOR:
         case TYPE_VOID:
             {
                 LOGGER_LOG_LOC(logger, L_ERROR, node->token,
@@ -2471,6 +5419,8 @@ static LLVMValueRef gen_codegen_struct_definition(t_ast_node *node,
     struct_info->struct_type = struct_type;
     HASH_ADD_KEYPTR(hh, struct_infos, struct_info->struct_name,
                     strlen(struct_info->struct_name), struct_info);
+    /* Cached conversions may refer to a previous struct of the same name. */
+    ++llvm_type_generation;
     for (size_t i = 0; i < elements_count; ++i)
     {
         element_types[i] = gen_type_to_llvm_type(
@@ -2526,6 +5476,131 @@ l_cleanup:
     return NULL;
 }
 
+/**
+ * @brief Convert a value to the type of an element of an aggregate literal.
+ *
+ * @details Nested aggregate literals evaluate to a pointer to their storage, so
+ * they are loaded, or replaced by their initializer when they are constant.
+ *
+ * @param[in] value the value of the element.
+ * @param[in] element_type the type of the element in the aggregate.
+ * @param[in] builder the LLVM builder.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return @p value converted to @p element_type.
+ */
+static LLVMValueRef gen_aggregate_element(LLVMValueRef value,
+                                          LLVMTypeRef element_type,
+                                          LLVMBuilderRef builder,
+                                          t_logger *logger)
+{
+    LLVMTypeRef type = LLVMTypeOf(value);
+
+    if (type == element_type)
+    {
+        return value;
+    }
+
+    if ((LLVMPointerTypeKind == LLVMGetTypeKind(type))
+        && (LLVMGetElementType(type) == element_type))
+    {
+        if ((NULL != LLVMIsAGlobalVariable(value))
+            && LLVMIsGlobalConstant(value))
+        {
+            return LLVMGetInitializer(value);
+        }
+
+        return LLVMBuildLoad2(builder, element_type, value, "");
+    }
+
+    return gen_codegen_cast(builder, value, element_type, logger);
+}
+
+/**
+ * @brief Build the storage of an aggregate literal.
+ *
+ * @details Literals whose elements are all constant become private unnamed_addr
+ * constants, so identical literals can be merged. Other literals are built in a
+ * temporary on the stack of the current function, which SROA can break into
+ * registers. Large zero literals are cleared with memset instead.
+ *
+ * @param[in] type the struct or array type of the literal.
+ * @param[in] values the values of the elements, converted to their types.
+ * @param[in] count the number of elements.
+ * @param[in] name the name of the storage.
+ * @param[in] module the LLVM module.
+ * @param[in] builder the LLVM builder.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return a pointer to the storage of the literal.
+ */
+static LLVMValueRef gen_aggregate_literal(LLVMTypeRef type,
+                                          LLVMValueRef *values, size_t count,
+                                          const char *name,
+                                          LLVMModuleRef module,
+                                          LLVMBuilderRef builder,
+                                          t_logger *logger)
+{
+    bool is_constant = true, is_zero = true;
+    bool is_struct = LLVMStructTypeKind == LLVMGetTypeKind(type);
+    LLVMValueRef storage = NULL, initializer = NULL;
+    LLVMValueRef indices[2] = {LLVMConstInt(LLVMInt32Type(), 0, false), NULL};
+    LLVMBasicBlockRef block = LLVMGetInsertBlock(builder);
+    size_t i = 0;
+
+    for (i = 0; i < count; ++i)
+    {
+        is_constant = is_constant && LLVMIsConstant(values[i]);
+        is_zero = is_zero && LLVMIsNull(values[i]);
+    }
+
+    if ((NULL != block) && is_zero
+        && (LLVMABISizeOfType(LLVMGetModuleDataLayout(module), type)
+            >= GEN_MEMSET_THRESHOLD))
+    {
+        storage = gen_create_entry_block_allca(LLVMGetBasicBlockParent(block),
+                                               type, name);
+        (void) LLVMBuildMemSet(builder, storage,
+                               LLVMConstInt(LLVMInt8Type(), 0, false),
+                               LLVMSizeOf(type), LLVMGetAlignment(storage));
+        return storage;
+    }
+
+    if (is_constant)
+    {
+        initializer = is_struct
+                        ? LLVMConstNamedStruct(type, values, (unsigned) count)
+                        : LLVMConstArray(LLVMGetElementType(type), values,
+                                         (unsigned) count);
+        storage = LLVMAddGlobal(module, type, name);
+        (void) LLVMSetInitializer(storage, initializer);
+        (void) LLVMSetLinkage(storage, LLVMPrivateLinkage);
+        (void) LLVMSetUnnamedAddress(storage, LLVMGlobalUnnamedAddr);
+        (void) LLVMSetGlobalConstant(storage, true);
+        return storage;
+    }
+
+    if (NULL == block)
+    {
+        (void) LOGGER_log(logger, L_ERROR,
+                          "Aggregate literals outside of functions must be "
+                          "constant.\n");
+        exit(LUKA_CODEGEN_ERROR);
+    }
+
+    storage = gen_create_entry_block_allca(LLVMGetBasicBlockParent(block),
+                                           type, name);
+    for (i = 0; i < count; ++i)
+    {
+        indices[1] = LLVMConstInt(LLVMInt32Type(), i, false);
+        (void) LLVMBuildStore(
+            builder, values[i],
+            LLVMBuildInBoundsGEP2(builder, type, storage, indices, 2, ""));
+    }
+
+    return storage;
+}
+
 /**
  * @brief Generate LLVM IR for a struct value.
  *
@@ -2534,51 +5609,77 @@ l_cleanup:
  * @param[in] builder the LLVM builder.
  * @param[in] logger a logger that can be used to log messages.
  *
- * @return the built LLVM IR for the struct value.
+ * @return a pointer to the storage of the struct value.
  */
 static LLVMValueRef gen_codegen_struct_value(t_ast_node *node,
                                              LLVMModuleRef module,
                                              LLVMBuilderRef builder,
                                              t_logger *logger)
 {
-    size_t elements_count = node->struct_value.struct_values->size;
+    t_struct_info *struct_info = NULL;
     t_struct_value_field *struct_value_field = NULL;
-    LLVMValueRef struct_value = NULL, struct_var = NULL,
-                 *element_values = calloc(elements_count, sizeof(LLVMValueRef));
-    size_t i = 0;
-    if (NULL == element_values)
+    LLVMTypeRef element_type = NULL;
+    LLVMValueRef struct_var = NULL, *element_values = NULL;
+    size_t i = 0, index = 0;
+
+    HASH_FIND_STR(struct_infos, node->struct_value.name, struct_info);
+    if (NULL == struct_info)
     {
-        return NULL;
+        LOGGER_LOG_LOC(logger, L_ERROR, node->token,
+                       "Couldn't find struct info of `%s`.\n",
+                       node->struct_value.name);
+        exit(LUKA_CODEGEN_ERROR);
     }
 
-    for (i = 0; i < elements_count; ++i)
+    element_values = calloc(struct_info->number_of_fields, sizeof(LLVMValueRef));
+    if (NULL == element_values)
     {
-        element_values[i] = NULL;
+        return NULL;
     }
 
-    for (i = 0; i < elements_count; ++i)
+    VECTOR_FOR_EACH(node->struct_value.struct_values, struct_values)
     {
-        struct_value_field = VECTOR_GET_AS(t_struct_value_field_ptr,
-                                           node->struct_value.struct_values, i);
-        element_values[i]
-            = GEN_codegen(struct_value_field->expr, module, builder, logger);
+        struct_value_field
+            = ITERATOR_GET_AS(t_struct_value_field_ptr, &struct_values);
+        for (index = 0; index < struct_info->number_of_fields; ++index)
+        {
+            if (0
+                == strcmp(struct_value_field->name,
+                          struct_info->struct_fields[index]))
+            {
+                break;
+            }
+        }
+
+        if (struct_info->number_of_fields == index)
+        {
+            LOGGER_LOG_LOC(logger, L_ERROR, node->token,
+                           "`%s` is not a field in struct `%s`.\n",
+                           struct_value_field->name, struct_info->struct_name);
+            exit(LUKA_CODEGEN_ERROR);
+        }
+
+        element_type
+            = LLVMStructGetTypeAtIndex(struct_info->struct_type, (unsigned) index);
+        element_values[index] = gen_aggregate_element(
+            GEN_codegen(struct_value_field->expr, module, builder, logger),
+            element_type, builder, logger);
     }
 
-    for (i = 0; i < elements_count; ++i)
+    for (i = 0; i < struct_info->number_of_fields; ++i)
     {
         if (NULL == element_values[i])
         {
-            element_values[i] = LLVMConstInt(LLVMInt32Type(), 0, true);
+            element_values[i] = LLVMConstNull(LLVMStructGetTypeAtIndex(
+                struct_info->struct_type, (unsigned) i));
         }
     }
 
-    struct_value
-        = LLVMConstStruct(element_values, (unsigned int) elements_count, false);
-
-    struct_var = LLVMAddGlobal(module, LLVMTypeOf(struct_value), "struct_val");
-
-    (void) LLVMSetInitializer(struct_var, struct_value);
+    struct_var = gen_aggregate_literal(
+        struct_info->struct_type, element_values, struct_info->number_of_fields,
+        "struct_val", module, builder, logger);
 
+    (void) free(element_values);
     return struct_var;
 }
 
@@ -2758,6 +5859,19 @@ static LLVMValueRef gen_codegen_array_deref(t_ast_node *node,
                                             LLVMBuilderRef builder,
                                             t_logger *logger)
 {
+    t_named_value *val = NULL;
+    LLVMValueRef vector = NULL, index = NULL;
+
+    HASH_FIND_STR(named_values, node->array_deref.variable->variable.name, val);
+    if ((NULL != val) && (LLVMVectorTypeKind == LLVMGetTypeKind(val->type)))
+    {
+        /* Extract a single lane out of a vector */
+        vector = gen_codegen_variable(node->array_deref.variable, module,
+                                      builder, logger);
+        index = GEN_codegen(node->array_deref.index, module, builder, logger);
+        return LLVMBuildExtractElement(builder, vector, index, "lanetmp");
+    }
+
     return LLVMBuildLoad(
         builder, gen_get_address(node, module, builder, logger), "loadtmp");
 }
@@ -2857,7 +5971,7 @@ void GEN_module_structs_without_functions(t_module *module,
  * @param[in] builder the LLVM builder.
  * @param[in] logger a logger that can be used to log messages.
  *
- * @return a reference to the array literal in the global scope.
+ * @return a pointer to the storage of the array literal.
  */
 static LLVMValueRef gen_codegen_array_literal(t_ast_node *node,
                                               LLVMModuleRef module,
@@ -2866,32 +5980,30 @@ static LLVMValueRef gen_codegen_array_literal(t_ast_node *node,
 {
     t_ast_array_literal lit = node->array_literal;
     size_t i = 0, elements_count = lit.exprs->size;
-    LLVMValueRef *constant_vals = NULL, arr_val = NULL;
+    LLVMValueRef *vals = NULL, arr_val = NULL;
+    LLVMTypeRef element_type = gen_type_to_llvm_type(lit.type, logger);
     t_ast_node *expr = NULL;
-    constant_vals = calloc(elements_count, sizeof(LLVMValueRef));
-    if (NULL == constant_vals)
+    vals = calloc(elements_count, sizeof(LLVMValueRef));
+    if (NULL == vals)
     {
         (void) LOGGER_log(logger, L_ERROR,
-                          "Couldn't allocate memory for constant_vals.\n");
+                          "Couldn't allocate memory for vals.\n");
         exit(LUKA_CANT_ALLOC_MEMORY);
     }
 
     for (i = 0; i < elements_count; ++i)
     {
         expr = VECTOR_GET_AS(t_ast_node_ptr, lit.exprs, i);
-        constant_vals[i] = GEN_codegen(expr, module, builder, logger);
+        vals[i] = gen_aggregate_element(
+            GEN_codegen(expr, module, builder, logger), element_type, builder,
+            logger);
     }
 
-    arr_val
-        = LLVMAddGlobal(module,
-                        LLVMArrayType(gen_type_to_llvm_type(lit.type, logger),
-                                      (unsigned int) elements_count),
-                        "arraylit");
-
-    LLVMSetInitializer(
-        arr_val, LLVMConstArray(gen_type_to_llvm_type(lit.type, logger),
-                                constant_vals, (unsigned int) elements_count));
+    arr_val = gen_aggregate_literal(
+        LLVMArrayType(element_type, (unsigned int) elements_count), vals,
+        elements_count, "arraylit", module, builder, logger);
 
+    (void) free(vals);
     return arr_val;
 }
 
@@ -2921,6 +6033,68 @@ static LLVMValueRef gen_codegen_defer_stmt(t_ast_node *node,
     return NULL;
 }
 
+/**
+ * @brief Generate LLVM IR for a string literal.
+ *
+ * @details String literals are pooled by their contents, so every distinct
+ * literal is emitted once as a private unnamed_addr constant and all of its
+ * uses are constant GEPs to it.
+ *
+ * @param[in] node the AST node.
+ * @param[in] module the LLVM module.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return a pointer to the first character of the string literal.
+ */
+static LLVMValueRef gen_codegen_string(t_ast_node *node, LLVMModuleRef module,
+                                       t_logger *logger)
+{
+    t_pooled_string *pooled_string = NULL;
+    LLVMValueRef initializer = NULL;
+    LLVMValueRef indices[2] = {LLVMConstInt(LLVMInt32Type(), 0, false),
+                               LLVMConstInt(LLVMInt32Type(), 0, false)};
+
+    HASH_FIND_STR(string_pool, node->string.value, pooled_string);
+    if ((NULL != pooled_string)
+        && (LLVMGetGlobalParent(pooled_string->global) != module))
+    {
+        HASH_DEL(string_pool, pooled_string);
+        (void) free(pooled_string->value);
+        (void) free(pooled_string);
+        pooled_string = NULL;
+    }
+
+    if (NULL == pooled_string)
+    {
+        pooled_string = calloc(1, sizeof(t_pooled_string));
+        if (NULL == pooled_string)
+        {
+            (void) LOGGER_log(logger, L_ERROR,
+                              "Couldn't allocate memory for pooled string.\n");
+            exit(LUKA_CANT_ALLOC_MEMORY);
+        }
+
+        initializer
+            = LLVMConstString(node->string.value,
+                              (unsigned) strlen(node->string.value), false);
+        pooled_string->value = strdup(node->string.value);
+        pooled_string->global
+            = LLVMAddGlobal(module, LLVMTypeOf(initializer), "str");
+        (void) LLVMSetInitializer(pooled_string->global, initializer);
+        (void) LLVMSetLinkage(pooled_string->global, LLVMPrivateLinkage);
+        (void) LLVMSetUnnamedAddress(pooled_string->global,
+                                     LLVMGlobalUnnamedAddr);
+        (void) LLVMSetGlobalConstant(pooled_string->global, true);
+        (void) LLVMSetAlignment(pooled_string->global, 1);
+        HASH_ADD_KEYPTR(hh, string_pool, pooled_string->value,
+                        strlen(pooled_string->value), pooled_string);
+    }
+
+    return LLVMConstInBoundsGEP2(
+        LLVMTypeOf(LLVMGetInitializer(pooled_string->global)),
+        pooled_string->global, indices, 2);
+}
+
 LLVMValueRef GEN_codegen(t_ast_node *node, LLVMModuleRef module,
                          LLVMBuilderRef builder, t_logger *logger)
 {
@@ -2929,7 +6103,7 @@ LLVMValueRef GEN_codegen(t_ast_node *node, LLVMModuleRef module,
         case AST_TYPE_NUMBER:
             return gen_codegen_number(node, logger);
         case AST_TYPE_STRING:
-            return LLVMBuildGlobalStringPtr(builder, node->string.value, "str");
+            return gen_codegen_string(node, module, logger);
         case AST_TYPE_UNARY_EXPR:
             return gen_codegen_unexpr(node, module, builder, logger);
         case AST_TYPE_BINARY_EXPR:
@@ -2942,8 +6116,12 @@ LLVMValueRef GEN_codegen(t_ast_node *node, LLVMModuleRef module,
             return gen_codegen_return_stmt(node, module, builder, logger);
         case AST_TYPE_IF_EXPR:
             return gen_codegen_if_expr(node, module, builder, logger);
+        case AST_TYPE_MATCH_EXPR:
+            return gen_codegen_match_expr(node, module, builder, logger);
         case AST_TYPE_WHILE_EXPR:
             return gen_codegen_while_expr(node, module, builder, logger);
+        case AST_TYPE_FOR_EXPR:
+            return gen_codegen_for_expr(node, module, builder, logger);
         case AST_TYPE_CAST_EXPR:
             return gen_codegen_cast_expr(node, module, builder, logger);
         case AST_TYPE_VARIABLE:
@@ -2958,6 +6136,8 @@ LLVMValueRef GEN_codegen(t_ast_node *node, LLVMModuleRef module,
             return gen_codegen_expression_stmt(node, module, builder, logger);
         case AST_TYPE_BREAK_STMT:
             return gen_codegen_break_stmt(node, module, builder, logger);
+        case AST_TYPE_CONTINUE_STMT:
+            return gen_codegen_continue_stmt(node, module, builder, logger);
         case AST_TYPE_STRUCT_DEFINITION:
             return gen_codegen_struct_definition(node, module, builder, logger);
         case AST_TYPE_STRUCT_VALUE:
@@ -2984,14 +6164,18 @@ LLVMValueRef GEN_codegen(t_ast_node *node, LLVMModuleRef module,
     }
 }
 
-void GEN_codegen_initialize()
+void GEN_codegen_initialize(bool verify, bool strict, unsigned int fast_math)
 {
+    verify_functions = verify;
+    strict_overflow = strict;
+    default_fast_math_flags = fast_math;
+
     loop_blocks = calloc(1, sizeof(t_vector));
     if (NULL == loop_blocks)
     {
         exit(LUKA_CODEGEN_ERROR);
     }
-    (void) vector_setup(loop_blocks, 6, sizeof(LLVMBasicBlockRef));
+    (void) vector_setup(loop_blocks, 6, sizeof(t_loop_blocks));
 
     defer_blocks = calloc(1, sizeof(t_vector));
     if (NULL == defer_blocks)
@@ -2999,6 +6183,34 @@ void GEN_codegen_initialize()
         exit(LUKA_CODEGEN_ERROR);
     }
     (void) vector_setup(defer_blocks, 6, sizeof(t_ast_node));
+
+    scoped_values = calloc(1, sizeof(t_vector));
+    if (NULL == scoped_values)
+    {
+        exit(LUKA_CODEGEN_ERROR);
+    }
+    (void) vector_setup(scoped_values, 16, sizeof(t_named_value_ptr));
+
+    memory_variables = calloc(1, sizeof(t_vector));
+    if (NULL == memory_variables)
+    {
+        exit(LUKA_CODEGEN_ERROR);
+    }
+    (void) vector_setup(memory_variables, 6, sizeof(t_char_ptr));
+
+    captured_variables = calloc(1, sizeof(t_vector));
+    if (NULL == captured_variables)
+    {
+        exit(LUKA_CODEGEN_ERROR);
+    }
+    (void) vector_setup(captured_variables, 6, sizeof(t_char_ptr));
+
+    written_through_variables = calloc(1, sizeof(t_vector));
+    if (NULL == written_through_variables)
+    {
+        exit(LUKA_CODEGEN_ERROR);
+    }
+    (void) vector_setup(written_through_variables, 6, sizeof(t_char_ptr));
 }
 
 void GEN_codegen_reset()
@@ -3007,6 +6219,10 @@ void GEN_codegen_reset()
     t_enum_info *enum_info = NULL, *enum_info_iter = NULL;
 
     gen_named_values_clear();
+    (void) gen_type_mappings_clear(&llvm_type_to_ttype);
+    ++llvm_type_generation;
+    (void) gen_string_pool_clear();
+    (void) gen_fast_math_templates_clear();
 
     HASH_ITER(hh, struct_infos, struct_info, struct_info_iter)
     {
@@ -3085,4 +6301,48 @@ void GEN_codegen_reset()
         (void) vector_destroy(defer_blocks);
         (void) free(defer_blocks);
     }
+
+    if (NULL != scoped_values)
+    {
+        (void) vector_clear(scoped_values);
+        (void) vector_destroy(scoped_values);
+        (void) free(scoped_values);
+    }
+
+    if (NULL != memory_variables)
+    {
+        (void) vector_clear(memory_variables);
+        (void) vector_destroy(memory_variables);
+        (void) free(memory_variables);
+    }
+
+    if (NULL != captured_variables)
+    {
+        (void) vector_clear(captured_variables);
+        (void) vector_destroy(captured_variables);
+        (void) free(captured_variables);
+    }
+
+    if (NULL != written_through_variables)
+    {
+        (void) vector_clear(written_through_variables);
+        (void) vector_destroy(written_through_variables);
+        (void) free(written_through_variables);
+    }
+}
+
+unsigned int GEN_fast_math_flag(const char *name)
+{
+    size_t i = 0;
+
+    for (i = 0;
+         i < sizeof(GEN_FAST_MATH_FLAGS) / sizeof(GEN_FAST_MATH_FLAGS[0]); ++i)
+    {
+        if (0 == strcmp(name, GEN_FAST_MATH_FLAGS[i].name))
+        {
+            return GEN_FAST_MATH_FLAGS[i].flag;
+        }
+    }
+
+    return 0;
 }
@@ -11,7 +11,8 @@
 /** A string representation of the keywords in the Luka programming language */
 const char *keywords[NUMBER_OF_KEYWORDS]
     = {"fn", "return", "if", "else", "let", "mut", "extern", "while", "break",
-       "as", "struct", "enum", "import", "type", "defer",
+       "as", "struct", "enum", "import", "type", "defer", "export",
+       "for", "in", "continue", "restrict", "match",
 
        /* Literals */
        "null", "true", "false",
@@ -67,7 +68,8 @@ static char *lexer_lex_number(const char *source, size_t *index,
     {
     } while (isdigit(source[++*index]));
 
-    if ('.' == source[*index])
+    /* A ".." right after the digits is a range, not a decimal point */
+    if (('.' == source[*index]) && ('.' != source[*index + 1]))
     {
         is_floating = true;
         ++*index;
@@ -352,20 +354,50 @@ t_return_code LEXER_tokenize_source(t_vector *tokens, const char *source,
                 }
             case '+':
                 {
-                    token->type = T_PLUS;
-                    token->content = "+";
+                    if ('%' == source[i + 1])
+                    {
+                        ++i;
+                        ++offset;
+                        token->type = T_PLUS_PERCENT;
+                        token->content = "+%";
+                    }
+                    else
+                    {
+                        token->type = T_PLUS;
+                        token->content = "+";
+                    }
                     break;
                 }
             case '-':
                 {
-                    token->type = T_MINUS;
-                    token->content = "-";
+                    if ('%' == source[i + 1])
+                    {
+                        ++i;
+                        ++offset;
+                        token->type = T_MINUS_PERCENT;
+                        token->content = "-%";
+                    }
+                    else
+                    {
+                        token->type = T_MINUS;
+                        token->content = "-";
+                    }
                     break;
                 }
             case '*':
                 {
-                    token->type = T_STAR;
-                    token->content = "*";
+                    if ('%' == source[i + 1])
+                    {
+                        ++i;
+                        ++offset;
+                        token->type = T_STAR_PERCENT;
+                        token->content = "*%";
+                    }
+                    else
+                    {
+                        token->type = T_STAR;
+                        token->content = "*";
+                    }
                     break;
                 }
             case '%':
@@ -376,14 +408,34 @@ t_return_code LEXER_tokenize_source(t_vector *tokens, const char *source,
                 }
             case '&':
                 {
-                    token->type = T_AMPERCENT;
-                    token->content = "&";
+                    if ('&' == source[i + 1])
+                    {
+                        ++i;
+                        ++offset;
+                        token->type = T_DOUBLE_AMPERCENT;
+                        token->content = "&&";
+                    }
+                    else
+                    {
+                        token->type = T_AMPERCENT;
+                        token->content = "&";
+                    }
                     break;
                 }
             case '|':
                 {
-                    token->type = T_PIPE;
-                    token->content = "|";
+                    if ('|' == source[i + 1])
+                    {
+                        ++i;
+                        ++offset;
+                        token->type = T_DOUBLE_PIPE;
+                        token->content = "||";
+                    }
+                    else
+                    {
+                        token->type = T_PIPE;
+                        token->content = "|";
+                    }
                     break;
                 }
             case '^':
@@ -442,6 +494,13 @@ t_return_code LEXER_tokenize_source(t_vector *tokens, const char *source,
                         token->type = T_EQEQ;
                         token->content = "==";
                     }
+                    else if ('>' == source[i + 1])
+                    {
+                        ++i;
+                        ++offset;
+                        token->type = T_FAT_ARROW;
+                        token->content = "=>";
+                    }
                     else
                     {
                         token->type = T_EQUALS;
@@ -565,6 +624,13 @@ t_return_code LEXER_tokenize_source(t_vector *tokens, const char *source,
                         token->type = T_THREE_DOTS;
                         token->content = "...";
                     }
+                    else if ('.' == source[i + 1])
+                    {
+                        ++i;
+                        ++offset;
+                        token->type = T_DOUBLE_DOT;
+                        token->content = "..";
+                    }
                     else
                     {
                         token->type = T_DOT;
@@ -107,12 +107,6 @@ void LIB_free_type_aliases_vector(t_vector *type_alises)
                 type_alias->name = NULL;
             }
 
-            if (NULL != type_alias->type)
-            {
-                (void) TYPE_free_type(type_alias->type);
-                type_alias->type = NULL;
-            }
-
             (void) free(type_alias);
             type_alias = NULL;
         }
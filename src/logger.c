@@ -19,6 +19,8 @@ t_logger *LOGGER_initialize(char *file_path, size_t verbosity)
 
     logger->verbosity = verbosity;
     logger->file_path = file_path;
+    logger->recovery = NULL;
+    logger->deferred = NULL;
     logger->fp = fopen(file_path, "a");
     if (NULL == logger->fp)
     {
@@ -43,6 +45,41 @@ l_cleanup:
     return NULL;
 }
 
+/**
+ * @brief Keep a message to be logged later by LOGGER_replay.
+ *
+ * @param[in,out] logger the deferring logger.
+ * @param[in] level the severity level of the log message.
+ * @param[in] format the format of the log message.
+ * @param[in] args additional arguments to the log formatter.
+ */
+__attribute__((format(printf, 3, 0))) static void
+logger_defer(t_logger *logger, const char *level, const char *format,
+             va_list args)
+{
+    t_logger_message message = {0};
+    va_list args_copy;
+    int length = 0;
+
+    (void) va_copy(args_copy, args);
+    length = vsnprintf(NULL, 0, format, args_copy);
+    (void) va_end(args_copy);
+    if (0 > length)
+    {
+        return;
+    }
+
+    message.level = level;
+    message.message = malloc((size_t) length + 1);
+    if (NULL == message.message)
+    {
+        exit(LUKA_CANT_ALLOC_MEMORY);
+    }
+
+    (void) vsnprintf(message.message, (size_t) length + 1, format, args);
+    (void) vector_push_back(logger->deferred, &message);
+}
+
 __attribute__((format(printf, 3, 4))) void
 LOGGER_log(t_logger *logger, const char *level, const char *format, ...)
 {
@@ -52,6 +89,23 @@ LOGGER_log(t_logger *logger, const char *level, const char *format, ...)
     bool is_info_log = 0 == strcmp(L_INFO, level);
     bool used_varargs = false;
 
+    if ((NULL != logger) && (NULL != logger->recovery))
+    {
+        longjmp(*logger->recovery, 1);
+    }
+
+    if ((NULL != logger) && (NULL != logger->deferred))
+    {
+        /* Info messages of a quiet logger are dropped anyway */
+        if (!is_info_log || (logger->verbosity > 0))
+        {
+            (void) va_start(args, format);
+            (void) logger_defer(logger, level, format, args);
+            (void) va_end(args);
+        }
+        return;
+    }
+
     if ((NULL != logger) && (NULL != logger->fp))
     {
         (void) va_start(args, format);
@@ -96,6 +150,58 @@ LOGGER_log(t_logger *logger, const char *level, const char *format, ...)
     }
 }
 
+void LOGGER_log_location(t_logger *logger, const char *file_path, long line,
+                         long offset)
+{
+    t_logger_message message = {0};
+
+    if ((NULL != logger) && (NULL != logger->deferred))
+    {
+        message.file_path = file_path;
+        message.line = line;
+        message.offset = offset;
+        (void) vector_push_back(logger->deferred, &message);
+        return;
+    }
+
+    (void) IO_print_error(file_path, line, offset);
+}
+
+void LOGGER_replay(t_logger *logger, t_vector *messages)
+{
+    const t_logger_message *message = NULL;
+
+    VECTOR_FOR_EACH(messages, iterator)
+    {
+        message = iterator_get(&iterator);
+        if (NULL == message->message)
+        {
+            (void) LOGGER_log_location(logger, message->file_path,
+                                       message->line, message->offset);
+        }
+        else
+        {
+            (void) LOGGER_log(logger, message->level, "%s", message->message);
+        }
+    }
+
+    (void) LOGGER_discard(messages);
+}
+
+void LOGGER_discard(t_vector *messages)
+{
+    t_logger_message *message = NULL;
+
+    VECTOR_FOR_EACH(messages, iterator)
+    {
+        message = iterator_get(&iterator);
+        (void) free(message->message);
+        message->message = NULL;
+    }
+
+    (void) vector_clear(messages);
+}
+
 void LOGGER_free(t_logger *logger)
 {
     if (NULL != logger)
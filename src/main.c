@@ -32,6 +32,8 @@
 #include "logger.h"
 #include "main_internal.h"
 #include "parser.h"
+#include "reachability.h"
+#include "type.h"
 #include "type_checker.h"
 #include "uthash.h"
 #include "vector.h"
@@ -47,6 +49,8 @@ static struct option S_LONG_OPTIONS[]
        {"bitcode", no_argument, NULL, 'b'},
        {"optimization", required_argument, NULL, 'O'},
        {"triple", required_argument, NULL, 't'},
+       {"fast", no_argument, NULL, 'f'},
+       {NULL, required_argument, NULL, 'm'},
        {NULL, no_argument, NULL, 'c'},
        {NULL, no_argument, NULL, 'S'},
        {NULL, 0, NULL, 0}};
@@ -67,6 +71,18 @@ static void print_help(void)
         "                       Optimization levels: 0, 1, 2, 3, s (optimize "
         "for space)\n"
         "  -t/--triple          The LLVM Target to codegen for.\n"
+        "  -f/--fast            Compile as fast as possible, implies -O0.\n"
+        "  -fstrict-overflow    Assume unsigned arithmetic never wraps either,\n"
+        "                       use +%%, -%% and *%% for arithmetic that does.\n"
+        "  -ffast-math[=flags]  Optimize floating point math as if it were on\n"
+        "                       real numbers, allowing only the given comma\n"
+        "                       separated flags if any: reassoc, contract,\n"
+        "                       nnan, ninf, nsz, arcp and afn.\n"
+        "  -mcpu=<cpu>          The CPU to codegen for.\n"
+        "  -mattr=<features>    Comma separated CPU features to enable or\n"
+        "                       disable, e.g. +avx2,-fma.\n"
+        "  -march=<cpu>         The CPU to codegen for, native for the CPU of\n"
+        "                       the host including all of its features.\n"
         "  -c                   Compile and assemble, but do not link.\n"
         "  -S                   Compile only; do not assemble or link.\n"
         "\n");
@@ -91,12 +107,20 @@ static void context_initialize(t_main_context *context, int argc, char **argv)
     context->target = NULL;
     context->target_data = NULL;
     context->triple = NULL;
+    context->cpu = NULL;
+    context->features = NULL;
+    context->native = false;
+    context->target_cpu = NULL;
+    context->target_features = NULL;
     context->error = NULL;
     context->logger = NULL;
     context->verbosity = 0;
     context->output_path = OUT_FILENAME;
     context->bitcode = false;
     context->optimization = DEFAULT_OPT;
+    context->fast = false;
+    context->strict_overflow = false;
+    context->fast_math = 0;
     context->compile = true;
     context->assemble = true;
     context->link = true;
@@ -213,6 +237,50 @@ static void context_destruct(t_main_context *context)
         (void) LLVMDisposeModule(context->llvm_module);
         context->llvm_module = NULL;
     }
+
+    if (NULL != context->target_cpu)
+    {
+        (void) LLVMDisposeMessage(context->target_cpu);
+        context->target_cpu = NULL;
+    }
+
+    if (NULL != context->target_features)
+    {
+        (void) LLVMDisposeMessage(context->target_features);
+        context->target_features = NULL;
+    }
+}
+
+static bool parse_fast_math_flags(const char *names, unsigned int *flags)
+{
+    char name[16] = {0};
+    size_t length = 0;
+    unsigned int flag = 0;
+
+    *flags = 0;
+    while (true)
+    {
+        length = strcspn(names, ",");
+        if (length >= sizeof(name))
+        {
+            return false;
+        }
+
+        (void) memcpy(name, names, length);
+        name[length] = '\0';
+        flag = GEN_fast_math_flag(name);
+        if (0 == flag)
+        {
+            return false;
+        }
+
+        *flags |= flag;
+        if ('\0' == names[length])
+        {
+            return true;
+        }
+        names += length + 1;
+    }
 }
 
 static t_return_code get_args(t_main_context *context)
@@ -223,7 +291,7 @@ static t_return_code get_args(t_main_context *context)
 
     while (-1
            != (ch = (char) getopt_long(context->argc, context->argv,
-                                       "hvo:bO:t:cS", S_LONG_OPTIONS, NULL)))
+                                       "hvo:bO:t:f::m:cS", S_LONG_OPTIONS, NULL)))
     {
         switch (ch)
         {
@@ -245,6 +313,63 @@ static t_return_code get_args(t_main_context *context)
             case 't':
                 context->triple = optarg;
                 break;
+            case 'f':
+                if (NULL == optarg)
+                {
+                    context->fast = true;
+                }
+                else if (0 == strcmp(optarg, "strict-overflow"))
+                {
+                    context->strict_overflow = true;
+                }
+                else if (0 == strcmp(optarg, "fast-math"))
+                {
+                    context->fast_math = GEN_FAST_MATH_ALL;
+                }
+                else if (0
+                         == strncmp(optarg, "fast-math=", strlen("fast-math=")))
+                {
+                    if (!parse_fast_math_flags(optarg + strlen("fast-math="),
+                                               &context->fast_math))
+                    {
+                        (void) fprintf(stderr,
+                                       "Unknown fast-math flags in -f%s\n",
+                                       optarg);
+                        status_code = LUKA_WRONG_PARAMETERS;
+                        goto l_cleanup;
+                    }
+                }
+                else
+                {
+                    (void) fprintf(stderr, "Unknown option -f%s\n", optarg);
+                    status_code = LUKA_WRONG_PARAMETERS;
+                    goto l_cleanup;
+                }
+                break;
+            case 'm':
+                if (0 == strncmp(optarg, "cpu=", strlen("cpu=")))
+                {
+                    context->cpu = optarg + strlen("cpu=");
+                }
+                else if (0 == strncmp(optarg, "attr=", strlen("attr=")))
+                {
+                    context->features = optarg + strlen("attr=");
+                }
+                else if (0 == strcmp(optarg, "arch=native"))
+                {
+                    context->native = true;
+                }
+                else if (0 == strncmp(optarg, "arch=", strlen("arch=")))
+                {
+                    context->cpu = optarg + strlen("arch=");
+                }
+                else
+                {
+                    (void) fprintf(stderr, "Unknown option -m%s\n", optarg);
+                    status_code = LUKA_WRONG_PARAMETERS;
+                    goto l_cleanup;
+                }
+                break;
             case 'c':
                 context->link = false;
                 break;
@@ -259,6 +384,11 @@ static t_return_code get_args(t_main_context *context)
         }
     }
 
+    if (context->fast)
+    {
+        context->optimization = '0';
+    }
+
     if (optind >= context->argc)
     {
         (void) print_help();
@@ -370,7 +500,17 @@ static t_return_code parse(t_main_context *context, const char *file_path)
     (void) PARSER_initialize(context->parser, context->tokens, file_path,
                              context->logger, context->type_aliases);
 
-    (void) PARSER_print_parser_tokens(context->parser);
+    /* Bodies of imported functions are parsed once the reachability analysis
+     * reaches them, which only happens when compiling a lone file. */
+    context->parser->lazy = (1 == context->files_count)
+                         && (NULL != context->modules[context->file_index]);
+
+    /* The dumps only end up in the log file unless running verbosely, and
+     * writing them takes longer than compiling large files. */
+    if (!context->fast || (context->verbosity > 0))
+    {
+        (void) PARSER_print_parser_tokens(context->parser);
+    }
 
     module = PARSER_parse_file(context->parser);
     if (NULL == module)
@@ -386,14 +526,6 @@ static t_return_code parse(t_main_context *context, const char *file_path)
         original_module = true;
     }
 
-    VECTOR_FOR_EACH(module->functions, iterator)
-    {
-        context->node = ITERATOR_GET_AS(t_ast_node_ptr, &iterator);
-        context->node = AST_fix_function_last_expression_stmt(context->node);
-        (void) AST_fill_parameter_types(context->node, context->logger, module);
-        (void) AST_fill_variable_types(context->node, context->logger, module);
-    }
-
     VECTOR_FOR_EACH(module->import_paths, iterator)
     {
         resolved_path = ITERATOR_GET_AS(t_char_ptr, &iterator);
@@ -454,25 +586,22 @@ static t_return_code parse(t_main_context *context, const char *file_path)
     VECTOR_FOR_EACH(module->variables, iterator)
     {
         context->node = ITERATOR_GET_AS(t_ast_node_ptr, &iterator);
-        context->node = AST_fix_types(context->node, module, context->logger);
-        context->node = AST_resolve_type_aliases(
-            context->node, context->type_aliases, context->logger);
+        (void) AST_analyze(context->node, module, context->type_aliases,
+                           context->logger);
     }
 
     VECTOR_FOR_EACH(module->structs, iterator)
     {
         context->node = ITERATOR_GET_AS(t_ast_node_ptr, &iterator);
-        context->node = AST_fix_types(context->node, module, context->logger);
-        context->node = AST_resolve_type_aliases(
-            context->node, context->type_aliases, context->logger);
+        (void) AST_analyze(context->node, module, context->type_aliases,
+                           context->logger);
     }
 
     VECTOR_FOR_EACH(module->functions, iterator)
     {
         context->node = ITERATOR_GET_AS(t_ast_node_ptr, &iterator);
-        context->node = AST_fix_types(context->node, module, context->logger);
-        context->node = AST_resolve_type_aliases(
-            context->node, context->type_aliases, context->logger);
+        (void) AST_analyze(context->node, module, context->type_aliases,
+                           context->logger);
     }
 
     if (original_module)
@@ -481,7 +610,10 @@ static t_return_code parse(t_main_context *context, const char *file_path)
     }
     context->current_module = module;
 
-    (void) AST_print_functions(module->functions, 0, context->logger);
+    if (!context->fast || (context->verbosity > 0))
+    {
+        (void) AST_print_functions(module->functions, 0, context->logger);
+    }
 
     status_code = LUKA_SUCCESS;
 l_cleanup:
@@ -492,18 +624,11 @@ static t_return_code type_check(t_main_context *context)
 {
     t_return_code status_code = LUKA_UNINITIALIZED;
     t_module *module = context->current_module;
-    t_ast_node *node = NULL;
-    bool success = false;
 
-    VECTOR_FOR_EACH(module->functions, iterator)
+    if (!CHECK_functions(module, module->functions, context->logger))
     {
-        node = ITERATOR_GET_AS(t_ast_node_ptr, &iterator);
-        success = CHECK_function(module, node, context->logger);
-        if (!success)
-        {
-            status_code = LUKA_TYPE_CHECK_ERROR;
-            goto l_cleanup;
-        }
+        status_code = LUKA_TYPE_CHECK_ERROR;
+        goto l_cleanup;
     }
 
     status_code = LUKA_SUCCESS;
@@ -511,16 +636,88 @@ l_cleanup:
     return status_code;
 }
 
+static LLVMCodeGenOptLevel codegen_level(char optimization)
+{
+    switch (optimization)
+    {
+        case '0':
+            return LLVMCodeGenLevelNone;
+        case '1':
+            return LLVMCodeGenLevelLess;
+        case '3':
+            return LLVMCodeGenLevelAggressive;
+        default:
+            return LLVMCodeGenLevelDefault;
+    }
+}
+
+static void initialize_target_cpu(t_main_context *context)
+{
+    char *host_features = NULL, *features = NULL;
+    size_t features_length = 0;
+
+    if (!context->native)
+    {
+        context->target_cpu
+            = LLVMCreateMessage((NULL == context->cpu) ? "" : context->cpu);
+        context->target_features = LLVMCreateMessage(
+            (NULL == context->features) ? "" : context->features);
+        return;
+    }
+
+    context->target_cpu = (NULL == context->cpu)
+                            ? LLVMGetHostCPUName()
+                            : LLVMCreateMessage(context->cpu);
+
+    host_features = LLVMGetHostCPUFeatures();
+    if (NULL == context->features)
+    {
+        context->target_features = host_features;
+        return;
+    }
+
+    /* Features given explicitly come last so they override the host */
+    features_length = strlen(host_features) + strlen(context->features) + 2;
+    features = malloc(features_length);
+    if (NULL == features)
+    {
+        (void) LOGGER_log(context->logger, L_ERROR,
+                          "Couldn't allocate memory for target features.\n");
+        exit(LUKA_CANT_ALLOC_MEMORY);
+    }
+
+    (void) snprintf(features, features_length, "%s,%s", host_features,
+                    context->features);
+    context->target_features = LLVMCreateMessage(features);
+    (void) free(features);
+    (void) LLVMDisposeMessage(host_features);
+}
+
 static t_return_code initialize_llvm(t_main_context *context)
 {
     t_return_code status_code = LUKA_UNINITIALIZED;
 
     (void) LLVMInitializeCore(LLVMGetGlobalPassRegistry());
-    (void) LLVMInitializeAllTargets();
-    (void) LLVMInitializeAllTargetInfos();
-    (void) LLVMInitializeAllTargetMCs();
-    (void) LLVMInitializeAllAsmPrinters();
-    (void) LLVMInitializeAllAsmParsers();
+    if (context->fast)
+    {
+        /* Names of local values only make the IR easier to read */
+        (void) LLVMContextSetDiscardValueNames(LLVMGetGlobalContext(), true);
+    }
+
+    if (context->fast && (NULL == context->triple))
+    {
+        (void) LLVMInitializeNativeTarget();
+        (void) LLVMInitializeNativeAsmPrinter();
+        (void) LLVMInitializeNativeAsmParser();
+    }
+    else
+    {
+        (void) LLVMInitializeAllTargets();
+        (void) LLVMInitializeAllTargetInfos();
+        (void) LLVMInitializeAllTargetMCs();
+        (void) LLVMInitializeAllAsmPrinters();
+        (void) LLVMInitializeAllAsmParsers();
+    }
 
     context->llvm_module = LLVMModuleCreateWithName("");
     if (NULL == context->triple)
@@ -548,8 +745,14 @@ static t_return_code initialize_llvm(t_main_context *context)
         (void) LLVMDisposeMessage(context->error);
     }
 
+    (void) initialize_target_cpu(context);
+    (void) LOGGER_log(context->logger, L_INFO,
+                      "Target CPU: %s, target features: %s\n",
+                      context->target_cpu, context->target_features);
+
     context->target_machine = LLVMCreateTargetMachine(
-        context->target, context->triple, "", "", LLVMCodeGenLevelDefault,
+        context->target, context->triple, context->target_cpu,
+        context->target_features, codegen_level(context->optimization),
         LLVMRelocPIC, LLVMCodeModelDefault);
     (void) LLVMSetTarget(context->llvm_module, context->triple);
     context->target_data = LLVMCreateTargetDataLayout(context->target_machine);
@@ -674,6 +877,8 @@ l_cleanup:
 
 static void add_o1_optimizations(t_main_context *context)
 {
+    /* Locals start in allocas, loop passes only see through registers */
+    (void) LLVMAddPromoteMemoryToRegisterPass(context->pass_manager);
     (void) LLVMAddDeadArgEliminationPass(context->pass_manager);
     (void) LLVMAddCalledValuePropagationPass(context->pass_manager);
     (void) LLVMAddAlignmentFromAssumptionsPass(context->pass_manager);
@@ -704,18 +909,69 @@ static void add_o1_optimizations(t_main_context *context)
     (void) LLVMAddLowerExpectIntrinsicPass(context->pass_manager);
 }
 
+static void add_target_attributes(t_main_context *context)
+{
+    LLVMValueRef function = NULL;
+    LLVMAttributeRef cpu = NULL, features = NULL;
+
+    if (0 != strcmp("", context->target_cpu))
+    {
+        cpu = LLVMCreateStringAttribute(
+            LLVMGetGlobalContext(), "target-cpu", strlen("target-cpu"),
+            context->target_cpu, (unsigned) strlen(context->target_cpu));
+    }
+
+    if (0 != strcmp("", context->target_features))
+    {
+        features = LLVMCreateStringAttribute(
+            LLVMGetGlobalContext(), "target-features",
+            strlen("target-features"), context->target_features,
+            (unsigned) strlen(context->target_features));
+    }
+
+    for (function = LLVMGetFirstFunction(context->llvm_module);
+         NULL != function; function = LLVMGetNextFunction(function))
+    {
+        if (LLVMIsDeclaration(function))
+        {
+            continue;
+        }
+
+        if (NULL != cpu)
+        {
+            (void) LLVMAddAttributeAtIndex(function, LLVMAttributeFunctionIndex,
+                                           cpu);
+        }
+
+        if (NULL != features)
+        {
+            (void) LLVMAddAttributeAtIndex(function, LLVMAttributeFunctionIndex,
+                                           features);
+        }
+    }
+}
+
 static t_return_code optimize(t_main_context *context)
 {
     t_return_code status_code = LUKA_UNINITIALIZED;
 
+    (void) add_target_attributes(context);
+
     context->pass_manager = LLVMCreatePassManager();
+    /* Lets the vectorizer and the unroller know the registers and the costs of
+     * the target */
+    (void) LLVMAddAnalysisPasses(context->target_machine,
+                                 context->pass_manager);
 
-    (void) LLVMAddVerifierPass(context->pass_manager);
-    if (('0' == context->optimization) || ('1' == context->optimization))
+    /* The module was verified right after code generation */
+    if (!context->fast)
     {
-        (void) LLVMAddAlwaysInlinerPass(context->pass_manager);
+        (void) LLVMAddVerifierPass(context->pass_manager);
     }
 
+    /* There's no other inliner, so this is what honors `@inline` */
+    (void) LLVMAddAlwaysInlinerPass(context->pass_manager);
+
     if ('0' != context->optimization)
     {
         (void) add_o1_optimizations(context);
@@ -950,6 +1206,14 @@ static t_return_code do_file(t_main_context *context, const char *file_path)
     t_return_code status_code = LUKA_UNINITIALIZED;
     RAISE_LUKA_STATUS_ON_ERROR(frontend(context, file_path), status_code,
                                l_cleanup);
+
+    /* Files compiled together may call each other's functions, so only a lone
+     * file knows everything that is reachable. */
+    if (1 == context->files_count)
+    {
+        (void) REACHABILITY_prune(context->current_module, context->logger);
+    }
+
     RAISE_LUKA_STATUS_ON_ERROR(backend(context, NULL), status_code, l_cleanup);
 
     status_code = LUKA_SUCCESS;
@@ -972,7 +1236,8 @@ int main(int argc, char **argv)
     RAISE_LUKA_STATUS_ON_ERROR(initialize_llvm(&context), status_code,
                                l_cleanup);
 
-    (void) GEN_codegen_initialize();
+    (void) GEN_codegen_initialize(!context.fast, context.strict_overflow,
+                                  context.fast_math);
 
     if (!CORE_initialize_builtins(context.logger))
     {
@@ -1032,7 +1297,10 @@ int main(int argc, char **argv)
 
 l_cleanup:
     (void) context_destruct(&context);
+    (void) PARSER_free_lazy_bodies();
+    (void) AST_free_nodes();
     (void) GEN_codegen_reset();
+    (void) TYPE_free_interned_types();
     (void) LLVMResetFatalErrorHandler();
     (void) LLVMShutdown();
 
@@ -35,6 +35,11 @@ typedef struct
     LLVMTargetRef target;
     LLVMTargetDataRef target_data;
     char *triple;
+    char *cpu;
+    char *features;
+    bool native;
+    char *target_cpu;
+    char *target_features;
     char *error;
     t_logger *logger;
     size_t verbosity;
@@ -42,6 +47,9 @@ typedef struct
     char *cmd;
     bool bitcode;
     char optimization;
+    bool fast;
+    bool strict_overflow;
+    unsigned int fast_math;
     bool compile;
     bool assemble;
     bool link;
@@ -81,6 +89,17 @@ static void context_destruct(t_main_context *context);
  */
 static t_return_code get_args(t_main_context *context);
 
+/**
+ * @brief Parse a comma separated list of fast-math flags, such as
+ * `reassoc,nnan`.
+ *
+ * @param[in] names the names of the flags.
+ * @param[out] flags the parsed flags.
+ *
+ * @return whether every name is the name of a fast-math flag.
+ */
+static bool parse_fast_math_flags(const char *names, unsigned int *flags);
+
 /**
  * @brief Perform the lexing stage.
  *
@@ -123,6 +142,23 @@ static t_return_code parse(t_main_context *context, const char *file_path);
  */
 static t_return_code type_check(t_main_context *context);
 
+/**
+ * @brief Map an optimization level to the matching LLVM codegen level.
+ *
+ * @param[in] optimization the optimization level given with -O.
+ *
+ * @return the codegen level of the target machine.
+ */
+static LLVMCodeGenOptLevel codegen_level(char optimization);
+
+/**
+ * @brief Decide the CPU and CPU features to codegen for, detecting the ones of
+ * the host when -march=native is used.
+ *
+ * @param[in,out] context the context to use.
+ */
+static void initialize_target_cpu(t_main_context *context);
+
 /**
  * @brief Initalize all LLVM related things both in global scope and in context
  * variable.
@@ -166,6 +202,15 @@ static t_return_code code_generation(t_main_context *context);
  */
 static void add_o1_optimizations(t_main_context *context);
 
+/**
+ * @brief Mark every function defined in the module with the target CPU and
+ * features, so the optimization passes can use all of the instructions of the
+ * target.
+ *
+ * @param[in,out] context the context to use.
+ */
+static void add_target_attributes(t_main_context *context);
+
 /**
  * @brief Optimize the IR before saving it based on the optimization level.
  *
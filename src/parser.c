@@ -8,9 +8,79 @@
 #include "type.h"
 #include "vector.h"
 
+#include <limits.h>
+#include <pthread.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
+#include <unistd.h>
+
+/** The least amount of functions worth parsing on another thread */
+#define PARSER_FUNCTIONS_PER_THREAD (256)
+#define PARSER_MAX_THREADS          (16)
+
+typedef struct
+{
+    size_t start;         /**< The index of the `fn` token of the function */
+    size_t end;           /**< The index of the '}' that closes its body */
+    t_ast_node *function; /**< The function if it was parsed ahead, or NULL */
+} t_parser_chunk; /**< A top level function that may be parsed ahead */
+
+typedef struct
+{
+    const char *name; /**< The name of the struct or enum */
+    size_t index;     /**< The index of its `struct` or `enum` token */
+} t_parser_declaration; /**< A struct or enum declared somewhere in a file */
+
+typedef struct
+{
+    t_vector chunks;    /**< The top level functions, in source order */
+    t_vector structs;   /**< The struct declarations, in source order */
+    t_vector enums;     /**< The enum declarations, in source order */
+    size_t next_chunk;  /**< The first chunk that wasn't merged yet */
+    size_t next_struct; /**< The first struct that wasn't declared yet */
+    size_t next_enum;   /**< The first enum that wasn't declared yet */
+} t_parser_speculation; /**< Functions of a file that were parsed ahead */
+
+typedef struct
+{
+    const t_parser *parser;            /**< The parser of the file */
+    t_parser_speculation *speculation; /**< Where the chunks are */
+    size_t first;                      /**< The first chunk to parse */
+    size_t last;                       /**< One past the last chunk to parse */
+} t_parser_worker; /**< A thread that parses a range of chunks ahead */
+
+typedef struct
+{
+    int precedence;            /**< How tightly the operator binds, or 0 */
+    t_ast_binop_type operator; /**< The binary operator of the token */
+} t_parser_binary_operator; /**< How a token parses as a binary operator */
+
+/** The binary operators by token, every operator is left associative */
+static const t_parser_binary_operator binary_operators[T_EOF + 1] = {
+    [T_DOUBLE_PIPE] = {1, BINOP_LOR},
+    [T_DOUBLE_AMPERCENT] = {2, BINOP_LAND},
+    [T_PIPE] = {3, BINOP_BOR},
+    [T_CARET] = {4, BINOP_BXOR},
+    [T_AMPERCENT] = {5, BINOP_BAND},
+    [T_EQEQ] = {6, BINOP_EQUALS},
+    [T_NEQ] = {6, BINOP_NEQ},
+    [T_OPEN_ANG] = {7, BINOP_LESSER},
+    [T_CLOSE_ANG] = {7, BINOP_GREATER},
+    [T_LEQ] = {7, BINOP_LEQ},
+    [T_GEQ] = {7, BINOP_GEQ},
+    [T_SHL] = {8, BINOP_SHL},
+    [T_SHR] = {8, BINOP_SHR},
+    [T_PLUS] = {9, BINOP_ADD},
+    [T_MINUS] = {9, BINOP_SUBTRACT},
+    [T_PLUS_PERCENT] = {9, BINOP_ADD_WRAP},
+    [T_MINUS_PERCENT] = {9, BINOP_SUB_WRAP},
+    [T_STAR] = {10, BINOP_MULTIPLY},
+    [T_STAR_PERCENT] = {10, BINOP_MUL_WRAP},
+    [T_SLASH] = {10, BINOP_DIVIDE},
+    [T_PERCENT] = {10, BINOP_MODULOS},
+};
+static t_lazy_body *lazy_bodies = NULL;
 
 /**
  * @brief Parse an expression.
@@ -22,85 +92,99 @@
 static t_ast_node *parser_parse_expression(t_parser *parser);
 
 /**
- * @brief Parse an assignment (or a lower precedence expression).
+ * @brief Parse a range for expression, from the `for` keyword.
  *
  * @param[in,out] parser the parser to parse with.
+ * @param[in] label the label of the loop, or NULL.
+ * @param[in] hints the optimization hints of the loop.
  *
- * @return an assignment AST node.
+ * @return a for expression AST node.
  */
-static t_ast_node *parser_parse_assignment(t_parser *parser);
+static t_ast_node *parser_parse_for_expr(t_parser *parser, char *label,
+                                         t_loop_hints hints);
 
 /**
- * @brief Parse an bor (or a lower precedence expression).
+ * @brief Parse a match expression, such as
+ * `match (value) { 1, 2 => { ... } else => { ... } }`.
  *
- * @param[in,out] parser the parser to parse with.
+ * @param[in,out] parser the parser to parse with, at the `match` keyword.
  *
- * @return an bor AST node.
+ * @return a match expression AST node.
  */
-static t_ast_node *parser_parse_bor(t_parser *parser);
+static t_ast_node *parser_parse_match_expr(t_parser *parser);
 
 /**
- * @brief Parse an bxor (or a lower precedence expression).
+ * @brief Parse the optimization hints in front of a loop, such as
+ * `@unroll(4) @vectorize(width: 8)`.
  *
- * @param[in,out] parser the parser to parse with.
+ * @param[in,out] parser the parser to parse with, advanced past the hints.
  *
- * @return an bxor AST node.
+ * @return the hints of the loop, all unset if the current token isn't a hint.
  */
-static t_ast_node *parser_parse_bxor(t_parser *parser);
+static t_loop_hints parser_parse_loop_hints(t_parser *parser);
 
 /**
- * @brief Parse an band (or a lower precedence expression).
+ * @brief Parse the positive integer argument of a loop hint.
  *
- * @param[in,out] parser the parser to parse with.
+ * @param[in,out] parser the parser to parse with, advanced to the argument.
  *
- * @return an band AST node.
+ * @return the value of the argument.
  */
-static t_ast_node *parser_parse_band(t_parser *parser);
+static unsigned int parser_parse_loop_hint_argument(t_parser *parser);
 
 /**
- * @brief Parse an equality (or a lower precedence expression).
+ * @brief Parse the attributes in front of a function, such as
+ * `@inline @hot fn ...`.
  *
- * @param[in,out] parser the parser to parse with.
+ * @param[in,out] parser the parser to parse with, advanced past the
+ * attributes.
  *
- * @return an equality AST node.
+ * @return the attributes of the function, all unset if the current token isn't
+ * an attribute.
  */
-static t_ast_node *parser_parse_equality(t_parser *parser);
+static t_function_attributes parser_parse_function_attributes(
+    t_parser *parser);
 
 /**
- * @brief Parse a comparison (or a lower precedence expression).
+ * @brief Parse the label of a labelled loop, such as `outer:` in
+ * `outer: while (...) {...}`.
  *
- * @param[in,out] parser the parser to parse with.
+ * @param[in,out] parser the parser to parse with, advanced to the loop keyword
+ * if there is a label.
  *
- * @return a comparison AST node.
+ * @return the label or NULL if the current token doesn't start a label.
  */
-static t_ast_node *parser_parse_comparison(t_parser *parser);
+static char *parser_parse_loop_label(t_parser *parser);
 
 /**
- * @brief Parse an shift (or a lower precedence expression).
+ * @brief Parse the optional label after a `break` or `continue` keyword,
+ * along with the ';' that ends the statement.
  *
  * @param[in,out] parser the parser to parse with.
  *
- * @return an shift AST node.
+ * @return the label or NULL if the statement refers to the innermost loop.
  */
-static t_ast_node *parser_parse_shift(t_parser *parser);
+static char *parser_parse_jump_label(t_parser *parser);
 
 /**
- * @brief Parse a term (or a lower precedence expression).
+ * @brief Parse an assignment (or a lower precedence expression).
  *
  * @param[in,out] parser the parser to parse with.
  *
- * @return a term AST node.
+ * @return an assignment AST node.
  */
-static t_ast_node *parser_parse_term(t_parser *parser);
+static t_ast_node *parser_parse_assignment(t_parser *parser);
 
 /**
- * @brief Parse a factor (or a lower precedence expression).
+ * @brief Parse a chain of binary expressions whose operators bind tighter than
+ * a given precedence (or a lower precedence expression).
  *
  * @param[in,out] parser the parser to parse with.
+ * @param[in] min_precedence the lowest precedence of an operator to parse.
  *
- * @return a factor AST node.
+ * @return a binary expression AST node.
  */
-static t_ast_node *parser_parse_factor(t_parser *parser);
+static t_ast_node *parser_parse_binary(t_parser *parser, int min_precedence);
 
 /**
  * @brief Parse a unary (or a lower precedence expression).
@@ -208,6 +292,17 @@ static t_enum_field *parser_parse_enum_field(t_parser *parser);
  */
 static bool parser_is_enum_name(t_parser *parser, const char *ident_name);
 
+/**
+ * @brief Check if an identifier is the name of a SIMD vector type, such as
+ * `f32x4` or `u8x16`, and fill the vector type if it is.
+ *
+ * @param[in] ident_name the identifier to check.
+ * @param[out] type the type to fill with the vector type.
+ *
+ * @return whether the @p ident_name is a name of a vector type.
+ */
+static bool parser_parse_vector_type(const char *ident_name, t_type *type);
+
 /**
  * @brief Parse a function.
  *
@@ -226,6 +321,17 @@ static t_ast_node *parser_parse_function(t_parser *parser);
  */
 static t_ast_node *parser_parse_prototype(t_parser *parser);
 
+/**
+ * @brief Parse the `restrict` qualifier of a function argument, as in
+ * `dest: restrict mut u8*`.
+ *
+ * @param[in,out] parser the parser to parse with, on the name of the argument
+ * and advanced to the qualifier if there is one.
+ *
+ * @return whether the argument is a `restrict` pointer.
+ */
+static bool parser_parse_restrict(t_parser *parser);
+
 /**
  * @brief Parse a let statement.
  *
@@ -366,7 +472,9 @@ static void parser_match_advance(t_parser *parser, t_toktype type,
 static bool parser_is_compound_expr(t_ast_node *node)
 {
     return (node->type == AST_TYPE_WHILE_EXPR)
-        || (node->type == AST_TYPE_IF_EXPR);
+        || (node->type == AST_TYPE_FOR_EXPR)
+        || (node->type == AST_TYPE_IF_EXPR)
+        || (node->type == AST_TYPE_MATCH_EXPR);
 }
 
 /**
@@ -381,26 +489,16 @@ static bool parser_is_compound_expr(t_ast_node *node)
 static t_type *parser_parse_type(t_parser *parser, bool parse_prefix)
 {
     t_token *token = NULL;
-    t_type *type = NULL;
-    t_type *inner_type = NULL;
+    t_type ttype = {0};
+    t_type *type = &ttype;
     size_t length = 0;
 
-    type = calloc(1, sizeof(t_type));
-    if (NULL == type)
-    {
-        exit(LUKA_CANT_ALLOC_MEMORY);
-    }
-    type->inner_type = NULL;
-    type->payload = NULL;
-    type->mutable = false;
-
     if (parse_prefix)
     {
         token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index + 1);
         if (T_COLON != token->type)
         {
-            type->type = TYPE_ANY;
-            return type;
+            return TYPE_make_type(TYPE_ANY, NULL, NULL, false);
         }
 
         parser_expect_advance(parser, T_COLON, "Expected a `:` before type.");
@@ -469,32 +567,37 @@ static t_type *parser_parse_type(t_parser *parser, bool parse_prefix)
             type->type = TYPE_STRUCT;
             parser_advance(parser);
             token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
-            type->payload = (void *) strdup(token->content);
+            type->payload = (void *) token->content;
             break;
         case T_ENUM:
             type->type = TYPE_ENUM;
             parser_advance(parser);
             token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
-            type->payload = (void *) strdup(token->content);
+            type->payload = (void *) token->content;
             break;
         case T_IDENTIFIER:
             {
                 if (parser_is_struct_name(parser, token->content))
                 {
                     type->type = TYPE_STRUCT;
-                    type->payload = (void *) strdup(token->content);
+                    type->payload = (void *) token->content;
                     break;
                 }
 
                 if (parser_is_enum_name(parser, token->content))
                 {
                     type->type = TYPE_ENUM;
-                    type->payload = (void *) strdup(token->content);
+                    type->payload = (void *) token->content;
+                    break;
+                }
+
+                if (parser_parse_vector_type(token->content, type))
+                {
                     break;
                 }
 
                 type->type = TYPE_ALIAS;
-                type->payload = (void *) strdup(token->content);
+                type->payload = (void *) token->content;
             }
         case T_MUT:
         case T_OPEN_BRACKET:
@@ -513,23 +616,33 @@ static t_type *parser_parse_type(t_parser *parser, bool parse_prefix)
         case T_CLOSE_PAREN:
         case T_COLON:
         case T_COMMA:
+        case T_CONTINUE:
         case T_DEFER:
         case T_DOT:
+        case T_DOUBLE_AMPERCENT:
         case T_DOUBLE_COLON:
+        case T_DOUBLE_DOT:
+        case T_DOUBLE_PIPE:
         case T_ELSE:
         case T_EOF:
         case T_EQEQ:
         case T_EQUALS:
+        case T_EXPORT:
         case T_EXTERN:
         case T_FALSE:
+        case T_FAT_ARROW:
         case T_FN:
+        case T_FOR:
         case T_GEQ:
         case T_IF:
         case T_IMPORT:
+        case T_IN:
         case T_INTLIT:
         case T_LEQ:
         case T_LET:
+        case T_MATCH:
         case T_MINUS:
+        case T_MINUS_PERCENT:
         case T_NEQ:
         case T_NULL:
         case T_NUMBER:
@@ -539,11 +652,14 @@ static t_type *parser_parse_type(t_parser *parser, bool parse_prefix)
         case T_PERCENT:
         case T_PIPE:
         case T_PLUS:
+        case T_PLUS_PERCENT:
+        case T_RESTRICT:
         case T_RETURN:
         case T_SEMI_COLON:
         case T_SHL:
         case T_SHR:
         case T_SLASH:
+        case T_STAR_PERCENT:
         case T_STRING:
         case T_THREE_DOTS:
         case T_TILDE:
@@ -557,20 +673,15 @@ static t_type *parser_parse_type(t_parser *parser, bool parse_prefix)
             }
     }
 
+    type = TYPE_intern(&ttype);
     token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index + 1);
     while ((T_STAR == token->type) || (T_OPEN_BRACKET == token->type)
            || (T_MUT == token->type))
     {
-        inner_type = type;
-        type = calloc(1, sizeof(t_type));
-        if (NULL == type)
-        {
-            exit(LUKA_CANT_ALLOC_MEMORY);
-        }
-
-        type->inner_type = inner_type;
-        type->payload = NULL;
-        type->mutable = false;
+        ttype.inner_type = type;
+        ttype.payload = NULL;
+        ttype.mutable = false;
+        type = &ttype;
 
         if (T_MUT == token->type)
         {
@@ -609,6 +720,8 @@ static t_type *parser_parse_type(t_parser *parser, bool parse_prefix)
             token
                 = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index + 1);
         }
+
+        type = TYPE_intern(&ttype);
     }
 
     return type;
@@ -645,6 +758,8 @@ void PARSER_initialize(t_parser *parser, t_vector *tokens,
     (void) vector_setup(parser->enum_names, 1, sizeof(char *));
 
     parser->type_aliases = type_aliases;
+    parser->lazy = false;
+    parser->no_struct_value = false;
 }
 
 void PARSER_free(t_parser *parser)
@@ -664,6 +779,337 @@ void PARSER_free(t_parser *parser)
     parser->enum_names = NULL;
 }
 
+/**
+ * @brief Find the '}' that closes the body of the function starting at a
+ * given `fn` token.
+ *
+ * @param[in] parser the parser of the file.
+ * @param[in] start the index of the `fn` token.
+ * @param[out] end the index of the '}' that closes the body.
+ *
+ * @return whether the function seems to have a well formed body.
+ */
+static bool parser_find_body_end(const t_parser *parser, size_t start,
+                                 size_t *end)
+{
+    t_token *token = NULL;
+    size_t index = start, depth = 0;
+
+    for (index = start; index < parser->tokens->size; ++index)
+    {
+        token = VECTOR_GET_AS(t_token_ptr, parser->tokens, index);
+        if (T_OPEN_BRACE == token->type)
+        {
+            ++depth;
+        }
+        else if (T_CLOSE_BRACE == token->type)
+        {
+            if (0 == depth)
+            {
+                return false;
+            }
+
+            --depth;
+            if (0 == depth)
+            {
+                *end = index;
+                return true;
+            }
+        }
+        else if ((T_EOF == token->type) || ((0 == depth) && (start != index)
+                                            && (T_SEMI_COLON == token->type)))
+        {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief Split a file into its top level functions and find where every struct
+ * and enum is declared, without parsing anything.
+ *
+ * @param[in] parser the parser of the file.
+ * @param[in,out] speculation where to put the functions and the declarations.
+ */
+static void parser_scan_file(const t_parser *parser,
+                             t_parser_speculation *speculation)
+{
+    t_token *token = NULL, *next = NULL;
+    t_parser_chunk chunk = {0};
+    t_parser_declaration declaration = {0};
+    size_t index = 0, depth = 0;
+
+    for (index = 0; index + 1 < parser->tokens->size; ++index)
+    {
+        token = VECTOR_GET_AS(t_token_ptr, parser->tokens, index);
+        next = VECTOR_GET_AS(t_token_ptr, parser->tokens, index + 1);
+        if (T_OPEN_BRACE == token->type)
+        {
+            ++depth;
+        }
+        else if ((T_CLOSE_BRACE == token->type) && (0 < depth))
+        {
+            --depth;
+        }
+        else if (((T_STRUCT == token->type) || (T_ENUM == token->type))
+                 && (T_IDENTIFIER == next->type))
+        {
+            declaration.name = next->content;
+            declaration.index = index;
+            (void) vector_push_back((T_STRUCT == token->type)
+                                        ? &speculation->structs
+                                        : &speculation->enums,
+                                    &declaration);
+        }
+        else if ((T_FN == token->type) && (0 == depth)
+                 && parser_find_body_end(parser, index, &chunk.end))
+        {
+            chunk.start = index;
+            (void) vector_push_back(&speculation->chunks, &chunk);
+        }
+    }
+}
+
+/**
+ * @brief Declare the structs or enums that were declared before a given index.
+ *
+ * @param[in,out] names the names to add the declared names to, or NULL to
+ * only skip the declarations.
+ * @param[in] declarations the declarations of the file, in source order.
+ * @param[in] next the first declaration that wasn't declared yet.
+ * @param[in] index the index to declare up to.
+ *
+ * @return the first declaration that still wasn't declared.
+ */
+static size_t parser_declare_names(t_vector *names,
+                                   const t_vector *declarations, size_t next,
+                                   size_t index)
+{
+    const t_parser_declaration *declaration = NULL;
+    const char *name = NULL;
+
+    for (; next < declarations->size; ++next)
+    {
+        declaration = vector_const_get(declarations, next);
+        if (index <= declaration->index)
+        {
+            break;
+        }
+
+        if (NULL != names)
+        {
+            name = declaration->name;
+            (void) vector_push_front(names, &name);
+        }
+    }
+
+    return next;
+}
+
+/**
+ * @brief Try to parse a chunk, giving up at the first error.
+ *
+ * @param[in,out] parser a parser whose logger jumps to @p recovery.
+ * @param[in] recovery the recovery point of the parser's logger.
+ * @param[in] chunk the chunk to parse.
+ *
+ * @return the function AST node, or NULL if it has to be parsed in order.
+ */
+static t_ast_node *parser_try_parse_chunk(t_parser *parser, jmp_buf *recovery,
+                                          const t_parser_chunk *chunk)
+{
+    t_ast_node *function = NULL;
+
+    parser->index = chunk->start;
+    if (0 != setjmp(*recovery))
+    {
+        return NULL;
+    }
+
+    function = parser_parse_function(parser);
+    return (chunk->end == parser->index) ? function : NULL;
+}
+
+/**
+ * @brief Parse a range of chunks ahead, on a thread of its own.
+ *
+ * @param[in,out] arg the #t_parser_worker of the thread.
+ *
+ * @return NULL.
+ */
+static void *parser_run_worker(void *arg)
+{
+    t_parser_worker *worker = arg;
+    t_parser_speculation *speculation = worker->speculation;
+    t_parser parser = *worker->parser;
+    t_logger logger = *worker->parser->logger;
+    t_vector struct_names = {0}, enum_names = {0};
+    t_parser_chunk *chunk = NULL;
+    size_t index = 0, next_struct = 0, next_enum = 0;
+    jmp_buf recovery;
+
+    (void) vector_setup(&struct_names, 1, sizeof(char *));
+    (void) vector_setup(&enum_names, 1, sizeof(char *));
+
+    logger.recovery = &recovery;
+    parser.logger = &logger;
+    parser.struct_names = &struct_names;
+    parser.enum_names = &enum_names;
+    parser.lazy = false;
+
+    for (index = worker->first; index < worker->last; ++index)
+    {
+        chunk = vector_get(&speculation->chunks, index);
+        next_struct = parser_declare_names(&struct_names, &speculation->structs,
+                                           next_struct, chunk->start);
+        next_enum = parser_declare_names(&enum_names, &speculation->enums,
+                                         next_enum, chunk->start);
+        chunk->function = parser_try_parse_chunk(&parser, &recovery, chunk);
+    }
+
+    (void) vector_destroy(&struct_names);
+    (void) vector_destroy(&enum_names);
+    (void) AST_release_thread_nodes();
+    return NULL;
+}
+
+/**
+ * @brief Parse the top level functions of a large file ahead, in parallel.
+ *
+ * @details Functions that fail to parse ahead are left to be parsed in order,
+ * so any error is reported exactly like without parsing ahead.
+ *
+ * @param[in] parser the parser of the file.
+ * @param[out] speculation where to put the functions parsed ahead.
+ */
+static void parser_speculate(const t_parser *parser,
+                             t_parser_speculation *speculation)
+{
+    pthread_t threads[PARSER_MAX_THREADS];
+    t_parser_worker workers[PARSER_MAX_THREADS];
+    size_t number_of_threads = 0, started = 0, parsed = 0, i = 0;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+
+    (void) memset(speculation, 0, sizeof(t_parser_speculation));
+    (void) vector_setup(&speculation->chunks, 1, sizeof(t_parser_chunk));
+    (void) vector_setup(&speculation->structs, 1,
+                        sizeof(t_parser_declaration));
+    (void) vector_setup(&speculation->enums, 1, sizeof(t_parser_declaration));
+
+    if (parser->lazy || (2 > cpus))
+    {
+        return;
+    }
+
+    (void) parser_scan_file(parser, speculation);
+    number_of_threads = speculation->chunks.size / PARSER_FUNCTIONS_PER_THREAD;
+    number_of_threads = (number_of_threads < (size_t) cpus) ? number_of_threads
+                                                             : (size_t) cpus;
+    number_of_threads = (number_of_threads < PARSER_MAX_THREADS)
+                            ? number_of_threads
+                            : PARSER_MAX_THREADS;
+    if (2 > number_of_threads)
+    {
+        (void) vector_clear(&speculation->chunks);
+        return;
+    }
+
+    for (i = 0; i < number_of_threads; ++i)
+    {
+        workers[i].parser = parser;
+        workers[i].speculation = speculation;
+        workers[i].first = speculation->chunks.size * i / number_of_threads;
+        workers[i].last
+            = speculation->chunks.size * (i + 1) / number_of_threads;
+        if (0 != pthread_create(&threads[i], NULL, parser_run_worker,
+                                &workers[i]))
+        {
+            break;
+        }
+        ++started;
+    }
+
+    for (i = 0; i < started; ++i)
+    {
+        (void) pthread_join(threads[i], NULL);
+    }
+
+    VECTOR_FOR_EACH(&speculation->chunks, chunks)
+    {
+        if (NULL != (ITERATOR_GET_AS(t_parser_chunk, &chunks)).function)
+        {
+            ++parsed;
+        }
+    }
+
+    (void) LOGGER_log(parser->logger, L_DEBUG,
+                      "Parsed %zu of %zu functions of %s ahead on %zu "
+                      "threads\n",
+                      parsed, speculation->chunks.size, parser->file_path,
+                      started);
+}
+
+/**
+ * @brief Parse the top level function starting at the current token, taking
+ * it from the functions parsed ahead if possible.
+ *
+ * @param[in,out] parser the parser to parse with.
+ * @param[in,out] speculation the functions parsed ahead.
+ *
+ * @return a function AST node.
+ */
+static t_ast_node *parser_parse_top_level_function(
+    t_parser *parser, t_parser_speculation *speculation)
+{
+    const t_parser_chunk *chunk = NULL;
+
+    for (; speculation->next_chunk < speculation->chunks.size;
+         ++speculation->next_chunk)
+    {
+        chunk = vector_const_get(&speculation->chunks, speculation->next_chunk);
+        if (parser->index <= chunk->start)
+        {
+            break;
+        }
+    }
+
+    if ((speculation->next_chunk == speculation->chunks.size)
+        || (parser->index != chunk->start) || (NULL == chunk->function))
+    {
+        return parser_parse_function(parser);
+    }
+
+    speculation->next_struct = parser_declare_names(
+        NULL, &speculation->structs, speculation->next_struct, chunk->start);
+    speculation->next_struct = parser_declare_names(
+        parser->struct_names, &speculation->structs, speculation->next_struct,
+        chunk->end);
+    speculation->next_enum = parser_declare_names(
+        NULL, &speculation->enums, speculation->next_enum, chunk->start);
+    speculation->next_enum
+        = parser_declare_names(parser->enum_names, &speculation->enums,
+                               speculation->next_enum, chunk->end);
+
+    parser->index = chunk->end;
+    ++speculation->next_chunk;
+    return chunk->function;
+}
+
+/**
+ * @brief Deallocate the memory of the functions parsed ahead, but not the
+ * functions themselves.
+ *
+ * @param[in,out] speculation the functions parsed ahead.
+ */
+static void parser_free_speculation(t_parser_speculation *speculation)
+{
+    (void) vector_destroy(&speculation->chunks);
+    (void) vector_destroy(&speculation->structs);
+    (void) vector_destroy(&speculation->enums);
+}
+
 t_module *PARSER_parse_file(t_parser *parser)
 {
     t_return_code status_code = LUKA_UNINITIALIZED;
@@ -675,6 +1121,11 @@ t_module *PARSER_parse_file(t_parser *parser)
     t_type *type = NULL;
     t_type_alias *type_alias = NULL;
     char type_str[512] = {0};
+    t_parser_speculation speculation = {0};
+    t_function_attributes attributes;
+    size_t attributes_index = 0;
+
+    (void) parser_speculate(parser, &speculation);
 
     RAISE_LUKA_STATUS_ON_ERROR(LIB_initialize_module(&module, parser->logger),
                                status_code, l_cleanup);
@@ -684,7 +1135,16 @@ t_module *PARSER_parse_file(t_parser *parser)
 
     while (parser->index < parser->tokens->size)
     {
+        attributes_index = parser->index;
+        attributes = parser_parse_function_attributes(parser);
         token = *(t_token_ptr *) vector_get(parser->tokens, parser->index);
+        if ((attributes_index != parser->index) && (T_FN != token->type)
+            && (T_EXPORT != token->type) && (T_EXTERN != token->type))
+        {
+            --parser->index;
+            parser_err(parser, "Expected a function after function "
+                               "attributes.");
+        }
 
         switch (token->type)
         {
@@ -692,8 +1152,24 @@ t_module *PARSER_parse_file(t_parser *parser)
                 {
                     starting_token = *(t_token_ptr *) vector_get(parser->tokens,
                                                                  parser->index);
-                    node = parser_parse_function(parser);
+                    node = parser_parse_top_level_function(parser,
+                                                           &speculation);
+                    node->token = starting_token;
+                    node->function.prototype->prototype.attributes = attributes;
+                    (void) vector_push_back(module->functions, &node);
+                    break;
+                }
+            case T_EXPORT:
+                {
+                    starting_token = *(t_token_ptr *) vector_get(parser->tokens,
+                                                                 parser->index);
+                    parser_expect_advance(
+                        parser, T_FN, "Expected 'fn' after 'export' keyword");
+                    node = parser_parse_top_level_function(parser,
+                                                           &speculation);
                     node->token = starting_token;
+                    node->function.exported = true;
+                    node->function.prototype->prototype.attributes = attributes;
                     (void) vector_push_back(module->functions, &node);
                     break;
                 }
@@ -706,6 +1182,12 @@ t_module *PARSER_parse_file(t_parser *parser)
                     /* Extern Variable */
                     if (token_after_ident->type == T_COLON)
                     {
+                        if (attributes_index != parser->index)
+                        {
+                            --parser->index;
+                            parser_err(parser, "Expected a function after "
+                                               "function attributes.");
+                        }
                         parser_advance(parser);
                         parser_match_advance(
                             parser, T_IDENTIFIER,
@@ -724,6 +1206,7 @@ t_module *PARSER_parse_file(t_parser *parser)
                     else
                     {
                         node = parser_parse_prototype(parser);
+                        node->prototype.attributes = attributes;
                         node = AST_new_function(node, NULL);
                         node->token = starting_token;
                         (void) vector_push_back(module->functions, &node);
@@ -849,9 +1332,13 @@ t_module *PARSER_parse_file(t_parser *parser)
             case T_CLOSE_PAREN:
             case T_COLON:
             case T_COMMA:
+            case T_CONTINUE:
             case T_DEFER:
             case T_DOT:
+            case T_DOUBLE_AMPERCENT:
             case T_DOUBLE_COLON:
+            case T_DOUBLE_DOT:
+            case T_DOUBLE_PIPE:
             case T_DOUBLE_TYPE:
             case T_ELSE:
             case T_EQEQ:
@@ -859,14 +1346,19 @@ t_module *PARSER_parse_file(t_parser *parser)
             case T_F32_TYPE:
             case T_F64_TYPE:
             case T_FALSE:
+            case T_FAT_ARROW:
             case T_FLOAT_TYPE:
+            case T_FOR:
             case T_GEQ:
             case T_IDENTIFIER:
             case T_IF:
+            case T_IN:
             case T_INTLIT:
             case T_INT_TYPE:
             case T_LEQ:
+            case T_MATCH:
             case T_MINUS:
+            case T_MINUS_PERCENT:
             case T_MUT:
             case T_NEQ:
             case T_NULL:
@@ -878,6 +1370,8 @@ t_module *PARSER_parse_file(t_parser *parser)
             case T_PERCENT:
             case T_PIPE:
             case T_PLUS:
+            case T_PLUS_PERCENT:
+            case T_RESTRICT:
             case T_RETURN:
             case T_S16_TYPE:
             case T_S32_TYPE:
@@ -888,6 +1382,7 @@ t_module *PARSER_parse_file(t_parser *parser)
             case T_SHR:
             case T_SLASH:
             case T_STAR:
+            case T_STAR_PERCENT:
             case T_STRING:
             case T_STR_TYPE:
             case T_THREE_DOTS:
@@ -915,6 +1410,8 @@ t_module *PARSER_parse_file(t_parser *parser)
     status_code = LUKA_SUCCESS;
 
 l_cleanup:
+    (void) parser_free_speculation(&speculation);
+
     if ((LUKA_SUCCESS != status_code) && (NULL != module))
     {
         (void) LIB_free_module(module, parser->logger);
@@ -949,6 +1446,27 @@ static t_ast_node *parser_parse_paren_expr(t_parser *parser)
     return expr;
 }
 
+/**
+ * @brief Make sure that the type of an array literal element can be inferred
+ * while the parser parses ahead, without a module to look things up in.
+ *
+ * @details A parser parses ahead if its logger has a recovery point, the
+ * element is left to be parsed in order otherwise.
+ *
+ * @param[in] parser the parser to parse with.
+ * @param[in] expr the array literal element.
+ */
+static void parser_check_element_type(t_parser *parser, t_ast_node *expr)
+{
+    if ((NULL != parser->logger->recovery)
+        && (AST_TYPE_ARRAY_LITERAL != expr->type)
+        && (AST_TYPE_LITERAL != expr->type) && (AST_TYPE_NUMBER != expr->type)
+        && (AST_TYPE_STRING != expr->type) && (AST_TYPE_VARIABLE != expr->type))
+    {
+        longjmp(*parser->logger->recovery, 1);
+    }
+}
+
 /**
  * @brief Parse an array literal.
  *
@@ -979,11 +1497,12 @@ static t_ast_node *parser_parse_array_literal(t_parser *parser)
     while (!parser_match(parser, T_CLOSE_BRACKET))
     {
         expr = parser_parse_expression(parser);
+        (void) parser_check_element_type(parser, expr);
         if (NULL == type)
         {
             type = TYPE_get_type(expr, parser->logger, parser->module);
         }
-        else if (!TYPE_equal(
+        else if (!TYPE_can_cast(
                      type, TYPE_get_type(expr, parser->logger, parser->module)))
         {
             LOGGER_LOG_LOC(
@@ -1039,6 +1558,51 @@ static bool parser_is_enum_name(t_parser *parser, const char *ident_name)
     return false;
 }
 
+static bool parser_parse_vector_type(const char *ident_name, t_type *type)
+{
+    static const struct
+    {
+        const char *name;
+        t_base_type type;
+    } element_types[] = {
+        {"s8", TYPE_SINT8},   {"s16", TYPE_SINT16}, {"s32", TYPE_SINT32},
+        {"s64", TYPE_SINT64}, {"u8", TYPE_UINT8},   {"u16", TYPE_UINT16},
+        {"u32", TYPE_UINT32}, {"u64", TYPE_UINT64}, {"f32", TYPE_F32},
+        {"f64", TYPE_F64},
+    };
+    size_t i = 0, length = 0, lanes = 0;
+    char *end = NULL;
+
+    for (i = 0; i < sizeof(element_types) / sizeof(element_types[0]); ++i)
+    {
+        length = strlen(element_types[i].name);
+        if ((0 == strncmp(element_types[i].name, ident_name, length))
+            && ('x' == ident_name[length]))
+        {
+            break;
+        }
+    }
+
+    if (sizeof(element_types) / sizeof(element_types[0]) == i)
+    {
+        return false;
+    }
+
+    lanes = (size_t) strtoul(ident_name + length + 1, &end, 10);
+    /* Only powers of two map to native SIMD registers */
+    if (('\0' != *end) || (lanes < 2) || (lanes > 64)
+        || (0 != (lanes & (lanes - 1))))
+    {
+        return false;
+    }
+
+    type->type = TYPE_VECTOR;
+    type->inner_type
+        = TYPE_make_type(element_types[i].type, NULL, NULL, false);
+    type->payload = (void *) lanes;
+    return true;
+}
+
 /**
  * @brief Parse an identifier expression.
  *
@@ -1079,9 +1643,8 @@ static t_ast_node *parser_parse_ident_expr(t_parser *parser)
         token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
         parser_advance(parser);
 
-        type = is_enum ? TYPE_initialize_type(TYPE_ENUM)
-                       : TYPE_initialize_type(TYPE_STRUCT);
-        type->payload = strdup(ident_name);
+        type = TYPE_make_type(is_enum ? TYPE_ENUM : TYPE_STRUCT, NULL,
+                              ident_name, false);
 
         node = AST_new_get_expr(AST_new_variable(ident_name, type, false),
                                 strdup(token->content), is_enum);
@@ -1094,7 +1657,7 @@ static t_ast_node *parser_parse_ident_expr(t_parser *parser)
             return node;
         }
     }
-    else if (parser_match(parser, T_OPEN_BRACE))
+    else if (parser_match(parser, T_OPEN_BRACE) && !parser->no_struct_value)
     {
         parser_advance(parser);
         struct_value_fields = calloc(1, sizeof(t_vector));
@@ -1170,14 +1733,12 @@ static t_ast_node *parser_parse_ident_expr(t_parser *parser)
 
         if (parser_is_struct_name(parser, ident_name))
         {
-            type = TYPE_initialize_type(TYPE_STRUCT);
-            type->payload = (void *) strdup(ident_name);
+            type = TYPE_make_type(TYPE_STRUCT, NULL, ident_name, false);
             node = AST_new_type_expr(type);
         }
         else if (parser_is_enum_name(parser, ident_name))
         {
-            type = TYPE_initialize_type(TYPE_ENUM);
-            type->payload = (void *) strdup(ident_name);
+            type = TYPE_make_type(TYPE_ENUM, NULL, ident_name, false);
             node = AST_new_type_expr(type);
         }
         else
@@ -1269,573 +1830,29 @@ l_cleanup:
     return NULL;
 }
 
-t_ast_node *parser_parse_equality(t_parser *parser)
+t_ast_node *parser_parse_unary(t_parser *parser)
 {
-    t_ast_node *lhs = NULL, *rhs = NULL, *node = NULL;
+    t_ast_node *unary = NULL, *node = NULL;
     t_token *token = NULL, *starting_token = NULL;
-    t_ast_binop_type operator= BINOP_NEQ;
+    bool mutable = false;
 
     starting_token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
-    lhs = parser_parse_comparison(parser);
-    token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
+    token = starting_token;
+
     switch (token->type)
     {
-        case T_NEQ:
+        case T_BANG:
             {
-                operator= BINOP_NEQ;
+                parser_advance(parser);
+                unary = parser_parse_unary(parser);
+                node = AST_new_unary_expr(UNOP_NOT, unary, false);
                 break;
             }
-        case T_EQEQ:
+        case T_MINUS:
             {
-                operator= BINOP_EQUALS;
-                break;
-            }
-        case T_AMPERCENT:
-        case T_ANY_TYPE:
-        case T_AS:
-        case T_BANG:
-        case T_BOOL_TYPE:
-        case T_BREAK:
-        case T_BUILTIN:
-        case T_CARET:
-        case T_CHAR:
-        case T_CHAR_TYPE:
-        case T_CLOSE_ANG:
-        case T_CLOSE_BRACE:
-        case T_CLOSE_BRACKET:
-        case T_CLOSE_PAREN:
-        case T_COLON:
-        case T_COMMA:
-        case T_DEFER:
-        case T_DOT:
-        case T_DOUBLE_COLON:
-        case T_DOUBLE_TYPE:
-        case T_ELSE:
-        case T_ENUM:
-        case T_EOF:
-        case T_EQUALS:
-        case T_EXTERN:
-        case T_F32_TYPE:
-        case T_F64_TYPE:
-        case T_FALSE:
-        case T_FLOAT_TYPE:
-        case T_FN:
-        case T_GEQ:
-        case T_IDENTIFIER:
-        case T_IF:
-        case T_IMPORT:
-        case T_INTLIT:
-        case T_INT_TYPE:
-        case T_LEQ:
-        case T_LET:
-        case T_MINUS:
-        case T_MUT:
-        case T_NULL:
-        case T_NUMBER:
-        case T_OPEN_ANG:
-        case T_OPEN_BRACE:
-        case T_OPEN_BRACKET:
-        case T_OPEN_PAREN:
-        case T_PERCENT:
-        case T_PIPE:
-        case T_PLUS:
-        case T_RETURN:
-        case T_S16_TYPE:
-        case T_S32_TYPE:
-        case T_S64_TYPE:
-        case T_S8_TYPE:
-        case T_SEMI_COLON:
-        case T_SHL:
-        case T_SHR:
-        case T_SLASH:
-        case T_STAR:
-        case T_STRING:
-        case T_STRUCT:
-        case T_STR_TYPE:
-        case T_THREE_DOTS:
-        case T_TILDE:
-        case T_TRUE:
-        case T_TYPE:
-        case T_U16_TYPE:
-        case T_U32_TYPE:
-        case T_U64_TYPE:
-        case T_U8_TYPE:
-        case T_UNKNOWN:
-        case T_VOID_TYPE:
-        case T_WHILE:
-            {
-                return lhs;
-            }
-    }
-
-    parser_advance(parser);
-    rhs = parser_parse_comparison(parser);
-    node = AST_new_binary_expr(operator, lhs, rhs);
-    node->token = starting_token;
-    return node;
-}
-
-t_ast_node *parser_parse_comparison(t_parser *parser)
-{
-    t_ast_node *lhs = NULL, *rhs = NULL, *node = NULL;
-    t_token *token = NULL, *starting_token = NULL;
-    t_ast_binop_type operator= BINOP_GREATER;
-
-    starting_token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
-    lhs = parser_parse_shift(parser);
-    token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
-    switch (token->type)
-    {
-        case T_CLOSE_ANG:
-            {
-                operator= BINOP_GREATER;
-                break;
-            }
-        case T_GEQ:
-            {
-                operator= BINOP_GEQ;
-                break;
-            }
-        case T_OPEN_ANG:
-            {
-                operator= BINOP_LESSER;
-                break;
-            }
-        case T_LEQ:
-            {
-                operator= BINOP_LEQ;
-                break;
-            }
-        case T_AMPERCENT:
-        case T_ANY_TYPE:
-        case T_AS:
-        case T_BANG:
-        case T_BOOL_TYPE:
-        case T_BREAK:
-        case T_BUILTIN:
-        case T_CARET:
-        case T_CHAR:
-        case T_CHAR_TYPE:
-        case T_CLOSE_BRACE:
-        case T_CLOSE_BRACKET:
-        case T_CLOSE_PAREN:
-        case T_COLON:
-        case T_COMMA:
-        case T_DEFER:
-        case T_DOT:
-        case T_DOUBLE_COLON:
-        case T_DOUBLE_TYPE:
-        case T_ELSE:
-        case T_ENUM:
-        case T_EOF:
-        case T_EQEQ:
-        case T_EQUALS:
-        case T_EXTERN:
-        case T_F32_TYPE:
-        case T_F64_TYPE:
-        case T_FALSE:
-        case T_FLOAT_TYPE:
-        case T_FN:
-        case T_IDENTIFIER:
-        case T_IF:
-        case T_IMPORT:
-        case T_INTLIT:
-        case T_INT_TYPE:
-        case T_LET:
-        case T_MINUS:
-        case T_MUT:
-        case T_NEQ:
-        case T_NULL:
-        case T_NUMBER:
-        case T_OPEN_BRACE:
-        case T_OPEN_BRACKET:
-        case T_OPEN_PAREN:
-        case T_PERCENT:
-        case T_PIPE:
-        case T_PLUS:
-        case T_RETURN:
-        case T_S16_TYPE:
-        case T_S32_TYPE:
-        case T_S64_TYPE:
-        case T_S8_TYPE:
-        case T_SEMI_COLON:
-        case T_SHL:
-        case T_SHR:
-        case T_SLASH:
-        case T_STAR:
-        case T_STRING:
-        case T_STRUCT:
-        case T_STR_TYPE:
-        case T_THREE_DOTS:
-        case T_TILDE:
-        case T_TRUE:
-        case T_TYPE:
-        case T_U16_TYPE:
-        case T_U32_TYPE:
-        case T_U64_TYPE:
-        case T_U8_TYPE:
-        case T_UNKNOWN:
-        case T_VOID_TYPE:
-        case T_WHILE:
-            {
-                return lhs;
-            }
-    }
-
-    parser_advance(parser);
-    rhs = parser_parse_shift(parser);
-    node = AST_new_binary_expr(operator, lhs, rhs);
-    node->token = starting_token;
-    return node;
-}
-
-t_ast_node *parser_parse_shift(t_parser *parser)
-{
-    t_ast_node *lhs = NULL, *rhs = NULL, *node = NULL;
-    t_token *token = NULL, *starting_token = NULL;
-    t_ast_binop_type operator= BINOP_SHL;
-
-    starting_token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
-    lhs = parser_parse_term(parser);
-    token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
-    switch (token->type)
-    {
-        case T_SHL:
-            {
-                operator= BINOP_SHL;
-                break;
-            }
-        case T_SHR:
-            {
-                operator= BINOP_SHR;
-                break;
-            }
-        case T_AMPERCENT:
-        case T_ANY_TYPE:
-        case T_AS:
-        case T_BANG:
-        case T_BOOL_TYPE:
-        case T_BREAK:
-        case T_BUILTIN:
-        case T_CARET:
-        case T_CHAR:
-        case T_CHAR_TYPE:
-        case T_CLOSE_ANG:
-        case T_CLOSE_BRACE:
-        case T_CLOSE_BRACKET:
-        case T_CLOSE_PAREN:
-        case T_COLON:
-        case T_COMMA:
-        case T_DEFER:
-        case T_DOT:
-        case T_DOUBLE_COLON:
-        case T_DOUBLE_TYPE:
-        case T_ELSE:
-        case T_ENUM:
-        case T_EOF:
-        case T_EQEQ:
-        case T_EQUALS:
-        case T_EXTERN:
-        case T_F32_TYPE:
-        case T_F64_TYPE:
-        case T_FALSE:
-        case T_FLOAT_TYPE:
-        case T_FN:
-        case T_GEQ:
-        case T_IDENTIFIER:
-        case T_IF:
-        case T_IMPORT:
-        case T_INTLIT:
-        case T_INT_TYPE:
-        case T_LEQ:
-        case T_LET:
-        case T_MINUS:
-        case T_MUT:
-        case T_NEQ:
-        case T_NULL:
-        case T_NUMBER:
-        case T_OPEN_ANG:
-        case T_OPEN_BRACE:
-        case T_OPEN_BRACKET:
-        case T_OPEN_PAREN:
-        case T_PERCENT:
-        case T_PIPE:
-        case T_PLUS:
-        case T_RETURN:
-        case T_S16_TYPE:
-        case T_S32_TYPE:
-        case T_S64_TYPE:
-        case T_S8_TYPE:
-        case T_SEMI_COLON:
-        case T_SLASH:
-        case T_STAR:
-        case T_STRING:
-        case T_STRUCT:
-        case T_STR_TYPE:
-        case T_THREE_DOTS:
-        case T_TILDE:
-        case T_TRUE:
-        case T_TYPE:
-        case T_U16_TYPE:
-        case T_U32_TYPE:
-        case T_U64_TYPE:
-        case T_U8_TYPE:
-        case T_UNKNOWN:
-        case T_VOID_TYPE:
-        case T_WHILE:
-            {
-                return lhs;
-            }
-    }
-
-    parser_advance(parser);
-    rhs = parser_parse_term(parser);
-    node = AST_new_binary_expr(operator, lhs, rhs);
-    node->token = starting_token;
-    return node;
-}
-
-t_ast_node *parser_parse_term(t_parser *parser)
-{
-    t_ast_node *lhs = NULL, *rhs = NULL, *node = NULL;
-    t_token *token = NULL, *starting_token = NULL;
-    t_ast_binop_type operator= BINOP_SUBTRACT;
-
-    starting_token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
-
-    lhs = parser_parse_factor(parser);
-    token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
-    switch (token->type)
-    {
-        case T_MINUS:
-            {
-                operator= BINOP_SUBTRACT;
-                break;
-            }
-        case T_PLUS:
-            {
-                operator= BINOP_ADD;
-                break;
-            }
-        case T_AMPERCENT:
-        case T_ANY_TYPE:
-        case T_AS:
-        case T_BANG:
-        case T_BOOL_TYPE:
-        case T_BREAK:
-        case T_BUILTIN:
-        case T_CARET:
-        case T_CHAR:
-        case T_CHAR_TYPE:
-        case T_CLOSE_ANG:
-        case T_CLOSE_BRACE:
-        case T_CLOSE_BRACKET:
-        case T_CLOSE_PAREN:
-        case T_COLON:
-        case T_COMMA:
-        case T_DEFER:
-        case T_DOT:
-        case T_DOUBLE_COLON:
-        case T_DOUBLE_TYPE:
-        case T_ELSE:
-        case T_ENUM:
-        case T_EOF:
-        case T_EQEQ:
-        case T_EQUALS:
-        case T_EXTERN:
-        case T_F32_TYPE:
-        case T_F64_TYPE:
-        case T_FALSE:
-        case T_FLOAT_TYPE:
-        case T_FN:
-        case T_GEQ:
-        case T_IDENTIFIER:
-        case T_IF:
-        case T_IMPORT:
-        case T_INTLIT:
-        case T_INT_TYPE:
-        case T_LEQ:
-        case T_LET:
-        case T_MUT:
-        case T_NEQ:
-        case T_NULL:
-        case T_NUMBER:
-        case T_OPEN_ANG:
-        case T_OPEN_BRACE:
-        case T_OPEN_BRACKET:
-        case T_OPEN_PAREN:
-        case T_PERCENT:
-        case T_PIPE:
-        case T_RETURN:
-        case T_S16_TYPE:
-        case T_S32_TYPE:
-        case T_S64_TYPE:
-        case T_S8_TYPE:
-        case T_SEMI_COLON:
-        case T_SHL:
-        case T_SHR:
-        case T_SLASH:
-        case T_STAR:
-        case T_STRING:
-        case T_STRUCT:
-        case T_STR_TYPE:
-        case T_THREE_DOTS:
-        case T_TILDE:
-        case T_TRUE:
-        case T_TYPE:
-        case T_U16_TYPE:
-        case T_U32_TYPE:
-        case T_U64_TYPE:
-        case T_U8_TYPE:
-        case T_UNKNOWN:
-        case T_VOID_TYPE:
-        case T_WHILE:
-            {
-                return lhs;
-            }
-    }
-
-    parser_advance(parser);
-    rhs = parser_parse_factor(parser);
-    node = AST_new_binary_expr(operator, lhs, rhs);
-    node->token = starting_token;
-    return node;
-}
-
-t_ast_node *parser_parse_factor(t_parser *parser)
-{
-    t_ast_node *lhs = NULL, *rhs = NULL, *node = NULL;
-    t_token *token = NULL, *starting_token = NULL;
-    t_ast_binop_type operator= BINOP_DIVIDE;
-
-    starting_token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
-
-    lhs = parser_parse_unary(parser);
-    token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
-    switch (token->type)
-    {
-        case T_SLASH:
-            {
-                operator= BINOP_DIVIDE;
-                break;
-            }
-        case T_STAR:
-            {
-                operator= BINOP_MULTIPLY;
-                break;
-            }
-        case T_PERCENT:
-            {
-                operator= BINOP_MODULOS;
-                break;
-            }
-        case T_AMPERCENT:
-        case T_ANY_TYPE:
-        case T_AS:
-        case T_BANG:
-        case T_BOOL_TYPE:
-        case T_BREAK:
-        case T_BUILTIN:
-        case T_CARET:
-        case T_CHAR:
-        case T_CHAR_TYPE:
-        case T_CLOSE_ANG:
-        case T_CLOSE_BRACE:
-        case T_CLOSE_BRACKET:
-        case T_CLOSE_PAREN:
-        case T_COLON:
-        case T_COMMA:
-        case T_DEFER:
-        case T_DOT:
-        case T_DOUBLE_COLON:
-        case T_DOUBLE_TYPE:
-        case T_ELSE:
-        case T_ENUM:
-        case T_EOF:
-        case T_EQEQ:
-        case T_EQUALS:
-        case T_EXTERN:
-        case T_F32_TYPE:
-        case T_F64_TYPE:
-        case T_FALSE:
-        case T_FLOAT_TYPE:
-        case T_FN:
-        case T_GEQ:
-        case T_IDENTIFIER:
-        case T_IF:
-        case T_IMPORT:
-        case T_INTLIT:
-        case T_INT_TYPE:
-        case T_LEQ:
-        case T_LET:
-        case T_MINUS:
-        case T_MUT:
-        case T_NEQ:
-        case T_NULL:
-        case T_NUMBER:
-        case T_OPEN_ANG:
-        case T_OPEN_BRACE:
-        case T_OPEN_BRACKET:
-        case T_OPEN_PAREN:
-        case T_PIPE:
-        case T_PLUS:
-        case T_RETURN:
-        case T_S16_TYPE:
-        case T_S32_TYPE:
-        case T_S64_TYPE:
-        case T_S8_TYPE:
-        case T_SEMI_COLON:
-        case T_SHL:
-        case T_SHR:
-        case T_STRING:
-        case T_STRUCT:
-        case T_STR_TYPE:
-        case T_THREE_DOTS:
-        case T_TILDE:
-        case T_TRUE:
-        case T_TYPE:
-        case T_U16_TYPE:
-        case T_U32_TYPE:
-        case T_U64_TYPE:
-        case T_U8_TYPE:
-        case T_UNKNOWN:
-        case T_VOID_TYPE:
-        case T_WHILE:
-            {
-                return lhs;
-            }
-    }
-
-    parser_advance(parser);
-    rhs = parser_parse_unary(parser);
-    node = AST_new_binary_expr(operator, lhs, rhs);
-    node->token = starting_token;
-    return node;
-}
-
-t_ast_node *parser_parse_unary(t_parser *parser)
-{
-    t_ast_node *unary = NULL, *node = NULL;
-    t_token *token = NULL, *starting_token = NULL;
-    bool mutable = false;
-
-    starting_token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
-    token = starting_token;
-
-    switch (token->type)
-    {
-        case T_BANG:
-            {
-                parser_advance(parser);
-                unary = parser_parse_unary(parser);
-                node = AST_new_unary_expr(UNOP_NOT, unary, false);
-                break;
-            }
-        case T_MINUS:
-            {
-                parser_advance(parser);
-                unary = parser_parse_unary(parser);
-                node = AST_new_unary_expr(UNOP_MINUS, unary, false);
+                parser_advance(parser);
+                unary = parser_parse_unary(parser);
+                node = AST_new_unary_expr(UNOP_MINUS, unary, false);
                 break;
             }
         case T_AMPERCENT:
@@ -1882,29 +1899,39 @@ t_ast_node *parser_parse_unary(t_parser *parser)
         case T_CLOSE_PAREN:
         case T_COLON:
         case T_COMMA:
+        case T_CONTINUE:
         case T_DEFER:
         case T_DOT:
+        case T_DOUBLE_AMPERCENT:
         case T_DOUBLE_COLON:
+        case T_DOUBLE_DOT:
+        case T_DOUBLE_PIPE:
         case T_DOUBLE_TYPE:
         case T_ELSE:
         case T_ENUM:
         case T_EOF:
         case T_EQEQ:
         case T_EQUALS:
+        case T_EXPORT:
         case T_EXTERN:
         case T_F32_TYPE:
         case T_F64_TYPE:
         case T_FALSE:
+        case T_FAT_ARROW:
         case T_FLOAT_TYPE:
         case T_FN:
+        case T_FOR:
         case T_GEQ:
         case T_IDENTIFIER:
         case T_IF:
         case T_IMPORT:
+        case T_IN:
         case T_INTLIT:
         case T_INT_TYPE:
         case T_LEQ:
         case T_LET:
+        case T_MATCH:
+        case T_MINUS_PERCENT:
         case T_MUT:
         case T_NEQ:
         case T_NULL:
@@ -1916,6 +1943,8 @@ t_ast_node *parser_parse_unary(t_parser *parser)
         case T_PERCENT:
         case T_PIPE:
         case T_PLUS:
+        case T_PLUS_PERCENT:
+        case T_RESTRICT:
         case T_RETURN:
         case T_S16_TYPE:
         case T_S32_TYPE:
@@ -1925,6 +1954,7 @@ t_ast_node *parser_parse_unary(t_parser *parser)
         case T_SHL:
         case T_SHR:
         case T_SLASH:
+        case T_STAR_PERCENT:
         case T_STRING:
         case T_STRUCT:
         case T_STR_TYPE:
@@ -1970,24 +2000,24 @@ t_ast_node *parser_parse_primary(t_parser *parser)
             }
         case T_NUMBER:
             {
-                type = TYPE_initialize_type(TYPE_SINT32);
                 if (TYPE_is_floating_point(token->content))
                 {
                     if ('f' == token->content[strlen(token->content) - 1])
                     {
-                        type->type = TYPE_F32;
+                        type = TYPE_make_type(TYPE_F32, NULL, NULL, false);
                         f32 = strtof(token->content, NULL);
                         n = AST_new_number(type, &f32);
                     }
                     else
                     {
-                        type->type = TYPE_F64;
+                        type = TYPE_make_type(TYPE_F64, NULL, NULL, false);
                         f64 = strtod(token->content, NULL);
                         n = AST_new_number(type, &f64);
                     }
                 }
                 else
                 {
+                    type = TYPE_make_type(TYPE_SINT32, NULL, NULL, false);
                     s32 = (int32_t) strtol(token->content, NULL, 10);
                     n = AST_new_number(type, &s32);
                 }
@@ -1996,7 +2026,7 @@ t_ast_node *parser_parse_primary(t_parser *parser)
             }
         case T_CHAR:
             {
-                type = TYPE_initialize_type(TYPE_UINT8);
+                type = TYPE_make_type(TYPE_UINT8, NULL, NULL, false);
                 u8 = (uint8_t) token->content[0];
                 n = AST_new_number(type, &u8);
                 parser_advance(parser);
@@ -2084,23 +2114,33 @@ t_ast_node *parser_parse_primary(t_parser *parser)
         case T_CLOSE_PAREN:
         case T_COLON:
         case T_COMMA:
+        case T_CONTINUE:
         case T_DEFER:
         case T_DOT:
+        case T_DOUBLE_AMPERCENT:
         case T_DOUBLE_COLON:
+        case T_DOUBLE_DOT:
+        case T_DOUBLE_PIPE:
         case T_ELSE:
         case T_ENUM:
         case T_EOF:
         case T_EQEQ:
         case T_EQUALS:
+        case T_EXPORT:
         case T_EXTERN:
+        case T_FAT_ARROW:
         case T_FN:
+        case T_FOR:
         case T_GEQ:
         case T_IF:
         case T_IMPORT:
+        case T_IN:
         case T_INTLIT:
         case T_LEQ:
         case T_LET:
+        case T_MATCH:
         case T_MINUS:
+        case T_MINUS_PERCENT:
         case T_MUT:
         case T_NEQ:
         case T_OPEN_ANG:
@@ -2108,12 +2148,15 @@ t_ast_node *parser_parse_primary(t_parser *parser)
         case T_PERCENT:
         case T_PIPE:
         case T_PLUS:
+        case T_PLUS_PERCENT:
+        case T_RESTRICT:
         case T_RETURN:
         case T_SEMI_COLON:
         case T_SHL:
         case T_SHR:
         case T_SLASH:
         case T_STAR:
+        case T_STAR_PERCENT:
         case T_STRUCT:
         case T_THREE_DOTS:
         case T_TILDE:
@@ -2183,9 +2226,21 @@ t_ast_node *parser_parse_expression(t_parser *parser)
     t_vector *then_body = NULL, *else_body = NULL, *body = NULL;
     t_token *token = NULL, *starting_token = NULL;
     t_type *type = NULL;
+    char *label = NULL;
+    t_loop_hints hints;
+    size_t hints_index = parser->index;
 
+    starting_token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
+
+    hints = parser_parse_loop_hints(parser);
+    label = parser_parse_loop_label(parser);
     token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
-    starting_token = token;
+    if ((hints_index != parser->index) && (T_WHILE != token->type)
+        && (T_FOR != token->type))
+    {
+        --parser->index;
+        parser_err(parser, "Expected a `while` or `for` loop after loop hints.");
+    }
 
     switch (token->type)
     {
@@ -2241,7 +2296,17 @@ t_ast_node *parser_parse_expression(t_parser *parser)
                     "Expected `)` after condition in while expression.");
                 --parser->index;
                 body = parser_parse_statements(parser);
-                node = AST_new_while_expr(cond, body);
+                node = AST_new_while_expr(cond, body, label, hints);
+                break;
+            }
+        case T_FOR:
+            {
+                node = parser_parse_for_expr(parser, label, hints);
+                break;
+            }
+        case T_MATCH:
+            {
+                node = parser_parse_match_expr(parser);
                 break;
             }
         case T_AMPERCENT:
@@ -2260,29 +2325,37 @@ t_ast_node *parser_parse_expression(t_parser *parser)
         case T_CLOSE_PAREN:
         case T_COLON:
         case T_COMMA:
+        case T_CONTINUE:
         case T_DEFER:
         case T_DOT:
+        case T_DOUBLE_AMPERCENT:
         case T_DOUBLE_COLON:
+        case T_DOUBLE_DOT:
+        case T_DOUBLE_PIPE:
         case T_DOUBLE_TYPE:
         case T_ELSE:
         case T_ENUM:
         case T_EOF:
         case T_EQEQ:
         case T_EQUALS:
+        case T_EXPORT:
         case T_EXTERN:
         case T_F32_TYPE:
         case T_F64_TYPE:
         case T_FALSE:
+        case T_FAT_ARROW:
         case T_FLOAT_TYPE:
         case T_FN:
         case T_GEQ:
         case T_IDENTIFIER:
         case T_IMPORT:
+        case T_IN:
         case T_INTLIT:
         case T_INT_TYPE:
         case T_LEQ:
         case T_LET:
         case T_MINUS:
+        case T_MINUS_PERCENT:
         case T_MUT:
         case T_NEQ:
         case T_NULL:
@@ -2294,6 +2367,8 @@ t_ast_node *parser_parse_expression(t_parser *parser)
         case T_PERCENT:
         case T_PIPE:
         case T_PLUS:
+        case T_PLUS_PERCENT:
+        case T_RESTRICT:
         case T_RETURN:
         case T_S16_TYPE:
         case T_S32_TYPE:
@@ -2304,6 +2379,7 @@ t_ast_node *parser_parse_expression(t_parser *parser)
         case T_SHR:
         case T_SLASH:
         case T_STAR:
+        case T_STAR_PERCENT:
         case T_STRING:
         case T_STRUCT:
         case T_STR_TYPE:
@@ -2318,20 +2394,386 @@ t_ast_node *parser_parse_expression(t_parser *parser)
         case T_UNKNOWN:
         case T_VOID_TYPE:
             {
-                node = parser_parse_assignment(parser);
-                break;
+                node = parser_parse_assignment(parser);
+                break;
+            }
+    }
+
+    if (parser_match(parser, T_AS))
+    {
+        type = parser_parse_type(parser, false);
+        parser_advance(parser);
+        node = AST_new_cast_expr(node, type);
+    }
+
+    node->token = starting_token;
+    return node;
+}
+
+char *parser_parse_loop_label(t_parser *parser)
+{
+    t_token *token = NULL;
+
+    if (!parser_match(parser, T_IDENTIFIER) || !parser_expect(parser, T_COLON)
+        || (parser->index + 2 >= parser->tokens->size))
+    {
+        return NULL;
+    }
+
+    token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index + 2);
+    if ((T_WHILE != token->type) && (T_FOR != token->type))
+    {
+        return NULL;
+    }
+
+    token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
+    parser->index += 2;
+    return strdup(token->content);
+}
+
+char *parser_parse_jump_label(t_parser *parser)
+{
+    t_token *token = NULL;
+    char *label = NULL;
+
+    if (parser_expect(parser, T_IDENTIFIER))
+    {
+        parser_advance(parser);
+        token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
+        label = strdup(token->content);
+    }
+
+    parser_expect_advance(parser, T_SEMI_COLON,
+                          "Expected a ';' at the end of a break or continue "
+                          "statement");
+    parser_advance(parser);
+    return label;
+}
+
+t_ast_node *parser_parse_for_expr(t_parser *parser, char *label,
+                                  t_loop_hints hints)
+{
+    t_ast_node *var = NULL, *start = NULL, *end = NULL, *step = NULL;
+    t_token *token = NULL;
+    t_type *type = NULL;
+    t_vector *body = NULL;
+    bool no_struct_value = parser->no_struct_value;
+
+    parser_expect_advance(parser, T_IDENTIFIER,
+                          "Expected an identifier after `for` keyword.");
+    token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
+    if (parser_expect(parser, T_COLON))
+    {
+        type = parser_parse_type(parser, true);
+    }
+    else
+    {
+        type = TYPE_make_type(TYPE_ANY, NULL, NULL, false);
+    }
+    var = AST_new_variable(strdup(token->content), type, false);
+    var->token = token;
+
+    parser_expect_advance(parser, T_IN,
+                          "Expected `in` after the variable of a for loop.");
+    parser_advance(parser);
+
+    /* The body follows the range, so `end {` is not a struct value */
+    parser->no_struct_value = true;
+    start = parser_parse_binary(parser, 1);
+    parser_match_advance(parser, T_DOUBLE_DOT,
+                         "Expected `..` between the bounds of a range.");
+    end = parser_parse_binary(parser, 1);
+
+    token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
+    if ((T_IDENTIFIER == token->type) && (0 == strcmp("step", token->content)))
+    {
+        parser_advance(parser);
+        step = parser_parse_binary(parser, 1);
+    }
+    parser->no_struct_value = no_struct_value;
+
+    --parser->index;
+    body = parser_parse_statements(parser);
+    return AST_new_for_expr(var, start, end, step, body, label, hints);
+}
+
+t_ast_node *parser_parse_match_expr(t_parser *parser)
+{
+    t_ast_node *value = NULL, *pattern = NULL;
+    t_ast_match_arm *arm = NULL;
+    t_vector *arms = NULL, *else_body = NULL;
+
+    parser_advance(parser);
+    parser_match_advance(parser, T_OPEN_PAREN,
+                         "Expected `(` after `match` keyword.");
+    value = parser_parse_expression(parser);
+    parser_match_advance(parser, T_CLOSE_PAREN,
+                         "Expected `)` after the value of a match expression.");
+    if (!parser_match(parser, T_OPEN_BRACE))
+    {
+        --parser->index;
+        parser_err(parser, "Expected `{` to open the arms of a match "
+                           "expression.");
+    }
+
+    arms = calloc(1, sizeof(t_vector));
+    if (NULL == arms)
+    {
+        (void) LOGGER_log(parser->logger, L_ERROR,
+                          "Couldn't allocate memory for match arms.\n");
+        exit(LUKA_CANT_ALLOC_MEMORY);
+    }
+    (void) vector_setup(arms, 4, sizeof(t_ast_match_arm_ptr));
+
+    while (!parser_expect(parser, T_CLOSE_BRACE))
+    {
+        parser_advance(parser);
+        if (NULL != else_body)
+        {
+            --parser->index;
+            parser_err(parser, "The `else` arm must be the last arm of a "
+                               "match expression.");
+        }
+
+        if (parser_match(parser, T_ELSE))
+        {
+            parser_expect_advance(parser, T_FAT_ARROW,
+                                  "Expected `=>` after `else` in a match "
+                                  "expression.");
+            else_body = parser_parse_statements(parser);
+            continue;
+        }
+
+        arm = calloc(1, sizeof(t_ast_match_arm));
+        if (NULL == arm)
+        {
+            (void) LOGGER_log(parser->logger, L_ERROR,
+                              "Couldn't allocate memory for a match arm.\n");
+            exit(LUKA_CANT_ALLOC_MEMORY);
+        }
+        arm->patterns = calloc(1, sizeof(t_vector));
+        if (NULL == arm->patterns)
+        {
+            (void) LOGGER_log(parser->logger, L_ERROR,
+                              "Couldn't allocate memory for match "
+                              "patterns.\n");
+            exit(LUKA_CANT_ALLOC_MEMORY);
+        }
+        (void) vector_setup(arm->patterns, 1, sizeof(t_ast_node_ptr));
+
+        pattern = parser_parse_binary(parser, 1);
+        (void) vector_push_back(arm->patterns, &pattern);
+        while (parser_match(parser, T_COMMA))
+        {
+            parser_advance(parser);
+            pattern = parser_parse_binary(parser, 1);
+            (void) vector_push_back(arm->patterns, &pattern);
+        }
+
+        if (!parser_match(parser, T_FAT_ARROW))
+        {
+            --parser->index;
+            parser_err(parser, "Expected `=>` after the patterns of a match "
+                               "arm.");
+        }
+        arm->body = parser_parse_statements(parser);
+        (void) vector_push_back(arms, &arm);
+    }
+
+    parser_advance(parser);
+    return AST_new_match_expr(value, arms, else_body);
+}
+
+t_loop_hints parser_parse_loop_hints(t_parser *parser)
+{
+    t_loop_hints hints;
+    t_token *token = NULL;
+
+    (void) memset(&hints, 0, sizeof(hints));
+    token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
+    while (T_BUILTIN == token->type)
+    {
+        if (0 == strcmp("@unroll", token->content))
+        {
+            if (parser_expect(parser, T_OPEN_PAREN))
+            {
+                parser_advance(parser);
+                hints.unroll_count = parser_parse_loop_hint_argument(parser);
+                parser_expect_advance(parser, T_CLOSE_PAREN,
+                                      "Expected `)` after the unroll count.");
+            }
+            else
+            {
+                hints.unroll_full = true;
+            }
+        }
+        else if (0 == strcmp("@vectorize", token->content))
+        {
+            hints.vectorize = true;
+            if (parser_expect(parser, T_OPEN_PAREN))
+            {
+                parser_advance(parser);
+                while (true)
+                {
+                    parser_expect_advance(
+                        parser, T_IDENTIFIER,
+                        "Expected `width` or `interleave` in a vectorize "
+                        "hint.");
+                    token = VECTOR_GET_AS(t_token_ptr, parser->tokens,
+                                          parser->index);
+                    if (0 == strcmp("width", token->content))
+                    {
+                        parser_expect_advance(parser, T_COLON,
+                                              "Expected `:` after `width`.");
+                        hints.vectorize_width
+                            = parser_parse_loop_hint_argument(parser);
+                    }
+                    else if (0 == strcmp("interleave", token->content))
+                    {
+                        parser_expect_advance(
+                            parser, T_COLON, "Expected `:` after `interleave`.");
+                        hints.interleave_count
+                            = parser_parse_loop_hint_argument(parser);
+                    }
+                    else
+                    {
+                        --parser->index;
+                        parser_err(parser, "Expected `width` or `interleave` "
+                                           "in a vectorize hint.");
+                    }
+
+                    if (!parser_expect(parser, T_COMMA))
+                    {
+                        break;
+                    }
+                    parser_advance(parser);
+                }
+                parser_expect_advance(
+                    parser, T_CLOSE_PAREN,
+                    "Expected `)` after the options of a vectorize hint.");
             }
+        }
+        else if (0 == strcmp("@no_vectorize", token->content))
+        {
+            hints.no_vectorize = true;
+        }
+        else if (0 == strcmp("@parallel_access", token->content))
+        {
+            hints.parallel_access = true;
+        }
+        else
+        {
+            break;
+        }
+
+        parser_advance(parser);
+        token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
     }
 
-    if (parser_match(parser, T_AS))
+    if (hints.vectorize && hints.no_vectorize)
     {
-        type = parser_parse_type(parser, false);
+        --parser->index;
+        parser_err(parser,
+                   "A loop can't have both `@vectorize` and `@no_vectorize`.");
+    }
+
+    return hints;
+}
+
+unsigned int parser_parse_loop_hint_argument(t_parser *parser)
+{
+    t_token *token = NULL;
+    char *end = NULL;
+    unsigned long value = 0;
+
+    parser_expect_advance(parser, T_NUMBER,
+                          "Expected a positive integer in a loop hint.");
+    token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
+    value = strtoul(token->content, &end, 10);
+    if (('\0' != *end) || (0 == value) || (UINT_MAX < value))
+    {
+        --parser->index;
+        parser_err(parser, "Expected a positive integer in a loop hint.");
+    }
+
+    return (unsigned int) value;
+}
+
+t_function_attributes parser_parse_function_attributes(t_parser *parser)
+{
+    t_function_attributes attributes;
+    t_token *token = NULL;
+
+    (void) memset(&attributes, 0, sizeof(attributes));
+    token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
+    while (T_BUILTIN == token->type)
+    {
+        if (0 == strcmp("@inline", token->content))
+        {
+            attributes.always_inline = true;
+        }
+        else if (0 == strcmp("@noinline", token->content))
+        {
+            attributes.no_inline = true;
+        }
+        else if (0 == strcmp("@hot", token->content))
+        {
+            attributes.hot = true;
+        }
+        else if (0 == strcmp("@cold", token->content))
+        {
+            attributes.cold = true;
+        }
+        else if (0 == strcmp("@pure", token->content))
+        {
+            attributes.pure = true;
+        }
+        else if (0 == strcmp("@const", token->content))
+        {
+            attributes.constant = true;
+        }
+        else if (0 == strcmp("@noreturn", token->content))
+        {
+            attributes.no_return = true;
+        }
+        else if (0 == strcmp("@nounwind", token->content))
+        {
+            attributes.no_unwind = true;
+        }
+        else if (0 == strcmp("@fast_math", token->content))
+        {
+            attributes.fast_math = true;
+        }
+        else
+        {
+            --parser->index;
+            parser_err(parser, "Unknown function attribute.");
+        }
+
         parser_advance(parser);
-        node = AST_new_cast_expr(node, type);
+        token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
     }
 
-    node->token = starting_token;
-    return node;
+    if (attributes.always_inline && attributes.no_inline)
+    {
+        --parser->index;
+        parser_err(parser,
+                   "A function can't have both `@inline` and `@noinline`.");
+    }
+
+    if (attributes.hot && attributes.cold)
+    {
+        --parser->index;
+        parser_err(parser, "A function can't have both `@hot` and `@cold`.");
+    }
+
+    if (attributes.pure && attributes.constant)
+    {
+        --parser->index;
+        parser_err(parser, "A function can't have both `@pure` and `@const`.");
+    }
+
+    return attributes;
 }
 
 t_ast_node *parser_parse_assignment(t_parser *parser)
@@ -2340,7 +2782,7 @@ t_ast_node *parser_parse_assignment(t_parser *parser)
     t_token *starting_token = NULL;
 
     starting_token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
-    lhs = parser_parse_bor(parser);
+    lhs = parser_parse_binary(parser, 1);
 
     if (parser_match(parser, T_EQUALS))
     {
@@ -2365,64 +2807,29 @@ t_ast_node *parser_parse_assignment(t_parser *parser)
     return lhs;
 }
 
-t_ast_node *parser_parse_bor(t_parser *parser)
-{
-    t_ast_node *lhs = NULL, *rhs = NULL, *node = NULL;
-    t_token *starting_token = NULL;
-
-    starting_token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
-    lhs = parser_parse_bxor(parser);
-
-    if (!parser_match(parser, T_PIPE))
-    {
-        return lhs;
-    }
-
-    parser_advance(parser);
-    rhs = parser_parse_bxor(parser);
-    node = AST_new_binary_expr(BINOP_BOR, lhs, rhs);
-    node->token = starting_token;
-    return node;
-}
-
-t_ast_node *parser_parse_bxor(t_parser *parser)
+t_ast_node *parser_parse_binary(t_parser *parser, int min_precedence)
 {
-    t_ast_node *lhs = NULL, *rhs = NULL, *node = NULL;
-    t_token *starting_token = NULL;
+    t_ast_node *lhs = NULL, *rhs = NULL;
+    t_token *token = NULL, *starting_token = NULL;
+    const t_parser_binary_operator *binary_operator = NULL;
 
     starting_token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
-    lhs = parser_parse_band(parser);
+    lhs = parser_parse_unary(parser);
 
-    if (!parser_match(parser, T_CARET))
+    while (true)
     {
-        return lhs;
-    }
-
-    parser_advance(parser);
-    rhs = parser_parse_band(parser);
-    node = AST_new_binary_expr(BINOP_BXOR, lhs, rhs);
-    node->token = starting_token;
-    return node;
-}
-
-t_ast_node *parser_parse_band(t_parser *parser)
-{
-    t_ast_node *lhs = NULL, *rhs = NULL, *node = NULL;
-    t_token *starting_token = NULL;
-
-    starting_token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
-    lhs = parser_parse_equality(parser);
+        token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
+        binary_operator = &binary_operators[token->type];
+        if (binary_operator->precedence < min_precedence)
+        {
+            return lhs;
+        }
 
-    if (!parser_match(parser, T_AMPERCENT))
-    {
-        return lhs;
+        parser_advance(parser);
+        rhs = parser_parse_binary(parser, binary_operator->precedence + 1);
+        lhs = AST_new_binary_expr(binary_operator->operator, lhs, rhs);
+        lhs->token = starting_token;
     }
-
-    parser_advance(parser);
-    rhs = parser_parse_equality(parser);
-    node = AST_new_binary_expr(BINOP_BAND, lhs, rhs);
-    node->token = starting_token;
-    return node;
 }
 
 static t_ast_node *parser_parse_let_statement(t_parser *parser, bool is_global)
@@ -2448,7 +2855,7 @@ static t_ast_node *parser_parse_let_statement(t_parser *parser, bool is_global)
     }
     else
     {
-        type = TYPE_initialize_type(TYPE_ANY);
+        type = TYPE_make_type(TYPE_ANY, NULL, NULL, false);
     }
     parser_expect_advance(parser, T_EQUALS,
                           "Expected a '=' after ident in variable declaration");
@@ -2456,7 +2863,7 @@ static t_ast_node *parser_parse_let_statement(t_parser *parser, bool is_global)
     expr = parser_parse_expression(parser);
     if (NULL != type)
     {
-        type->mutable = mutable;
+        type = TYPE_with_mutable(type, mutable);
     }
 
     var = AST_new_variable(strdup(token->content), type, mutable);
@@ -2505,10 +2912,13 @@ static t_ast_node *parser_parse_statement(t_parser *parser)
             }
         case T_BREAK:
             {
-                parser_expect_advance(parser, T_SEMI_COLON,
-                                      "Expected a ';' after 'break'");
-                parser_advance(parser);
-                node = AST_new_break_stmt();
+                node = AST_new_break_stmt(parser_parse_jump_label(parser));
+                node->token = starting_token;
+                return node;
+            }
+        case T_CONTINUE:
+            {
+                node = AST_new_continue_stmt(parser_parse_jump_label(parser));
                 node->token = starting_token;
                 return node;
             }
@@ -2584,26 +2994,35 @@ static t_ast_node *parser_parse_statement(t_parser *parser)
         case T_COLON:
         case T_COMMA:
         case T_DOT:
+        case T_DOUBLE_AMPERCENT:
         case T_DOUBLE_COLON:
+        case T_DOUBLE_DOT:
+        case T_DOUBLE_PIPE:
         case T_DOUBLE_TYPE:
         case T_ELSE:
         case T_EOF:
         case T_EQEQ:
         case T_EQUALS:
+        case T_EXPORT:
         case T_EXTERN:
         case T_F32_TYPE:
         case T_F64_TYPE:
         case T_FALSE:
+        case T_FAT_ARROW:
         case T_FLOAT_TYPE:
         case T_FN:
+        case T_FOR:
         case T_GEQ:
         case T_IDENTIFIER:
         case T_IF:
         case T_IMPORT:
+        case T_IN:
         case T_INTLIT:
         case T_INT_TYPE:
         case T_LEQ:
+        case T_MATCH:
         case T_MINUS:
+        case T_MINUS_PERCENT:
         case T_MUT:
         case T_NEQ:
         case T_NULL:
@@ -2615,6 +3034,8 @@ static t_ast_node *parser_parse_statement(t_parser *parser)
         case T_PERCENT:
         case T_PIPE:
         case T_PLUS:
+        case T_PLUS_PERCENT:
+        case T_RESTRICT:
         case T_S16_TYPE:
         case T_S32_TYPE:
         case T_S64_TYPE:
@@ -2624,6 +3045,7 @@ static t_ast_node *parser_parse_statement(t_parser *parser)
         case T_SHR:
         case T_SLASH:
         case T_STAR:
+        case T_STAR_PERCENT:
         case T_STRING:
         case T_STR_TYPE:
         case T_THREE_DOTS:
@@ -2714,6 +3136,7 @@ t_ast_node *parser_parse_prototype(t_parser *parser)
     unsigned int arity = 0;
     size_t allocated = 6;
     bool vararg = false;
+    bool *restricted = NULL, *new_restricted = NULL;
 
     t_token *token = NULL, *starting_token = NULL;
     t_ast_node *node = NULL;
@@ -2756,21 +3179,29 @@ t_ast_node *parser_parse_prototype(t_parser *parser)
                           "Couldn't allocate memory for types.\n");
         goto l_cleanup;
     }
+    restricted = calloc(allocated, sizeof(bool));
+    if (NULL == restricted)
+    {
+        (void) LOGGER_log(
+            parser->logger, L_ERROR,
+            "Couldn't allocate memory for restrict qualifiers.\n");
+        goto l_cleanup;
+    }
 
     if (T_THREE_DOTS == token->type)
     {
         types[0] = parser_parse_type(parser, true);
         if (TYPE_ANY != types[0]->type)
         {
-            types[0]->type = TYPE_ANY;
-            types[0]->inner_type = NULL;
-            types[0]->payload = NULL;
+            types[0] = TYPE_make_type(TYPE_ANY, NULL, NULL,
+                                      types[0]->mutable);
         }
         vararg = true;
     }
     else
     {
-        types[0] = parser_parse_type(parser, true);
+        restricted[0] = parser_parse_restrict(parser);
+        types[0] = parser_parse_type(parser, !restricted[0]);
     }
     args[0] = strdup(token->content);
     arity = 1;
@@ -2811,31 +3242,34 @@ t_ast_node *parser_parse_prototype(t_parser *parser)
                 goto l_cleanup;
             }
             types = new_types;
+
+            new_restricted = realloc(restricted, sizeof(bool) * allocated);
+            if (NULL == new_restricted)
+            {
+                (void) LOGGER_log(
+                    parser->logger, L_ERROR,
+                    "Couldn't allocate memory for restrict qualifiers.\n");
+                goto l_cleanup;
+            }
+            restricted = new_restricted;
         }
 
+        restricted[arity - 1] = false;
         if (T_THREE_DOTS == token->type)
         {
             types[arity - 1] = parser_parse_type(parser, true);
             if (TYPE_ANY != types[arity - 1]->type)
             {
-                types[arity - 1]->type = TYPE_ANY;
-                if (NULL != types[arity - 1]->inner_type)
-                {
-                    (void) TYPE_free_type(types[arity - 1]->inner_type);
-                }
-                types[arity - 1]->inner_type = NULL;
-
-                if (NULL != types[arity - 1]->payload)
-                {
-                    (void) free(types[arity - 1]->payload);
-                }
-                types[arity - 1]->payload = NULL;
+                types[arity - 1] = TYPE_make_type(
+                    TYPE_ANY, NULL, NULL, types[arity - 1]->mutable);
             }
             vararg = true;
         }
         else
         {
-            types[arity - 1] = parser_parse_type(parser, true);
+            restricted[arity - 1] = parser_parse_restrict(parser);
+            types[arity - 1]
+                = parser_parse_type(parser, !restricted[arity - 1]);
         }
         args[arity - 1] = strdup(token->content);
     }
@@ -2863,9 +3297,20 @@ t_ast_node *parser_parse_prototype(t_parser *parser)
             goto l_cleanup;
         }
         types = new_types;
+
+        new_restricted = realloc(restricted, sizeof(bool) * arity);
+        if (NULL == new_restricted)
+        {
+            (void) LOGGER_log(
+                parser->logger, L_ERROR,
+                "Couldn't allocate memory for restrict qualifiers.\n");
+            goto l_cleanup;
+        }
+        restricted = new_restricted;
     }
 
     node = AST_new_prototype(name, args, types, arity, return_type, vararg);
+    node->prototype.restricted = restricted;
     node->token = starting_token;
     return node;
 
@@ -2886,21 +3331,39 @@ l_cleanup:
 
     if (NULL != types)
     {
-        for (size_t i = 0; i < arity; ++i)
-        {
-            if (NULL != types[i])
-            {
-                (void) TYPE_free_type(types[i]);
-                types[i] = NULL;
-            }
-        }
         (void) free(types);
         types = NULL;
     }
 
+    if (NULL != restricted)
+    {
+        (void) free(restricted);
+        restricted = NULL;
+    }
+
     exit(LUKA_PARSER_FAILED);
 }
 
+bool parser_parse_restrict(t_parser *parser)
+{
+    t_token *token = NULL;
+
+    if (!parser_expect(parser, T_COLON)
+        || (parser->index + 2 >= parser->tokens->size))
+    {
+        return false;
+    }
+
+    token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index + 2);
+    if (T_RESTRICT != token->type)
+    {
+        return false;
+    }
+
+    parser->index += 2;
+    return true;
+}
+
 t_ast_node *parser_parse_struct_definition(t_parser *parser)
 {
     t_ast_node *node = NULL;
@@ -2938,6 +3401,8 @@ t_vector *parser_parse_struct_functions(t_parser *parser)
     t_vector *functions = NULL;
     t_ast_node *function = NULL;
     t_token *token = NULL;
+    t_function_attributes attributes;
+    bool exported = false;
 
     functions = calloc(1, sizeof(t_vector));
     if (NULL == functions)
@@ -2955,11 +3420,22 @@ t_vector *parser_parse_struct_functions(t_parser *parser)
     {
         while (true)
         {
+            attributes = parser_parse_function_attributes(parser);
+            token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
+            exported = T_EXPORT == token->type;
+            if (exported)
+            {
+                parser_expect_advance(parser, T_FN,
+                                      "Expected 'fn' after 'export' keyword");
+            }
+
             function = parser_parse_function(parser);
             if (NULL == function)
             {
                 goto l_cleanup;
             }
+            function->function.exported = exported;
+            function->function.prototype->prototype.attributes = attributes;
             vector_push_back(functions, &function);
             parser_advance(parser);
 
@@ -3014,7 +3490,8 @@ t_vector *parser_parse_struct_fields(t_parser *parser)
         while (true)
         {
             token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
-            if (T_FN == token->type)
+            if ((T_FN == token->type) || (T_BUILTIN == token->type)
+                || (T_EXPORT == token->type))
             {
                 break;
             }
@@ -3027,7 +3504,8 @@ t_vector *parser_parse_struct_fields(t_parser *parser)
             vector_push_back(fields, &struct_field);
 
             token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
-            if ((T_CLOSE_BRACE == token->type) || (T_FN == token->type))
+            if ((T_CLOSE_BRACE == token->type) || (T_FN == token->type)
+                || (T_BUILTIN == token->type) || (T_EXPORT == token->type))
             {
                 break;
             }
@@ -3058,12 +3536,6 @@ l_cleanup:
                 (void) free(struct_field->name);
                 struct_field->name = NULL;
             }
-
-            if (NULL != struct_field->type)
-            {
-                (void) TYPE_free_type(struct_field->type);
-                struct_field->type = NULL;
-            }
             (void) free(struct_field);
             struct_field = NULL;
         }
@@ -3102,12 +3574,6 @@ l_cleanup:
             (void) free(struct_field->name);
             struct_field->name = NULL;
         }
-
-        if (NULL != struct_field->type)
-        {
-            (void) TYPE_free_type(struct_field->type);
-            struct_field->type = NULL;
-        }
         (void) free(struct_field);
         struct_field = NULL;
     }
@@ -3145,8 +3611,8 @@ t_vector *parser_parse_enum_fields(t_parser *parser)
 
             if (NULL == enum_field->expr)
             {
-                enum_field->expr
-                    = AST_new_number(TYPE_initialize_type(TYPE_SINT32), &value);
+                enum_field->expr = AST_new_number(
+                    TYPE_make_type(TYPE_SINT32, NULL, NULL, false), &value);
             }
             else
             {
@@ -3258,15 +3724,105 @@ l_cleanup:
     return NULL;
 }
 
+/**
+ * @brief Skip the body of a function by matching its braces, remembering where
+ * it starts so it can be parsed once it's needed.
+ *
+ * @param[in,out] parser the parser to parse with.
+ * @param[in] function the function AST node the body belongs to.
+ */
+static void parser_skip_function_body(t_parser *parser, t_ast_node *function)
+{
+    t_lazy_body *lazy_body = NULL;
+    t_token *token = NULL;
+    size_t depth = 1;
+
+    lazy_body = calloc(1, sizeof(t_lazy_body));
+    if (NULL == lazy_body)
+    {
+        (void) LOGGER_log(parser->logger, L_ERROR,
+                          "Couldn't allocate memory for lazy body.\n");
+        exit(LUKA_CANT_ALLOC_MEMORY);
+    }
+
+    lazy_body->function = function;
+    lazy_body->parser = parser;
+    lazy_body->index = parser->index;
+
+    parser_expect_advance(parser, T_OPEN_BRACE,
+                          "Expected '{' to open a body of statements");
+    while (0 < depth)
+    {
+        if (parser_expect(parser, T_EOF))
+        {
+            parser_err(parser, "Expected '}' to close a body of statements");
+        }
+
+        parser_advance(parser);
+        token = VECTOR_GET_AS(t_token_ptr, parser->tokens, parser->index);
+        if (T_OPEN_BRACE == token->type)
+        {
+            ++depth;
+        }
+        else if (T_CLOSE_BRACE == token->type)
+        {
+            --depth;
+        }
+    }
+
+    HASH_ADD_PTR(lazy_bodies, function, lazy_body);
+}
+
 t_ast_node *parser_parse_function(t_parser *parser)
 {
-    t_ast_node *prototype = NULL;
+    t_ast_node *prototype = NULL, *function = NULL;
     t_vector *body = NULL;
     prototype = parser_parse_prototype(parser);
+    if (parser->lazy)
+    {
+        function = AST_new_function(prototype, NULL);
+        (void) parser_skip_function_body(parser, function);
+        return function;
+    }
+
     body = parser_parse_statements(parser);
     return AST_new_function(prototype, body);
 }
 
+t_parser *PARSER_parse_lazy_body(t_ast_node *function)
+{
+    t_lazy_body *lazy_body = NULL;
+    t_parser *parser = NULL;
+    size_t index = 0;
+
+    HASH_FIND_PTR(lazy_bodies, &function, lazy_body);
+    if (NULL == lazy_body)
+    {
+        return NULL;
+    }
+
+    parser = lazy_body->parser;
+    index = parser->index;
+    parser->index = lazy_body->index;
+    function->function.body = parser_parse_statements(parser);
+    parser->index = index;
+
+    HASH_DEL(lazy_bodies, lazy_body);
+    (void) free(lazy_body);
+    return parser;
+}
+
+void PARSER_free_lazy_bodies(void)
+{
+    t_lazy_body *lazy_body = NULL, *tmp = NULL;
+
+    HASH_ITER(hh, lazy_bodies, lazy_body, tmp)
+    {
+        HASH_DEL(lazy_bodies, lazy_body);
+        (void) free(lazy_body);
+    }
+}
+
 void PARSER_print_parser_tokens(t_parser *parser)
 {
     t_token *token = NULL;
@@ -0,0 +1,569 @@
+/** @file reachability.c */
+#include "reachability.h"
+
+#include "ast.h"
+#include "lib.h"
+#include "parser.h"
+#include "type_checker.h"
+#include "utils.h"
+#include "uthash.h"
+#include "vector.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct
+{
+    char *name;           /**< The name of the symbol */
+    t_vector definitions; /**< The nodes that declare or define the symbol */
+    bool reachable;       /**< Whether the symbol is reachable */
+    bool struct_function; /**< Whether the symbol is a struct function */
+    UT_hash_handle hh;    /**< A handle for uthash */
+} t_reachability_symbol;  /**< A function or a global variable */
+
+typedef struct
+{
+    t_reachability_symbol *symbols; /**< The symbols of the program by name */
+    t_vector worklist; /**< Reachable symbols that weren't visited yet */
+    t_vector modules;  /**< Every module of the program */
+    t_logger *logger;  /**< A logger that can be used to log messages */
+} t_reachability;      /**< The state of the reachability analysis */
+
+/**
+ * @brief Write the name of the symbol a top level node declares.
+ *
+ * @param[out] buffer the buffer to write the name into.
+ * @param[in] buffer_length the length of @p buffer.
+ * @param[in] node a function or a let statement.
+ * @param[in] struct_name the name of the struct the function belongs to, or
+ * NULL.
+ *
+ * @return @p buffer.
+ */
+static char *reachability_symbol_name(char *buffer, size_t buffer_length,
+                                      const t_ast_node *node,
+                                      const char *struct_name)
+{
+    const char *name = (AST_TYPE_FUNCTION == node->type)
+                         ? node->function.prototype->prototype.name
+                         : node->let_stmt.var->variable.name;
+
+    if (NULL == struct_name)
+    {
+        (void) snprintf(buffer, buffer_length, "%s", name);
+    }
+    else
+    {
+        (void) snprintf(buffer, buffer_length, "%s.%s", struct_name, name);
+    }
+
+    return buffer;
+}
+
+/**
+ * @brief Mark the symbol called @p name as reachable, queueing its definitions
+ * to be visited if it wasn't reachable before.
+ *
+ * @param[in,out] reachability the state of the analysis.
+ * @param[in] name the name of the symbol, names that aren't symbols of the
+ * program (such as locals) are ignored.
+ */
+static void reachability_reach(t_reachability *reachability, const char *name)
+{
+    t_reachability_symbol *symbol = NULL;
+
+    if (NULL == name)
+    {
+        return;
+    }
+
+    HASH_FIND_STR(reachability->symbols, name, symbol);
+    if ((NULL == symbol) || symbol->reachable)
+    {
+        return;
+    }
+
+    symbol->reachable = true;
+    (void) vector_push_back(&reachability->worklist, &symbol);
+}
+
+/**
+ * @brief Add a declaration or a definition of a symbol of the program.
+ *
+ * @param[in,out] reachability the state of the analysis.
+ * @param[in] node a function or a let statement.
+ * @param[in] struct_name the name of the struct the function belongs to, or
+ * NULL.
+ */
+static void reachability_add_symbol(t_reachability *reachability,
+                                    t_ast_node *node, const char *struct_name)
+{
+    t_reachability_symbol *symbol = NULL;
+    char name[1024] = {0};
+
+    (void) reachability_symbol_name(name, sizeof(name), node, struct_name);
+    HASH_FIND_STR(reachability->symbols, name, symbol);
+    if (NULL == symbol)
+    {
+        symbol = calloc(1, sizeof(t_reachability_symbol));
+        if (NULL == symbol)
+        {
+            (void) LOGGER_log(reachability->logger, L_ERROR,
+                              "Couldn't allocate memory for symbol.\n");
+            exit(LUKA_CANT_ALLOC_MEMORY);
+        }
+
+        symbol->name = strdup(name);
+        symbol->struct_function = NULL != struct_name;
+        (void) vector_setup(&symbol->definitions, 1, sizeof(t_ast_node_ptr));
+        HASH_ADD_KEYPTR(hh, reachability->symbols, symbol->name,
+                        strlen(symbol->name), symbol);
+    }
+
+    (void) vector_push_back(&symbol->definitions, &node);
+
+    if ((AST_TYPE_FUNCTION == node->type) && node->function.exported)
+    {
+        (void) reachability_reach(reachability, name);
+    }
+}
+
+/**
+ * @brief Add the functions of a struct definition, named after the struct.
+ *
+ * @param[in,out] reachability the state of the analysis.
+ * @param[in] node the struct definition.
+ */
+static void reachability_add_struct_functions(t_reachability *reachability,
+                                              t_ast_node *node)
+{
+    t_ast_node *function = NULL;
+
+    if (NULL == node->struct_definition.struct_functions)
+    {
+        return;
+    }
+
+    VECTOR_FOR_EACH(node->struct_definition.struct_functions, functions)
+    {
+        function = ITERATOR_GET_AS(t_ast_node_ptr, &functions);
+        (void) reachability_add_symbol(reachability, function,
+                                       node->struct_definition.name);
+    }
+}
+
+/**
+ * @brief Add the symbols of @p module and of every module it imports.
+ *
+ * @param[in,out] reachability the state of the analysis.
+ * @param[in] module the module to add.
+ */
+static void reachability_add_module(t_reachability *reachability,
+                                    t_module *module)
+{
+    t_ast_node *node = NULL;
+    t_module *import = NULL;
+
+    if (LIB_module_in_list(&reachability->modules, module))
+    {
+        return;
+    }
+
+    (void) vector_push_back(&reachability->modules, &module);
+
+    VECTOR_FOR_EACH(module->functions, functions)
+    {
+        node = ITERATOR_GET_AS(t_ast_node_ptr, &functions);
+        (void) reachability_add_symbol(reachability, node, NULL);
+    }
+
+    VECTOR_FOR_EACH(module->variables, variables)
+    {
+        node = ITERATOR_GET_AS(t_ast_node_ptr, &variables);
+        (void) reachability_add_symbol(reachability, node, NULL);
+    }
+
+    VECTOR_FOR_EACH(module->structs, structs)
+    {
+        node = ITERATOR_GET_AS(t_ast_node_ptr, &structs);
+        (void) reachability_add_struct_functions(reachability, node);
+    }
+
+    VECTOR_FOR_EACH(module->imports, imports)
+    {
+        import = *(t_module **) iterator_get(&imports);
+        (void) reachability_add_module(reachability, import);
+    }
+}
+
+static void reachability_visit_node(t_reachability *reachability,
+                                    t_ast_node *node);
+
+/**
+ * @brief Visit every node in a vector of AST nodes.
+ *
+ * @param[in,out] reachability the state of the analysis.
+ * @param[in] nodes the nodes to visit, may be NULL.
+ */
+static void reachability_visit_nodes(t_reachability *reachability,
+                                     t_vector *nodes)
+{
+    t_ast_node *node = NULL;
+
+    if (NULL == nodes)
+    {
+        return;
+    }
+
+    VECTOR_FOR_EACH(nodes, iterator)
+    {
+        node = ITERATOR_GET_AS(t_ast_node_ptr, &iterator);
+        (void) reachability_visit_node(reachability, node);
+    }
+}
+
+/**
+ * @brief Mark every symbol that @p node references as reachable.
+ *
+ * @param[in,out] reachability the state of the analysis.
+ * @param[in] node the node to visit, may be NULL.
+ */
+static void reachability_visit_node(t_reachability *reachability,
+                                    t_ast_node *node)
+{
+    t_struct_value_field *struct_value = NULL;
+    t_ast_match_arm *arm = NULL;
+    char function_name[1024] = {0};
+
+    if (NULL == node)
+    {
+        return;
+    }
+
+    switch (node->type)
+    {
+        case AST_TYPE_BREAK_STMT:
+        case AST_TYPE_BUILTIN:
+        case AST_TYPE_CONTINUE_STMT:
+        case AST_TYPE_ENUM_DEFINITION:
+        case AST_TYPE_LITERAL:
+        case AST_TYPE_NUMBER:
+        case AST_TYPE_PROTOTYPE:
+        case AST_TYPE_STRING:
+        case AST_TYPE_TYPE_EXPR:
+            break;
+        case AST_TYPE_VARIABLE:
+            {
+                (void) reachability_reach(reachability, node->variable.name);
+                break;
+            }
+        case AST_TYPE_LET_STMT:
+            {
+                (void) reachability_visit_node(reachability,
+                                               node->let_stmt.expr);
+                break;
+            }
+        case AST_TYPE_EXPRESSION_STMT:
+            {
+                (void) reachability_visit_node(reachability,
+                                               node->expression_stmt.expr);
+                break;
+            }
+        case AST_TYPE_RETURN_STMT:
+            {
+                (void) reachability_visit_node(reachability,
+                                               node->return_stmt.expr);
+                break;
+            }
+        case AST_TYPE_DEFER_STMT:
+            {
+                (void) reachability_visit_nodes(reachability,
+                                                node->defer_stmt.body);
+                break;
+            }
+        case AST_TYPE_ASSIGNMENT_EXPR:
+            {
+                (void) reachability_visit_node(reachability,
+                                               node->assignment_expr.lhs);
+                (void) reachability_visit_node(reachability,
+                                               node->assignment_expr.rhs);
+                break;
+            }
+        case AST_TYPE_UNARY_EXPR:
+            {
+                (void) reachability_visit_node(reachability,
+                                               node->unary_expr.rhs);
+                break;
+            }
+        case AST_TYPE_BINARY_EXPR:
+            {
+                (void) reachability_visit_node(reachability,
+                                               node->binary_expr.lhs);
+                (void) reachability_visit_node(reachability,
+                                               node->binary_expr.rhs);
+                break;
+            }
+        case AST_TYPE_CAST_EXPR:
+            {
+                (void) reachability_visit_node(reachability,
+                                               node->cast_expr.expr);
+                break;
+            }
+        case AST_TYPE_GET_EXPR:
+            {
+                (void) reachability_visit_node(reachability,
+                                               node->get_expr.variable);
+                break;
+            }
+        case AST_TYPE_ARRAY_DEREF:
+            {
+                (void) reachability_visit_node(reachability,
+                                               node->array_deref.variable);
+                (void) reachability_visit_node(reachability,
+                                               node->array_deref.index);
+                break;
+            }
+        case AST_TYPE_ARRAY_LITERAL:
+            {
+                (void) reachability_visit_nodes(reachability,
+                                                node->array_literal.exprs);
+                break;
+            }
+        case AST_TYPE_STRUCT_VALUE:
+            {
+                if (NULL == node->struct_value.struct_values)
+                {
+                    break;
+                }
+
+                VECTOR_FOR_EACH(node->struct_value.struct_values, struct_values)
+                {
+                    struct_value = ITERATOR_GET_AS(t_struct_value_field_ptr,
+                                                   &struct_values);
+                    (void) reachability_visit_node(reachability,
+                                                   struct_value->expr);
+                }
+                break;
+            }
+        case AST_TYPE_CALL_EXPR:
+            {
+                if (AST_TYPE_BUILTIN != node->call_expr.callable->type)
+                {
+                    (void) UTILS_fill_function_name(
+                        function_name, sizeof(function_name), node, NULL, NULL,
+                        reachability->logger);
+                    (void) reachability_reach(reachability, function_name);
+                }
+
+                (void) reachability_visit_node(reachability,
+                                               node->call_expr.callable);
+                (void) reachability_visit_nodes(reachability,
+                                                node->call_expr.args);
+                break;
+            }
+        case AST_TYPE_IF_EXPR:
+            {
+                (void) reachability_visit_node(reachability,
+                                               node->if_expr.cond);
+                (void) reachability_visit_nodes(reachability,
+                                                node->if_expr.then_body);
+                (void) reachability_visit_nodes(reachability,
+                                                node->if_expr.else_body);
+                break;
+            }
+        case AST_TYPE_MATCH_EXPR:
+            {
+                (void) reachability_visit_node(reachability,
+                                               node->match_expr.value);
+                VECTOR_FOR_EACH(node->match_expr.arms, arms)
+                {
+                    arm = ITERATOR_GET_AS(t_ast_match_arm_ptr, &arms);
+                    (void) reachability_visit_nodes(reachability,
+                                                    arm->patterns);
+                    (void) reachability_visit_nodes(reachability, arm->body);
+                }
+                (void) reachability_visit_nodes(reachability,
+                                                node->match_expr.else_body);
+                break;
+            }
+        case AST_TYPE_WHILE_EXPR:
+            {
+                (void) reachability_visit_node(reachability,
+                                               node->while_expr.cond);
+                (void) reachability_visit_nodes(reachability,
+                                                node->while_expr.body);
+                break;
+            }
+        case AST_TYPE_FOR_EXPR:
+            {
+                (void) reachability_visit_node(reachability,
+                                               node->for_expr.start);
+                (void) reachability_visit_node(reachability,
+                                               node->for_expr.end);
+                (void) reachability_visit_node(reachability,
+                                               node->for_expr.step);
+                (void) reachability_visit_nodes(reachability,
+                                                node->for_expr.body);
+                break;
+            }
+        case AST_TYPE_FUNCTION:
+            {
+                (void) reachability_visit_nodes(reachability,
+                                                node->function.body);
+                break;
+            }
+        case AST_TYPE_STRUCT_DEFINITION:
+            {
+                /* Structs defined inside a function are generated with it,
+                 * together with all of their functions */
+                (void) reachability_visit_nodes(
+                    reachability, node->struct_definition.struct_functions);
+                break;
+            }
+    }
+}
+
+/**
+ * @brief Parse, analyze and type check the body of a reachable function if
+ * its parsing was deferred.
+ *
+ * @param[in] reachability the state of the analysis.
+ * @param[in] symbol the symbol the function defines.
+ * @param[in,out] node a definition of the symbol.
+ */
+static void reachability_parse_body(const t_reachability *reachability,
+                                    const t_reachability_symbol *symbol,
+                                    t_ast_node *node)
+{
+    t_parser *parser = NULL;
+
+    if (AST_TYPE_FUNCTION != node->type)
+    {
+        return;
+    }
+
+    parser = PARSER_parse_lazy_body(node);
+    if (NULL == parser)
+    {
+        return;
+    }
+
+    (void) AST_analyze(node, parser->module, parser->type_aliases,
+                       reachability->logger);
+
+    /* Like the rest of the frontend, only check the functions of a module and
+     * not the functions of its structs */
+    if (!symbol->struct_function
+        && !CHECK_function(parser->module, node, reachability->logger))
+    {
+        exit(LUKA_TYPE_CHECK_ERROR);
+    }
+}
+
+/**
+ * @brief Remove the unreachable nodes from a vector of top level nodes.
+ *
+ * @param[in] reachability the state of the analysis.
+ * @param[in,out] nodes the functions or let statements, may be NULL.
+ * @param[in] struct_name the name of the struct the functions belong to, or
+ * NULL.
+ */
+static void reachability_prune_nodes(const t_reachability *reachability,
+                                     t_vector *nodes, const char *struct_name)
+{
+    t_reachability_symbol *symbol = NULL;
+    t_ast_node *node = NULL;
+    char name[1024] = {0};
+    size_t i = 0;
+
+    if (NULL == nodes)
+    {
+        return;
+    }
+
+    for (i = nodes->size; i > 0; --i)
+    {
+        node = VECTOR_GET_AS(t_ast_node_ptr, nodes, i - 1);
+        (void) reachability_symbol_name(name, sizeof(name), node, struct_name);
+        HASH_FIND_STR(reachability->symbols, name, symbol);
+        if ((NULL != symbol) && symbol->reachable)
+        {
+            continue;
+        }
+
+        /* The node isn't freed, parts of it may still be owned by the tokens
+         * of its module */
+        (void) LOGGER_log(reachability->logger, L_DEBUG,
+                          "Removing unreachable %s.\n", name);
+        (void) vector_erase(nodes, i - 1);
+    }
+}
+
+/**
+ * @brief Remove the unreachable functions, struct functions and global
+ * variables of a module.
+ *
+ * @param[in] reachability the state of the analysis.
+ * @param[in,out] module the module to prune.
+ */
+static void reachability_prune_module(const t_reachability *reachability,
+                                      t_module *module)
+{
+    t_ast_node *node = NULL;
+
+    (void) reachability_prune_nodes(reachability, module->functions, NULL);
+    (void) reachability_prune_nodes(reachability, module->variables, NULL);
+
+    VECTOR_FOR_EACH(module->structs, structs)
+    {
+        node = ITERATOR_GET_AS(t_ast_node_ptr, &structs);
+        (void) reachability_prune_nodes(
+            reachability, node->struct_definition.struct_functions,
+            node->struct_definition.name);
+    }
+}
+
+void REACHABILITY_prune(t_module *module, t_logger *logger)
+{
+    t_reachability reachability = {.symbols = NULL, .logger = logger};
+    t_reachability_symbol *symbol = NULL, *tmp = NULL;
+    t_module *current = NULL;
+    t_ast_node *node = NULL;
+
+    (void) vector_setup(&reachability.worklist, 16,
+                        sizeof(t_reachability_symbol *));
+    (void) vector_setup(&reachability.modules, 8, sizeof(t_module *));
+
+    (void) reachability_add_module(&reachability, module);
+    (void) reachability_reach(&reachability, "main");
+
+    while (!vector_is_empty(&reachability.worklist))
+    {
+        symbol = *(t_reachability_symbol **) vector_back(
+            &reachability.worklist);
+        (void) vector_pop_back(&reachability.worklist);
+        VECTOR_FOR_EACH(&symbol->definitions, definitions)
+        {
+            node = ITERATOR_GET_AS(t_ast_node_ptr, &definitions);
+            (void) reachability_parse_body(&reachability, symbol, node);
+            (void) reachability_visit_node(&reachability, node);
+        }
+    }
+
+    VECTOR_FOR_EACH(&reachability.modules, modules)
+    {
+        current = *(t_module **) iterator_get(&modules);
+        (void) reachability_prune_module(&reachability, current);
+    }
+
+    HASH_ITER(hh, reachability.symbols, symbol, tmp)
+    {
+        HASH_DEL(reachability.symbols, symbol);
+        (void) vector_destroy(&symbol->definitions);
+        (void) free(symbol->name);
+        (void) free(symbol);
+    }
+
+    (void) vector_destroy(&reachability.worklist);
+    (void) vector_destroy(&reachability.modules);
+}
@@ -1,15 +1,29 @@
 /** @file type.c */
 #include "type.h"
+#include "ast.h"
 #include "core.h"
 #include "defs.h"
 #include "lib.h"
 #include "logger.h"
+#include "uthash.h"
 #include "utils.h"
 #include "vector.h"
 
+#include <pthread.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+typedef struct
+{
+    char *key;         /**< The structural encoding of the type */
+    t_type *type;      /**< The shared instance of the type */
+    UT_hash_handle hh; /**< A handle for uthash */
+} t_interned_type;     /**< An entry in the interned types table */
+
+static t_interned_type *interned_types = NULL;
+static pthread_mutex_t interned_types_lock = PTHREAD_MUTEX_INITIALIZER;
+
 static bool type_can_cast(const t_type *type1, const t_type *type2);
 
 bool TYPE_is_floating_point(const char *s)
@@ -30,48 +44,17 @@ bool TYPE_is_floating_type(t_type *type)
     return (type->type == TYPE_F32) || (type->type == TYPE_F64);
 }
 
-t_type *TYPE_initialize_type(t_base_type type)
+/**
+ * @brief Check whether the payload of a type holds a length instead of an
+ * allocated name.
+ *
+ * @param[in] type the type.
+ *
+ * @return true for arrays and vectors, whose payload is their length.
+ */
+static bool type_is_length_payload_type(const t_type *type)
 {
-    t_type *ttype = calloc(1, sizeof(t_type));
-    if (NULL == ttype)
-    {
-        exit(LUKA_CANT_ALLOC_MEMORY);
-    }
-
-    ttype->type = type;
-    ttype->inner_type = NULL;
-    ttype->payload = NULL;
-    ttype->mutable = false;
-    return ttype;
-}
-
-static bool type_is_payload_type(const t_type *type)
-{
-    switch (type->type)
-    {
-        case TYPE_STRUCT:
-        case TYPE_ENUM:
-        case TYPE_ALIAS:
-            return true;
-        case TYPE_ANY:
-        case TYPE_ARRAY:
-        case TYPE_BOOL:
-        case TYPE_F32:
-        case TYPE_F64:
-        case TYPE_PTR:
-        case TYPE_SINT16:
-        case TYPE_SINT32:
-        case TYPE_SINT64:
-        case TYPE_SINT8:
-        case TYPE_STRING:
-        case TYPE_TYPE:
-        case TYPE_UINT16:
-        case TYPE_UINT32:
-        case TYPE_UINT64:
-        case TYPE_UINT8:
-        case TYPE_VOID:
-            return false;
-    }
+    return (TYPE_ARRAY == type->type) || (TYPE_VECTOR == type->type);
 }
 
 /** can cast type1 to type2 */
@@ -108,6 +91,7 @@ static bool type_can_cast(const t_type *type1, const t_type *type2)
                 case TYPE_STRING:
                 case TYPE_STRUCT:
                 case TYPE_TYPE:
+                case TYPE_VECTOR:
                 case TYPE_VOID:
                     break;
             }
@@ -139,6 +123,7 @@ static bool type_can_cast(const t_type *type1, const t_type *type2)
                 case TYPE_STRING:
                 case TYPE_STRUCT:
                 case TYPE_TYPE:
+                case TYPE_VECTOR:
                 case TYPE_VOID:
                     break;
             }
@@ -170,6 +155,7 @@ static bool type_can_cast(const t_type *type1, const t_type *type2)
                 case TYPE_UINT32:
                 case TYPE_UINT64:
                 case TYPE_UINT8:
+                case TYPE_VECTOR:
                 case TYPE_VOID:
                     break;
             }
@@ -198,6 +184,7 @@ static bool type_can_cast(const t_type *type1, const t_type *type2)
                 case TYPE_UINT32:
                 case TYPE_UINT64:
                 case TYPE_UINT8:
+                case TYPE_VECTOR:
                 case TYPE_VOID:
                     break;
             }
@@ -217,12 +204,20 @@ static bool type_can_cast(const t_type *type1, const t_type *type2)
             {
                 case TYPE_ARRAY:
                 case TYPE_PTR:
-                    result = TYPE_equal(type1->inner_type, type2->inner_type);
+                    result = TYPE_can_cast(type1->inner_type,
+                                           type2->inner_type);
                     result = result
                           && (type1->inner_type->mutable
                                   ? true
                                   : !type2->inner_type->mutable);
                     break;
+                case TYPE_VECTOR:
+                    /* Arrays initialize vectors with as many lanes */
+                    result = (TYPE_ARRAY == type1->type)
+                          && (type1->payload == type2->payload)
+                          && TYPE_can_cast(type1->inner_type,
+                                           type2->inner_type);
+                    break;
                 case TYPE_ALIAS:
                 case TYPE_ANY:
                 case TYPE_BOOL:
@@ -244,6 +239,12 @@ static bool type_can_cast(const t_type *type1, const t_type *type2)
                     break;
             }
             break;
+        case TYPE_VECTOR:
+            /* Vectors cast lane by lane into vectors with as many lanes */
+            result = (TYPE_VECTOR == type2->type)
+                  && (type1->payload == type2->payload)
+                  && TYPE_can_cast(type1->inner_type, type2->inner_type);
+            break;
         case TYPE_ALIAS:
             /* TODO: Check aliases match */
             result = true;
@@ -254,6 +255,12 @@ static bool type_can_cast(const t_type *type1, const t_type *type2)
             break;
     }
 
+    if ((TYPE_VECTOR == type2->type) && (NULL == type1->inner_type))
+    {
+        /* Scalars are broadcast to every lane */
+        result = TYPE_can_cast(type1, type2->inner_type);
+    }
+
     if (TYPE_ANY == type2->type)
     {
         result = true;
@@ -264,79 +271,189 @@ static bool type_can_cast(const t_type *type1, const t_type *type2)
 
 bool TYPE_equal(const t_type *type1, const t_type *type2)
 {
-    bool equal = false;
+    if ((NULL == type1) || (NULL == type2))
+    {
+        return type1 == type2;
+    }
+
+    return type1->canonical == type2->canonical;
+}
+
+bool TYPE_can_cast(const t_type *type1, const t_type *type2)
+{
+    if ((NULL == type1) || (NULL == type2))
+    {
+        return type1 == type2;
+    }
 
-    if ((NULL == type1) && (NULL == type2))
+    if (TYPE_equal(type1, type2))
     {
         return true;
     }
-    else if (NULL == type1)
+
+    /* Pointers, arrays and vectors can be cast if their inner types can */
+    if ((type1->type == type2->type) && (NULL != type1->inner_type)
+        && ((TYPE_VECTOR != type1->type) || (type1->payload == type2->payload))
+        && TYPE_can_cast(type1->inner_type, type2->inner_type))
     {
-        return false;
+        return true;
     }
-    else if (NULL == type2)
+
+    return type_can_cast(type1, type2);
+}
+
+/**
+ * @brief Write an encoding of a type, that is equal for two types only if they
+ * are identical, as their inner types are interned.
+ *
+ * @param[in] type the type to encode.
+ * @param[out] buffer the buffer to write the encoding into, may be NULL if
+ * @p length is 0.
+ * @param[in] length the length of @p buffer.
+ *
+ * @return the amount of characters that the encoding takes.
+ */
+static int type_encode(const t_type *type, char *buffer, size_t length)
+{
+    if (type_is_length_payload_type(type))
     {
-        return false;
+        return snprintf(buffer, length, "%d%c%p[%zu]", type->type,
+                        type->mutable ? 'm' : 'c', (void *) type->inner_type,
+                        (size_t) type->payload);
     }
 
-    equal = type1->type == type2->type;
-    equal = equal && TYPE_equal(type1->inner_type, type2->inner_type);
-    equal
-        = equal && (type_is_payload_type(type1) == type_is_payload_type(type2));
-    equal = type_is_payload_type(type1)
-              ? equal
-                    && (0
-                        == strncmp(type1->payload, type2->payload,
-                                   strlen(type1->payload)))
-              : equal;
-    equal = equal || type_can_cast(type1, type2);
-    return equal;
+    return snprintf(buffer, length, "%d%c%p{%s}", type->type,
+                    type->mutable ? 'm' : 'c', (void *) type->inner_type,
+                    (NULL == type->payload) ? "" : (char *) type->payload);
 }
 
-t_type *TYPE_dup_type(t_type *type)
+/**
+ * @brief Get the single shared instance of a Luka type, the caller must hold
+ * the lock of the interned types table.
+ *
+ * @param[in] type the Luka type to intern, whose inner type is interned.
+ *
+ * @return the interned instance of @p type, or NULL if @p type is NULL.
+ */
+static t_type *type_intern(const t_type *type)
 {
-    t_type *res = NULL;
+    t_interned_type *entry = NULL;
+    t_type *interned = NULL;
+    t_type canonical;
+    char *key = NULL;
+    int length = 0;
 
-    if (NULL != type)
+    if (NULL == type)
     {
-        res = TYPE_initialize_type(type->type);
-        res->inner_type = TYPE_dup_type(type->inner_type);
-        res->payload = NULL;
-        res->mutable = type->mutable;
-        if (NULL != type->payload)
-        {
-            if (type->type == TYPE_ARRAY)
-            {
-                res->payload = type->payload;
-            }
-            else
-            {
-                res->payload = (void *) strdup(type->payload);
-            }
-        }
+        return NULL;
     }
 
-    return res;
+    length = type_encode(type, NULL, 0);
+    key = (length < 0) ? NULL : calloc((size_t) length + 1, sizeof(char));
+    if (NULL == key)
+    {
+        exit(LUKA_CANT_ALLOC_MEMORY);
+    }
+    (void) type_encode(type, key, (size_t) length + 1);
+
+    HASH_FIND_STR(interned_types, key, entry);
+    if (NULL != entry)
+    {
+        (void) free(key);
+        return entry->type;
+    }
+
+    interned = calloc(1, sizeof(t_type));
+    entry = calloc(1, sizeof(t_interned_type));
+    if ((NULL == interned) || (NULL == entry))
+    {
+        exit(LUKA_CANT_ALLOC_MEMORY);
+    }
+
+    interned->type = type->type;
+    interned->mutable = type->mutable;
+    interned->inner_type = type->inner_type;
+    if ((NULL != type->payload) && !type_is_length_payload_type(type))
+    {
+        interned->payload = (void *) strdup(type->payload);
+    }
+    else
+    {
+        interned->payload = type->payload;
+    }
+
+    entry->key = key;
+    entry->type = interned;
+    HASH_ADD_KEYPTR(hh, interned_types, entry->key, strlen(entry->key), entry);
+
+    if (!interned->mutable
+        && ((NULL == interned->inner_type)
+            || (interned->inner_type == interned->inner_type->canonical)))
+    {
+        interned->canonical = interned;
+    }
+    else
+    {
+        canonical = *interned;
+        canonical.mutable = false;
+        canonical.inner_type = (NULL == interned->inner_type)
+                                 ? NULL
+                                 : interned->inner_type->canonical;
+        interned->canonical = type_intern(&canonical);
+    }
+
+    return interned;
+}
+
+t_type *TYPE_intern(const t_type *type)
+{
+    t_type *interned = NULL;
+
+    (void) pthread_mutex_lock(&interned_types_lock);
+    interned = type_intern(type);
+    (void) pthread_mutex_unlock(&interned_types_lock);
+
+    return interned;
+}
+
+t_type *TYPE_make_type(t_base_type type, t_type *inner_type, void *payload,
+                       bool mutable)
+{
+    t_type ttype;
+
+    ttype.type = type;
+    ttype.inner_type = inner_type;
+    ttype.payload = payload;
+    ttype.mutable = mutable;
+    ttype.canonical = NULL;
+    return TYPE_intern(&ttype);
 }
 
-void TYPE_free_type(t_type *type)
+t_type *TYPE_with_mutable(t_type *type, bool mutable)
 {
-    if (NULL != type)
+    if (mutable == type->mutable)
     {
-        if ((NULL != type->payload) && (type->type != TYPE_ARRAY))
-        {
-            (void) free(type->payload);
-            type->payload = NULL;
-        }
+        return type;
+    }
+
+    return TYPE_make_type(type->type, type->inner_type, type->payload, mutable);
+}
+
+void TYPE_free_interned_types(void)
+{
+    t_interned_type *entry = NULL, *entry_iter = NULL;
 
-        if (NULL != type->inner_type)
+    HASH_ITER(hh, interned_types, entry, entry_iter)
+    {
+        HASH_DEL(interned_types, entry);
+        if ((NULL != entry->type->payload)
+            && !type_is_length_payload_type(entry->type))
         {
-            (void) TYPE_free_type(type->inner_type);
-            type->inner_type = NULL;
+            (void) free(entry->type->payload);
         }
-
-        (void) free(type);
-        type = NULL;
+        (void) free(entry->type);
+        (void) free(entry->key);
+        (void) free(entry);
     }
 }
 
@@ -365,6 +482,9 @@ ssize_t TYPE_sizeof(t_type *type)
         case TYPE_PTR:
         case TYPE_ARRAY:
             return sizeof(void *);
+        case TYPE_VECTOR:
+            return (ssize_t) (size_t) type->payload
+                 * TYPE_sizeof(type->inner_type);
         case TYPE_STRING:
             return sizeof(char *);
         case TYPE_STRUCT:
@@ -399,6 +519,37 @@ bool TYPE_is_signed(t_type *type)
         case TYPE_UINT32:
         case TYPE_UINT64:
         case TYPE_UINT8:
+        case TYPE_VECTOR:
+        case TYPE_VOID:
+            return false;
+    }
+}
+
+bool TYPE_is_integer_type(t_type *type)
+{
+    switch (type->type)
+    {
+        case TYPE_SINT8:
+        case TYPE_SINT16:
+        case TYPE_SINT32:
+        case TYPE_SINT64:
+        case TYPE_UINT8:
+        case TYPE_UINT16:
+        case TYPE_UINT32:
+        case TYPE_UINT64:
+            return true;
+        case TYPE_ALIAS:
+        case TYPE_ANY:
+        case TYPE_ARRAY:
+        case TYPE_BOOL:
+        case TYPE_ENUM:
+        case TYPE_F32:
+        case TYPE_F64:
+        case TYPE_PTR:
+        case TYPE_STRING:
+        case TYPE_STRUCT:
+        case TYPE_TYPE:
+        case TYPE_VECTOR:
         case TYPE_VOID:
             return false;
     }
@@ -484,6 +635,12 @@ const char *TYPE_to_string(t_type *type, t_logger *logger, char *buffer,
                 (void) snprintf(buffer + strlen(buffer), buffer_size, "[]");
             }
             break;
+        case TYPE_VECTOR:
+            (void) TYPE_to_string(type->inner_type, logger, buffer,
+                                  buffer_size);
+            (void) snprintf(buffer + strlen(buffer), buffer_size, "x%zu",
+                            (size_t) type->payload);
+            break;
         case TYPE_ENUM:
         case TYPE_STRUCT:
         case TYPE_ALIAS:
@@ -512,6 +669,150 @@ static t_type *type_last_stmt_type(t_vector *body, t_logger *logger,
     return TYPE_get_type(last_stmt, logger, module);
 }
 
+/**
+ * @brief Get the type of a match expression, which is the type of the first
+ * arm that isn't empty.
+ *
+ * @param[in] node the match expression.
+ * @param[in] logger a logger that can be used to log messages.
+ * @param[in] module the module that contains the match expression.
+ *
+ * @return the type of the match expression.
+ */
+static t_type *type_match_expr_type(const t_ast_node *node, t_logger *logger,
+                                    const t_module *module)
+{
+    const t_ast_match_arm *arm = NULL;
+
+    VECTOR_FOR_EACH(node->match_expr.arms, arms)
+    {
+        arm = ITERATOR_GET_AS(t_ast_match_arm_ptr, &arms);
+        if (0 != arm->body->size)
+        {
+            return type_last_stmt_type(arm->body, logger, module);
+        }
+    }
+
+    if ((NULL != node->match_expr.else_body)
+        && (0 != node->match_expr.else_body->size))
+    {
+        return type_last_stmt_type(node->match_expr.else_body, logger, module);
+    }
+
+    return TYPE_make_type(TYPE_VOID, NULL, NULL, false);
+}
+
+/**
+ * @brief Get the type of a binary expression, which is the type of its vector
+ * operand if it has one, so that scalars are broadcast to the vector.
+ * Conditions on scalars are bools.
+ *
+ * @param[in] node the binary expression.
+ * @param[in] logger a logger that can be used to log messages.
+ * @param[in] module the module that contains the binary expression.
+ *
+ * @return the type of the binary expression.
+ */
+static t_type *type_binary_expr_type(const t_ast_node *node, t_logger *logger,
+                                     const t_module *module)
+{
+    t_type *type = NULL, *lhs_type = NULL;
+
+    type = TYPE_get_type(node->binary_expr.rhs, logger, module);
+    if (TYPE_VECTOR != type->type)
+    {
+        lhs_type = TYPE_get_type(node->binary_expr.lhs, logger, module);
+        if (TYPE_VECTOR != lhs_type->type)
+        {
+            if (AST_is_cond_binop(node->binary_expr.operator))
+            {
+                return TYPE_make_type(TYPE_BOOL, NULL, NULL, false);
+            }
+            return type;
+        }
+
+        type = lhs_type;
+    }
+
+    if (!AST_is_cond_binop(node->binary_expr.operator))
+    {
+        return type;
+    }
+
+    /* Comparing vectors gives a mask with a bool for every lane */
+    return TYPE_make_type(TYPE_VECTOR,
+                          TYPE_make_type(TYPE_BOOL, NULL, NULL, false),
+                          type->payload, false);
+}
+
+/**
+ * @brief Get the type of a call to a SIMD vector builtin, which depends on the
+ * types of its arguments.
+ *
+ * @param[in] node the call expression.
+ * @param[in] logger a logger that can be used to log messages.
+ * @param[in] module the module that contains the call expression.
+ *
+ * @return the type of the call, or NULL if the builtin's return type is fixed.
+ */
+static t_type *type_builtin_call_type(const t_ast_node *node,
+                                      t_logger *logger, const t_module *module)
+{
+    t_type *type = NULL, *vector_type = NULL, *mask_type = NULL;
+    t_vector *args = node->call_expr.args;
+
+    if ((NULL == args) || (args->size < 1))
+    {
+        return NULL;
+    }
+
+    switch (node->call_expr.callable->builtin.id)
+    {
+        case BUILTIN_ID_SELECT:
+            if (args->size < 2)
+            {
+                return NULL;
+            }
+            return TYPE_get_type(*(t_ast_node **) vector_get(args, 1), logger,
+                                 module);
+        case BUILTIN_ID_SHUFFLE:
+            if (args->size < 3)
+            {
+                return NULL;
+            }
+            vector_type = TYPE_get_type(*(t_ast_node **) vector_get(args, 0),
+                                        logger, module);
+            mask_type = TYPE_get_type(*(t_ast_node **) vector_get(args, 2),
+                                      logger, module);
+            if ((TYPE_VECTOR == vector_type->type)
+                && (TYPE_ARRAY == mask_type->type))
+            {
+                type = TYPE_make_type(TYPE_VECTOR, vector_type->inner_type,
+                                      mask_type->payload, false);
+            }
+            break;
+        case BUILTIN_ID_REDUCE_ADD:
+        case BUILTIN_ID_REDUCE_MUL:
+        case BUILTIN_ID_REDUCE_MIN:
+        case BUILTIN_ID_REDUCE_MAX:
+        case BUILTIN_ID_REDUCE_AND:
+        case BUILTIN_ID_REDUCE_OR:
+        case BUILTIN_ID_REDUCE_XOR:
+            vector_type = TYPE_get_type(*(t_ast_node **) vector_get(args, 0),
+                                        logger, module);
+            if (TYPE_VECTOR == vector_type->type)
+            {
+                type = vector_type->inner_type;
+            }
+            break;
+        case BUILTIN_ID_INVALID:
+        case BUILTIN_ID_SIZEOF:
+            break;
+    }
+
+    return type;
+}
+
 t_type *TYPE_get_type(const t_ast_node *node, t_logger *logger,
                       const t_module *module)
 {
@@ -520,26 +821,33 @@ t_type *TYPE_get_type(const t_ast_node *node, t_logger *logger,
     t_vector *struct_fields = NULL;
     t_struct_field *struct_field = NULL;
 
+    if (NULL != node->expr_type)
+    {
+        return node->expr_type;
+    }
+
     switch (node->type)
     {
         case AST_TYPE_STRUCT_DEFINITION:
         case AST_TYPE_BREAK_STMT:
+        case AST_TYPE_CONTINUE_STMT:
         case AST_TYPE_EXPRESSION_STMT:
         case AST_TYPE_LET_STMT:
         case AST_TYPE_DEFER_STMT:
-            return TYPE_initialize_type(TYPE_VOID);
+        case AST_TYPE_FOR_EXPR:
+            return TYPE_make_type(TYPE_VOID, NULL, NULL, false);
         case AST_TYPE_LITERAL:
             switch (node->literal.type)
             {
                 case AST_LITERAL_FALSE:
                 case AST_LITERAL_TRUE:
-                    return TYPE_initialize_type(TYPE_BOOL);
+                    return TYPE_make_type(TYPE_BOOL, NULL, NULL, false);
                 case AST_LITERAL_NULL:
-                    type = TYPE_initialize_type(TYPE_PTR);
-                    type->inner_type = TYPE_initialize_type(TYPE_ANY);
-                    return type;
+                    return TYPE_make_type(
+                        TYPE_PTR, TYPE_make_type(TYPE_ANY, NULL, NULL, false),
+                        NULL, false);
             }
-            return TYPE_initialize_type(TYPE_ANY);
+            return TYPE_make_type(TYPE_ANY, NULL, NULL, false);
         case AST_TYPE_ASSIGNMENT_EXPR:
             return TYPE_get_type(node->assignment_expr.lhs, logger, module);
         case AST_TYPE_FUNCTION:
@@ -547,14 +855,13 @@ t_type *TYPE_get_type(const t_ast_node *node, t_logger *logger,
             {
                 return TYPE_get_type(node->function.prototype, logger, module);
             }
-            return TYPE_initialize_type(TYPE_ANY);
+            return TYPE_make_type(TYPE_ANY, NULL, NULL, false);
         case AST_TYPE_PROTOTYPE:
-            return TYPE_dup_type(node->prototype.return_type);
+            return node->prototype.return_type;
         case AST_TYPE_BUILTIN:
-            return TYPE_dup_type(
-                CORE_lookup_builtin(node)->prototype.return_type);
+            return CORE_lookup_builtin(node)->prototype.return_type;
         case AST_TYPE_TYPE_EXPR:
-            return TYPE_initialize_type(TYPE_TYPE);
+            return TYPE_make_type(TYPE_TYPE, NULL, NULL, false);
         case AST_TYPE_IF_EXPR:
             if (NULL != node->if_expr.then_body)
             {
@@ -566,50 +873,54 @@ t_type *TYPE_get_type(const t_ast_node *node, t_logger *logger,
                 return type_last_stmt_type(node->if_expr.else_body, logger,
                                            module);
             }
-            return TYPE_initialize_type(TYPE_VOID);
+            return TYPE_make_type(TYPE_VOID, NULL, NULL, false);
+        case AST_TYPE_MATCH_EXPR:
+            return type_match_expr_type(node, logger, module);
         case AST_TYPE_WHILE_EXPR:
             if (NULL != node->while_expr.body)
             {
                 return type_last_stmt_type(node->while_expr.body, logger,
                                            module);
             }
-            return TYPE_initialize_type(TYPE_VOID);
+            return TYPE_make_type(TYPE_VOID, NULL, NULL, false);
         case AST_TYPE_NUMBER:
-            type = TYPE_dup_type(node->number.type);
-            type->mutable = true;
-            return type;
+            return TYPE_with_mutable(node->number.type, true);
         case AST_TYPE_STRING:
-            type = TYPE_initialize_type(TYPE_PTR);
-            type->inner_type = TYPE_initialize_type(TYPE_UINT8);
-            return type;
+            return TYPE_make_type(
+                TYPE_PTR, TYPE_make_type(TYPE_UINT8, NULL, NULL, false), NULL,
+                false);
         case AST_TYPE_VARIABLE:
-            return TYPE_dup_type(node->variable.type);
+            return node->variable.type;
         case AST_TYPE_CAST_EXPR:
-            return TYPE_dup_type(node->cast_expr.type);
+            return node->cast_expr.type;
         case AST_TYPE_RETURN_STMT:
             return TYPE_get_type(node->return_stmt.expr, logger, module);
         case AST_TYPE_ARRAY_DEREF:
             type = TYPE_get_type(node->array_deref.variable, logger, module);
             if (NULL != type)
             {
-                inner = TYPE_dup_type(type->inner_type);
+                inner = type->inner_type;
+                if (TYPE_VECTOR == type->type)
+                {
+                    /* Lanes are as mutable as the vector holding them */
+                    inner = TYPE_with_mutable(inner, type->mutable);
+                }
             }
-            (void) TYPE_free_type(type);
             return inner;
         case AST_TYPE_GET_EXPR:
             if (node->get_expr.is_enum)
             {
-                return TYPE_initialize_type(TYPE_SINT32);
+                return TYPE_make_type(TYPE_SINT32, NULL, NULL, false);
             }
 
             type = TYPE_get_type(node->get_expr.variable, logger, module);
-            if (NULL == type->payload)
+            if ((NULL == type) || (NULL == type->payload))
             {
                 LOGGER_LOG_LOC(logger, L_ERROR, node->token,
                                "get expr variable type payload is NULL, "
                                "assuming return type is any\n",
                                NULL);
-                return TYPE_initialize_type(TYPE_ANY);
+                return TYPE_make_type(TYPE_ANY, NULL, NULL, false);
             }
             VECTOR_FOR_EACH(module->structs, structs)
             {
@@ -630,7 +941,7 @@ t_type *TYPE_get_type(const t_ast_node *node, t_logger *logger,
                                "get expr variable type struct %s not found in "
                                "module, assuming return type is any\n",
                                type->payload);
-                return TYPE_initialize_type(TYPE_ANY);
+                return TYPE_make_type(TYPE_ANY, NULL, NULL, false);
             }
 
             VECTOR_FOR_EACH(struct_fields, struct_fields_it)
@@ -639,7 +950,7 @@ t_type *TYPE_get_type(const t_ast_node *node, t_logger *logger,
                     = *(t_struct_field **) iterator_get(&struct_fields_it);
                 if (0 == strcmp(struct_field->name, node->get_expr.key))
                 {
-                    return TYPE_dup_type(struct_field->type);
+                    return struct_field->type;
                 }
             }
 
@@ -647,7 +958,7 @@ t_type *TYPE_get_type(const t_ast_node *node, t_logger *logger,
                            "get expr key not found in struct %s, assuming "
                            "return type is any\n",
                            type->payload);
-            return TYPE_initialize_type(TYPE_ANY);
+            return TYPE_make_type(TYPE_ANY, NULL, NULL, false);
         case AST_TYPE_UNARY_EXPR:
             switch (node->unary_expr.operator)
             {
@@ -656,21 +967,18 @@ t_type *TYPE_get_type(const t_ast_node *node, t_logger *logger,
                 case UNOP_BNOT:
                     return TYPE_get_type(node->unary_expr.rhs, logger, module);
                 case UNOP_NOT:
-                    return TYPE_initialize_type(TYPE_BOOL);
+                    return TYPE_make_type(TYPE_BOOL, NULL, NULL, false);
                 case UNOP_REF:
-                    type = TYPE_initialize_type(TYPE_PTR);
-                    type->inner_type
-                        = TYPE_get_type(node->unary_expr.rhs, logger, module);
-                    type->mutable = node->unary_expr.mutable;
-                    return type;
+                    return TYPE_make_type(
+                        TYPE_PTR,
+                        TYPE_get_type(node->unary_expr.rhs, logger, module),
+                        NULL, node->unary_expr.mutable);
                 case UNOP_DEREF:
                     type = TYPE_get_type(node->unary_expr.rhs, logger, module);
-                    inner = TYPE_dup_type(type->inner_type);
-                    (void) TYPE_free_type(type);
-                    return inner;
+                    return type->inner_type;
             }
         case AST_TYPE_BINARY_EXPR:
-            return TYPE_get_type(node->binary_expr.rhs, logger, module);
+            return type_binary_expr_type(node, logger, module);
         case AST_TYPE_CALL_EXPR:
             {
                 bool builtin = false;
@@ -684,6 +992,11 @@ t_type *TYPE_get_type(const t_ast_node *node, t_logger *logger,
 
                 if (builtin)
                 {
+                    type = type_builtin_call_type(node, logger, module);
+                    if (NULL != type)
+                    {
+                        return type;
+                    }
                     return TYPE_get_type(node->call_expr.callable, logger,
                                          module);
                 }
@@ -695,7 +1008,7 @@ t_type *TYPE_get_type(const t_ast_node *node, t_logger *logger,
                         "TYPE_get_type: module is NULL, cannot use it "
                         "to lookup function %s, assuming return type is any\n",
                         function_name_buffer);
-                    return TYPE_initialize_type(TYPE_ANY);
+                    return TYPE_make_type(TYPE_ANY, NULL, NULL, false);
                 }
                 func
                     = LIB_resolve_func_name(module, function_name_buffer, NULL);
@@ -706,7 +1019,7 @@ t_type *TYPE_get_type(const t_ast_node *node, t_logger *logger,
                         "TYPE_get_type: Couldn't find function %s "
                         "inside module, assuming return type is any\n",
                         function_name_buffer);
-                    return TYPE_initialize_type(TYPE_ANY);
+                    return TYPE_make_type(TYPE_ANY, NULL, NULL, false);
                 }
                 if (NULL == func->function.prototype)
                 {
@@ -714,24 +1027,30 @@ t_type *TYPE_get_type(const t_ast_node *node, t_logger *logger,
                         logger, L_ERROR, node->token,
                         "TYPE_get_type: function %s prototype is NULL\n",
                         function_name_buffer);
-                    return TYPE_initialize_type(TYPE_ANY);
+                    return TYPE_make_type(TYPE_ANY, NULL, NULL, false);
                 }
-                return TYPE_dup_type(
-                    func->function.prototype->prototype.return_type);
+                return func->function.prototype->prototype.return_type;
             }
         case AST_TYPE_STRUCT_VALUE:
-            type = TYPE_initialize_type(TYPE_STRUCT);
-            type->payload = strdup(node->struct_value.name);
-            type->mutable = true;
-            return type;
+            return TYPE_make_type(TYPE_STRUCT, NULL, node->struct_value.name,
+                                  true);
         case AST_TYPE_ENUM_DEFINITION:
-            type = TYPE_initialize_type(TYPE_ENUM);
-            type->payload = strdup(node->enum_definition.name);
-            return type;
+            return TYPE_make_type(TYPE_ENUM, NULL, node->enum_definition.name,
+                                  false);
         case AST_TYPE_ARRAY_LITERAL:
-            type = TYPE_initialize_type(TYPE_ARRAY);
-            type->inner_type = TYPE_dup_type(node->array_literal.type);
-            type->payload = (void *) node->array_literal.exprs->size;
-            return type;
+            return TYPE_make_type(TYPE_ARRAY, node->array_literal.type,
+                                  (void *) node->array_literal.exprs->size,
+                                  false);
     }
 }
+
+t_type *TYPE_annotate_type(t_ast_node *node, t_logger *logger,
+                           const t_module *module)
+{
+    if (NULL == node->expr_type)
+    {
+        node->expr_type = TYPE_get_type(node, logger, module);
+    }
+
+    return node->expr_type;
+}
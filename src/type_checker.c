@@ -8,12 +8,398 @@
 #include "type.h"
 #include "utils.h"
 #include "vector.h"
+#include <pthread.h>
+#include <stdatomic.h>
 #include <string.h>
+#include <unistd.h>
+
+/** The least amount of functions worth checking on another thread */
+#define CHECK_FUNCTIONS_PER_THREAD (64)
+#define CHECK_MAX_THREADS          (16)
+
+typedef struct
+{
+    const t_ast_node *function; /**< The function to check */
+    t_vector messages;          /**< The messages logged while checking it */
+    bool success;               /**< Whether the function passed checking */
+} t_check_task; /**< Type checking of a single function */
+
+typedef struct
+{
+    const t_module *module;  /**< The module of the functions */
+    const t_logger *logger;  /**< The logger of the module */
+    t_check_task *tasks;     /**< The tasks, in source order */
+    size_t number_of_tasks;  /**< The number of tasks */
+    atomic_size_t next_task; /**< The first task that no thread took yet */
+} t_check_pool; /**< Threads that share the tasks of a module between them */
 
 bool check_expr(const t_module *module, t_ast_node *expr, t_logger *logger);
 bool check_stmt(const t_module *module, t_ast_node *stmt, t_logger *logger);
 
-bool check_expr(const t_module *module, t_ast_node *expr, t_logger *logger)
+/**
+ * @brief Give an integer literal the type of the operand it is compared with,
+ * as in `count < 10` with an s64 `count`.
+ *
+ * @param[in,out] literal the AST node of the operand, which is converted if it
+ * is an integer literal or a negated integer literal.
+ * @param[in] type the type of the other operand.
+ *
+ * @return whether the literal was converted, false if the operand isn't an
+ * integer literal or its value doesn't fit in the type.
+ */
+static bool check_coerce_integer_literal(t_ast_node *literal, t_type *type)
+{
+    int64_t value = 0;
+    t_type *literal_type = NULL;
+
+    if ((AST_TYPE_UNARY_EXPR == literal->type)
+        && (UNOP_MINUS == literal->unary_expr.operator)
+        && (AST_TYPE_NUMBER == literal->unary_expr.rhs->type)
+        && (TYPE_is_signed(type) || TYPE_is_floating_type(type))
+        && check_coerce_integer_literal(literal->unary_expr.rhs, type))
+    {
+        literal->expr_type = NULL;
+        return true;
+    }
+
+    if (AST_TYPE_NUMBER != literal->type)
+    {
+        return false;
+    }
+
+    literal_type = literal->number.type;
+    switch (literal_type->type)
+    {
+        case TYPE_SINT8:
+            value = literal->number.value.s8;
+            break;
+        case TYPE_SINT16:
+            value = literal->number.value.s16;
+            break;
+        case TYPE_SINT32:
+            value = literal->number.value.s32;
+            break;
+        case TYPE_SINT64:
+            value = literal->number.value.s64;
+            break;
+        case TYPE_UINT8:
+            value = literal->number.value.u8;
+            break;
+        case TYPE_UINT16:
+            value = literal->number.value.u16;
+            break;
+        case TYPE_UINT32:
+            value = literal->number.value.u32;
+            break;
+        case TYPE_UINT64:
+            if (literal->number.value.u64 > INT64_MAX)
+            {
+                return false;
+            }
+            value = (int64_t) literal->number.value.u64;
+            break;
+        case TYPE_F32:
+        case TYPE_F64:
+        case TYPE_ALIAS:
+        case TYPE_ANY:
+        case TYPE_ARRAY:
+        case TYPE_BOOL:
+        case TYPE_ENUM:
+        case TYPE_PTR:
+        case TYPE_STRING:
+        case TYPE_STRUCT:
+        case TYPE_TYPE:
+        case TYPE_VECTOR:
+        case TYPE_VOID:
+            return false;
+    }
+
+    switch (type->type)
+    {
+        case TYPE_F32:
+            literal->number.value.f32 = (float) value;
+            break;
+        case TYPE_F64:
+            literal->number.value.f64 = (double) value;
+            break;
+        case TYPE_SINT8:
+            if ((value < INT8_MIN) || (value > INT8_MAX))
+            {
+                return false;
+            }
+            literal->number.value.s8 = (int8_t) value;
+            break;
+        case TYPE_SINT16:
+            if ((value < INT16_MIN) || (value > INT16_MAX))
+            {
+                return false;
+            }
+            literal->number.value.s16 = (int16_t) value;
+            break;
+        case TYPE_SINT32:
+            if ((value < INT32_MIN) || (value > INT32_MAX))
+            {
+                return false;
+            }
+            literal->number.value.s32 = (int32_t) value;
+            break;
+        case TYPE_SINT64:
+            literal->number.value.s64 = value;
+            break;
+        case TYPE_UINT8:
+            if ((value < 0) || (value > UINT8_MAX))
+            {
+                return false;
+            }
+            literal->number.value.u8 = (uint8_t) value;
+            break;
+        case TYPE_UINT16:
+            if ((value < 0) || (value > UINT16_MAX))
+            {
+                return false;
+            }
+            literal->number.value.u16 = (uint16_t) value;
+            break;
+        case TYPE_UINT32:
+            if ((value < 0) || (value > UINT32_MAX))
+            {
+                return false;
+            }
+            literal->number.value.u32 = (uint32_t) value;
+            break;
+        case TYPE_UINT64:
+            if (value < 0)
+            {
+                return false;
+            }
+            literal->number.value.u64 = (uint64_t) value;
+            break;
+        case TYPE_ALIAS:
+        case TYPE_ANY:
+        case TYPE_ARRAY:
+        case TYPE_BOOL:
+        case TYPE_ENUM:
+        case TYPE_PTR:
+        case TYPE_STRING:
+        case TYPE_STRUCT:
+        case TYPE_TYPE:
+        case TYPE_VECTOR:
+        case TYPE_VOID:
+            return false;
+    }
+
+    literal->number.type = TYPE_make_type(type->type, NULL, NULL, false);
+    literal->expr_type = NULL;
+    return true;
+}
+
+/**
+ * @brief Type check a binary expression whose operands were already checked.
+ *
+ * @param[in] module the module of the expression.
+ * @param[in,out] expr the binary expression, integer literal operands of a
+ * comparison may be converted to the type of the other operand.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return whether the expression passed type checking.
+ */
+static bool check_binary_expr(const t_module *module, t_ast_node *expr,
+                              t_logger *logger)
+{
+    t_type *type1 = NULL, *type2 = NULL;
+    char type1_str[1024], type2_str[1024];
+
+    /* Code generation looks at the signedness of the operands */
+    type1 = TYPE_annotate_type(expr->binary_expr.lhs, logger, module);
+    type2 = TYPE_annotate_type(expr->binary_expr.rhs, logger, module);
+    /* An integer literal is compared as the type of the other side */
+    if (AST_is_cond_binop(expr->binary_expr.operator)
+        && !TYPE_equal(type1, type2)
+        && (check_coerce_integer_literal(expr->binary_expr.rhs, type1)
+            || check_coerce_integer_literal(expr->binary_expr.lhs, type2)))
+    {
+        type1 = TYPE_annotate_type(expr->binary_expr.lhs, logger, module);
+        type2 = TYPE_annotate_type(expr->binary_expr.rhs, logger, module);
+    }
+    /* A scalar on either side of a vector is broadcast to its lanes */
+    if (!TYPE_can_cast(type1, type2)
+        && !((TYPE_VECTOR == type1->type) && TYPE_can_cast(type2, type1)))
+    {
+        (void) memset(type1_str, 0, 1024);
+        (void) memset(type2_str, 0, 1024);
+        (void) TYPE_to_string(type1, logger, type1_str, 1024);
+        (void) TYPE_to_string(type2, logger, type2_str, 1024);
+        LOGGER_LOG_LOC(logger, L_ERROR, expr->token,
+                       "Binary expr type checking failed: "
+                       "lhs is of type `%s` but rhs is of type `%s`\n",
+                       type1_str, type2_str);
+
+        return false;
+    }
+
+    /* Logical operators branch on their operands */
+    if (((BINOP_LAND == expr->binary_expr.operator)
+         || (BINOP_LOR == expr->binary_expr.operator))
+        && (TYPE_BOOL != type1->type))
+    {
+        (void) memset(type1_str, 0, 1024);
+        (void) TYPE_to_string(type1, logger, type1_str, 1024);
+        LOGGER_LOG_LOC(logger, L_ERROR, expr->token,
+                       "Logical operators are only defined on bools, but the "
+                       "operands are of type `%s`\n",
+                       type1_str);
+
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Type check a binary expression and the binary expressions nested in
+ * its operands.
+ *
+ * @details The nested binary expressions are collected on an explicit stack
+ * and checked from the innermost outwards, so a deeply nested expression such
+ * as `1 + (1 + (...))` doesn't take a stack frame per level. Every checked
+ * binary expression has its type memoized for the one enclosing it.
+ *
+ * @param[in] module the module of the expression.
+ * @param[in,out] expr the outermost binary expression.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return whether the expressions passed type checking.
+ */
+static bool check_binary_exprs(const t_module *module, t_ast_node *expr,
+                               t_logger *logger)
+{
+    t_vector stack = {0}, exprs = {0};
+    t_ast_node *node = NULL, *operands[2] = {NULL, NULL};
+    bool success = true;
+    size_t i = 0, j = 0;
+
+    (void) vector_setup(&stack, 16, sizeof(t_ast_node_ptr));
+    (void) vector_setup(&exprs, 16, sizeof(t_ast_node_ptr));
+
+    /* Pushing the rhs last visits it first, so the reverse order checks the
+     * lhs before the rhs and every operand before its expression */
+    (void) vector_push_back(&stack, &expr);
+    while (!vector_is_empty(&stack))
+    {
+        node = *(t_ast_node **) vector_back(&stack);
+        (void) vector_pop_back(&stack);
+        (void) vector_push_back(&exprs, &node);
+
+        operands[0] = node->binary_expr.lhs;
+        operands[1] = node->binary_expr.rhs;
+        for (j = 0; j < 2; ++j)
+        {
+            if (AST_TYPE_BINARY_EXPR == operands[j]->type)
+            {
+                (void) vector_push_back(&stack, &operands[j]);
+            }
+        }
+    }
+
+    for (i = exprs.size; success && (i > 0); --i)
+    {
+        node = VECTOR_GET_AS(t_ast_node_ptr, &exprs, i - 1);
+        operands[0] = node->binary_expr.lhs;
+        operands[1] = node->binary_expr.rhs;
+        for (j = 0; success && (j < 2); ++j)
+        {
+            if (AST_TYPE_BINARY_EXPR != operands[j]->type)
+            {
+                success = check_expr(module, operands[j], logger);
+            }
+        }
+
+        success = success && check_binary_expr(module, node, logger);
+        if (success)
+        {
+            (void) TYPE_annotate_type(node, logger, module);
+        }
+    }
+
+    (void) vector_destroy(&stack);
+    (void) vector_destroy(&exprs);
+    return success;
+}
+
+/**
+ * @brief Type check the logical operators of the condition of an if or while
+ * expression.
+ *
+ * @details Only the operands of `&&` and `||` are checked, which must be
+ * bools since each of them is branched on. The rest of the condition is left
+ * unchecked, like the conditions of if and while have always been.
+ *
+ * @param[in] module the module of the condition.
+ * @param[in] cond the condition.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return whether the logical operators of the condition passed type
+ * checking.
+ */
+static bool check_condition(const t_module *module, t_ast_node *cond,
+                            t_logger *logger)
+{
+    t_vector stack = {0};
+    t_ast_node *node = NULL, *operands[2] = {NULL, NULL};
+    t_type *type = NULL;
+    char type_str[1024];
+    bool success = true;
+    size_t i = 0;
+
+    (void) vector_setup(&stack, 8, sizeof(t_ast_node_ptr));
+    (void) vector_push_back(&stack, &cond);
+    while (success && !vector_is_empty(&stack))
+    {
+        node = *(t_ast_node **) vector_back(&stack);
+        (void) vector_pop_back(&stack);
+        if ((AST_TYPE_BINARY_EXPR != node->type)
+            || ((BINOP_LAND != node->binary_expr.operator)
+                && (BINOP_LOR != node->binary_expr.operator)))
+        {
+            continue;
+        }
+
+        operands[0] = node->binary_expr.rhs;
+        operands[1] = node->binary_expr.lhs;
+        for (i = 0; success && (i < 2); ++i)
+        {
+            type = TYPE_get_type(operands[i], logger, module);
+            success = (NULL != type) && (TYPE_BOOL == type->type);
+            if (!success)
+            {
+                (void) memset(type_str, 0, 1024);
+                (void) TYPE_to_string(type, logger, type_str, 1024);
+                LOGGER_LOG_LOC(logger, L_ERROR, node->token,
+                               "Logical operators are only defined on bools, "
+                               "but the operands are of type `%s`\n",
+                               type_str);
+            }
+            else
+            {
+                (void) vector_push_back(&stack, &operands[i]);
+            }
+        }
+    }
+
+    (void) vector_destroy(&stack);
+    return success;
+}
+
+/**
+ * @brief Type check an expression, without memoizing its type.
+ *
+ * @param[in] module the module of the expression.
+ * @param[in] expr the expression to check.
+ * @param[in] logger a logger that can be used to log messages.
+ *
+ * @return whether the expression passed type checking.
+ */
+static bool check_expr_node(const t_module *module, t_ast_node *expr,
+                            t_logger *logger)
 {
     t_ast_node *func = NULL, *proto = NULL, *stmt = NULL, *node = NULL;
     bool vararg = false, success = false, builtin = false,
@@ -132,7 +518,7 @@ bool check_expr(const t_module *module, t_ast_node *expr, t_logger *logger)
                     node = *(t_ast_node **) vector_get(expr->call_expr.args, i);
                     type1 = TYPE_get_type(node, logger, module);
                     type2 = proto->prototype.types[i];
-                    if (!TYPE_equal(type1, type2))
+                    if (!TYPE_can_cast(type1, type2))
                     {
                         (void) memset(type1_str, 0, 1024);
                         (void) memset(type2_str, 0, 1024);
@@ -146,7 +532,6 @@ bool check_expr(const t_module *module, t_ast_node *expr, t_logger *logger)
                                        function_name_buffer, type2_str,
                                        type1_str);
 
-                        (void) TYPE_free_type(type1);
                         success = false;
                         goto l_cleanup_call_expr;
                     }
@@ -174,6 +559,11 @@ l_cleanup_call_expr:
             }
         case AST_TYPE_WHILE_EXPR:
             {
+                if (!check_condition(module, expr->while_expr.cond, logger))
+                {
+                    return false;
+                }
+
                 if (NULL != expr->while_expr.body)
                 {
                     VECTOR_FOR_EACH(expr->while_expr.body, stmts)
@@ -187,10 +577,160 @@ l_cleanup_call_expr:
                     }
                 }
 
+                return true;
+            }
+        case AST_TYPE_FOR_EXPR:
+            {
+                t_ast_node *bounds[] = {expr->for_expr.start, expr->for_expr.end,
+                                        expr->for_expr.step};
+
+                for (i = 0; i < sizeof(bounds) / sizeof(bounds[0]); ++i)
+                {
+                    node = bounds[i];
+                    if (NULL == node)
+                    {
+                        continue;
+                    }
+
+                    if (!check_expr(module, node, logger))
+                    {
+                        return false;
+                    }
+
+                    type1 = TYPE_get_type(node, logger, module);
+                    success = TYPE_is_integer_type(type1);
+                    if (!success)
+                    {
+                        (void) memset(type1_str, 0, 1024);
+                        (void) TYPE_to_string(type1, logger, type1_str, 1024);
+                        LOGGER_LOG_LOC(logger, L_ERROR, node->token,
+                                       "For expr type checking failed: the "
+                                       "range must be of an integer type but "
+                                       "got `%s`\n",
+                                       type1_str);
+                    }
+                    if (!success)
+                    {
+                        return false;
+                    }
+                }
+
+                if (!TYPE_is_integer_type(expr->for_expr.var->variable.type))
+                {
+                    (void) memset(type1_str, 0, 1024);
+                    (void) TYPE_to_string(expr->for_expr.var->variable.type,
+                                          logger, type1_str, 1024);
+                    LOGGER_LOG_LOC(logger, L_ERROR, expr->token,
+                                   "For expr type checking failed: the "
+                                   "induction variable must be of an integer "
+                                   "type but got `%s`\n",
+                                   type1_str);
+                    return false;
+                }
+
+                if (NULL != expr->for_expr.body)
+                {
+                    VECTOR_FOR_EACH(expr->for_expr.body, stmts)
+                    {
+                        stmt = ITERATOR_GET_AS(t_ast_node_ptr, &stmts);
+                        success = check_stmt(module, stmt, logger);
+                        if (!success)
+                        {
+                            return false;
+                        }
+                    }
+                }
+
+                return true;
+            }
+        case AST_TYPE_MATCH_EXPR:
+            {
+                t_ast_match_arm *arm = NULL;
+
+                if (!check_expr(module, expr->match_expr.value, logger))
+                {
+                    return false;
+                }
+
+                type1 = TYPE_get_type(expr->match_expr.value, logger, module);
+                success = TYPE_is_integer_type(type1)
+                       || (TYPE_ENUM == type1->type);
+                if (!success)
+                {
+                    (void) memset(type1_str, 0, 1024);
+                    (void) TYPE_to_string(type1, logger, type1_str, 1024);
+                    LOGGER_LOG_LOC(logger, L_ERROR, expr->token,
+                                   "Match expr type checking failed: the "
+                                   "value must be of an integer or enum type "
+                                   "but got `%s`\n",
+                                   type1_str);
+                }
+                if (!success)
+                {
+                    return false;
+                }
+
+                VECTOR_FOR_EACH(expr->match_expr.arms, arms)
+                {
+                    arm = ITERATOR_GET_AS(t_ast_match_arm_ptr, &arms);
+                    VECTOR_FOR_EACH(arm->patterns, patterns)
+                    {
+                        node = ITERATOR_GET_AS(t_ast_node_ptr, &patterns);
+                        if (!check_expr(module, node, logger))
+                        {
+                            return false;
+                        }
+
+                        type1 = TYPE_get_type(node, logger, module);
+                        success = TYPE_is_integer_type(type1);
+                        if (!success)
+                        {
+                            (void) memset(type1_str, 0, 1024);
+                            (void) TYPE_to_string(type1, logger, type1_str,
+                                                  1024);
+                            LOGGER_LOG_LOC(logger, L_ERROR, node->token,
+                                           "Match expr type checking failed: "
+                                           "a pattern must be an integer or "
+                                           "an enum value but got `%s`\n",
+                                           type1_str);
+                        }
+                        if (!success)
+                        {
+                            return false;
+                        }
+                    }
+
+                    VECTOR_FOR_EACH(arm->body, stmts)
+                    {
+                        stmt = ITERATOR_GET_AS(t_ast_node_ptr, &stmts);
+                        if (!check_stmt(module, stmt, logger))
+                        {
+                            return false;
+                        }
+                    }
+                }
+
+                if (NULL != expr->match_expr.else_body)
+                {
+                    VECTOR_FOR_EACH(expr->match_expr.else_body, stmts)
+                    {
+                        stmt = ITERATOR_GET_AS(t_ast_node_ptr, &stmts);
+                        if (!check_stmt(module, stmt, logger))
+                        {
+                            return false;
+                        }
+                    }
+                }
+
                 return true;
             }
         case AST_TYPE_IF_EXPR:
             {
+                if (!check_condition(module, expr->if_expr.cond, logger))
+                {
+                    return false;
+                }
+
                 if (NULL != expr->if_expr.then_body)
                 {
                     VECTOR_FOR_EACH(expr->if_expr.then_body, stmts)
@@ -226,7 +766,7 @@ l_cleanup_call_expr:
             }
             type1 = TYPE_get_type(expr->assignment_expr.lhs, logger, module);
             type2 = TYPE_get_type(expr->assignment_expr.rhs, logger, module);
-            if (!TYPE_equal(type2, type1))
+            if (!TYPE_can_cast(type2, type1))
             {
                 (void) memset(type1_str, 0, 1024);
                 (void) memset(type2_str, 0, 1024);
@@ -237,8 +777,6 @@ l_cleanup_call_expr:
                                "lhs is of type `%s` but rhs is of type `%s`\n",
                                type1_str, type2_str);
 
-                (void) TYPE_free_type(type1);
-                (void) TYPE_free_type(type2);
                 return false;
             }
 
@@ -250,13 +788,9 @@ l_cleanup_call_expr:
                     "Assignment expr type checking failed: "
                     "Tried to assign to immutable lhs of type `%s`\n",
                     type1_str);
-                (void) TYPE_free_type(type1);
-                (void) TYPE_free_type(type2);
                 return false;
             }
 
-            (void) TYPE_free_type(type1);
-            (void) TYPE_free_type(type2);
             return true;
         case AST_TYPE_GET_EXPR:
             if (NULL == expr->get_expr.variable)
@@ -275,43 +809,19 @@ l_cleanup_call_expr:
             return (expr->get_expr.is_enum ? TYPE_ENUM == type1->type
                                            : TYPE_STRUCT == type1->type);
         case AST_TYPE_BINARY_EXPR:
-            if (!check_expr(module, expr->binary_expr.rhs, logger))
-            {
-                return false;
-            }
-
-            if (!check_expr(module, expr->binary_expr.rhs, logger))
-            {
-                return false;
-            }
-
-            type1 = TYPE_get_type(expr->binary_expr.lhs, logger, module);
-            type2 = TYPE_get_type(expr->binary_expr.rhs, logger, module);
-            if (!TYPE_equal(type1, type2))
-            {
-                (void) memset(type1_str, 0, 1024);
-                (void) memset(type2_str, 0, 1024);
-                (void) TYPE_to_string(type1, logger, type1_str, 1024);
-                (void) TYPE_to_string(type2, logger, type2_str, 1024);
-                LOGGER_LOG_LOC(logger, L_ERROR, expr->token,
-                               "Binary expr type checking failed: "
-                               "lhs is of type `%s` but rhs is of type `%s`\n",
-                               type1_str, type2_str);
-
-                (void) TYPE_free_type(type1);
-                (void) TYPE_free_type(type2);
-                return false;
-            }
-            return true;
+            return check_binary_exprs(module, expr, logger);
+        case AST_TYPE_RETURN_STMT:
+            return (NULL == expr->return_stmt.expr)
+                || check_expr(module, expr->return_stmt.expr, logger);
         case AST_TYPE_UNARY_EXPR:
         case AST_TYPE_PROTOTYPE:
         case AST_TYPE_FUNCTION:
-        case AST_TYPE_RETURN_STMT:
         case AST_TYPE_CAST_EXPR:
         case AST_TYPE_VARIABLE:
         case AST_TYPE_LET_STMT:
         case AST_TYPE_EXPRESSION_STMT:
         case AST_TYPE_BREAK_STMT:
+        case AST_TYPE_CONTINUE_STMT:
         case AST_TYPE_STRUCT_DEFINITION:
         case AST_TYPE_STRUCT_VALUE:
         case AST_TYPE_ENUM_DEFINITION:
@@ -326,6 +836,70 @@ l_cleanup_call_expr:
     }
 }
 
+/**
+ * @brief Whether the type of an expression of the given kind can be memoized.
+ *
+ * @details Every expression with a value is memoized, so the types that code
+ * generation reads are computed once. Statements and control flow are not,
+ * since their types are those of their bodies.
+ *
+ * @param[in] type the kind of the expression.
+ *
+ * @return whether the type of the expression should be memoized.
+ */
+static bool check_is_memoized(t_ast_node_type type)
+{
+    switch (type)
+    {
+        case AST_TYPE_NUMBER:
+        case AST_TYPE_STRING:
+        case AST_TYPE_LITERAL:
+        case AST_TYPE_VARIABLE:
+        case AST_TYPE_CAST_EXPR:
+        case AST_TYPE_UNARY_EXPR:
+        case AST_TYPE_BINARY_EXPR:
+        case AST_TYPE_ASSIGNMENT_EXPR:
+        case AST_TYPE_CALL_EXPR:
+        case AST_TYPE_STRUCT_VALUE:
+        case AST_TYPE_GET_EXPR:
+        case AST_TYPE_ARRAY_DEREF:
+        case AST_TYPE_ARRAY_LITERAL:
+            return true;
+        case AST_TYPE_PROTOTYPE:
+        case AST_TYPE_FUNCTION:
+        case AST_TYPE_RETURN_STMT:
+        case AST_TYPE_IF_EXPR:
+        case AST_TYPE_MATCH_EXPR:
+        case AST_TYPE_WHILE_EXPR:
+        case AST_TYPE_FOR_EXPR:
+        case AST_TYPE_LET_STMT:
+        case AST_TYPE_EXPRESSION_STMT:
+        case AST_TYPE_BREAK_STMT:
+        case AST_TYPE_CONTINUE_STMT:
+        case AST_TYPE_STRUCT_DEFINITION:
+        case AST_TYPE_ENUM_DEFINITION:
+        case AST_TYPE_BUILTIN:
+        case AST_TYPE_TYPE_EXPR:
+        case AST_TYPE_DEFER_STMT:
+            return false;
+    }
+}
+
+bool check_expr(const t_module *module, t_ast_node *expr, t_logger *logger)
+{
+    if (!check_expr_node(module, expr, logger))
+    {
+        return false;
+    }
+
+    if (check_is_memoized(expr->type))
+    {
+        (void) TYPE_annotate_type(expr, logger, module);
+    }
+
+    return true;
+}
+
 bool check_stmt(const t_module *module, t_ast_node *stmt, t_logger *logger)
 {
     t_type *type1 = NULL, *type2 = NULL;
@@ -344,7 +918,7 @@ bool check_stmt(const t_module *module, t_ast_node *stmt, t_logger *logger)
 
             type1 = TYPE_get_type(stmt->let_stmt.var, logger, module);
             type2 = TYPE_get_type(stmt->let_stmt.expr, logger, module);
-            if (!TYPE_equal(type2, type1))
+            if (!TYPE_can_cast(type2, type1))
             {
                 (void) memset(type1_str, 0, 1024);
                 (void) memset(type2_str, 0, 1024);
@@ -355,8 +929,6 @@ bool check_stmt(const t_module *module, t_ast_node *stmt, t_logger *logger)
                                "lhs is of type `%s` but rhs is of type `%s`\n",
                                type1_str, type2_str);
 
-                (void) TYPE_free_type(type1);
-                (void) TYPE_free_type(type2);
                 return false;
             }
             return true;
@@ -368,12 +940,15 @@ bool check_stmt(const t_module *module, t_ast_node *stmt, t_logger *logger)
         case AST_TYPE_FUNCTION:
         case AST_TYPE_RETURN_STMT:
         case AST_TYPE_IF_EXPR:
+        case AST_TYPE_MATCH_EXPR:
         case AST_TYPE_WHILE_EXPR:
+        case AST_TYPE_FOR_EXPR:
         case AST_TYPE_CAST_EXPR:
         case AST_TYPE_VARIABLE:
         case AST_TYPE_ASSIGNMENT_EXPR:
         case AST_TYPE_CALL_EXPR:
         case AST_TYPE_BREAK_STMT:
+        case AST_TYPE_CONTINUE_STMT:
         case AST_TYPE_STRUCT_DEFINITION:
         case AST_TYPE_STRUCT_VALUE:
         case AST_TYPE_ENUM_DEFINITION:
@@ -390,6 +965,189 @@ bool check_stmt(const t_module *module, t_ast_node *stmt, t_logger *logger)
     }
 }
 
+/**
+ * @brief Push the statements of a block on a stack of nodes to visit.
+ *
+ * @param[in,out] stack the #t_ast_node_ptr nodes to visit.
+ * @param[in] body the statements of the block, may be NULL.
+ */
+static void check_push_body(t_vector *stack, t_vector *body)
+{
+    if (NULL == body)
+    {
+        return;
+    }
+
+    VECTOR_FOR_EACH(body, stmts)
+    {
+        (void) vector_push_back(stack, iterator_get(&stmts));
+    }
+}
+
+/**
+ * @brief Push the children of a node on a stack of nodes to visit.
+ *
+ * @details The callable of a call isn't pushed, since a method is looked up
+ * by the call and isn't a field of the struct it is called on.
+ *
+ * @param[in,out] stack the #t_ast_node_ptr nodes to visit.
+ * @param[in] node the node whose children should be visited.
+ */
+static void check_push_children(t_vector *stack, t_ast_node *node)
+{
+    t_ast_node *children[3] = {NULL, NULL, NULL};
+    t_ast_match_arm *arm = NULL;
+    t_struct_value_field *struct_value = NULL;
+    size_t i = 0;
+
+    switch (node->type)
+    {
+        case AST_TYPE_NUMBER:
+        case AST_TYPE_STRING:
+        case AST_TYPE_LITERAL:
+        case AST_TYPE_VARIABLE:
+        case AST_TYPE_PROTOTYPE:
+        case AST_TYPE_FUNCTION:
+        case AST_TYPE_BREAK_STMT:
+        case AST_TYPE_CONTINUE_STMT:
+        case AST_TYPE_STRUCT_DEFINITION:
+        case AST_TYPE_ENUM_DEFINITION:
+        case AST_TYPE_BUILTIN:
+        case AST_TYPE_TYPE_EXPR:
+            break;
+        case AST_TYPE_CAST_EXPR:
+            children[0] = node->cast_expr.expr;
+            break;
+        case AST_TYPE_UNARY_EXPR:
+            children[0] = node->unary_expr.rhs;
+            break;
+        case AST_TYPE_BINARY_EXPR:
+            children[0] = node->binary_expr.lhs;
+            children[1] = node->binary_expr.rhs;
+            break;
+        case AST_TYPE_ASSIGNMENT_EXPR:
+            children[0] = node->assignment_expr.lhs;
+            children[1] = node->assignment_expr.rhs;
+            break;
+        case AST_TYPE_GET_EXPR:
+            children[0] = node->get_expr.variable;
+            break;
+        case AST_TYPE_ARRAY_DEREF:
+            children[0] = node->array_deref.variable;
+            children[1] = node->array_deref.index;
+            break;
+        case AST_TYPE_RETURN_STMT:
+            children[0] = node->return_stmt.expr;
+            break;
+        case AST_TYPE_EXPRESSION_STMT:
+            children[0] = node->expression_stmt.expr;
+            break;
+        case AST_TYPE_LET_STMT:
+            children[0] = node->let_stmt.var;
+            children[1] = node->let_stmt.expr;
+            break;
+        case AST_TYPE_CALL_EXPR:
+            (void) check_push_body(stack, node->call_expr.args);
+            break;
+        case AST_TYPE_ARRAY_LITERAL:
+            (void) check_push_body(stack, node->array_literal.exprs);
+            break;
+        case AST_TYPE_STRUCT_VALUE:
+            if (NULL == node->struct_value.struct_values)
+            {
+                break;
+            }
+
+            VECTOR_FOR_EACH(node->struct_value.struct_values, struct_values)
+            {
+                struct_value = ITERATOR_GET_AS(t_struct_value_field_ptr,
+                                               &struct_values);
+                (void) vector_push_back(stack, &struct_value->expr);
+            }
+            break;
+        case AST_TYPE_IF_EXPR:
+            children[0] = node->if_expr.cond;
+            (void) check_push_body(stack, node->if_expr.then_body);
+            (void) check_push_body(stack, node->if_expr.else_body);
+            break;
+        case AST_TYPE_WHILE_EXPR:
+            children[0] = node->while_expr.cond;
+            (void) check_push_body(stack, node->while_expr.body);
+            break;
+        case AST_TYPE_FOR_EXPR:
+            children[0] = node->for_expr.start;
+            children[1] = node->for_expr.end;
+            children[2] = node->for_expr.step;
+            (void) check_push_body(stack, node->for_expr.body);
+            break;
+        case AST_TYPE_MATCH_EXPR:
+            children[0] = node->match_expr.value;
+            VECTOR_FOR_EACH(node->match_expr.arms, arms)
+            {
+                arm = ITERATOR_GET_AS(t_ast_match_arm_ptr, &arms);
+                (void) check_push_body(stack, arm->patterns);
+                (void) check_push_body(stack, arm->body);
+            }
+            (void) check_push_body(stack, node->match_expr.else_body);
+            break;
+        case AST_TYPE_DEFER_STMT:
+            (void) check_push_body(stack, node->defer_stmt.body);
+            break;
+    }
+
+    for (i = 0; i < sizeof(children) / sizeof(children[0]); ++i)
+    {
+        if (NULL != children[i])
+        {
+            (void) vector_push_back(stack, &children[i]);
+        }
+    }
+}
+
+/**
+ * @brief Memoize the type of every expression in a checked block, so that
+ * code generation reads the types instead of computing them.
+ *
+ * @details The nodes are collected on an explicit stack and annotated in
+ * reverse, which annotates every child before its parent without taking a
+ * stack frame per level of nesting.
+ *
+ * @param[in] module the module of the block.
+ * @param[in,out] body the statements of the block.
+ * @param[in] logger a logger that can be used to log messages.
+ */
+static void check_annotate_types(const t_module *module, t_vector *body,
+                                 t_logger *logger)
+{
+    t_vector stack = {0}, nodes = {0};
+    t_ast_node *node = NULL;
+    size_t i = 0;
+
+    (void) vector_setup(&stack, 16, sizeof(t_ast_node_ptr));
+    (void) vector_setup(&nodes, 64, sizeof(t_ast_node_ptr));
+
+    (void) check_push_body(&stack, body);
+    while (!vector_is_empty(&stack))
+    {
+        node = *(t_ast_node **) vector_back(&stack);
+        (void) vector_pop_back(&stack);
+        (void) vector_push_back(&nodes, &node);
+        (void) check_push_children(&stack, node);
+    }
+
+    for (i = nodes.size; i > 0; --i)
+    {
+        node = VECTOR_GET_AS(t_ast_node_ptr, &nodes, i - 1);
+        if (check_is_memoized(node->type))
+        {
+            (void) TYPE_annotate_type(node, logger, module);
+        }
+    }
+
+    (void) vector_destroy(&stack);
+    (void) vector_destroy(&nodes);
+}
+
 bool CHECK_function(const t_module *module, const t_ast_node *function,
                     t_logger *logger)
 {
@@ -412,5 +1170,145 @@ bool CHECK_function(const t_module *module, const t_ast_node *function,
         }
     }
 
+    (void) check_annotate_types(module, function->function.body, logger);
     return true;
 }
+
+/**
+ * @brief Take tasks from a pool and run them until none are left.
+ *
+ * @param[in,out] arg the #t_check_pool to take tasks from.
+ *
+ * @return NULL.
+ */
+static void *check_run_worker(void *arg)
+{
+    t_check_pool *pool = arg;
+    t_logger logger = *pool->logger;
+    t_check_task *task = NULL;
+    size_t index = 0;
+
+    while (true)
+    {
+        index = atomic_fetch_add_explicit(&pool->next_task, 1,
+                                          memory_order_relaxed);
+        if (index >= pool->number_of_tasks)
+        {
+            break;
+        }
+
+        task = &pool->tasks[index];
+        logger.deferred = &task->messages;
+        task->success = CHECK_function(pool->module, task->function, &logger);
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief The number of threads worth checking a given amount of functions.
+ *
+ * @param[in] number_of_functions the number of functions to check.
+ *
+ * @return the number of threads, including the calling thread.
+ */
+static size_t check_number_of_threads(size_t number_of_functions)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t number_of_threads = number_of_functions / CHECK_FUNCTIONS_PER_THREAD;
+
+    if (1 > cpus)
+    {
+        return 1;
+    }
+
+    number_of_threads = (number_of_threads < (size_t) cpus) ? number_of_threads
+                                                             : (size_t) cpus;
+    return (number_of_threads < CHECK_MAX_THREADS) ? number_of_threads
+                                                   : CHECK_MAX_THREADS;
+}
+
+bool CHECK_functions(const t_module *module, const t_vector *functions,
+                     t_logger *logger)
+{
+    pthread_t threads[CHECK_MAX_THREADS];
+    t_check_pool pool = {0};
+    size_t number_of_threads = check_number_of_threads(functions->size);
+    size_t started = 0, i = 0;
+    bool success = true;
+
+    if (2 > number_of_threads)
+    {
+        for (i = 0; i < functions->size; ++i)
+        {
+            if (!CHECK_function(module,
+                                *(t_ast_node *const *) vector_const_get(
+                                    functions, i),
+                                logger))
+            {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    pool.tasks = calloc(functions->size, sizeof(t_check_task));
+    if (NULL == pool.tasks)
+    {
+        (void) LOGGER_log(logger, L_ERROR,
+                          "Couldn't allocate memory for type checking "
+                          "tasks.\n");
+        exit(LUKA_CANT_ALLOC_MEMORY);
+    }
+
+    for (i = 0; i < functions->size; ++i)
+    {
+        pool.tasks[i].function
+            = *(t_ast_node *const *) vector_const_get(functions, i);
+        (void) vector_setup(&pool.tasks[i].messages, 1,
+                            sizeof(t_logger_message));
+    }
+
+    pool.module = module;
+    pool.logger = logger;
+    pool.number_of_tasks = functions->size;
+    (void) atomic_init(&pool.next_task, 0);
+
+    /* The calling thread takes tasks too, so every task is done even if no
+     * thread could be started. */
+    for (i = 0; i + 1 < number_of_threads; ++i)
+    {
+        if (0 != pthread_create(&threads[i], NULL, check_run_worker, &pool))
+        {
+            break;
+        }
+        ++started;
+    }
+
+    (void) check_run_worker(&pool);
+    for (i = 0; i < started; ++i)
+    {
+        (void) pthread_join(threads[i], NULL);
+    }
+
+    /* Report like checking the functions one by one would have, up to the
+     * first function that failed. */
+    for (i = 0; i < pool.number_of_tasks; ++i)
+    {
+        if (success)
+        {
+            (void) LOGGER_replay(logger, &pool.tasks[i].messages);
+            success = pool.tasks[i].success;
+        }
+        else
+        {
+            (void) LOGGER_discard(&pool.tasks[i].messages);
+        }
+
+        (void) vector_destroy(&pool.tasks[i].messages);
+    }
+
+    (void) free(pool.tasks);
+    return success;
+}
@@ -45,7 +45,7 @@ char *UTILS_fill_function_name(char *function_name_buffer, size_t buffer_length,
             if (NULL != pushed_first_arg)
             {
                 arg = AST_new_variable(strdup(variable->variable.name),
-                                       TYPE_dup_type(variable->variable.type),
+                                       variable->variable.type,
                                        variable->variable.mutable);
                 if (!derefed)
                 {
@@ -1,6 +1,7 @@
 #include "utest.h"
 
 #include "lexer.h"
+#include "lib.h"
 
 extern int lexer_is_keyword(const char *identifier);
 extern char *lexer_lex_number(const char *source, size_t *index,
@@ -15,6 +16,29 @@ struct lexer
     size_t index;
 };
 
+static t_vector *lexer_test_tokenize(const char *source, t_logger *logger)
+{
+    t_vector *tokens = calloc(1, sizeof(t_vector));
+    if ((NULL == tokens) || vector_setup(tokens, 1, sizeof(t_token_ptr)))
+    {
+        return NULL;
+    }
+
+    if (LUKA_SUCCESS
+        != LEXER_tokenize_source(tokens, source, logger, "test.luka"))
+    {
+        (void) LIB_free_tokens_vector(tokens);
+        return NULL;
+    }
+
+    return tokens;
+}
+
+static t_token *lexer_test_token(t_vector *tokens, size_t index)
+{
+    return VECTOR_GET_AS(t_token_ptr, tokens, index);
+}
+
 UTEST_F_SETUP(lexer)
 {
     utest_fixture->logger = LOGGER_initialize("/dev/null", 0);
@@ -67,6 +91,12 @@ UTEST(lexer, is_keyword_works_for_keywords)
     ASSERT_NE(-1, lexer_is_keyword("f64"));
     ASSERT_NE(-1, lexer_is_keyword("f32"));
     ASSERT_NE(-1, lexer_is_keyword("s64"));
+    ASSERT_NE(-1, lexer_is_keyword("export"));
+    ASSERT_NE(-1, lexer_is_keyword("for"));
+    ASSERT_NE(-1, lexer_is_keyword("in"));
+    ASSERT_NE(-1, lexer_is_keyword("continue"));
+    ASSERT_NE(-1, lexer_is_keyword("restrict"));
+    ASSERT_NE(-1, lexer_is_keyword("match"));
 }
 
 UTEST(lexer, is_keyword_works_for_not_keywords)
@@ -75,6 +105,8 @@ UTEST(lexer, is_keyword_works_for_not_keywords)
     ASSERT_EQ(-1, lexer_is_keyword("a1"));
     ASSERT_EQ(-1, lexer_is_keyword("___asd___"));
     ASSERT_EQ(-1, lexer_is_keyword("s5"));
+    /* `step` is only special inside a for loop header */
+    ASSERT_EQ(-1, lexer_is_keyword("step"));
 }
 
 UTEST_F(lexer, lex_number_works_for_integers)
@@ -110,6 +142,65 @@ UTEST_F(lexer, lex_number_works_with_f_suffix)
     ASSERT_EQ((size_t) 4, utest_fixture->index);
 }
 
+UTEST_F(lexer, lex_number_stops_before_range)
+{
+    utest_fixture->index = 0;
+    ASSERT_STREQ("0", lexer_lex_number("0..10", &utest_fixture->index,
+                                       utest_fixture->logger));
+    ASSERT_EQ((size_t) 0, utest_fixture->index);
+}
+
+UTEST_F(lexer, tokenize_range)
+{
+    t_vector *tokens = lexer_test_tokenize("0..10", utest_fixture->logger);
+    ASSERT_NE((t_vector *) NULL, tokens);
+
+    ASSERT_EQ(T_NUMBER, lexer_test_token(tokens, 0)->type);
+    ASSERT_STREQ("0", lexer_test_token(tokens, 0)->content);
+    ASSERT_EQ(T_DOUBLE_DOT, lexer_test_token(tokens, 1)->type);
+    ASSERT_EQ(T_NUMBER, lexer_test_token(tokens, 2)->type);
+    ASSERT_STREQ("10", lexer_test_token(tokens, 2)->content);
+    (void) LIB_free_tokens_vector(tokens);
+}
+
+UTEST_F(lexer, tokenize_wrapping_operators)
+{
+    t_vector *tokens
+        = lexer_test_tokenize("a +% b -% c *% d % e", utest_fixture->logger);
+    ASSERT_NE((t_vector *) NULL, tokens);
+
+    ASSERT_EQ(T_PLUS_PERCENT, lexer_test_token(tokens, 1)->type);
+    ASSERT_EQ(T_MINUS_PERCENT, lexer_test_token(tokens, 3)->type);
+    ASSERT_EQ(T_STAR_PERCENT, lexer_test_token(tokens, 5)->type);
+    ASSERT_EQ(T_PERCENT, lexer_test_token(tokens, 7)->type);
+    (void) LIB_free_tokens_vector(tokens);
+}
+
+UTEST_F(lexer, tokenize_logical_operators)
+{
+    t_vector *tokens
+        = lexer_test_tokenize("a && b || c & d | e", utest_fixture->logger);
+    ASSERT_NE((t_vector *) NULL, tokens);
+
+    ASSERT_EQ(T_DOUBLE_AMPERCENT, lexer_test_token(tokens, 1)->type);
+    ASSERT_EQ(T_DOUBLE_PIPE, lexer_test_token(tokens, 3)->type);
+    ASSERT_EQ(T_AMPERCENT, lexer_test_token(tokens, 5)->type);
+    ASSERT_EQ(T_PIPE, lexer_test_token(tokens, 7)->type);
+    (void) LIB_free_tokens_vector(tokens);
+}
+
+UTEST_F(lexer, tokenize_fat_arrow)
+{
+    t_vector *tokens
+        = lexer_test_tokenize("1 => x == y = z", utest_fixture->logger);
+    ASSERT_NE((t_vector *) NULL, tokens);
+
+    ASSERT_EQ(T_FAT_ARROW, lexer_test_token(tokens, 1)->type);
+    ASSERT_EQ(T_EQEQ, lexer_test_token(tokens, 3)->type);
+    ASSERT_EQ(T_EQUALS, lexer_test_token(tokens, 5)->type);
+    (void) LIB_free_tokens_vector(tokens);
+}
+
 UTEST_F(lexer, lex_identifier_empty_string)
 {
     utest_fixture->index = 0;